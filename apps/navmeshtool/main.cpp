@@ -0,0 +1,247 @@
+#include "navmesh.hpp"
+#include "worldspacedata.hpp"
+
+#include "../openmw/mwphysics/constants.hpp"
+
+#include <components/debug/debugging.hpp>
+#include <components/debug/debuglog.hpp>
+#include <components/detournavigator/navmeshdiskcache.hpp>
+#include <components/detournavigator/settings.hpp>
+#include <components/esm/esmreader.hpp>
+#include <components/files/collections.hpp>
+#include <components/files/configurationmanager.hpp>
+#include <components/files/escape.hpp>
+#include <components/resource/bulletshape.hpp>
+#include <components/resource/bulletshapemanager.hpp>
+#include <components/resource/resourcesystem.hpp>
+#include <components/settings/settings.hpp>
+#include <components/to_utf8/to_utf8.hpp>
+#include <components/vfs/manager.hpp>
+#include <components/vfs/registerarchives.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace NavMeshTool
+{
+    namespace
+    {
+        namespace bpo = boost::program_options;
+
+        using StringsVector = std::vector<std::string>;
+
+        bpo::options_description makeOptionsDescription()
+        {
+            bpo::options_description result("Syntax: openmw-navmeshtool <options>\nAllowed options");
+
+            result.add_options()
+                ("help", "print help message")
+
+                ("data", bpo::value<Files::EscapePathContainer>()->default_value(Files::EscapePathContainer(), "data")
+                    ->multitoken()->composing(), "set data directories (later directories have higher priority)")
+
+                ("data-local", bpo::value<Files::EscapeHashString>()->default_value(""),
+                    "set local data directory (highest priority)")
+
+                ("fallback-archive", bpo::value<Files::EscapeStringVector>()->default_value(Files::EscapeStringVector(), "fallback-archive")
+                    ->multitoken(), "set fallback BSA archives (later archives have higher priority)")
+
+                ("resources", bpo::value<Files::EscapeHashString>()->default_value("resources"),
+                    "set resources directory")
+
+                ("content", bpo::value<Files::EscapeStringVector>()->default_value(Files::EscapeStringVector(), "")
+                    ->multitoken(), "content file(s): esm/esp, or omwgame/omwaddon")
+
+                ("fs-strict", bpo::value<bool>()->implicit_value(true)
+                    ->default_value(false), "strict file system handling (no case folding)")
+
+                ("encoding", bpo::value<Files::EscapeHashString>()->
+                    default_value("win1252"),
+                    "Character encoding used in OpenMW game messages:\n"
+                    "\n\twin1250 - Central and Eastern European such as Polish, Czech, Slovak, Hungarian, Slovene, Bosnian, Croatian, Serbian (Latin script), Romanian and Albanian languages\n"
+                    "\n\twin1251 - Cyrillic alphabet such as Russian, Bulgarian, Serbian Cyrillic and other languages\n"
+                    "\n\twin1252 - Western European (Latin) alphabet, used by default")
+
+                ("threads", bpo::value<std::size_t>()->default_value(std::max<std::size_t>(std::thread::hardware_concurrency(), 1)),
+                    "number of threads for nav mesh generation")
+
+                ("output", bpo::value<Files::EscapeHashString>()->default_value(""),
+                    "directory to write nav mesh tiles, \"[Navigator] nav mesh disk cache path\" setting is used when empty")
+            ;
+
+            return result;
+        }
+
+        void loadSettings(const Files::ConfigurationManager& config, Settings::Manager& settings)
+        {
+            const std::string localDefault = (config.getLocalPath() / "settings-default.cfg").string();
+            const std::string globalDefault = (config.getGlobalPath() / "settings-default.cfg").string();
+
+            if (boost::filesystem::exists(localDefault))
+                settings.loadDefault(localDefault);
+            else if (boost::filesystem::exists(globalDefault))
+                settings.loadDefault(globalDefault);
+            else
+                throw std::runtime_error("No default settings file found! Make sure the file \"settings-default.cfg\" was properly installed.");
+
+            const std::string settingsPath = (config.getUserConfigPath() / "settings.cfg").string();
+            if (boost::filesystem::exists(settingsPath))
+                settings.loadUser(settingsPath);
+        }
+
+        void openContentFiles(const Files::Collections& fileCollections, const StringsVector& contentFiles,
+            ToUTF8::Utf8Encoder& encoder, std::vector<ESM::ESMReader>& readers)
+        {
+            readers.resize(contentFiles.size());
+
+            for (std::size_t i = 0; i < contentFiles.size(); ++i)
+            {
+                const auto& file = contentFiles[i];
+                const auto& collection = fileCollections.getCollection(boost::filesystem::path(file).extension().string());
+                if (!collection.doesExist(file))
+                    throw std::runtime_error("Failed loading " + file + ": the content file does not exist");
+
+                Log(Debug::Info) << "Loading content file " << file;
+
+                readers[i].setEncoder(&encoder);
+                readers[i].setIndex(static_cast<int>(i));
+                readers[i].setGlobalReaderList(&readers);
+                readers[i].open(collection.getPath(file).string());
+            }
+        }
+
+        float getGameSettingFloat(const EsmData& esmData, const std::string& id, float defaultValue)
+        {
+            if (const auto value = esmData.mGameSettings.search(id))
+                return value->mValue.getFloat();
+            return defaultValue;
+        }
+
+        int runNavMeshTool(int argc, char *argv[])
+        {
+            bpo::options_description desc = makeOptionsDescription();
+
+            bpo::parsed_options options = bpo::command_line_parser(argc, argv)
+                .options(desc).allow_unregistered().run();
+            bpo::variables_map variables;
+
+            bpo::store(options, variables);
+            bpo::notify(variables);
+
+            if (variables.find("help") != variables.end())
+            {
+                std::cout << desc << std::endl;
+                return 0;
+            }
+
+            Files::ConfigurationManager config;
+            config.readConfiguration(variables, desc);
+
+            const std::string encoding(variables["encoding"].as<Files::EscapeHashString>().toStdString());
+            Log(Debug::Info) << ToUTF8::encodingUsingMessage(encoding);
+            ToUTF8::Utf8Encoder encoder(ToUTF8::calculateEncoding(encoding));
+
+            Files::PathContainer dataDirs(Files::EscapePath::toPathContainer(variables["data"].as<Files::EscapePathContainer>()));
+
+            std::string local(variables["data-local"].as<Files::EscapeHashString>().toStdString());
+            if (!local.empty())
+            {
+                if (local.front() == '\"')
+                    local = local.substr(1, local.length() - 2);
+
+                dataDirs.push_back(Files::PathContainer::value_type(local));
+            }
+
+            config.processPaths(dataDirs);
+
+            const auto fsStrict = variables["fs-strict"].as<bool>();
+            const auto archives = variables["fallback-archive"].as<Files::EscapeStringVector>().toStdStringVector();
+            const auto contentFiles = variables["content"].as<Files::EscapeStringVector>().toStdStringVector();
+            const auto threadsNumber = variables["threads"].as<std::size_t>();
+
+            if (contentFiles.empty())
+                throw std::runtime_error("No content file given (esm/esp, nor omwgame/omwaddon)");
+
+            Settings::Manager settings;
+            loadSettings(config, settings);
+
+            auto navigatorSettings = DetourNavigator::makeSettingsFromSettingsManager();
+            if (!navigatorSettings)
+                throw std::runtime_error("Navigator is disabled by \"[Navigator] enable\" setting");
+
+            std::string output(variables["output"].as<Files::EscapeHashString>().toStdString());
+            if (output.empty())
+                output = navigatorSettings->mNavMeshDiskCachePath;
+            if (output.empty())
+                throw std::runtime_error("No output directory given by --output nor \"[Navigator] nav mesh disk cache path\"");
+
+            const Files::Collections fileCollections(dataDirs, !fsStrict);
+
+            VFS::Manager vfs(fsStrict);
+            VFS::registerArchives(&vfs, fileCollections, archives, true);
+
+            Resource::ResourceSystem resourceSystem(&vfs);
+            Resource::BulletShapeManager bulletShapeManager(&vfs, resourceSystem.getSceneManager(),
+                resourceSystem.getNifFileManager());
+
+            std::vector<ESM::ESMReader> readers;
+            openContentFiles(fileCollections, contentFiles, encoder, readers);
+
+            EsmData esmData;
+            loadEsmData(readers, esmData);
+
+            navigatorSettings->mMaxClimb = MWPhysics::sStepSizeUp;
+            navigatorSettings->mMaxSlope = MWPhysics::sMaxSlope;
+            navigatorSettings->mSwimHeightScale = getGameSettingFloat(esmData, "fSwimHeightScale", 0);
+
+            const float maxActivationDistance = getGameSettingFloat(esmData, "iMaxActivateDist", 192);
+
+            const auto playerShape = bulletShapeManager.getShape("meshes\\base_anim.nif");
+            if (!playerShape)
+                throw std::runtime_error("Failed to load player collision shape: meshes\\base_anim.nif");
+            const osg::Vec3f agentHalfExtents = playerShape->mCollisionBoxHalfExtents;
+
+            const DetourNavigator::NavMeshDiskCache diskCache(output, *navigatorSettings);
+
+            Log(Debug::Info) << "Generating nav mesh tiles for agent (" << agentHalfExtents.x() << ", "
+                             << agentHalfExtents.y() << ", " << agentHalfExtents.z() << ") into " << output
+                             << " using " << threadsNumber << " threads...";
+
+            const auto start = std::chrono::steady_clock::now();
+            NavMeshTilesStats total;
+            std::size_t worldspaces = 0;
+
+            forEachWorldspace(esmData, readers, bulletShapeManager,
+                WorldspaceBuilderSettings {*navigatorSettings, maxActivationDistance},
+                [&] (WorldspaceData& worldspace)
+                {
+                    const auto stats = generateAllNavMeshTiles(agentHalfExtents, *navigatorSettings,
+                        threadsNumber, worldspace, diskCache);
+                    total.mGenerated += stats.mGenerated;
+                    total.mCached += stats.mCached;
+                    total.mEmpty += stats.mEmpty;
+                    ++worldspaces;
+                });
+
+            const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            Log(Debug::Info) << std::fixed << std::setprecision(2) << "Processed " << worldspaces << " worldspaces in "
+                             << duration << " seconds: " << total.mGenerated << " tiles generated ("
+                             << (duration > 0 ? total.mGenerated / duration : 0) << " tiles/s), "
+                             << total.mCached << " already cached, " << total.mEmpty << " empty";
+
+            return 0;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    return wrapApplication(NavMeshTool::runNavMeshTool, argc, argv, "NavMeshTool");
+}
@@ -0,0 +1,101 @@
+#include "navmesh.hpp"
+#include "worldspacedata.hpp"
+
+#include <components/debug/debuglog.hpp>
+#include <components/detournavigator/makenavmesh.hpp>
+#include <components/detournavigator/navmeshdiskcache.hpp>
+#include <components/detournavigator/recastmesh.hpp>
+#include <components/detournavigator/settings.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NavMeshTool
+{
+    NavMeshTilesStats generateAllNavMeshTiles(const osg::Vec3f& agentHalfExtents,
+        const DetourNavigator::Settings& settings, std::size_t threadsNumber, WorldspaceData& data,
+        const DetourNavigator::NavMeshDiskCache& diskCache)
+    {
+        using DetourNavigator::TilePosition;
+
+        std::vector<TilePosition> tiles;
+        data.mRecastMeshManager.forEachTilePosition([&] (const TilePosition& tile) { tiles.push_back(tile); });
+
+        std::atomic_size_t next(0);
+        std::atomic_size_t generated(0);
+        std::atomic_size_t cached(0);
+        std::atomic_size_t empty(0);
+        std::atomic_bool failed(false);
+        std::mutex errorMutex;
+        std::exception_ptr error;
+
+        const auto process = [&]
+        {
+            try
+            {
+                for (std::size_t i = next++; i < tiles.size() && !failed; i = next++)
+                {
+                    const auto& tile = tiles[i];
+                    const auto recastMesh = data.mRecastMeshManager.getMesh(tile);
+                    if (!recastMesh)
+                    {
+                        ++empty;
+                        continue;
+                    }
+
+                    const auto offMeshConnections = data.mOffMeshConnectionsManager.get(tile);
+
+                    if (diskCache.get(agentHalfExtents, tile, *recastMesh, offMeshConnections).mValue)
+                    {
+                        ++cached;
+                        continue;
+                    }
+
+                    const auto navMeshData = DetourNavigator::makeNavMeshTileData(agentHalfExtents, *recastMesh,
+                        offMeshConnections, tile, settings, nullptr);
+
+                    if (!navMeshData.mValue)
+                    {
+                        ++empty;
+                        continue;
+                    }
+
+                    diskCache.set(agentHalfExtents, tile, *recastMesh, offMeshConnections, navMeshData);
+                    ++generated;
+                }
+            }
+            catch (...)
+            {
+                const std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+                failed = true;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (std::size_t i = 1; i < std::max(threadsNumber, std::size_t(1)); ++i)
+            threads.emplace_back(process);
+        process();
+        for (auto& thread : threads)
+            thread.join();
+
+        if (error)
+            std::rethrow_exception(error);
+
+        NavMeshTilesStats result;
+        result.mGenerated = generated;
+        result.mCached = cached;
+        result.mEmpty = empty;
+
+        Log(Debug::Verbose) << "Worldspace \"" << data.mName << "\": " << tiles.size() << " tiles, "
+                            << result.mGenerated << " generated, " << result.mCached << " cached, "
+                            << result.mEmpty << " empty";
+
+        return result;
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef OPENMW_NAVMESHTOOL_NAVMESH_H
+#define OPENMW_NAVMESHTOOL_NAVMESH_H
+
+#include <osg/Vec3f>
+
+#include <cstddef>
+
+namespace DetourNavigator
+{
+    class NavMeshDiskCache;
+    struct Settings;
+}
+
+namespace NavMeshTool
+{
+    struct WorldspaceData;
+
+    struct NavMeshTilesStats
+    {
+        std::size_t mGenerated = 0;
+        std::size_t mCached = 0;
+        std::size_t mEmpty = 0;
+    };
+
+    /// Generates all tiles of given worldspace using \a threadsNumber threads and stores them into \a diskCache.
+    /// Tiles already present in \a diskCache are not generated again.
+    NavMeshTilesStats generateAllNavMeshTiles(const osg::Vec3f& agentHalfExtents,
+        const DetourNavigator::Settings& settings, std::size_t threadsNumber, WorldspaceData& data,
+        const DetourNavigator::NavMeshDiskCache& diskCache);
+}
+
+#endif
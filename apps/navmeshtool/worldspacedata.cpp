@@ -0,0 +1,567 @@
+#include "worldspacedata.hpp"
+
+#include <components/debug/debuglog.hpp>
+#include <components/detournavigator/settingsutils.hpp>
+#include <components/esm/esmreader.hpp>
+#include <components/misc/convert.hpp>
+#include <components/misc/coordinateconverter.hpp>
+#include <components/misc/stringops.hpp>
+#include <components/resource/bulletshape.hpp>
+#include <components/resource/bulletshapemanager.hpp>
+
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcher.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObject.h>
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
+#include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+
+#include <osg/Quat>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+namespace NavMeshTool
+{
+    namespace
+    {
+        /// Same order as MWWorld::CellStore::forEach visits objects having collision.
+        enum class ObjectType
+        {
+            Activator,
+            Container,
+            Door,
+            Light,
+            Static,
+        };
+
+        struct CellObject
+        {
+            ESM::CellRef mRef;
+            bool mDeleted;
+            ObjectType mType;
+            std::string mModel;
+            bool mTeleport;
+        };
+
+        struct LoadedObject
+        {
+            const CollisionObject* mObject;
+            btTransform mClosedDoorTransform;
+            bool mIsDoor;
+        };
+
+        class ClosestNotMeRayResultCallback : public btCollisionWorld::ClosestRayResultCallback
+        {
+        public:
+            ClosestNotMeRayResultCallback(const btCollisionObject* me, const btVector3& from, const btVector3& to)
+                : btCollisionWorld::ClosestRayResultCallback(from, to)
+                , mMe(me)
+            {}
+
+            btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult, bool normalInWorldSpace) override
+            {
+                if (rayResult.m_collisionObject == mMe)
+                    return 1;
+                return btCollisionWorld::ClosestRayResultCallback::addSingleResult(rayResult, normalInWorldSpace);
+            }
+
+        private:
+            const btCollisionObject* mMe;
+        };
+
+        class CollisionWorld
+        {
+        public:
+            CollisionWorld()
+                : mDispatcher(&mConfiguration)
+                , mWorld(&mDispatcher, &mBroadphase, &mConfiguration)
+            {}
+
+            ~CollisionWorld()
+            {
+                for (int i = mWorld.getNumCollisionObjects() - 1; i >= 0; --i)
+                    mWorld.removeCollisionObject(mWorld.getCollisionObjectArray()[i]);
+            }
+
+            void add(btCollisionObject& object)
+            {
+                mWorld.addCollisionObject(&object);
+            }
+
+            osg::Vec3f castRay(const osg::Vec3f& from, const osg::Vec3f& to, const btCollisionObject& ignore,
+                boost::optional<float> waterLevel)
+            {
+                const auto btFrom = Misc::Convert::toBullet(from);
+                const auto btTo = Misc::Convert::toBullet(to);
+                ClosestNotMeRayResultCallback callback(&ignore, btFrom, btTo);
+                mWorld.rayTest(btFrom, btTo, callback);
+                auto result = callback.hasHit() ? Misc::Convert::makeOsgVec3f(callback.m_hitPointWorld) : from;
+                if (waterLevel && from.z() >= *waterLevel && *waterLevel >= to.z()
+                        && (!callback.hasHit() || *waterLevel > result.z()))
+                    result = osg::Vec3f(from.x(), from.y(), *waterLevel);
+                return result;
+            }
+
+        private:
+            btDefaultCollisionConfiguration mConfiguration;
+            btCollisionDispatcher mDispatcher;
+            btDbvtBroadphase mBroadphase;
+            btCollisionWorld mWorld;
+        };
+
+        osg::Quat makeObjectOsgQuat(const ESM::Position& position)
+        {
+            const float xr = position.rot[0];
+            const float yr = position.rot[1];
+            const float zr = position.rot[2];
+
+            return osg::Quat(zr, osg::Vec3(0, 0, -1))
+                * osg::Quat(yr, osg::Vec3(0, -1, 0))
+                * osg::Quat(xr, osg::Vec3(-1, 0, 0));
+        }
+
+        bool isMarker(const std::string& id)
+        {
+            return id == "prisonmarker" || id == "divinemarker" || id == "templemarker" || id == "northmarker";
+        }
+
+        template <class T>
+        const T* searchRecord(const MWWorld::Store<T>& store, const std::string& id)
+        {
+            return store.search(id);
+        }
+
+        bool getObjectInfo(const EsmData& esmData, const std::string& id, ObjectType& type, std::string& model)
+        {
+            if (const auto record = searchRecord(esmData.mActivators, id))
+            {
+                type = ObjectType::Activator;
+                model = record->mModel;
+            }
+            else if (const auto record = searchRecord(esmData.mContainers, id))
+            {
+                type = ObjectType::Container;
+                model = record->mModel;
+            }
+            else if (const auto record = searchRecord(esmData.mDoors, id))
+            {
+                type = ObjectType::Door;
+                model = record->mModel;
+            }
+            else if (const auto record = searchRecord(esmData.mLights, id))
+            {
+                if (record->mData.mFlags & ESM::Light::Carry)
+                    return false;
+                type = ObjectType::Light;
+                model = record->mModel;
+            }
+            else if (const auto record = searchRecord(esmData.mStatics, id))
+            {
+                type = ObjectType::Static;
+                model = record->mModel;
+            }
+            else
+                return false;
+
+            if (model.empty() || isMarker(id))
+                return false;
+
+            model = "meshes\\" + model;
+            return true;
+        }
+
+        /// Reproduces references order of MWWorld::CellStore lists filtered to objects with collision.
+        std::vector<CellObject> readCellObjects(const EsmData& esmData, const ESM::Cell& cell,
+            std::vector<ESM::ESMReader>& readers)
+        {
+            std::vector<CellObject> objects;
+            std::map<ESM::RefNum, std::size_t> byRefNum;
+
+            const auto addRef = [&] (ESM::CellRef& ref, bool deleted)
+            {
+                Misc::StringUtils::lowerCaseInPlace(ref.mRefID);
+
+                CellObject object {ref, deleted, ObjectType::Static, std::string(), ref.mTeleport};
+                const bool hasCollision = getObjectInfo(esmData, ref.mRefID, object.mType, object.mModel);
+
+                const auto it = byRefNum.find(ref.mRefNum);
+                if (it != byRefNum.end())
+                {
+                    auto& existing = objects[it->second];
+                    if (hasCollision && existing.mType == object.mType)
+                    {
+                        existing = std::move(object);
+                        return;
+                    }
+                    existing.mDeleted = true;
+                    byRefNum.erase(it);
+                }
+
+                if (!hasCollision)
+                    return;
+
+                byRefNum.emplace(ref.mRefNum, objects.size());
+                objects.push_back(std::move(object));
+            };
+
+            for (std::size_t i = 0; i < cell.mContextList.size(); ++i)
+            {
+                try
+                {
+                    const int index = cell.mContextList[i].index;
+                    cell.restore(readers[index], static_cast<int>(i));
+
+                    ESM::CellRef ref;
+                    ref.mRefNum.mContentFile = ESM::RefNum::RefNum_NoContentFile;
+                    bool deleted = false;
+                    while (ESM::Cell::getNextRef(readers[index], ref, deleted))
+                    {
+                        if (std::find(cell.mMovedRefs.begin(), cell.mMovedRefs.end(), ref.mRefNum) != cell.mMovedRefs.end())
+                            continue;
+                        addRef(ref, deleted);
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    Log(Debug::Error) << "An error occurred loading references for cell " << cell.getDescription()
+                                      << ": " << e.what();
+                }
+            }
+
+            for (const auto& leased : cell.mLeasedRefs)
+            {
+                auto ref = leased.first;
+                addRef(ref, leased.second);
+            }
+
+            objects.erase(std::remove_if(objects.begin(), objects.end(),
+                [] (const CellObject& v) { return v.mDeleted; }), objects.end());
+
+            std::stable_sort(objects.begin(), objects.end(),
+                [] (const CellObject& l, const CellObject& r) { return l.mType < r.mType; });
+
+            return objects;
+        }
+
+        std::unique_ptr<CollisionObject> makeHeightfield(const EsmData& esmData, const ESM::Cell& cell)
+        {
+            const float verts = ESM::Land::LAND_SIZE;
+            const float worldsize = ESM::Land::REAL_SIZE;
+            const float triSize = worldsize / (verts - 1);
+
+            std::unique_ptr<CollisionObject> result(new CollisionObject);
+
+            float minHeight = ESM::Land::DEFAULT_HEIGHT;
+            float maxHeight = ESM::Land::DEFAULT_HEIGHT;
+
+            ESM::Land::LandData landData;
+            const auto land = esmData.mLands.search(cell.getGridX(), cell.getGridY());
+            if (land != nullptr && (land->mDataTypes & ESM::Land::DATA_VHGT))
+            {
+                land->loadData(ESM::Land::DATA_VHGT, &landData);
+                result->mHeights.assign(landData.mHeights, landData.mHeights + ESM::Land::LAND_NUM_VERTS);
+                minHeight = landData.mMinHeight;
+                maxHeight = landData.mMaxHeight;
+            }
+            else
+                result->mHeights.assign(ESM::Land::LAND_NUM_VERTS, ESM::Land::DEFAULT_HEIGHT);
+
+            result->mHeightfieldShape.reset(new btHeightfieldTerrainShape(
+                static_cast<int>(verts), static_cast<int>(verts),
+                result->mHeights.data(),
+                1,
+                minHeight, maxHeight, 2,
+                PHY_FLOAT, false
+            ));
+            result->mHeightfieldShape->setUseDiamondSubdivision(true);
+            result->mHeightfieldShape->setLocalScaling(btVector3(triSize, triSize, 1));
+
+            const btTransform transform(btQuaternion::getIdentity(),
+                btVector3((cell.getGridX() + 0.5f) * triSize * (verts - 1),
+                          (cell.getGridY() + 0.5f) * triSize * (verts - 1),
+                          (maxHeight + minHeight) * 0.5f));
+
+            result->mObject.reset(new btCollisionObject);
+            result->mObject->setCollisionShape(result->mHeightfieldShape.get());
+            result->mObject->setWorldTransform(transform);
+
+            return result;
+        }
+
+        std::unique_ptr<CollisionObject> makeObject(Resource::BulletShapeManager& bulletShapeManager,
+            const CellObject& cellObject, btTransform& closedDoorTransform)
+        {
+            osg::ref_ptr<Resource::BulletShapeInstance> shapeInstance;
+            try
+            {
+                shapeInstance = bulletShapeManager.getInstance(cellObject.mModel);
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Warning) << "Failed to load collision shape " << cellObject.mModel << ": " << e.what();
+                return nullptr;
+            }
+
+            if (!shapeInstance || !shapeInstance->getCollisionShape())
+                return nullptr;
+
+            const auto& position = cellObject.mRef.mPos;
+            shapeInstance->setLocalScaling(btVector3(cellObject.mRef.mScale, cellObject.mRef.mScale,
+                                                     cellObject.mRef.mScale));
+
+            std::unique_ptr<CollisionObject> result(new CollisionObject);
+            result->mShapeInstance = shapeInstance;
+            result->mObject.reset(new btCollisionObject);
+            result->mObject->setCollisionShape(shapeInstance->getCollisionShape());
+            result->mObject->setWorldTransform(btTransform(
+                Misc::Convert::toBullet(makeObjectOsgQuat(position)),
+                btVector3(position.pos[0], position.pos[1], position.pos[2])));
+
+            closedDoorTransform = result->mObject->getWorldTransform();
+
+            return result;
+        }
+
+        void addObject(WorldspaceData& worldspace, const LoadedObject& loaded, CollisionWorld& collisionWorld,
+            const WorldspaceBuilderSettings& settings, boost::optional<float> waterLevel)
+        {
+            using namespace DetourNavigator;
+
+            const auto& navigatorSettings = settings.mNavigatorSettings;
+            const auto& object = *loaded.mObject;
+            const auto& shape = *object.mShapeInstance->getCollisionShape();
+            const auto avoid = object.mShapeInstance->getAvoidCollisionShape();
+            const auto& transform = object.mObject->getWorldTransform();
+            const ObjectId id(&object);
+
+            bool added = worldspace.mRecastMeshManager.addObject(id, shape, transform, AreaType_ground);
+            if (avoid)
+                added = worldspace.mRecastMeshManager.addObject(ObjectId(avoid), *avoid, transform, AreaType_null)
+                    || added;
+
+            if (!added || !loaded.mIsDoor)
+                return;
+
+            btVector3 aabbMin;
+            btVector3 aabbMax;
+            shape.getAabb(btTransform::getIdentity(), aabbMin, aabbMax);
+
+            const auto center = (aabbMax + aabbMin) * 0.5f;
+
+            const auto distanceFromDoor = settings.mMaxActivationDistance * 0.5f;
+            const auto toPoint = aabbMax.x() - aabbMin.x() < aabbMax.y() - aabbMin.y()
+                    ? btVector3(distanceFromDoor, 0, 0)
+                    : btVector3(0, distanceFromDoor, 0);
+
+            const auto start = Misc::Convert::makeOsgVec3f(loaded.mClosedDoorTransform(center + toPoint));
+            const auto connectionStart = collisionWorld.castRay(start, start - osg::Vec3f(0, 0, 1000),
+                *object.mObject, waterLevel);
+
+            const auto end = Misc::Convert::makeOsgVec3f(loaded.mClosedDoorTransform(center - toPoint));
+            const auto connectionEnd = collisionWorld.castRay(end, end - osg::Vec3f(0, 0, 1000),
+                *object.mObject, waterLevel);
+
+            worldspace.mOffMeshConnectionsManager.add(id, OffMeshConnection {
+                toNavMeshCoordinates(navigatorSettings, connectionStart),
+                toNavMeshCoordinates(navigatorSettings, connectionEnd),
+                AreaType_door
+            });
+        }
+
+        void addPathgrid(WorldspaceData& worldspace, const ESM::Cell& cell, const ESM::Pathgrid& pathgrid,
+            const DetourNavigator::Settings& settings)
+        {
+            using namespace DetourNavigator;
+
+            worldspace.mPathgrids.emplace_back(new ESM::Pathgrid(pathgrid));
+            const auto& stored = *worldspace.mPathgrids.back();
+
+            Misc::CoordinateConverter converter(&cell);
+            for (const auto& edge : stored.mEdges)
+            {
+                const auto src = Misc::Convert::makeOsgVec3f(converter.toWorldPoint(stored.mPoints[edge.mV0]));
+                const auto dst = Misc::Convert::makeOsgVec3f(converter.toWorldPoint(stored.mPoints[edge.mV1]));
+                worldspace.mOffMeshConnectionsManager.add(ObjectId(&stored), OffMeshConnection {
+                    toNavMeshCoordinates(settings, src),
+                    toNavMeshCoordinates(settings, dst),
+                    AreaType_pathgrid
+                });
+            }
+        }
+
+        void addWater(WorldspaceData& worldspace, const osg::Vec2i& cellPosition, int cellSize, float level,
+            const btTransform& transform)
+        {
+            worldspace.mRecastMeshManager.addWater(cellPosition, cellSize,
+                btTransform(transform.getBasis(), btVector3(transform.getOrigin().x(), transform.getOrigin().y(), level)));
+        }
+
+        /// Fills worldspace the same way MWWorld::Scene does on loading given cells in given order.
+        void fillWorldspace(WorldspaceData& worldspace, const std::vector<const ESM::Cell*>& cells,
+            const EsmData& esmData, std::vector<ESM::ESMReader>& readers,
+            Resource::BulletShapeManager& bulletShapeManager, const WorldspaceBuilderSettings& settings)
+        {
+            CollisionWorld collisionWorld;
+            std::vector<const CollisionObject*> heightfields;
+            std::vector<std::vector<LoadedObject>> cellsObjects;
+
+            heightfields.reserve(cells.size());
+            cellsObjects.reserve(cells.size());
+
+            for (const auto cell : cells)
+            {
+                if (cell->isExterior())
+                {
+                    worldspace.mObjects.push_back(makeHeightfield(esmData, *cell));
+                    collisionWorld.add(*worldspace.mObjects.back()->mObject);
+                    heightfields.push_back(worldspace.mObjects.back().get());
+                }
+                else
+                    heightfields.push_back(nullptr);
+
+                cellsObjects.emplace_back();
+
+                for (const auto& cellObject : readCellObjects(esmData, *cell, readers))
+                {
+                    btTransform closedDoorTransform;
+                    auto object = makeObject(bulletShapeManager, cellObject, closedDoorTransform);
+                    if (!object)
+                        continue;
+                    collisionWorld.add(*object->mObject);
+                    worldspace.mObjects.push_back(std::move(object));
+                    cellsObjects.back().push_back(LoadedObject {worldspace.mObjects.back().get(), closedDoorTransform,
+                        cellObject.mType == ObjectType::Door && !cellObject.mTeleport});
+                }
+            }
+
+            for (std::size_t i = 0; i < cells.size(); ++i)
+            {
+                const auto& cell = *cells[i];
+                const osg::Vec2i cellPosition(cell.getGridX(), cell.getGridY());
+                const bool waterEnabled = cell.hasWater();
+                const auto waterLevel = waterEnabled ? boost::optional<float>(cell.mWater) : boost::optional<float>();
+
+                if (heightfields[i])
+                    worldspace.mRecastMeshManager.addObject(DetourNavigator::ObjectId(heightfields[i]),
+                        *heightfields[i]->mHeightfieldShape, heightfields[i]->mObject->getWorldTransform(),
+                        DetourNavigator::AreaType_ground);
+
+                if (const auto pathgrid = esmData.mPathgrids.search(cell))
+                    addPathgrid(worldspace, cell, *pathgrid, settings.mNavigatorSettings);
+
+                for (const auto& object : cellsObjects[i])
+                    addObject(worldspace, object, collisionWorld, settings, waterLevel);
+
+                if (!waterEnabled)
+                    continue;
+
+                if (cell.isExterior())
+                    addWater(worldspace, cellPosition, ESM::Land::REAL_SIZE, cell.mWater,
+                        heightfields[i]->mObject->getWorldTransform());
+                else
+                    addWater(worldspace, cellPosition, std::numeric_limits<int>::max(), cell.mWater,
+                        btTransform::getIdentity());
+            }
+        }
+    }
+
+    void loadEsmData(std::vector<ESM::ESMReader>& readers, EsmData& esmData)
+    {
+        esmData.mPathgrids.setCells(esmData.mCells);
+
+        for (auto& esm : readers)
+        {
+            const auto& masters = esm.getGameFiles();
+            for (const auto& master : masters)
+            {
+                int index = ~0;
+                for (int i = 0; i < esm.getIndex(); ++i)
+                {
+                    const auto candidate = boost::filesystem::path(readers[i].getContext().filename).filename().string();
+                    if (Misc::StringUtils::ciEqual(master.name, candidate))
+                    {
+                        index = i;
+                        break;
+                    }
+                }
+                if (index == static_cast<int>(~0))
+                    esm.fail("File " + esm.getName() + " asks for parent file " + master.name
+                        + ", but it has not been loaded yet. Please check your load order.");
+                esm.addParentFileIndex(index);
+            }
+
+            while (esm.hasMoreRecs())
+            {
+                const ESM::NAME name = esm.getRecName();
+                esm.getRecHeader();
+
+                switch (name.intval)
+                {
+                    case ESM::REC_GMST: esmData.mGameSettings.load(esm); break;
+                    case ESM::REC_CELL: esmData.mCells.load(esm); break;
+                    case ESM::REC_LAND: esmData.mLands.load(esm); break;
+                    case ESM::REC_PGRD: esmData.mPathgrids.load(esm); break;
+                    case ESM::REC_ACTI: esmData.mActivators.load(esm); break;
+                    case ESM::REC_CONT: esmData.mContainers.load(esm); break;
+                    case ESM::REC_DOOR: esmData.mDoors.load(esm); break;
+                    case ESM::REC_LIGH: esmData.mLights.load(esm); break;
+                    case ESM::REC_STAT: esmData.mStatics.load(esm); break;
+                    default: esm.skipRecord(); break;
+                }
+            }
+        }
+
+        esmData.mGameSettings.setUp();
+        esmData.mCells.setUp();
+        esmData.mLands.setUp();
+        esmData.mPathgrids.setUp();
+        esmData.mActivators.setUp();
+        esmData.mContainers.setUp();
+        esmData.mDoors.setUp();
+        esmData.mLights.setUp();
+        esmData.mStatics.setUp();
+    }
+
+    CollisionObject::CollisionObject() = default;
+
+    CollisionObject::CollisionObject(CollisionObject&&) = default;
+
+    CollisionObject::~CollisionObject() = default;
+
+    WorldspaceData::WorldspaceData(const std::string& name, const DetourNavigator::Settings& settings)
+        : mName(name)
+        , mRecastMeshManager(settings)
+        , mOffMeshConnectionsManager(settings)
+    {
+    }
+
+    void forEachWorldspace(const EsmData& esmData, std::vector<ESM::ESMReader>& readers,
+        Resource::BulletShapeManager& bulletShapeManager, const WorldspaceBuilderSettings& settings,
+        const std::function<void (WorldspaceData&)>& function)
+    {
+        {
+            std::vector<const ESM::Cell*> cells;
+            for (auto it = esmData.mCells.extBegin(); it != esmData.mCells.extEnd(); ++it)
+                cells.push_back(&*it);
+
+            Log(Debug::Info) << "Processing exterior with " << cells.size() << " cells...";
+
+            WorldspaceData worldspace("sys::default", settings.mNavigatorSettings);
+            fillWorldspace(worldspace, cells, esmData, readers, bulletShapeManager, settings);
+            function(worldspace);
+        }
+
+        for (auto it = esmData.mCells.intBegin(); it != esmData.mCells.intEnd(); ++it)
+        {
+            WorldspaceData worldspace(it->mName, settings.mNavigatorSettings);
+            fillWorldspace(worldspace, {&*it}, esmData, readers, bulletShapeManager, settings);
+            function(worldspace);
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef OPENMW_NAVMESHTOOL_WORLDSPACEDATA_H
+#define OPENMW_NAVMESHTOOL_WORLDSPACEDATA_H
+
+#include "../openmw/mwworld/store.hpp"
+
+#include <components/detournavigator/offmeshconnectionsmanager.hpp>
+#include <components/detournavigator/tilecachedrecastmeshmanager.hpp>
+#include <components/esm/loadacti.hpp>
+#include <components/esm/loadcell.hpp>
+#include <components/esm/loadcont.hpp>
+#include <components/esm/loaddoor.hpp>
+#include <components/esm/loadgmst.hpp>
+#include <components/esm/loadland.hpp>
+#include <components/esm/loadligh.hpp>
+#include <components/esm/loadpgrd.hpp>
+#include <components/esm/loadstat.hpp>
+
+#include <osg/ref_ptr>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class btCollisionObject;
+class btCollisionShape;
+class btHeightfieldTerrainShape;
+
+namespace ESM
+{
+    class ESMReader;
+}
+
+namespace Resource
+{
+    class BulletShapeInstance;
+    class BulletShapeManager;
+}
+
+namespace NavMeshTool
+{
+    /// Subset of ESMStore required to reproduce navigator input.
+    struct EsmData
+    {
+        MWWorld::Store<ESM::GameSetting> mGameSettings;
+        MWWorld::Store<ESM::Cell> mCells;
+        MWWorld::Store<ESM::Land> mLands;
+        MWWorld::Store<ESM::Pathgrid> mPathgrids;
+        MWWorld::Store<ESM::Activator> mActivators;
+        MWWorld::Store<ESM::Container> mContainers;
+        MWWorld::Store<ESM::Door> mDoors;
+        MWWorld::Store<ESM::Light> mLights;
+        MWWorld::Store<ESM::Static> mStatics;
+    };
+
+    void loadEsmData(std::vector<ESM::ESMReader>& readers, EsmData& esmData);
+
+    struct CollisionObject
+    {
+        osg::ref_ptr<Resource::BulletShapeInstance> mShapeInstance;
+        std::unique_ptr<btHeightfieldTerrainShape> mHeightfieldShape;
+        std::vector<float> mHeights;
+        std::unique_ptr<btCollisionObject> mObject;
+
+        CollisionObject();
+        CollisionObject(CollisionObject&&);
+        ~CollisionObject();
+    };
+
+    /// Navigator input for single worldspace. Exterior cells share one worldspace, each interior cell has its own.
+    struct WorldspaceData
+    {
+        std::string mName;
+        std::vector<std::unique_ptr<CollisionObject>> mObjects;
+        std::vector<std::unique_ptr<ESM::Pathgrid>> mPathgrids;
+        DetourNavigator::TileCachedRecastMeshManager mRecastMeshManager;
+        DetourNavigator::OffMeshConnectionsManager mOffMeshConnectionsManager;
+
+        WorldspaceData(const std::string& name, const DetourNavigator::Settings& settings);
+    };
+
+    struct WorldspaceBuilderSettings
+    {
+        const DetourNavigator::Settings& mNavigatorSettings;
+        float mMaxActivationDistance;
+    };
+
+    /// Calls \a function for each worldspace with fully filled navigator input. Only one worldspace exists at a time.
+    void forEachWorldspace(const EsmData& esmData, std::vector<ESM::ESMReader>& readers,
+        Resource::BulletShapeManager& bulletShapeManager, const WorldspaceBuilderSettings& settings,
+        const std::function<void (WorldspaceData&)>& function);
+}
+
+#endif
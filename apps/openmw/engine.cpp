@@ -1,6 +1,8 @@
 #include "engine.hpp"
 
 #include <iomanip>
+#include <memory>
+#include <stdexcept>
 #include <fstream>
 #include <chrono>
 #include <thread>
@@ -15,6 +17,7 @@
 
 #include <components/debug/debuglog.hpp>
 #include <components/debug/gldebug.hpp>
+#include <components/debug/trace.hpp>
 
 #include <components/misc/rng.hpp>
 
@@ -47,6 +50,7 @@
 
 #include "mwsound/soundmanagerimp.hpp"
 
+#include "mwworld/benchmarkpath.hpp"
 #include "mwworld/class.hpp"
 #include "mwworld/player.hpp"
 #include "mwworld/worldimp.hpp"
@@ -164,7 +168,8 @@ namespace
                   mFrameStart(frameStart),
                   mFrameNumber(frameNumber),
                   mTimer(timer),
-                  mStats(stats)
+                  mStats(stats),
+                  mTraceZone(UserStatsValue<sType>::sValue.mLabel.c_str())
             {
             }
 
@@ -187,8 +192,103 @@ namespace
             const unsigned int mFrameNumber;
             const osg::Timer& mTimer;
             osg::Stats& mStats;
+            const Debug::TraceZone mTraceZone;
     };
 
+    /// Moves the player along the benchmark path and writes a line of timings per frame.
+    class Benchmark
+    {
+        public:
+            /// Fixed time step to simulate the same frames on every run
+            static constexpr double sTimeStep = 1.0 / 60.0;
+
+            Benchmark(MWWorld::BenchmarkPath&& path, const std::string& outputPath)
+                : mPath(std::move(path)),
+                  mOutput(outputPath),
+                  mTime(-1),
+                  mUpdateTime(0),
+                  mFrames(0),
+                  mTotalFrameTime(0),
+                  mMaxFrameTime(0)
+            {
+                if (mPath.empty())
+                    throw std::runtime_error("Benchmark path has no waypoints");
+                if (!mOutput)
+                    throw std::runtime_error("Failed to open benchmark output file: " + outputPath);
+
+                mOutput << "frame,path_time,frame_time,benchmark_time_taken";
+                forEachUserStatsValue([&] (const UserStats& v) { mOutput << ',' << v.mTaken; });
+                mOutput << ",rendering_time_taken\n";
+            }
+
+            bool isStarted() const { return mTime >= 0; }
+
+            bool isDone() const { return mTime > mPath.getDuration(); }
+
+            /// Move the player to the position of the path at the time of the next frame. Changes to another cell
+            /// are done immediately, so the time taken includes loading the cell.
+            void update(double dt)
+            {
+                const osg::Timer_t start = osg::Timer::instance()->tick();
+                const bool first = !isStarted();
+                mTime = first ? 0.0 : mTime + dt;
+
+                const MWWorld::BenchmarkWaypoint waypoint = mPath.getWaypoint(mTime);
+                const ESM::Position& position = waypoint.mPosition;
+                MWBase::World* world = MWBase::Environment::get().getWorld();
+                if (first || waypoint.mCell != mCell)
+                {
+                    if (waypoint.mCell.empty())
+                        world->changeToExteriorCell(position, false);
+                    else
+                        world->changeToInteriorCell(waypoint.mCell, position, false);
+                    mCell = waypoint.mCell;
+                }
+                else
+                {
+                    const MWWorld::Ptr player = world->moveObject(world->getPlayerPtr(), position.pos[0], position.pos[1], position.pos[2]);
+                    world->rotateObject(player, position.rot[0], position.rot[1], position.rot[2]);
+                }
+
+                mUpdateTime = osg::Timer::instance()->delta_s(start, osg::Timer::instance()->tick());
+            }
+
+            void writeFrame(unsigned int frameNumber, double frameTime, double renderingTime, osg::Stats& stats)
+            {
+                mOutput << frameNumber << ',' << mTime << ',' << frameTime << ',' << mUpdateTime;
+                forEachUserStatsValue([&] (const UserStats& v)
+                {
+                    double value = 0;
+                    stats.getAttribute(frameNumber, v.mTaken, value);
+                    mOutput << ',' << value;
+                });
+                mOutput << ',' << renderingTime << '\n';
+
+                ++mFrames;
+                mTotalFrameTime += frameTime;
+                mMaxFrameTime = std::max(mMaxFrameTime, frameTime);
+            }
+
+            ~Benchmark()
+            {
+                if (mFrames > 0)
+                    Log(Debug::Info) << "Benchmark: " << mFrames << " frames, average frame time "
+                                     << mTotalFrameTime / mFrames * 1000 << " ms, maximum " << mMaxFrameTime * 1000 << " ms";
+            }
+
+        private:
+            const MWWorld::BenchmarkPath mPath;
+            std::ofstream mOutput;
+            std::string mCell;
+            double mTime;
+            double mUpdateTime;
+            std::size_t mFrames;
+            double mTotalFrameTime;
+            double mMaxFrameTime;
+    };
+
+    constexpr double Benchmark::sTimeStep;
+
     void initStatsHandler(Resource::Profiler& profiler)
     {
         const osg::Vec4f textColor(1.f, 1.f, 1.f, 1.f);
@@ -376,6 +476,7 @@ OMW::Engine::Engine(Files::ConfigurationManager& configurationManager)
   , mFSStrict (false)
   , mScriptBlacklistUse (true)
   , mNewGame (false)
+  , mRendering (true)
   , mCfgMgr(configurationManager)
 {
     MWClass::registerClasses();
@@ -400,6 +501,8 @@ OMW::Engine::~Engine()
     delete mScriptContext;
     mScriptContext = nullptr;
 
+    if (mResourceSystem)
+        mResourceSystem->getSceneManager()->setWorkQueue(nullptr);
     mWorkQueue = nullptr;
 
     mViewer = nullptr;
@@ -647,11 +750,13 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
         Settings::Manager::getString("texture mipmap", "General"),
         Settings::Manager::getInt("anisotropy", "General")
     );
+    mResourceSystem->getSceneManager()->setSceneFileCachePath(Settings::Manager::getString("mesh cache path", "General"));
 
     int numThreads = Settings::Manager::getInt("preload num threads", "Cells");
     if (numThreads <= 0)
         throw std::runtime_error("Invalid setting: 'preload num threads' must be >0");
     mWorkQueue = new SceneUtil::WorkQueue(numThreads);
+    mResourceSystem->getSceneManager()->setWorkQueue(mWorkQueue.get());
 
     // Create input and UI first to set up a bootstrapping environment for
     // showing a loading screen and keeping the window responsive while doing so
@@ -896,17 +1001,54 @@ void OMW::Engine::go()
             Log(Debug::Warning) << "Failed to open file for stats: " << path;
     }
 
+    // tracing may also be toggled from the console
+    Debug::Tracer::setThreadName("Main");
+
+    std::string traceFile;
+    if (const auto path = std::getenv("OPENMW_TRACE_FILE"))
+    {
+        traceFile = path;
+        Debug::Tracer::setEnabled(true);
+    }
+
+    std::unique_ptr<Benchmark> benchmark;
+    if (!mBenchmarkPath.empty())
+    {
+        boost::filesystem::ifstream pathStream(mBenchmarkPath);
+        if (!pathStream)
+            throw std::runtime_error("Failed to open benchmark path file: " + mBenchmarkPath);
+        benchmark.reset(new Benchmark(MWWorld::BenchmarkPath::read(pathStream), mBenchmarkOutput));
+        Log(Debug::Info) << "Benchmark path is loaded from " << mBenchmarkPath;
+    }
+
     // Start the main rendering loop
     osg::Timer frameTimer;
     double simulationTime = 0.0;
     while (!mViewer->done() && !mEnvironment.getStateManager()->hasQuitRequest())
     {
+        Debug::TraceZone frameZone("Frame");
+
         double dt = frameTimer.time_s();
         frameTimer.setStartTick();
         dt = std::min(dt, 0.2);
 
+        const bool benchmarking = benchmark && mEnvironment.getStateManager()->getState() == MWBase::StateManager::State_Running;
+        if (benchmarking)
+        {
+            if (benchmark->isDone())
+            {
+                mEnvironment.getStateManager()->requestQuit();
+                continue;
+            }
+            if (!benchmark->isStarted())
+                Log(Debug::Info) << "Benchmark is started after " << osg::Timer::instance()->time_s() << " s";
+            dt = Benchmark::sTimeStep;
+            benchmark->update(dt);
+        }
+
         mViewer->advance(simulationTime);
 
+        double renderingTime = 0.0;
         if (!frame(dt))
         {
             std::this_thread::sleep_for(std::chrono::milliseconds(5));
@@ -919,13 +1061,23 @@ void OMW::Engine::go()
 
             mEnvironment.getWorld()->updateWindowManager();
 
-            mViewer->renderingTraversals();
+            if (mRendering)
+            {
+                const osg::Timer_t renderingStart = frameTimer.tick();
+                Debug::TraceZone zone("Rendering");
+                mViewer->renderingTraversals();
+                renderingTime = frameTimer.delta_s(renderingStart, frameTimer.tick());
+            }
 
             bool guiActive = mEnvironment.getWindowManager()->isGuiMode();
             if (!guiActive)
                 simulationTime += dt;
         }
 
+        if (benchmarking)
+            benchmark->writeFrame(mViewer->getFrameStamp()->getFrameNumber(), frameTimer.time_s(), renderingTime,
+                                  *mViewer->getViewerStats());
+
         if (stats)
         {
             const auto frameNumber = mViewer->getFrameStamp()->getFrameNumber();
@@ -939,7 +1091,18 @@ void OMW::Engine::go()
             }
         }
 
-        mEnvironment.limitFrameRate(frameTimer.time_s());
+        if (!benchmarking)
+            mEnvironment.limitFrameRate(frameTimer.time_s());
+    }
+
+    if (!traceFile.empty())
+    {
+        Debug::Tracer::setEnabled(false);
+        std::ofstream trace(traceFile);
+        if (trace)
+            Debug::Tracer::write(trace);
+        else
+            Log(Debug::Warning) << "Failed to open file for trace: " << traceFile;
     }
 
     // Save user settings
@@ -1012,3 +1175,14 @@ void OMW::Engine::setRandomSeed(unsigned int seed)
 {
     mRandomSeed = seed;
 }
+
+void OMW::Engine::setBenchmark(const std::string& path, const std::string& output)
+{
+    mBenchmarkPath = path;
+    mBenchmarkOutput = output;
+}
+
+void OMW::Engine::setRendering(bool rendering)
+{
+    mRendering = rendering;
+}
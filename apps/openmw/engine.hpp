@@ -110,6 +110,9 @@ namespace OMW
             std::vector<std::string> mScriptBlacklist;
             bool mScriptBlacklistUse;
             bool mNewGame;
+            std::string mBenchmarkPath;
+            std::string mBenchmarkOutput;
+            bool mRendering;
 
             // not implemented
             Engine (const Engine&);
@@ -201,6 +204,13 @@ namespace OMW
 
             void setRandomSeed(unsigned int seed);
 
+            /// Move the player along the path read from the given file once the game is running, and quit at its end.
+            /// Frames are simulated at a fixed time step and their timings are written to the output file.
+            void setBenchmark(const std::string& path, const std::string& output);
+
+            /// Disable to skip the rendering traversals, i.e. culling and drawing.
+            void setRendering(bool rendering);
+
         private:
             Files::ConfigurationManager& mCfgMgr;
     };
@@ -138,6 +138,16 @@ bool parseOptions (int argc, char** argv, OMW::Engine& engine, Files::Configurat
         ("random-seed", bpo::value <unsigned int> ()
             ->default_value(Misc::Rng::generateDefaultSeed()),
             "seed value for random number generator")
+
+        ("benchmark", bpo::value<Files::EscapeHashString>()->default_value(""),
+            "move the player along the path in the given file at a fixed time step, write frame timings and quit at its end\n"
+            "\tone waypoint per line: <time> <x> <y> <z> [<z rotation> [<x rotation> [<interior cell name>]]]")
+
+        ("benchmark-output", bpo::value<Files::EscapeHashString>()->default_value("benchmark.csv"),
+            "file to write the frame timings of the benchmark to")
+
+        ("no-render", bpo::value<bool>()->implicit_value(true)
+            ->default_value(false), "skip the rendering traversals, e.g. to benchmark the simulation only")
     ;
 
     bpo::parsed_options valid_opts = bpo::command_line_parser(argc, argv)
@@ -238,6 +248,9 @@ bool parseOptions (int argc, char** argv, OMW::Engine& engine, Files::Configurat
     engine.setActivationDistanceOverride (variables["activate-dist"].as<int>());
     engine.enableFontExport(variables["export-fonts"].as<bool>());
     engine.setRandomSeed(variables["random-seed"].as<unsigned int>());
+    engine.setBenchmark(variables["benchmark"].as<Files::EscapeHashString>().toStdString(),
+                        variables["benchmark-output"].as<Files::EscapeHashString>().toStdString());
+    engine.setRendering(!variables["no-render"].as<bool>());
 
     return true;
 }
@@ -38,6 +38,12 @@ namespace Loading
     class Listener;
 }
 
+namespace MWMechanics
+{
+    class AiScheduler;
+    class CrowdSteering;
+}
+
 namespace MWBase
 {
     /// \brief Interface for game mechanics manager (implemented in MWMechanics)
@@ -64,6 +70,9 @@ namespace MWBase
             virtual void updateCell(const MWWorld::Ptr &old, const MWWorld::Ptr &ptr) = 0;
             ///< Moves an object to a new cell
 
+            virtual void updatePosition(const MWWorld::Ptr& ptr) = 0;
+            ///< Notifies that an object was moved within the world
+
             virtual void drop (const MWWorld::CellStore *cellStore) = 0;
             ///< Deregister all objects in the given cell.
 
@@ -97,6 +106,9 @@ namespace MWBase
             virtual int getHoursToRest() const = 0;
             ///< Calculate how many hours the player needs to rest in order to be fully healed
 
+            virtual int getHoursToDeath(int hours, bool sleep) const = 0;
+            ///< Hour of a rest of the given length at which effects over time kill the player, 0 if the player survives
+
             virtual int getBarterOffer(const MWWorld::Ptr& ptr,int basePrice, bool buying) = 0;
             ///< This is used by every service to determine the price of objects given the trading skills of the player and NPC.
 
@@ -272,6 +284,10 @@ namespace MWBase
 
             virtual void reportStats(unsigned int frameNumber, osg::Stats& stats) const = 0;
 
+            virtual MWMechanics::AiScheduler& getAiScheduler() = 0;
+
+            virtual MWMechanics::CrowdSteering& getCrowdSteering() = 0;
+
             virtual int getGreetingTimer(const MWWorld::Ptr& ptr) const = 0;
             virtual float getAngleToPlayer(const MWWorld::Ptr& ptr) const  = 0;
             virtual MWMechanics::GreetingState getGreetingState(const MWWorld::Ptr& ptr) const = 0;
@@ -41,7 +41,7 @@ namespace MWGui
 
         mRemainingTime -= dt;
 
-        while (mRemainingTime <= 0)
+        while (mRunning && mRemainingTime <= 0)
         {
             mRemainingTime += mDelay;
             ++mCurHour;
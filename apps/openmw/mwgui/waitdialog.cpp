@@ -57,6 +57,8 @@ namespace MWGui
         , mManualHours(1)
         , mFadeTimeRemaining(0)
         , mInterruptAt(-1)
+        , mPendingHours(0)
+        , mDeathAt(0)
         , mProgressBar()
     {
         getWidget(mDateTimeText, "DateTimeText");
@@ -106,6 +108,7 @@ namespace MWGui
     void WaitDialog::clear()
     {
         mSleeping = false;
+        mPendingHours = 0;
         mTimeAdvancer.stop();
     }
 
@@ -180,6 +183,8 @@ namespace MWGui
         setVisible(false);
 
         mHours = hoursToWait;
+        mPendingHours = 0;
+        mDeathAt = MWBase::Environment::get().getMechanicsManager()->getHoursToDeath(hoursToWait, mSleeping);
 
         // FIXME: move this somewhere else?
         mInterruptAt = -1;
@@ -238,16 +243,31 @@ namespace MWGui
     void WaitDialog::onWaitingProgressChanged(int cur, int total)
     {
         mProgressBar.setProgress(cur, total);
-        MWBase::Environment::get().getMechanicsManager()->rest(1, mSleeping);
-        MWBase::Environment::get().getWorld()->advanceTime(1);
 
-        MWWorld::Ptr player = MWBase::Environment::get().getWorld()->getPlayerPtr();
-        if (player.getClass().getCreatureStats(player).isDead())
+        // Scripts may watch the time while the player is waiting, but nothing else is seen again until waiting stops,
+        // so items, actors and the scene catch up once for the whole wait.
+        MWBase::Environment::get().getWorld()->advanceTime(1, true);
+        ++mPendingHours;
+
+        // Stop at the hour effects over time kill the player, as when resting hour by hour
+        if (mPendingHours == mDeathAt)
+        {
+            fastForward();
             stopWaiting();
+        }
     }
 
     void WaitDialog::onWaitingInterrupted()
     {
+        fastForward();
+
+        MWWorld::Ptr player = MWMechanics::getPlayer();
+        if (player.getClass().getCreatureStats(player).isDead())
+        {
+            stopWaiting();
+            return;
+        }
+
         MWBase::Environment::get().getWindowManager()->messageBox("#{sSleepInterrupt}");
         MWBase::Environment::get().getWorld()->spawnRandomCreature(mInterruptCreatureList);
         stopWaiting();
@@ -255,9 +275,13 @@ namespace MWGui
 
     void WaitDialog::onWaitingFinished()
     {
+        fastForward();
         stopWaiting();
 
         MWWorld::Ptr player = MWMechanics::getPlayer();
+        if (player.getClass().getCreatureStats(player).isDead())
+            return;
+
         const MWMechanics::NpcStats &pcstats = player.getClass().getNpcStats(player);
 
         // trigger levelup if possible
@@ -318,8 +342,29 @@ namespace MWGui
     }
 
 
+    void WaitDialog::fastForward()
+    {
+        if (mPendingHours == 0)
+            return;
+
+        MWBase::World* world = MWBase::Environment::get().getWorld();
+
+        float duration = mPendingHours * 3600.f;
+        const float timeScale = world->getTimeScaleFactor();
+        if (timeScale != 0.f)
+            duration /= timeScale;
+
+        world->rechargeItems(duration, false);
+        // Apply pending weather transitions and reset the scene as after any other fast-forward
+        world->advanceTime(0);
+
+        MWBase::Environment::get().getMechanicsManager()->rest(mPendingHours, mSleeping);
+        mPendingHours = 0;
+    }
+
     void WaitDialog::wakeUp ()
     {
+        fastForward();
         mSleeping = false;
         if (mInterruptAt != -1)
             onWaitingInterrupted();
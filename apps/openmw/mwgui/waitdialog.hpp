@@ -61,6 +61,9 @@ namespace MWGui
         int mInterruptAt;
         std::string mInterruptCreatureList;
 
+        int mPendingHours; // waited hours not applied to items and actors yet
+        int mDeathAt; // waited hour at which effects over time kill the player, 0 if they don't
+
         WaitDialogProgressBar mProgressBar;
 
         void onUntilHealedButtonClicked(MyGUI::Widget* sender);
@@ -77,6 +80,9 @@ namespace MWGui
 
         void startWaiting(int hoursToWait);
         void stopWaiting();
+
+        /// Let actors rest for all hours waited so far in a single step.
+        void fastForward();
     };
 
 }
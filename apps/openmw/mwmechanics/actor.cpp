@@ -5,12 +5,14 @@
 namespace MWMechanics
 {
     Actor::Actor(const MWWorld::Ptr &ptr, MWRender::Animation *animation)
+        : mPtr(ptr)
     {
         mCharacterController.reset(new CharacterController(ptr, animation));
     }
 
     void Actor::updatePtr(const MWWorld::Ptr &newPtr)
     {
+        mPtr = newPtr;
         mCharacterController->updatePtr(newPtr);
     }
 
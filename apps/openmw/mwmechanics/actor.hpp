@@ -3,16 +3,14 @@
 
 #include <memory>
 
+#include "../mwworld/ptr.hpp"
+
 #include "../mwmechanics/actorutil.hpp"
 
 namespace MWRender
 {
     class Animation;
 }
-namespace MWWorld
-{
-    class Ptr;
-}
 
 namespace MWMechanics
 {
@@ -24,6 +22,8 @@ namespace MWMechanics
     public:
         Actor(const MWWorld::Ptr& ptr, MWRender::Animation* animation);
 
+        const MWWorld::Ptr& getPtr() const { return mPtr; }
+
         /// Notify this actor of its new base object Ptr, use when the object changed cells
         void updatePtr(const MWWorld::Ptr& newPtr);
 
@@ -42,6 +42,7 @@ namespace MWMechanics
         void setTurningToPlayer(bool turning);
 
     private:
+        MWWorld::Ptr mPtr;
         std::unique_ptr<CharacterController> mCharacterController;
         int mGreetingTimer{0};
         float mTargetAngleRadians{0.f};
@@ -1,10 +1,17 @@
 #include "actors.hpp"
 
+#include <array>
+#include <exception>
+#include <functional>
+#include <limits>
+
 #include <components/esm/esmreader.hpp>
 #include <components/esm/esmwriter.hpp>
 
 #include <components/sceneutil/positionattitudetransform.hpp>
+#include <components/sceneutil/workqueue.hpp>
 #include <components/debug/debuglog.hpp>
+#include <components/debug/trace.hpp>
 #include <components/misc/rng.hpp>
 #include <components/settings/settings.hpp>
 
@@ -41,6 +48,7 @@
 #include "combat.hpp"
 #include "actorutil.hpp"
 #include "tickableeffects.hpp"
+#include "restprojection.hpp"
 
 namespace
 {
@@ -140,6 +148,64 @@ void getRestorationPerHourOfSleep (const MWWorld::Ptr& ptr, float& health, float
     magicka = fRestMagicMult * stats.getAttribute(ESM::Attribute::Intelligence).getModified();
 }
 
+float getMaxHeadTrackDistance (const MWWorld::Ptr& actor)
+{
+    static const float fMaxHeadTrackDistance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
+            .find("fMaxHeadTrackDistance")->mValue.getFloat();
+    static const float fInteriorHeadTrackMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
+            .find("fInteriorHeadTrackMult")->mValue.getFloat();
+    float maxDistance = fMaxHeadTrackDistance;
+    const ESM::Cell* currentCell = actor.getCell()->getCell();
+    if (!currentCell->isExterior() && !(currentCell->mData.mFlags & ESM::Cell::QuasiEx))
+        maxDistance *= fInteriorHeadTrackMult;
+    return maxDistance;
+}
+
+// Roughly a third of the maximum AI processing distance, so that a neighbour search visits a few dozen grid cells
+const float actorsGridCellSize = 2048.f;
+
+// Below this number of actors per thread the synchronisation costs more than the work
+const std::size_t minActorsPerWorkItem = 16;
+
+class ActorsWorkItem : public SceneUtil::WorkItem
+{
+public:
+    typedef std::vector<MWWorld::Ptr>::const_iterator Iterator;
+
+    ActorsWorkItem(Iterator begin, Iterator end, const std::function<void (const MWWorld::Ptr&)>& function)
+        : mBegin(begin)
+        , mEnd(end)
+        , mFunction(function)
+    {
+    }
+
+    void doWork() override
+    {
+        try
+        {
+            for (Iterator it = mBegin; it != mEnd; ++it)
+                mFunction(*it);
+        }
+        catch (...)
+        {
+            mException = std::current_exception();
+        }
+    }
+
+    /// Throw the exception caught in doWork() on the calling thread, if any.
+    void rethrow() const
+    {
+        if (mException)
+            std::rethrow_exception(mException);
+    }
+
+private:
+    Iterator mBegin;
+    Iterator mEnd;
+    std::function<void (const MWWorld::Ptr&)> mFunction;
+    std::exception_ptr mException;
+};
+
 }
 
 namespace MWMechanics
@@ -177,6 +243,156 @@ namespace MWMechanics
         }
     };
 
+    class GetDynamicStatTicks : public MWMechanics::EffectSourceVisitor
+    {
+        MWWorld::Ptr mActor;
+        float mSecondsPerHour;
+        std::array<DynamicStatRest, 3>& mStats;
+
+    public:
+        std::array<float, 3> mExpiringPerHour;
+
+        GetDynamicStatTicks(const MWWorld::Ptr& actor, float secondsPerHour, std::array<DynamicStatRest, 3>& stats)
+            : mActor(actor), mSecondsPerHour(secondsPerHour), mStats(stats), mExpiringPerHour{{0.f, 0.f, 0.f}} {}
+
+        virtual void visit (MWMechanics::EffectKey key, int effectIndex,
+                            const std::string& sourceName, const std::string& sourceId, int casterActorId,
+                            float magnitude, float remainingTime = -1, float totalTime = -1)
+        {
+            if (remainingTime < 0)
+                return;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                const float perHour = getDynamicStatTick(mActor, key, i) * magnitude * mSecondsPerHour;
+                if (perHour == 0)
+                    continue;
+                mStats[i].mTicks.push_back({perHour, remainingTime / mSecondsPerHour});
+                mExpiringPerHour[i] += perHour;
+            }
+        }
+    };
+
+    bool isDynamicStatTick(const MWWorld::Ptr& actor, const EffectKey& key)
+    {
+        return getDynamicStatTick(actor, key, 0) != 0 || getDynamicStatTick(actor, key, 1) != 0
+            || getDynamicStatTick(actor, key, 2) != 0;
+    }
+
+    bool hasDynamicStatTicks(const MWWorld::Ptr& actor)
+    {
+        const MagicEffects& effects = actor.getClass().getCreatureStats(actor).getMagicEffects();
+        for (MagicEffects::Collection::const_iterator it = effects.begin(); it != effects.end(); ++it)
+        {
+            if (it->second.getMagnitude() != 0 && isDynamicStatTick(actor, it->first))
+                return true;
+        }
+        return false;
+    }
+
+    /// Game hours before a sleeping actor restores magicka, negative if it does not at all
+    double getStuntedMagickaHours(const MWWorld::Ptr& ptr)
+    {
+        CreatureStats& stats = ptr.getClass().getCreatureStats(ptr);
+        if (stats.getMagicEffects().get(ESM::MagicEffect::StuntedMagicka).getMagnitude() <= 0)
+            return 0;
+
+        GetStuntedMagickaDuration visitor(ptr);
+        stats.getActiveSpells().visitEffectSources(visitor);
+        stats.getSpells().visitEffectSources(visitor);
+        if (ptr.getClass().hasInventoryStore(ptr))
+            ptr.getClass().getInventoryStore(ptr).visitEffectSources(visitor);
+
+        // Take a maximum remaining duration of Stunted Magicka effects (-1 is a constant one) in game hours.
+        if (visitor.mRemainingTime > 0)
+        {
+            double timeScale = MWBase::Environment::get().getWorld()->getTimeScaleFactor();
+            if(timeScale == 0.0)
+                timeScale = 1;
+
+            return visitor.mRemainingTime * timeScale / 3600.f;
+        }
+        else if (visitor.mRemainingTime == -1)
+            return -1;
+        return 0;
+    }
+
+    float getFatigueRestorationPerHour(const MWWorld::Ptr& ptr)
+    {
+        const MWWorld::Store<ESM::GameSetting>& settings = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
+        float fFatigueReturnBase = settings.find("fFatigueReturnBase")->mValue.getFloat ();
+        float fFatigueReturnMult = settings.find("fFatigueReturnMult")->mValue.getFloat ();
+        float fEndFatigueMult = settings.find("fEndFatigueMult")->mValue.getFloat ();
+
+        float endurance = ptr.getClass().getCreatureStats(ptr).getAttribute (ESM::Attribute::Endurance).getModified ();
+
+        float normalizedEncumbrance = ptr.getClass().getNormalizedEncumbrance(ptr);
+        if (normalizedEncumbrance > 1)
+            normalizedEncumbrance = 1;
+
+        float x = fFatigueReturnBase + fFatigueReturnMult * (1 - normalizedEncumbrance);
+        x *= fEndFatigueMult * endurance;
+
+        return 3600 * x;
+    }
+
+    /// Dynamic stats of a resting actor with the effects over time changing them
+    std::array<DynamicStatRest, 3> getDynamicStatsRest(const MWWorld::Ptr& ptr, bool sleep, bool restore)
+    {
+        CreatureStats& stats = ptr.getClass().getCreatureStats(ptr);
+
+        float secondsPerHour = 3600.f;
+        const float timeScale = MWBase::Environment::get().getWorld()->getTimeScaleFactor();
+        if (timeScale != 0.f)
+            secondsPerHour /= timeScale;
+
+        const float lowest = std::numeric_limits<float>::lowest();
+        std::array<DynamicStatRest, 3> rest;
+        for (int i = 0; i < 3; ++i)
+        {
+            const DynamicStat<float>& stat = stats.getDynamic(i);
+            rest[i] = DynamicStatRest {stat.getCurrent(), stat.getModified(), 0, lowest, 0, 0, {}};
+        }
+        // The actor dies when health drops below 1
+        rest[0].mDepletedBelow = 1;
+        static const bool uncappedDamageFatigue = Settings::Manager::getBool("uncapped damage fatigue", "Game");
+        if (uncappedDamageFatigue)
+            rest[2].mMin = lowest;
+
+        if (restore)
+        {
+            if (sleep)
+            {
+                getRestorationPerHourOfSleep(ptr, rest[0].mRestorePerHour, rest[1].mRestorePerHour);
+                const double stuntedHours = getStuntedMagickaHours(ptr);
+                if (stuntedHours < 0)
+                    rest[1].mRestorePerHour = 0;
+                else
+                    rest[1].mRestoreDelay = static_cast<float>(stuntedHours);
+            }
+
+            // Current fatigue can be above base value due to a fortify effect, it is not restored then.
+            if (stats.getFatigue().getCurrent() < stats.getFatigue().getBase())
+                rest[2].mRestorePerHour = getFatigueRestorationPerHour(ptr);
+        }
+
+        // Effects of active spells expire, the rest of the magnitude comes from abilities and equipment
+        GetDynamicStatTicks expiring(ptr, secondsPerHour, rest);
+        stats.getActiveSpells().visitEffectSources(expiring);
+
+        const MagicEffects& effects = stats.getMagicEffects();
+        for (int i = 0; i < 3; ++i)
+        {
+            float constant = -expiring.mExpiringPerHour[i];
+            for (MagicEffects::Collection::const_iterator it = effects.begin(); it != effects.end(); ++it)
+                constant += getDynamicStatTick(ptr, it->first, i) * it->second.getMagnitude() * secondsPerHour;
+            if (constant != 0)
+                rest[i].mTicks.push_back({constant, -1});
+        }
+
+        return rest;
+    }
+
     class GetCurrentMagnitudes : public MWMechanics::EffectSourceVisitor
     {
         std::string mSpellId;
@@ -402,6 +618,60 @@ namespace MWMechanics
         calculateRestoration(ptr, duration);
     }
 
+    void Actors::updateActiveEffects (const MWWorld::Ptr& ptr, float duration)
+    {
+        CreatureStats& stats = ptr.getClass().getCreatureStats(ptr);
+        stats.getActiveSpells().update(duration);
+
+        if (stats.isDead())
+        {
+            // They can be added during the death animation
+            if (!stats.isDeathAnimationFinished())
+                adjustMagicEffects(ptr);
+            return;
+        }
+
+        adjustMagicEffects(ptr);
+        if (stats.needToRecalcDynamicStats())
+            calculateDynamicStats(ptr);
+    }
+
+    void Actors::updateActiveEffects (float duration)
+    {
+        mActorsList.clear();
+        for (const Actor& actor : mActors)
+            mActorsList.push_back(actor.getPtr());
+
+        const std::size_t numItems = std::min(mNumUpdateThreads + 1, mActorsList.size() / minActorsPerWorkItem);
+        if (numItems <= 1)
+        {
+            for (const MWWorld::Ptr& ptr : mActorsList)
+                updateActiveEffects(ptr, duration);
+            return;
+        }
+
+        // Each actor only touches its own spells and stats here, the first range is done by this thread
+        const std::size_t actorsPerItem = (mActorsList.size() + numItems - 1) / numItems;
+        const auto function = [this, duration] (const MWWorld::Ptr& ptr) { updateActiveEffects(ptr, duration); };
+        std::vector<osg::ref_ptr<ActorsWorkItem>> items;
+        for (std::size_t begin = actorsPerItem; begin < mActorsList.size(); begin += actorsPerItem)
+        {
+            const std::size_t end = std::min(begin + actorsPerItem, mActorsList.size());
+            items.emplace_back(new ActorsWorkItem(mActorsList.begin() + begin, mActorsList.begin() + end, function));
+            mWorkQueue->addWorkItem(items.back());
+        }
+
+        ActorsWorkItem item(mActorsList.begin(), mActorsList.begin() + actorsPerItem, function);
+        item.doWork();
+
+        for (const auto& workItem : items)
+            workItem->waitTillDone();
+
+        item.rethrow();
+        for (const auto& workItem : items)
+            workItem->rethrow();
+    }
+
     void Actors::updateHeadTracking(const MWWorld::Ptr& actor, const MWWorld::Ptr& targetActor,
                                     MWWorld::Ptr& headTrackTarget, float& sqrHeadTrackDistance)
     {
@@ -411,14 +681,7 @@ namespace MWMechanics
         if (targetActor.getClass().getCreatureStats(targetActor).isDead())
             return;
 
-        static const float fMaxHeadTrackDistance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("fMaxHeadTrackDistance")->mValue.getFloat();
-        static const float fInteriorHeadTrackMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("fInteriorHeadTrackMult")->mValue.getFloat();
-        float maxDistance = fMaxHeadTrackDistance;
-        const ESM::Cell* currentCell = actor.getCell()->getCell();
-        if (!currentCell->isExterior() && !(currentCell->mData.mFlags & ESM::Cell::QuasiEx))
-            maxDistance *= fInteriorHeadTrackMult;
+        const float maxDistance = getMaxHeadTrackDistance(actor);
 
         const osg::Vec3f actor1Pos(actor.getRefData().getPosition().asVec3());
         const osg::Vec3f actor2Pos(targetActor.getRefData().getPosition().asVec3());
@@ -749,17 +1012,12 @@ namespace MWMechanics
         if (creatureStats.isDeathAnimationFinished())
             return;
 
-        MagicEffects now = creatureStats.getSpells().getMagicEffects();
-
+        const MagicEffects* equipmentEffects = nullptr;
         if (creature.getClass().hasInventoryStore(creature))
-        {
-            MWWorld::InventoryStore& store = creature.getClass().getInventoryStore (creature);
-            now += store.getMagicEffects();
-        }
-
-        now += creatureStats.getActiveSpells().getMagicEffects();
+            equipmentEffects = &creature.getClass().getInventoryStore(creature).getMagicEffects();
 
-        creatureStats.modifyMagicEffects(now);
+        creatureStats.modifyMagicEffects(creatureStats.getSpells().getMagicEffects(), equipmentEffects,
+                                         creatureStats.getActiveSpells().getMagicEffects());
     }
 
     void Actors::calculateDynamicStats (const MWWorld::Ptr& ptr)
@@ -791,8 +1049,6 @@ namespace MWMechanics
         if (stats.isDead())
             return;
 
-        const MWWorld::Store<ESM::GameSetting>& settings = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>();
-
         if (sleep)
         {
             float health, magicka;
@@ -802,29 +1058,9 @@ namespace MWMechanics
             stat.setCurrent(stat.getCurrent() + health * hours);
             stats.setHealth(stat);
 
-            double restoreHours = hours;
-            bool stunted = stats.getMagicEffects ().get(ESM::MagicEffect::StuntedMagicka).getMagnitude() > 0;
-            if (stunted)
-            {
-                // Stunted Magicka effect should be taken into account.
-                GetStuntedMagickaDuration visitor(ptr);
-                stats.getActiveSpells().visitEffectSources(visitor);
-                stats.getSpells().visitEffectSources(visitor);
-                if (ptr.getClass().hasInventoryStore(ptr))
-                    ptr.getClass().getInventoryStore(ptr).visitEffectSources(visitor);
-
-                // Take a maximum remaining duration of Stunted Magicka effects (-1 is a constant one) in game hours.
-                if (visitor.mRemainingTime > 0)
-                {
-                    double timeScale = MWBase::Environment::get().getWorld()->getTimeScaleFactor();
-                    if(timeScale == 0.0)
-                        timeScale = 1;
-
-                    restoreHours = std::max(0.0, hours - visitor.mRemainingTime * timeScale / 3600.f);
-                }
-                else if (visitor.mRemainingTime == -1)
-                    restoreHours = 0;
-            }
+            // Stunted Magicka effect should be taken into account.
+            const double stuntedHours = getStuntedMagickaHours(ptr);
+            const double restoreHours = stuntedHours < 0 ? 0 : std::max(0.0, hours - stuntedHours);
 
             if (restoreHours > 0)
             {
@@ -841,20 +1077,7 @@ namespace MWMechanics
             return;
 
         // Restore fatigue
-        float fFatigueReturnBase = settings.find("fFatigueReturnBase")->mValue.getFloat ();
-        float fFatigueReturnMult = settings.find("fFatigueReturnMult")->mValue.getFloat ();
-        float fEndFatigueMult = settings.find("fEndFatigueMult")->mValue.getFloat ();
-
-        float endurance = stats.getAttribute (ESM::Attribute::Endurance).getModified ();
-
-        float normalizedEncumbrance = ptr.getClass().getNormalizedEncumbrance(ptr);
-        if (normalizedEncumbrance > 1)
-            normalizedEncumbrance = 1;
-
-        float x = fFatigueReturnBase + fFatigueReturnMult * (1 - normalizedEncumbrance);
-        x *= fEndFatigueMult * endurance;
-
-        fatigue.setCurrent (fatigue.getCurrent() + 3600 * x * hours);
+        fatigue.setCurrent (fatigue.getCurrent() + getFatigueRestorationPerHour(ptr) * hours);
         stats.setFatigue (fatigue);
     }
 
@@ -888,10 +1111,11 @@ namespace MWMechanics
         private:
             MWWorld::Ptr mActor;
             float mDuration;
+            bool mTickDynamicStats;
 
         public:
-            ExpiryVisitor(const MWWorld::Ptr& actor, float duration)
-                : mActor(actor), mDuration(duration)
+            ExpiryVisitor(const MWWorld::Ptr& actor, float duration, bool tickDynamicStats)
+                : mActor(actor), mDuration(duration), mTickDynamicStats(tickDynamicStats)
             {
             }
 
@@ -899,7 +1123,8 @@ namespace MWMechanics
                                 const std::string& /*sourceName*/, const std::string& /*sourceId*/, int /*casterActorId*/,
                                 float magnitude, float remainingTime = -1, float /*totalTime*/ = -1)
             {
-                if (magnitude > 0 && remainingTime > 0 && remainingTime < mDuration)
+                if (magnitude > 0 && remainingTime > 0 && remainingTime < mDuration
+                        && (mTickDynamicStats || !isDynamicStatTick(mActor, key)))
                 {
                     CreatureStats& creatureStats = mActor.getClass().getCreatureStats(mActor);
                     if (effectTick(creatureStats, mActor, key, magnitude * remainingTime))
@@ -908,7 +1133,8 @@ namespace MWMechanics
             }
     };
 
-    void Actors::calculateCreatureStatModifiers (const MWWorld::Ptr& ptr, float duration)
+    void Actors::calculateCreatureStatModifiers (const MWWorld::Ptr& ptr, float duration,
+                                                 const std::array<RestedDynamicStat, 3>* restedStats)
     {
         CreatureStats &creatureStats = ptr.getClass().getCreatureStats(ptr);
         const MagicEffects &effects = creatureStats.getMagicEffects();
@@ -921,13 +1147,14 @@ namespace MWMechanics
             // in case duration > remaining time of effect.
             // One case where this will happen is when the player uses the rest/wait command
             // while there is a tickable effect active that should expire before the end of the rest/wait.
-            ExpiryVisitor visitor(ptr, duration);
+            ExpiryVisitor visitor(ptr, duration, restedStats == nullptr);
             creatureStats.getActiveSpells().visitEffectSources(visitor);
 
             for (MagicEffects::Collection::const_iterator it = effects.begin(); it != effects.end(); ++it)
             {
                 // tickable effects (i.e. effects having a lasting impact after expiry)
-                effectTick(creatureStats, ptr, it->first, it->second.getMagnitude() * duration);
+                if (restedStats == nullptr || !isDynamicStatTick(ptr, it->first))
+                    effectTick(creatureStats, ptr, it->first, it->second.getMagnitude() * duration);
 
                 // instant effects are already applied on spell impact in spellcasting.cpp, but may also come from permanent abilities
                 if (it->second.getMagnitude() > 0)
@@ -942,6 +1169,17 @@ namespace MWMechanics
                     }
                 }
             }
+
+            // Effects over time on dynamic stats were already projected over the whole rest
+            if (restedStats != nullptr)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    DynamicStat<float> stat = creatureStats.getDynamic(i);
+                    stat.setCurrent((*restedStats)[i].mValue, true, true);
+                    creatureStats.setDynamic(i, stat);
+                }
+            }
         }
 
         // purge levitate effect if levitation is disabled
@@ -1221,8 +1459,8 @@ namespace MWMechanics
 
     bool Actors::isAttackPreparing(const MWWorld::Ptr& ptr)
     {
-        PtrActorMap::iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        const auto it = mIndex.find(ptr.mRef);
+        if (it == mIndex.end())
             return false;
         CharacterController* ctrl = it->second->getCharacterController();
 
@@ -1231,8 +1469,8 @@ namespace MWMechanics
 
     bool Actors::isRunning(const MWWorld::Ptr& ptr)
     {
-        PtrActorMap::iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        const auto it = mIndex.find(ptr.mRef);
+        if (it == mIndex.end())
             return false;
         CharacterController* ctrl = it->second->getCharacterController();
 
@@ -1241,8 +1479,8 @@ namespace MWMechanics
 
     bool Actors::isSneaking(const MWWorld::Ptr& ptr)
     {
-        PtrActorMap::iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        const auto it = mIndex.find(ptr.mRef);
+        if (it == mIndex.end())
             return false;
         CharacterController* ctrl = it->second->getCharacterController();
 
@@ -1461,9 +1699,14 @@ namespace MWMechanics
     }
 
     Actors::Actors()
+        : mActorsGrid(actorsGridCellSize)
+        , mNumUpdateThreads(static_cast<std::size_t>(std::max(0, Settings::Manager::getInt("actors update threads", "Game"))))
     {
         mTimerDisposeSummonsCorpses = 0.2f; // We should add a delay between summoned creature death and its corpse despawning
 
+        if (mNumUpdateThreads > 0)
+            mWorkQueue = new SceneUtil::WorkQueue(static_cast<int>(mNumUpdateThreads));
+
         updateProcessingRange();
     }
 
@@ -1496,9 +1739,11 @@ namespace MWMechanics
         MWRender::Animation *anim = MWBase::Environment::get().getWorld()->getAnimation(ptr);
         if (!anim)
             return;
-        mActors.insert(std::make_pair(ptr, new Actor(ptr, anim)));
+        mActors.emplace_back(ptr, anim);
+        mIndex.emplace(ptr.mRef, std::prev(mActors.end()));
+        mActorsGrid.update(ptr, ptr.getRefData().getPosition().asVec3());
 
-        CharacterController* ctrl = mActors[ptr]->getCharacterController();
+        CharacterController* ctrl = mActors.back().getCharacterController();
         if (updateImmediately)
             ctrl->update(0);
 
@@ -1541,18 +1786,19 @@ namespace MWMechanics
 
     void Actors::removeActor (const MWWorld::Ptr& ptr)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
+        const auto iter = mIndex.find(ptr.mRef);
+        if(iter != mIndex.end())
         {
-            delete iter->second;
-            mActors.erase(iter);
+            mActorsGrid.remove(ptr);
+            mActors.erase(iter->second);
+            mIndex.erase(iter);
         }
     }
 
     void Actors::castSpell(const MWWorld::Ptr& ptr, const std::string spellId, bool manualSpell)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
+        const auto iter = mIndex.find(ptr.mRef);
+        if(iter != mIndex.end())
             iter->second->getCharacterController()->castSpell(spellId, manualSpell);
     }
 
@@ -1590,26 +1836,36 @@ namespace MWMechanics
 
     void Actors::updateActor(const MWWorld::Ptr &old, const MWWorld::Ptr &ptr)
     {
-        PtrActorMap::iterator iter = mActors.find(old);
-        if(iter != mActors.end())
+        const auto iter = mIndex.find(old.mRef);
+        if(iter != mIndex.end())
         {
-            Actor *actor = iter->second;
-            mActors.erase(iter);
+            const ActorList::iterator actor = iter->second;
+            mIndex.erase(iter);
 
             actor->updatePtr(ptr);
-            mActors.insert(std::make_pair(ptr, actor));
+            mIndex.emplace(ptr.mRef, actor);
+            mActorsGrid.remove(old);
+            mActorsGrid.update(ptr, ptr.getRefData().getPosition().asVec3());
         }
     }
 
+    void Actors::updatePosition(const MWWorld::Ptr &ptr)
+    {
+        if (mIndex.find(ptr.mRef) != mIndex.end())
+            mActorsGrid.update(ptr, ptr.getRefData().getPosition().asVec3());
+    }
+
     void Actors::dropActors (const MWWorld::CellStore *cellStore, const MWWorld::Ptr& ignore)
     {
-        PtrActorMap::iterator iter = mActors.begin();
+        ActorList::iterator iter = mActors.begin();
         while(iter != mActors.end())
         {
-            if((iter->first.isInCell() && iter->first.getCell()==cellStore) && iter->first != ignore)
+            const MWWorld::Ptr& ptr = iter->getPtr();
+            if((ptr.isInCell() && ptr.getCell()==cellStore) && ptr != ignore)
             {
-                delete iter->second;
-                mActors.erase(iter++);
+                mIndex.erase(ptr.mRef);
+                mActorsGrid.remove(ptr);
+                iter = mActors.erase(iter);
             }
             else
                 ++iter;
@@ -1625,14 +1881,14 @@ namespace MWMechanics
 
         if (aiActive)
         {
-            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+            for(ActorList::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
             {
-                if (iter->first == player) continue;
+                if (iter->getPtr() == player) continue;
 
-                bool inProcessingRange = (playerPos - iter->first.getRefData().getPosition().asVec3()).length2() <= mActorsProcessingRange*mActorsProcessingRange;
+                bool inProcessingRange = (playerPos - iter->getPtr().getRefData().getPosition().asVec3()).length2() <= mActorsProcessingRange*mActorsProcessingRange;
                 if (inProcessingRange)
                 {
-                    MWMechanics::CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
+                    MWMechanics::CreatureStats& stats = iter->getPtr().getClass().getCreatureStats(iter->getPtr());
                     if (!stats.isDead() && stats.getAiSequence().isInCombat())
                     {
                         hasHostiles = true;
@@ -1661,6 +1917,8 @@ namespace MWMechanics
 
     void Actors::update (float duration, bool paused)
     {
+        Debug::TraceZone zone("Actors::update");
+
         if(!paused)
         {
             static float timerUpdateAITargets = 0;
@@ -1686,6 +1944,7 @@ namespace MWMechanics
             /// \todo move update logic to Actor class where appropriate
 
             std::map<const MWWorld::Ptr, const std::set<MWWorld::Ptr> > cachedAllies; // will be filled as engageCombat iterates
+            std::vector<MWWorld::Ptr> neighbors;
 
             bool aiActive = MWBase::Environment::get().getMechanicsManager()->isAIActive();
             int attackedByPlayerId = player.getClass().getCreatureStats(player).getHitAttemptActorId();
@@ -1697,13 +1956,15 @@ namespace MWMechanics
                     player.getClass().getCreatureStats(player).setHitAttemptActorId(-1);
             }
 
+            updateActiveEffects(duration);
+
              // AI and magic effects update
-            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+            for(ActorList::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
             {
-                bool isPlayer = iter->first == player;
-                CharacterController* ctrl = iter->second->getCharacterController();
+                bool isPlayer = iter->getPtr() == player;
+                CharacterController* ctrl = iter->getCharacterController();
 
-                float distSqr = (playerPos - iter->first.getRefData().getPosition().asVec3()).length2();
+                float distSqr = (playerPos - iter->getPtr().getRefData().getPosition().asVec3()).length2();
                 // AI processing is only done within given distance to the player.
                 bool inProcessingRange = distSqr <= mActorsProcessingRange*mActorsProcessingRange;
 
@@ -1711,30 +1972,27 @@ namespace MWMechanics
                     ctrl->setAttackingOrSpell(world->getPlayer().getAttackingOrSpell());
 
                 // If dead or no longer in combat, no longer store any actors who attempted to hit us. Also remove for the player.
-                if (iter->first != player && (iter->first.getClass().getCreatureStats(iter->first).isDead()
-                    || !iter->first.getClass().getCreatureStats(iter->first).getAiSequence().isInCombat()
+                if (iter->getPtr() != player && (iter->getPtr().getClass().getCreatureStats(iter->getPtr()).isDead()
+                    || !iter->getPtr().getClass().getCreatureStats(iter->getPtr()).getAiSequence().isInCombat()
                     || !inProcessingRange))
                 {
-                    iter->first.getClass().getCreatureStats(iter->first).setHitAttemptActorId(-1);
-                    if (player.getClass().getCreatureStats(player).getHitAttemptActorId() == iter->first.getClass().getCreatureStats(iter->first).getActorId())
+                    iter->getPtr().getClass().getCreatureStats(iter->getPtr()).setHitAttemptActorId(-1);
+                    if (player.getClass().getCreatureStats(player).getHitAttemptActorId() == iter->getPtr().getClass().getCreatureStats(iter->getPtr()).getActorId())
                         player.getClass().getCreatureStats(player).setHitAttemptActorId(-1);
                 }
 
-                iter->first.getClass().getCreatureStats(iter->first).getActiveSpells().update(duration);
-
                 // For dead actors we need to update looping spell particles
-                if (iter->first.getClass().getCreatureStats(iter->first).isDead())
+                if (iter->getPtr().getClass().getCreatureStats(iter->getPtr()).isDead())
                 {
-                    // They can be added during the death animation
-                    if (!iter->first.getClass().getCreatureStats(iter->first).isDeathAnimationFinished())
-                        adjustMagicEffects(iter->first);
                     ctrl->updateContinuousVfx();
                 }
                 else
                 {
                     bool cellChanged = world->hasCellChanged();
-                    MWWorld::Ptr actor = iter->first; // make a copy of the map key to avoid it being invalidated when the player teleports
-                    updateActor(actor, duration);
+                    MWWorld::Ptr actor = iter->getPtr(); // make a copy to keep the old Ptr when the player teleports
+                    calculateCreatureStatModifiers(actor, duration);
+                    // fatigue restoration
+                    calculateRestoration(actor, duration);
 
                     // Looping magic VFX update
                     // Note: we need to do this before any of the animations are updated.
@@ -1753,13 +2011,19 @@ namespace MWMechanics
                         if (timerUpdateAITargets == 0)
                         {
                             if (!isPlayer)
-                                adjustCommandedActor(iter->first);
+                                adjustCommandedActor(iter->getPtr());
 
-                            for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
+                            // player is not AI-controlled
+                            if (!isPlayer)
                             {
-                                if (it->first == iter->first || isPlayer) // player is not AI-controlled
-                                    continue;
-                                engageCombat(iter->first, it->first, cachedAllies, it->first == player);
+                                neighbors.clear();
+                                mActorsGrid.getInRange(iter->getPtr().getRefData().getPosition().asVec3(), mActorsProcessingRange, neighbors);
+                                for (const MWWorld::Ptr& neighbor : neighbors)
+                                {
+                                    if (neighbor == iter->getPtr())
+                                        continue;
+                                    engageCombat(iter->getPtr(), neighbor, cachedAllies, neighbor == player);
+                                }
                             }
                         }
                         if (timerUpdateHeadTrack == 0)
@@ -1767,7 +2031,7 @@ namespace MWMechanics
                             float sqrHeadTrackDistance = std::numeric_limits<float>::max();
                             MWWorld::Ptr headTrackTarget;
 
-                            MWMechanics::CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
+                            MWMechanics::CreatureStats& stats = iter->getPtr().getClass().getCreatureStats(iter->getPtr());
                             bool firstPersonPlayer = isPlayer && world->isFirstPerson();
 
                             // 1. Unconsious actor can not track target
@@ -1778,48 +2042,51 @@ namespace MWMechanics
                                 !stats.getAiSequence().hasPackage(AiPackageTypeId::Pursue) &&
                                 !firstPersonPlayer)
                             {
-                                for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
+                                neighbors.clear();
+                                mActorsGrid.getInRange(iter->getPtr().getRefData().getPosition().asVec3(),
+                                                       getMaxHeadTrackDistance(iter->getPtr()), neighbors);
+                                for (const MWWorld::Ptr& neighbor : neighbors)
                                 {
-                                    if (it->first == iter->first)
+                                    if (neighbor == iter->getPtr())
                                         continue;
-                                    updateHeadTracking(iter->first, it->first, headTrackTarget, sqrHeadTrackDistance);
+                                    updateHeadTracking(iter->getPtr(), neighbor, headTrackTarget, sqrHeadTrackDistance);
                                 }
                             }
 
                             ctrl->setHeadTrackTarget(headTrackTarget);
                         }
 
-                        if (iter->first.getClass().isNpc() && iter->first != player)
-                            updateCrimePursuit(iter->first, duration);
+                        if (iter->getPtr().getClass().isNpc() && iter->getPtr() != player)
+                            updateCrimePursuit(iter->getPtr(), duration);
 
-                        if (iter->first != player)
+                        if (iter->getPtr() != player)
                         {
-                            CreatureStats &stats = iter->first.getClass().getCreatureStats(iter->first);
-                            if (isConscious(iter->first))
+                            CreatureStats &stats = iter->getPtr().getClass().getCreatureStats(iter->getPtr());
+                            if (isConscious(iter->getPtr()))
                             {
-                                stats.getAiSequence().execute(iter->first, *ctrl, duration);
-                                updateGreetingState(iter->first, *iter->second, timerUpdateHello > 0);
-                                playIdleDialogue(iter->first);
-                                updateMovementSpeed(iter->first);
+                                stats.getAiSequence().execute(iter->getPtr(), *ctrl, duration);
+                                updateGreetingState(iter->getPtr(), *iter, timerUpdateHello > 0);
+                                playIdleDialogue(iter->getPtr());
+                                updateMovementSpeed(iter->getPtr());
                             }
                         }
                     }
-                    else if (aiActive && iter->first != player && isConscious(iter->first))
+                    else if (aiActive && iter->getPtr() != player && isConscious(iter->getPtr()))
                     {
-                        CreatureStats &stats = iter->first.getClass().getCreatureStats(iter->first);
-                        stats.getAiSequence().execute(iter->first, *ctrl, duration, /*outOfRange*/true);
+                        CreatureStats &stats = iter->getPtr().getClass().getCreatureStats(iter->getPtr());
+                        stats.getAiSequence().execute(iter->getPtr(), *ctrl, duration, /*outOfRange*/true);
                     }
 
-                    if(iter->first.getClass().isNpc())
+                    if(iter->getPtr().getClass().isNpc())
                     {
                         // We can not update drowning state for actors outside of AI distance - they can not resurface to breathe
                         if (inProcessingRange)
-                            updateDrowning(iter->first, duration, ctrl->isKnockedOut(), isPlayer);
+                            updateDrowning(iter->getPtr(), duration, ctrl->isKnockedOut(), isPlayer);
 
-                        calculateNpcStatModifiers(iter->first, duration);
+                        calculateNpcStatModifiers(iter->getPtr(), duration);
 
                         if (timerUpdateEquippedLight == 0)
-                            updateEquippedLight(iter->first, updateEquippedLightInterval, showTorches);
+                            updateEquippedLight(iter->getPtr(), updateEquippedLightInterval, showTorches);
                     }
                 }
             }
@@ -1832,14 +2099,14 @@ namespace MWMechanics
 
             // Animation/movement update
             CharacterController* playerCharacter = nullptr;
-            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+            for(ActorList::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
             {
-                const float dist = (playerPos - iter->first.getRefData().getPosition().asVec3()).length();
-                bool isPlayer = iter->first == player;
-                CreatureStats &stats = iter->first.getClass().getCreatureStats(iter->first);
+                const float dist = (playerPos - iter->getPtr().getRefData().getPosition().asVec3()).length();
+                bool isPlayer = iter->getPtr() == player;
+                CreatureStats &stats = iter->getPtr().getClass().getCreatureStats(iter->getPtr());
                 // Actors with active AI should be able to move.
                 bool alwaysActive = false;
-                if (!isPlayer && isConscious(iter->first) && !stats.isParalyzed())
+                if (!isPlayer && isConscious(iter->getPtr()) && !stats.isParalyzed())
                 {
                     MWMechanics::AiSequence& seq = stats.getAiSequence();
                     alwaysActive = !seq.isEmpty() && seq.getActivePackage().alwaysActive();
@@ -1850,34 +2117,34 @@ namespace MWMechanics
                     activeFlag = 2;
                 int active = inRange ? activeFlag : 0;
 
-                CharacterController* ctrl = iter->second->getCharacterController();
+                CharacterController* ctrl = iter->getCharacterController();
                 ctrl->setActive(active);
 
                 if (!inRange)
                 {
-                    iter->first.getRefData().getBaseNode()->setNodeMask(0);
-                    world->setActorCollisionMode(iter->first, false, false);
+                    iter->getPtr().getRefData().getBaseNode()->setNodeMask(0);
+                    world->setActorCollisionMode(iter->getPtr(), false, false);
                     continue;
                 }
                 else if (!isPlayer)
-                    iter->first.getRefData().getBaseNode()->setNodeMask(MWRender::Mask_Actor);
+                    iter->getPtr().getRefData().getBaseNode()->setNodeMask(MWRender::Mask_Actor);
 
-                const bool isDead = iter->first.getClass().getCreatureStats(iter->first).isDead();
-                if (!isDead && iter->first.getClass().getCreatureStats(iter->first).isParalyzed())
+                const bool isDead = iter->getPtr().getClass().getCreatureStats(iter->getPtr()).isDead();
+                if (!isDead && iter->getPtr().getClass().getCreatureStats(iter->getPtr()).isParalyzed())
                     ctrl->skipAnim();
 
                 // Handle player last, in case a cell transition occurs by casting a teleportation spell
                 // (would invalidate the iterator)
-                if (iter->first == getPlayer())
+                if (iter->getPtr() == getPlayer())
                 {
                     playerCharacter = ctrl;
                     continue;
                 }
 
-                world->setActorCollisionMode(iter->first, true, !iter->first.getClass().getCreatureStats(iter->first).isDeathAnimationFinished());
+                world->setActorCollisionMode(iter->getPtr(), true, !iter->getPtr().getClass().getCreatureStats(iter->getPtr()).isDeathAnimationFinished());
                 ctrl->update(duration);
 
-                updateVisibility(iter->first, ctrl);
+                updateVisibility(iter->getPtr(), ctrl);
             }
 
             if (playerCharacter)
@@ -1886,10 +2153,10 @@ namespace MWMechanics
                 playerCharacter->setVisibility(1.f);
             }
 
-            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+            for(ActorList::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
             {
-                const MWWorld::Class &cls = iter->first.getClass();
-                CreatureStats &stats = cls.getCreatureStats(iter->first);
+                const MWWorld::Class &cls = iter->getPtr().getClass();
+                CreatureStats &stats = cls.getCreatureStats(iter->getPtr());
 
                 //KnockedOutOneFrameLogic
                 //Used for "OnKnockedOut" command
@@ -1921,13 +2188,13 @@ namespace MWMechanics
 
     void Actors::resurrect(const MWWorld::Ptr &ptr)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
+        const auto iter = mIndex.find(ptr.mRef);
+        if(iter != mIndex.end())
         {
             if(iter->second->getCharacterController()->isDead())
             {
                 // Actor has been resurrected. Notify the CharacterController and re-enable collision.
-                MWBase::Environment::get().getWorld()->enableActorCollision(iter->first, true);
+                MWBase::Environment::get().getWorld()->enableActorCollision(ptr, true);
                 iter->second->getCharacterController()->resurrect();
             }
         }
@@ -1935,41 +2202,41 @@ namespace MWMechanics
 
     void Actors::killDeadActors()
     {
-        for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+        for(ActorList::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
         {
-            const MWWorld::Class &cls = iter->first.getClass();
-            CreatureStats &stats = cls.getCreatureStats(iter->first);
+            const MWWorld::Class &cls = iter->getPtr().getClass();
+            CreatureStats &stats = cls.getCreatureStats(iter->getPtr());
 
             if(!stats.isDead())
                 continue;
 
-            MWBase::Environment::get().getWorld()->removeActorPath(iter->first);
-            CharacterController::KillResult killResult = iter->second->getCharacterController()->kill();
+            MWBase::Environment::get().getWorld()->removeActorPath(iter->getPtr());
+            CharacterController::KillResult killResult = iter->getCharacterController()->kill();
             if (killResult == CharacterController::Result_DeathAnimStarted)
             {
                 // Play dying words
                 // Note: It's not known whether the soundgen tags scream, roar, and moan are reliable
                 // for NPCs since some of the npc death animation files are missing them.
-                MWBase::Environment::get().getDialogueManager()->say(iter->first, "hit");
+                MWBase::Environment::get().getDialogueManager()->say(iter->getPtr(), "hit");
 
                 // Apply soultrap
-                if (iter->first.getTypeName() == typeid(ESM::Creature).name())
+                if (iter->getPtr().getTypeName() == typeid(ESM::Creature).name())
                 {
-                    SoulTrap soulTrap (iter->first);
+                    SoulTrap soulTrap (iter->getPtr());
                     stats.getActiveSpells().visitEffectSources(soulTrap);
                 }
 
                 // Magic effects will be reset later, and the magic effect that could kill the actor
                 // needs to be determined now
-                calculateCreatureStatModifiers(iter->first, 0);
+                calculateCreatureStatModifiers(iter->getPtr(), 0);
 
-                if (cls.isEssential(iter->first))
+                if (cls.isEssential(iter->getPtr()))
                     MWBase::Environment::get().getWindowManager()->messageBox("#{sKilledEssential}");
             }
             else if (killResult == CharacterController::Result_DeathAnimJustFinished)
             {
-                bool isPlayer = iter->first == getPlayer();
-                notifyDied(iter->first);
+                bool isPlayer = iter->getPtr() == getPlayer();
+                notifyDied(iter->getPtr());
 
                 // Reset magic effects and recalculate derived effects
                 // One case where we need this is to make sure bound items are removed upon death
@@ -1979,9 +2246,9 @@ namespace MWMechanics
                 purgeSpellEffects(stats.getActorId());
 
                 // Reset dynamic stats, attributes and skills
-                calculateCreatureStatModifiers(iter->first, 0);
-                if (iter->first.getClass().isNpc())
-                    calculateNpcStatModifiers(iter->first, 0);
+                calculateCreatureStatModifiers(iter->getPtr(), 0);
+                if (iter->getPtr().getClass().isNpc())
+                    calculateNpcStatModifiers(iter->getPtr(), 0);
 
                 if (isPlayer)
                 {
@@ -1991,11 +2258,11 @@ namespace MWMechanics
                 else
                 {
                     // NPC death animation is over, disable actor collision
-                    MWBase::Environment::get().getWorld()->enableActorCollision(iter->first, false);
+                    MWBase::Environment::get().getWorld()->enableActorCollision(iter->getPtr(), false);
                 }
 
                 // Play Death Music if it was the player dying
-                if(iter->first == getPlayer())
+                if(iter->getPtr() == getPlayer())
                     MWBase::Environment::get().getSoundManager()->streamMusic("Special/MW_Death.mp3");
             }
         }
@@ -2034,9 +2301,9 @@ namespace MWMechanics
 
     void Actors::purgeSpellEffects(int casterActorId)
     {
-        for (PtrActorMap::iterator iter(mActors.begin());iter != mActors.end();++iter)
+        for (ActorList::iterator iter(mActors.begin());iter != mActors.end();++iter)
         {
-            MWMechanics::ActiveSpells& spells = iter->first.getClass().getCreatureStats(iter->first).getActiveSpells();
+            MWMechanics::ActiveSpells& spells = iter->getPtr().getClass().getCreatureStats(iter->getPtr()).getActiveSpells();
             spells.purge(casterActorId);
         }
     }
@@ -2051,42 +2318,66 @@ namespace MWMechanics
         const MWWorld::Ptr player = MWBase::Environment::get().getWorld()->getPlayerPtr();
         const osg::Vec3f playerPos = player.getRefData().getPosition().asVec3();
 
-        for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+        for(ActorList::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
         {
-            if (iter->first.getClass().getCreatureStats(iter->first).isDead())
+            if (iter->getPtr().getClass().getCreatureStats(iter->getPtr()).isDead())
             {
-                iter->first.getClass().getCreatureStats(iter->first).getActiveSpells().update(duration);
+                iter->getPtr().getClass().getCreatureStats(iter->getPtr()).getActiveSpells().update(duration);
                 continue;
             }
 
-            if (!sleep || iter->first == player)
-                restoreDynamicStats(iter->first, hours, sleep);
+            const bool restore = !sleep || iter->getPtr() == player;
+            const bool inProcessingRange = iter->getPtr().getRefData().getBaseNode() &&
+                    (playerPos - iter->getPtr().getRefData().getPosition().asVec3()).length2() <= mActorsProcessingRange*mActorsProcessingRange;
+
+            // Restoration is cut at the maximum every hour before effects over time tick, so one long step
+            // does not match resting hour by hour. Dynamic stats with such effects are projected instead.
+            const int wholeHours = static_cast<int>(hours);
+            std::array<RestedDynamicStat, 3> restedStats;
+            const bool project = inProcessingRange && wholeHours > 1 && wholeHours == hours && hasDynamicStatTicks(iter->getPtr());
+            if (project)
+            {
+                const std::array<DynamicStatRest, 3> stats = getDynamicStatsRest(iter->getPtr(), sleep, restore);
+                for (int i = 0; i < 3; ++i)
+                    restedStats[i] = projectRest(stats[i], wholeHours);
+            }
+
+            if (restore)
+                restoreDynamicStats(iter->getPtr(), hours, sleep);
 
-            if ((!iter->first.getRefData().getBaseNode()) ||
-                    (playerPos - iter->first.getRefData().getPosition().asVec3()).length2() > mActorsProcessingRange*mActorsProcessingRange)
+            if (!inProcessingRange)
                 continue;
 
-            adjustMagicEffects (iter->first);
-            if (iter->first.getClass().getCreatureStats(iter->first).needToRecalcDynamicStats())
-                calculateDynamicStats (iter->first);
+            adjustMagicEffects (iter->getPtr());
+            if (iter->getPtr().getClass().getCreatureStats(iter->getPtr()).needToRecalcDynamicStats())
+                calculateDynamicStats (iter->getPtr());
 
-            calculateCreatureStatModifiers (iter->first, duration);
-            if (iter->first.getClass().isNpc())
-                calculateNpcStatModifiers(iter->first, duration);
+            calculateCreatureStatModifiers (iter->getPtr(), duration, project ? &restedStats : nullptr);
+            if (iter->getPtr().getClass().isNpc())
+                calculateNpcStatModifiers(iter->getPtr(), duration);
 
-            iter->first.getClass().getCreatureStats(iter->first).getActiveSpells().update(duration);
+            iter->getPtr().getClass().getCreatureStats(iter->getPtr()).getActiveSpells().update(duration);
 
-            MWRender::Animation* animation = MWBase::Environment::get().getWorld()->getAnimation(iter->first);
+            MWRender::Animation* animation = MWBase::Environment::get().getWorld()->getAnimation(iter->getPtr());
             if (animation)
             {
                 animation->removeEffects();
-                MWBase::Environment::get().getWorld()->applyLoopingParticles(iter->first);
+                MWBase::Environment::get().getWorld()->applyLoopingParticles(iter->getPtr());
             }
         }
 
         fastForwardAi();
     }
 
+    int Actors::getHoursToDeath(const MWWorld::Ptr& ptr, int hours, bool sleep) const
+    {
+        if (ptr.getClass().getCreatureStats(ptr).isDead() || !hasDynamicStatTicks(ptr))
+            return 0;
+
+        const bool restore = !sleep || ptr == getPlayer();
+        return projectRest(getDynamicStatsRest(ptr, sleep, restore)[0], hours).mDepletionHour;
+    }
+
     void Actors::updateSneaking(CharacterController* ctrl, float duration)
     {
         static float sneakTimer = 0.f; // Times update of sneak icon
@@ -2190,15 +2481,15 @@ namespace MWMechanics
 
     void Actors::forceStateUpdate(const MWWorld::Ptr & ptr)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
+        const auto iter = mIndex.find(ptr.mRef);
+        if(iter != mIndex.end())
             iter->second->getCharacterController()->forceStateUpdate();
     }
 
     bool Actors::playAnimationGroup(const MWWorld::Ptr& ptr, const std::string& groupName, int mode, int number, bool persist)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
+        const auto iter = mIndex.find(ptr.mRef);
+        if(iter != mIndex.end())
         {
             return iter->second->getCharacterController()->playGroup(groupName, mode, number, persist);
         }
@@ -2210,51 +2501,43 @@ namespace MWMechanics
     }
     void Actors::skipAnimation(const MWWorld::Ptr& ptr)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
+        const auto iter = mIndex.find(ptr.mRef);
+        if(iter != mIndex.end())
             iter->second->getCharacterController()->skipAnim();
     }
 
     bool Actors::checkAnimationPlaying(const MWWorld::Ptr& ptr, const std::string& groupName)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
+        const auto iter = mIndex.find(ptr.mRef);
+        if(iter != mIndex.end())
             return iter->second->getCharacterController()->isAnimPlaying(groupName);
         return false;
     }
 
     void Actors::persistAnimationStates()
     {
-        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
-            iter->second->getCharacterController()->persistAnimationState();
+        for (ActorList::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
+            iter->getCharacterController()->persistAnimationState();
     }
 
     void Actors::getObjectsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out)
     {
-        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
-        {
-            if ((iter->first.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
-                out.push_back(iter->first);
-        }
+        mActorsGrid.getInRange(position, radius, out);
     }
 
     bool Actors::isAnyObjectInRange(const osg::Vec3f& position, float radius)
     {
-        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
-        {
-            if ((iter->first.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
-                return true;
-        }
-
-        return false;
+        std::vector<MWWorld::Ptr> neighbors;
+        mActorsGrid.getInRange(position, radius, neighbors);
+        return !neighbors.empty();
     }
 
     std::list<MWWorld::Ptr> Actors::getActorsSidingWith(const MWWorld::Ptr& actor)
     {
         std::list<MWWorld::Ptr> list;
-        for(PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
+        for(ActorList::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
         {
-            const MWWorld::Ptr &iteratedActor = iter->first;
+            const MWWorld::Ptr &iteratedActor = iter->getPtr();
             if (iteratedActor == getPlayer())
                 continue;
 
@@ -2290,9 +2573,9 @@ namespace MWMechanics
     std::list<MWWorld::Ptr> Actors::getActorsFollowing(const MWWorld::Ptr& actor)
     {
         std::list<MWWorld::Ptr> list;
-        for(PtrActorMap::iterator iter(mActors.begin());iter != mActors.end();++iter)
+        for(ActorList::iterator iter(mActors.begin());iter != mActors.end();++iter)
         {
-            const MWWorld::Ptr &iteratedActor = iter->first;
+            const MWWorld::Ptr &iteratedActor = iter->getPtr();
             if (iteratedActor == getPlayer() || iteratedActor == actor)
                 continue;
 
@@ -2353,9 +2636,9 @@ namespace MWMechanics
     std::list<int> Actors::getActorsFollowingIndices(const MWWorld::Ptr &actor)
     {
         std::list<int> list;
-        for(PtrActorMap::iterator iter(mActors.begin());iter != mActors.end();++iter)
+        for(ActorList::iterator iter(mActors.begin());iter != mActors.end();++iter)
         {
-            const MWWorld::Ptr &iteratedActor = iter->first;
+            const MWWorld::Ptr &iteratedActor = iter->getPtr();
             if (iteratedActor == getPlayer() || iteratedActor == actor)
                 continue;
 
@@ -2451,13 +2734,9 @@ namespace MWMechanics
 
     void Actors::clear()
     {
-        PtrActorMap::iterator it(mActors.begin());
-        for (; it != mActors.end(); ++it)
-        {
-            delete it->second;
-            it->second = nullptr;
-        }
         mActors.clear();
+        mIndex.clear();
+        mActorsGrid.clear();
         mDeathCount.clear();
     }
 
@@ -2471,8 +2750,8 @@ namespace MWMechanics
 
     bool Actors::isReadyToBlock(const MWWorld::Ptr &ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        const auto it = mIndex.find(ptr.mRef);
+        if (it == mIndex.end())
             return false;
 
         return it->second->getCharacterController()->isReadyToBlock();
@@ -2480,8 +2759,8 @@ namespace MWMechanics
 
     bool Actors::isCastingSpell(const MWWorld::Ptr &ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        const auto it = mIndex.find(ptr.mRef);
+        if (it == mIndex.end())
             return false;
 
         return it->second->getCharacterController()->isCastingSpell();
@@ -2489,8 +2768,8 @@ namespace MWMechanics
 
     bool Actors::isAttackingOrSpell(const MWWorld::Ptr& ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        const auto it = mIndex.find(ptr.mRef);
+        if (it == mIndex.end())
             return false;
         CharacterController* ctrl = it->second->getCharacterController();
 
@@ -2499,8 +2778,8 @@ namespace MWMechanics
 
     int Actors::getGreetingTimer(const MWWorld::Ptr& ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        const auto it = mIndex.find(ptr.mRef);
+        if (it == mIndex.end())
             return 0;
 
         return it->second->getGreetingTimer();
@@ -2508,8 +2787,8 @@ namespace MWMechanics
 
     float Actors::getAngleToPlayer(const MWWorld::Ptr& ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        const auto it = mIndex.find(ptr.mRef);
+        if (it == mIndex.end())
             return 0.f;
 
         return it->second->getAngleToPlayer();
@@ -2517,8 +2796,8 @@ namespace MWMechanics
 
     GreetingState Actors::getGreetingState(const MWWorld::Ptr& ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        const auto it = mIndex.find(ptr.mRef);
+        if (it == mIndex.end())
             return Greet_None;
 
         return it->second->getGreetingState();
@@ -2526,8 +2805,8 @@ namespace MWMechanics
 
     bool Actors::isTurningToPlayer(const MWWorld::Ptr& ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        const auto it = mIndex.find(ptr.mRef);
+        if (it == mIndex.end())
             return false;
 
         return it->second->isTurningToPlayer();
@@ -2539,10 +2818,11 @@ namespace MWMechanics
             return;
 
         // making a copy since fast-forward could move actor to a different cell and invalidate the mActors iterator
-        PtrActorMap map = mActors;
-        for (PtrActorMap::iterator it = map.begin(); it != map.end(); ++it)
+        std::vector<MWWorld::Ptr> actors;
+        for (const Actor& actor : mActors)
+            actors.push_back(actor.getPtr());
+        for (const MWWorld::Ptr& ptr : actors)
         {
-            MWWorld::Ptr ptr = it->first;
             if (ptr == getPlayer()
                     || !isConscious(ptr)
                     || ptr.getClass().getCreatureStats(ptr).isParalyzed())
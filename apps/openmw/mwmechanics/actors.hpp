@@ -1,13 +1,23 @@
 #ifndef GAME_MWMECHANICS_ACTORS_H
 #define GAME_MWMECHANICS_ACTORS_H
 
+#include <array>
 #include <set>
 #include <vector>
 #include <string>
 #include <list>
 #include <map>
+#include <unordered_map>
 
+#include <osg/ref_ptr>
+
+#include <components/misc/spatialgrid.hpp>
+
+#include "../mwworld/ptr.hpp"
+
+#include "../mwmechanics/actor.hpp"
 #include "../mwmechanics/actorutil.hpp"
+#include "../mwmechanics/restprojection.hpp"
 
 namespace ESM
 {
@@ -25,6 +35,11 @@ namespace Loading
     class Listener;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace MWWorld
 {
     class Ptr;
@@ -33,7 +48,6 @@ namespace MWWorld
 
 namespace MWMechanics
 {
-    class Actor;
     class CharacterController;
     class CreatureStats;
 
@@ -46,9 +60,16 @@ namespace MWMechanics
 
             void adjustMagicEffects (const MWWorld::Ptr& creature);
 
+            void updateActiveEffects (const MWWorld::Ptr& ptr, float duration);
+
+            void updateActiveEffects (float duration);
+            ///< Expire active spells and gather the magic effects of all actors, split across the update threads.
+
             void calculateDynamicStats (const MWWorld::Ptr& ptr);
 
-            void calculateCreatureStatModifiers (const MWWorld::Ptr& ptr, float duration);
+            void calculateCreatureStatModifiers (const MWWorld::Ptr& ptr, float duration,
+                                                 const std::array<RestedDynamicStat, 3>* restedStats = nullptr);
+            ///< \param restedStats Values to set dynamic stats to instead of ticking effects over time on them
             void calculateNpcStatModifiers (const MWWorld::Ptr& ptr, float duration);
 
             void calculateRestoration (const MWWorld::Ptr& ptr, float duration);
@@ -68,10 +89,12 @@ namespace MWMechanics
             Actors();
             ~Actors();
 
-            typedef std::map<MWWorld::Ptr,Actor*> PtrActorMap;
+            /// Actors are stored in order of insertion. Iterators stay valid until the actor is removed, also when the
+            /// actor changes cell.
+            typedef std::list<Actor> ActorList;
 
-            PtrActorMap::const_iterator begin() { return mActors.begin(); }
-            PtrActorMap::const_iterator end() { return mActors.end(); }
+            ActorList::const_iterator begin() { return mActors.begin(); }
+            ActorList::const_iterator end() { return mActors.end(); }
             std::size_t size() const { return mActors.size(); }
 
             void notifyDied(const MWWorld::Ptr &actor);
@@ -104,6 +127,9 @@ namespace MWMechanics
             void updateActor(const MWWorld::Ptr &old, const MWWorld::Ptr& ptr);
             ///< Updates an actor with a new Ptr
 
+            void updatePosition(const MWWorld::Ptr& ptr);
+            ///< Updates the position of an actor used to find its neighbours
+
             void dropActors (const MWWorld::CellStore *cellStore, const MWWorld::Ptr& ignore);
             ///< Deregister all actors (except for \a ignore) in the given cell.
 
@@ -142,6 +168,9 @@ namespace MWMechanics
             int getHoursToRest(const MWWorld::Ptr& ptr) const;
             ///< Calculate how many hours the given actor needs to rest in order to be fully healed
 
+            int getHoursToDeath(const MWWorld::Ptr& ptr, int hours, bool sleep) const;
+            ///< Hour of a rest of the given length at which effects over time kill the actor, 0 if it survives
+
             void fastForwardAi();
             ///< Simulate the passing of time
 
@@ -205,7 +234,12 @@ namespace MWMechanics
     private:
         void updateVisibility (const MWWorld::Ptr& ptr, CharacterController* ctrl);
 
-        PtrActorMap mActors;
+        ActorList mActors;
+        std::unordered_map<const MWWorld::LiveCellRefBase*, ActorList::iterator> mIndex;
+        Misc::SpatialGrid<MWWorld::Ptr> mActorsGrid;
+        std::vector<MWWorld::Ptr> mActorsList;
+        std::size_t mNumUpdateThreads;
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
         float mTimerDisposeSummonsCorpses;
         float mActorsProcessingRange;
 
@@ -23,6 +23,7 @@
 #include "character.hpp"
 #include "aicombataction.hpp"
 #include "actorutil.hpp"
+#include "aischeduler.hpp"
 
 namespace
 {
@@ -143,13 +144,15 @@ namespace MWMechanics
         storage.mActionCooldown -= duration;
 
         float& timerReact = storage.mTimerReact;
-        if (timerReact < AI_REACTION_TIME)
+        AiScheduler& scheduler = MWBase::Environment::get().getMechanicsManager()->getAiScheduler();
+        if (!scheduler.isDecisionDue(actor, timerReact))
         {
             timerReact += duration;
         }
         else
         {
             timerReact = 0;
+            AiScheduler::Decision decision(scheduler);
             if (attack(actor, target, storage, characterController))
                 return true;
         }
@@ -266,8 +269,11 @@ namespace MWMechanics
     void MWMechanics::AiCombat::updateLOS(const MWWorld::Ptr& actor, const MWWorld::Ptr& target, float duration, MWMechanics::AiCombatStorage& storage)
     {
         static const float LOS_UPDATE_DURATION = 0.5f;
-        if (storage.mUpdateLOSTimer <= 0.f)
+        AiScheduler& scheduler = MWBase::Environment::get().getMechanicsManager()->getAiScheduler();
+        if (storage.mUpdateLOSTimer <= 0.f
+                && scheduler.hasBudget((LOS_UPDATE_DURATION - storage.mUpdateLOSTimer) / LOS_UPDATE_DURATION))
         {
+            AiScheduler::Decision decision(scheduler);
             storage.mLOS = MWBase::Environment::get().getWorld()->getLOS(actor, target);
             storage.mUpdateLOSTimer = LOS_UPDATE_DURATION;
         }
@@ -8,10 +8,12 @@
 
 #include "../mwbase/world.hpp"
 #include "../mwbase/environment.hpp"
+#include "../mwbase/mechanicsmanager.hpp"
 
 #include "../mwworld/action.hpp"
 #include "../mwworld/class.hpp"
 #include "../mwworld/cellstore.hpp"
+#include "../mwworld/esmstore.hpp"
 #include "../mwworld/inventorystore.hpp"
 
 #include "../mwphysics/collisiontype.hpp"
@@ -21,6 +23,8 @@
 #include "movement.hpp"
 #include "steering.hpp"
 #include "actorutil.hpp"
+#include "aischeduler.hpp"
+#include "crowdsteering.hpp"
 
 #include <osg/Quat>
 
@@ -95,8 +99,20 @@ bool MWMechanics::AiPackage::pathTo(const MWWorld::Ptr& actor, const osg::Vec3f&
     const float distToTarget = distance(position, dest);
     const bool isDestReached = (distToTarget <= destTolerance);
 
-    if (!isDestReached && mTimer > AI_REACTION_TIME)
+    // a path found in the background replaces the one followed meanwhile
+    if (mPathFinder.hasPendingPath() && mPathFinder.updatePendingPath(actor, getPathGridGraph(actor.getCell())))
     {
+        mRotateOnTheRunChecks = 3;
+
+        if (!mPathFinder.getPath().empty() && distance(dest, mPathFinder.getPath().back()) > 100)
+            mPathFinder.addPointToPath(dest);
+    }
+
+    AiScheduler& scheduler = MWBase::Environment::get().getMechanicsManager()->getAiScheduler();
+    if (!isDestReached && scheduler.isDecisionDue(actor, mTimer))
+    {
+        AiScheduler::Decision decision(scheduler);
+
         if (actor.getClass().isBipedal(actor))
             openDoors(actor);
 
@@ -113,7 +129,7 @@ bool MWMechanics::AiPackage::pathTo(const MWWorld::Ptr& actor, const osg::Vec3f&
             if (wasShortcutting || doesPathNeedRecalc(dest, actor)) // if need to rebuild path
             {
                 const auto pathfindingHalfExtents = world->getPathfindingHalfExtents(actor);
-                mPathFinder.buildPath(actor, position, dest, actor.getCell(), getPathGridGraph(actor.getCell()),
+                mPathFinder.buildPathAsync(actor, position, dest, actor.getCell(), getPathGridGraph(actor.getCell()),
                     pathfindingHalfExtents, getNavigatorFlags(actor), getAreaCosts(actor));
                 mRotateOnTheRunChecks = 3;
 
@@ -168,11 +184,32 @@ bool MWMechanics::AiPackage::pathTo(const MWWorld::Ptr& actor, const osg::Vec3f&
         if (mRotateOnTheRunChecks > 0) mRotateOnTheRunChecks--;
     }
 
-    // turn to next path point by X,Z axes
-    zTurn(actor, mPathFinder.getZAngleToNext(position.x(), position.y()));
-    smoothTurn(actor, mPathFinder.getXAngleToNext(position.x(), position.y(), position.z()), 0);
-
     const auto destination = mPathFinder.getPath().empty() ? dest : mPathFinder.getPath().front();
+
+    // actors on the ground may follow the velocity of their crowd, it already avoids other actors.
+    // The crowd slows down close to its target, so it steers to the end of the path rather than to the next point.
+    boost::optional<osg::Vec3f> velocity;
+    if (!canActorMoveByZAxis(actor))
+        velocity = MWBase::Environment::get().getMechanicsManager()->getCrowdSteering()
+            .steer(actor, mPathFinder.getPath().empty() ? dest : mPathFinder.getPath().back(), getNavigatorFlags(actor));
+
+    if (velocity)
+    {
+        // slowing down or waiting for others to pass is a part of the avoidance
+        const float maxSpeed = actor.getClass().getMaxSpeed(actor);
+        float& forward = actor.getClass().getMovementSettings(actor).mPosition[1];
+        forward = maxSpeed > 0 ? forward * std::min(1.f, velocity->length() / maxSpeed) : 0;
+        if (velocity->length2() > 0)
+            zTurn(actor, getZAngleToDir(*velocity));
+    }
+    else
+    {
+        // turn to next path point by X,Z axes
+        zTurn(actor, mPathFinder.getZAngleToNext(position.x(), position.y()));
+        smoothTurn(actor, mPathFinder.getXAngleToNext(position.x(), position.y(), position.z()), 0);
+    }
+
+    // obstacles not on the navmesh are not avoided by the crowd
     mObstacleCheck.update(actor, destination, duration);
 
     // handle obstacles on the way
@@ -261,7 +298,8 @@ const MWMechanics::PathgridGraph& MWMechanics::AiPackage::getPathGridGraph(const
     CacheMap::iterator found = cache.find(id);
     if (found == cache.end())
     {
-        cache.insert(std::make_pair(id, std::make_unique<MWMechanics::PathgridGraph>(MWMechanics::PathgridGraph(cell))));
+        const ESM::Pathgrid* pathgrid = MWBase::Environment::get().getWorld()->getStore().get<ESM::Pathgrid>().search(*cell->getCell());
+        cache.insert(std::make_pair(id, std::make_unique<MWMechanics::PathgridGraph>(pathgrid)));
     }
     return *cache[id].get();
 }
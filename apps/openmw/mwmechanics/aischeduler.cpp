@@ -0,0 +1,96 @@
+#include "aischeduler.hpp"
+
+#include <osg/Stats>
+
+#include <components/settings/settings.hpp>
+
+#include "../mwworld/class.hpp"
+#include "../mwworld/ptr.hpp"
+
+#include "aipackage.hpp"
+#include "aisequence.hpp"
+#include "creaturestats.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // decisions are made regardless of the budget once this many periods have passed
+    constexpr float maxLateness = 2;
+}
+
+namespace MWMechanics
+{
+    AiScheduler::AiScheduler()
+        : mMaxReactionTime(std::max(AI_REACTION_TIME, Settings::Manager::getFloat("ai max reaction time", "Game")))
+        , mBudget(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<float, std::milli>(std::max(0.f, Settings::Manager::getFloat("ai decision budget", "Game")))))
+        , mProcessingRange(0)
+        , mTimeSpent(0)
+        , mDecisions(0)
+        , mDeferred(0)
+    {
+    }
+
+    void AiScheduler::update(const osg::Vec3f& playerPosition, float processingRange)
+    {
+        mPlayerPosition = playerPosition;
+        mProcessingRange = processingRange;
+        mTimeSpent = std::chrono::steady_clock::duration::zero();
+        mDecisions = 0;
+        mDeferred = 0;
+    }
+
+    float AiScheduler::getReactionTime(const MWWorld::Ptr& actor) const
+    {
+        if (mMaxReactionTime <= AI_REACTION_TIME || mProcessingRange <= 0)
+            return AI_REACTION_TIME;
+
+        const float distance = (actor.getRefData().getPosition().asVec3() - mPlayerPosition).length();
+        const float ratio = std::min(distance / mProcessingRange, 1.f);
+        // keep actors close to the player at the original reaction time
+        float delay = (mMaxReactionTime - AI_REACTION_TIME) * ratio * ratio;
+        // fights far away from the player still need to look like fights when the player arrives
+        if (actor.getClass().getCreatureStats(actor).getAiSequence().isInCombat())
+            delay *= 0.5f;
+
+        return AI_REACTION_TIME + delay;
+    }
+
+    bool AiScheduler::isDecisionDue(const MWWorld::Ptr& actor, float timer)
+    {
+        if (timer < AI_REACTION_TIME)
+            return false;
+        const float reactionTime = getReactionTime(actor);
+        if (timer < reactionTime)
+            return false;
+        return hasBudget(timer / reactionTime);
+    }
+
+    bool AiScheduler::hasBudget(float lateness)
+    {
+        // actors that come last in the update order would never decide under a steady overload otherwise
+        if (mBudget == std::chrono::steady_clock::duration::zero() || mTimeSpent < mBudget || lateness >= maxLateness)
+            return true;
+        ++mDeferred;
+        return false;
+    }
+
+    void AiScheduler::reportStats(unsigned int frameNumber, osg::Stats& stats) const
+    {
+        stats.setAttribute(frameNumber, "AI Decisions", mDecisions);
+        stats.setAttribute(frameNumber, "AI Deferred", mDeferred);
+    }
+
+    AiScheduler::Decision::Decision(AiScheduler& scheduler)
+        : mScheduler(scheduler)
+        , mStart(std::chrono::steady_clock::now())
+    {
+    }
+
+    AiScheduler::Decision::~Decision()
+    {
+        mScheduler.mTimeSpent += std::chrono::steady_clock::now() - mStart;
+        ++mScheduler.mDecisions;
+    }
+}
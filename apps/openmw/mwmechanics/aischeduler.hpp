@@ -0,0 +1,70 @@
+#ifndef GAME_MWMECHANICS_AISCHEDULER_H
+#define GAME_MWMECHANICS_AISCHEDULER_H
+
+#include <osg/Vec3f>
+
+#include <chrono>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace MWWorld
+{
+    class Ptr;
+}
+
+namespace MWMechanics
+{
+    /// @brief Spreads the expensive decisions of AI packages over frames, e.g. choosing a combat action or building a
+    /// path, while steering still runs every frame.
+    /// @par An actor decides again once its reaction time has passed, which grows with the distance to the player and
+    /// half as fast for actors in combat. Decisions that are due wait for a following frame once the decisions of the
+    /// current frame took longer than the budget, unless twice their period has passed since the previous decision.
+    class AiScheduler
+    {
+    public:
+        AiScheduler();
+
+        /// Start a new frame.
+        void update(const osg::Vec3f& playerPosition, float processingRange);
+
+        /// @return Time between two decisions of the actor, never less than AI_REACTION_TIME.
+        float getReactionTime(const MWWorld::Ptr& actor) const;
+
+        /// @param timer Time since the last decision of the actor.
+        /// @return true if the actor should decide now.
+        bool isDecisionDue(const MWWorld::Ptr& actor, float timer);
+
+        /// @param lateness Time since the previous decision relative to the period of the decisions.
+        /// @return true if the budget of this frame allows another decision or the decision is too late to wait.
+        bool hasBudget(float lateness);
+
+        void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
+
+        /// @brief Accounts the time of a decision to the budget of the frame.
+        class Decision
+        {
+        public:
+            explicit Decision(AiScheduler& scheduler);
+
+            ~Decision();
+
+        private:
+            AiScheduler& mScheduler;
+            std::chrono::steady_clock::time_point mStart;
+        };
+
+    private:
+        float mMaxReactionTime;
+        std::chrono::steady_clock::duration mBudget;
+        osg::Vec3f mPlayerPosition;
+        float mProcessingRange;
+        std::chrono::steady_clock::duration mTimeSpent;
+        unsigned int mDecisions;
+        unsigned int mDeferred;
+    };
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include "creaturestats.hpp"
 #include "movement.hpp"
 #include "actorutil.hpp"
+#include "aischeduler.hpp"
 
 namespace MWMechanics
 {
@@ -224,9 +225,11 @@ namespace MWMechanics
 
         float& lastReaction = storage.mReaction;
         lastReaction += duration;
-        if (AI_REACTION_TIME <= lastReaction)
+        AiScheduler& scheduler = MWBase::Environment::get().getMechanicsManager()->getAiScheduler();
+        if (scheduler.isDecisionDue(actor, lastReaction))
         {
             lastReaction = 0;
+            AiScheduler::Decision decision(scheduler);
             return reactionTimeActions(actor, storage, pos);
         }
         else
@@ -27,6 +27,7 @@ namespace MWMechanics
     {
         for (int i=0; i<4; ++i)
             mAiSettings[i] = 0;
+        mMagicEffectsSources.fill(0);
     }
 
     const AiSequence& CreatureStats::getAiSequence() const
@@ -215,6 +216,26 @@ namespace MWMechanics
         mMagicEffects.setModifiers(effects);
     }
 
+    void CreatureStats::modifyMagicEffects(const MagicEffects &spellEffects, const MagicEffects *equipmentEffects,
+                                           const MagicEffects &activeEffects)
+    {
+        const std::size_t equipmentRevision = equipmentEffects ? equipmentEffects->getRevision() : 0;
+        if (mMagicEffectsSources[0] == spellEffects.getRevision() && mMagicEffectsSources[1] == equipmentRevision
+                && mMagicEffectsSources[2] == activeEffects.getRevision()
+                && mMagicEffectsSources[3] == mMagicEffects.getRevision())
+            return;
+
+        MagicEffects now = spellEffects;
+        if (equipmentEffects)
+            now += *equipmentEffects;
+        now += activeEffects;
+
+        modifyMagicEffects(now);
+
+        mMagicEffectsSources = {{spellEffects.getRevision(), equipmentRevision, activeEffects.getRevision(),
+                                 mMagicEffects.getRevision()}};
+    }
+
     void CreatureStats::setAiSetting (AiSetting index, Stat<int> value)
     {
         mAiSettings[index] = value;
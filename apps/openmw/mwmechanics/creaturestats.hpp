@@ -1,6 +1,7 @@
 #ifndef GAME_MWMECHANICS_CREATURESTATS_H
 #define GAME_MWMECHANICS_CREATURESTATS_H
 
+#include <array>
 #include <set>
 #include <string>
 #include <stdexcept>
@@ -42,6 +43,8 @@ namespace MWMechanics
         Spells mSpells;
         ActiveSpells mActiveSpells;
         MagicEffects mMagicEffects;
+        // Revisions of the effects of spells, equipment, active spells and mMagicEffects after they were combined
+        std::array<std::size_t, 4> mMagicEffectsSources;
         Stat<int> mAiSettings[4];
         AiSequence mAiSequence;
         bool mDead;
@@ -153,6 +156,12 @@ namespace MWMechanics
         /// Set Modifier for each magic effect according to \a effects. Does not touch Base values.
         void modifyMagicEffects(const MagicEffects &effects);
 
+        /// Set Modifier for each magic effect to the sum of all sources. Does nothing if neither the sources
+        /// nor the magic effects of this actor changed since the last call.
+        /// \param equipmentEffects may be nullptr for actors without inventory store.
+        void modifyMagicEffects(const MagicEffects &spellEffects, const MagicEffects *equipmentEffects,
+                                const MagicEffects &activeEffects);
+
         void setAttackingOrSpell(bool attackingOrSpell);
 
         void setLevel(int level);
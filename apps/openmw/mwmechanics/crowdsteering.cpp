@@ -0,0 +1,70 @@
+#include "crowdsteering.hpp"
+
+#include <osg/Stats>
+
+#include <components/detournavigator/navigator.hpp>
+#include <components/settings/settings.hpp>
+
+#include "../mwbase/environment.hpp"
+#include "../mwbase/world.hpp"
+
+#include "../mwworld/class.hpp"
+#include "../mwworld/ptr.hpp"
+
+namespace MWMechanics
+{
+    CrowdSteering::CrowdSteering()
+        : mEnabled(Settings::Manager::getBool("enable crowd steering", "Navigator"))
+    {
+    }
+
+    boost::optional<osg::Vec3f> CrowdSteering::steer(const MWWorld::Ptr& actor, const osg::Vec3f& target,
+                                                     DetourNavigator::Flags flags)
+    {
+        if (!mEnabled)
+            return boost::none;
+
+        const MWBase::World* world = MWBase::Environment::get().getWorld();
+        const auto navigator = world->getNavigator();
+        const osg::Vec3f halfExtents = world->getPathfindingHalfExtents(actor);
+
+        auto crowd = mCrowds.find(halfExtents);
+        if (crowd == mCrowds.end())
+            crowd = mCrowds.emplace(halfExtents, DetourNavigator::Crowd(navigator->getSettings(), halfExtents)).first;
+
+        const DetourNavigator::ObjectId id(actor.mRef);
+        crowd->second.setAgent(id, actor.getRefData().getPosition().asVec3(), target,
+            actor.getClass().getMaxSpeed(actor), flags);
+
+        return crowd->second.getVelocity(id);
+    }
+
+    void CrowdSteering::update(float duration)
+    {
+        if (!mEnabled)
+            return;
+
+        const auto navigator = MWBase::Environment::get().getWorld()->getNavigator();
+        for (auto it = mCrowds.begin(); it != mCrowds.end();)
+        {
+            it->second.update(navigator->getNavMesh(it->first), duration);
+            if (it->second.getAgentsCount() == 0)
+                it = mCrowds.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    void CrowdSteering::clear()
+    {
+        mCrowds.clear();
+    }
+
+    void CrowdSteering::reportStats(unsigned int frameNumber, osg::Stats& stats) const
+    {
+        std::size_t agents = 0;
+        for (const auto& crowd : mCrowds)
+            agents += crowd.second.getAgentsCount();
+        stats.setAttribute(frameNumber, "AI Crowd Agents", agents);
+    }
+}
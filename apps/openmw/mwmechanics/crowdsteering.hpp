@@ -0,0 +1,51 @@
+#ifndef GAME_MWMECHANICS_CROWDSTEERING_H
+#define GAME_MWMECHANICS_CROWDSTEERING_H
+
+#include <components/detournavigator/crowd.hpp>
+
+#include <osg/Vec3f>
+
+#include <boost/optional.hpp>
+
+#include <map>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace MWWorld
+{
+    class Ptr;
+}
+
+namespace MWMechanics
+{
+    /// @brief Steers actors following their paths as crowds, so they avoid each other instead of getting stuck and
+    /// evading obstacles by trial and error.
+    /// @par Actors are grouped by their pathfinding half extents, each group is a separate crowd over its navmesh.
+    /// An actor leaves its crowd when it stops asking for steering.
+    class CrowdSteering
+    {
+    public:
+        CrowdSteering();
+
+        bool isEnabled() const { return mEnabled; }
+
+        /// @param target End of the path of the actor, the crowd slows the actor down close to it.
+        /// @return Velocity to follow, found by the last update, or none if the actor is not steered yet.
+        boost::optional<osg::Vec3f> steer(const MWWorld::Ptr& actor, const osg::Vec3f& target, DetourNavigator::Flags flags);
+
+        void update(float duration);
+
+        void clear();
+
+        void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
+
+    private:
+        bool mEnabled;
+        std::map<osg::Vec3f, DetourNavigator::Crowd> mCrowds;
+    };
+}
+
+#endif
@@ -1,10 +1,16 @@
 #include "magiceffects.hpp"
 
+#include <atomic>
 #include <stdexcept>
 
 #include <components/esm/effectlist.hpp>
 #include <components/esm/magiceffects.hpp>
 
+namespace
+{
+    std::atomic<std::size_t> lastRevision(0);
+}
+
 namespace MWMechanics
 {
     EffectKey::EffectKey() : mId (0), mArg (-1) {}
@@ -84,9 +90,20 @@ namespace MWMechanics
         return *this;
     }
 
+    MagicEffects::MagicEffects()
+    {
+        changed();
+    }
+
+    void MagicEffects::changed()
+    {
+        mRevision = ++lastRevision;
+    }
+
     void MagicEffects::remove(const EffectKey &key)
     {
         mCollection.erase(key);
+        changed();
     }
 
     void MagicEffects::add (const EffectKey& key, const EffectParam& param)
@@ -101,11 +118,14 @@ namespace MWMechanics
         {
             iter->second += param;
         }
+
+        changed();
     }
 
     void MagicEffects::modifyBase(const EffectKey &key, int diff)
     {
         mCollection[key].modifyBase(diff);
+        changed();
     }
 
     void MagicEffects::setModifiers(const MagicEffects &effects)
@@ -119,6 +139,8 @@ namespace MWMechanics
         {
             mCollection[it->first].setModifier(it->second.getModifier());
         }
+
+        changed();
     }
 
     MagicEffects& MagicEffects::operator+= (const MagicEffects& effects)
@@ -140,6 +162,8 @@ namespace MWMechanics
                 mCollection.insert (*iter);
         }
 
+        changed();
+
         return *this;
     }
 
@@ -210,5 +234,7 @@ namespace MWMechanics
         {
             mCollection[EffectKey(it->first)].setBase(it->second);
         }
+
+        changed();
     }
 }
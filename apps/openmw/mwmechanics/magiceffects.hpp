@@ -1,6 +1,7 @@
 #ifndef GAME_MWMECHANICS_MAGICEFFECTS_H
 #define GAME_MWMECHANICS_MAGICEFFECTS_H
 
+#include <cstddef>
 #include <map>
 #include <string>
 
@@ -89,9 +90,14 @@ namespace MWMechanics
         private:
 
             Collection mCollection;
+            std::size_t mRevision;
+
+            void changed();
 
         public:
 
+            MagicEffects();
+
             Collection::const_iterator begin() const { return mCollection.begin(); }
 
             Collection::const_iterator end() const { return mCollection.end(); }
@@ -114,6 +120,9 @@ namespace MWMechanics
 
             static MagicEffects diff (const MagicEffects& prev, const MagicEffects& now);
             ///< Return changes from \a prev to \a now.
+
+            std::size_t getRevision() const { return mRevision; }
+            ///< Unique among all effects ever changed, copies keep it until they are changed. Never 0.
     };
 }
 
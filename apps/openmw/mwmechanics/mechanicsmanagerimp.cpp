@@ -276,6 +276,12 @@ namespace MWMechanics
             mObjects.updateObject(old, ptr);
     }
 
+    void MechanicsManager::updatePosition(const MWWorld::Ptr& ptr)
+    {
+        if(ptr.getClass().isActor())
+            mActors.updatePosition(ptr);
+    }
+
     void MechanicsManager::drop(const MWWorld::CellStore *cellStore)
     {
         mActors.dropActors(cellStore, getPlayer());
@@ -337,7 +343,10 @@ namespace MWMechanics
             mActors.addActor(ptr, true);
         }
 
+        mAiScheduler.update(ptr.getRefData().getPosition().asVec3(), mActors.getProcessingRange());
         mActors.update(duration, paused);
+        if (!paused)
+            mCrowdSteering.update(duration);
         mObjects.update(duration, paused);
     }
 
@@ -412,6 +421,11 @@ namespace MWMechanics
         return mActors.getHoursToRest(getPlayer());
     }
 
+    int MechanicsManager::getHoursToDeath(int hours, bool sleep) const
+    {
+        return mActors.getHoursToDeath(getPlayer(), hours, sleep);
+    }
+
     void MechanicsManager::setPlayerName (const std::string& name)
     {
         MWBase::World *world = MWBase::Environment::get().getWorld();
@@ -1602,16 +1616,16 @@ namespace MWMechanics
             if (ptr.getClass().isClass(ptr, "Guard"))
             {
                 stats.setHitAttemptActorId(target.getClass().getCreatureStats(target).getActorId()); // Stops guard from ending combat if player is unreachable
-                for (Actors::PtrActorMap::const_iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
+                for (Actors::ActorList::const_iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
                 {
-                    if (iter->first.getClass().isClass(iter->first, "Guard"))
+                    if (iter->getPtr().getClass().isClass(iter->getPtr(), "Guard"))
                     {
-                        MWMechanics::AiSequence& aiSeq = iter->first.getClass().getCreatureStats(iter->first).getAiSequence();
+                        MWMechanics::AiSequence& aiSeq = iter->getPtr().getClass().getCreatureStats(iter->getPtr()).getAiSequence();
                         if (aiSeq.getTypeId() == MWMechanics::AiPackageTypeId::Pursue)
                         {
                             aiSeq.stopPursuit();
                             aiSeq.stack(MWMechanics::AiCombat(target), ptr);
-                            iter->first.getClass().getCreatureStats(iter->first).setHitAttemptActorId(target.getClass().getCreatureStats(target).getActorId()); // Stops guard from ending combat if player is unreachable
+                            iter->getPtr().getClass().getCreatureStats(iter->getPtr()).setHitAttemptActorId(target.getClass().getCreatureStats(target).getActorId()); // Stops guard from ending combat if player is unreachable
                         }
                     }
                 }
@@ -1701,6 +1715,7 @@ namespace MWMechanics
     void MechanicsManager::clear()
     {
         mActors.clear();
+        mCrowdSteering.clear();
         mStolenItems.clear();
         mClassSelected = false;
         mRaceSelected = false;
@@ -1873,6 +1888,18 @@ namespace MWMechanics
     {
         stats.setAttribute(frameNumber, "Mechanics Actors", mActors.size());
         stats.setAttribute(frameNumber, "Mechanics Objects", mObjects.size());
+        mAiScheduler.reportStats(frameNumber, stats);
+        mCrowdSteering.reportStats(frameNumber, stats);
+    }
+
+    AiScheduler& MechanicsManager::getAiScheduler()
+    {
+        return mAiScheduler;
+    }
+
+    CrowdSteering& MechanicsManager::getCrowdSteering()
+    {
+        return mCrowdSteering;
     }
 
     int MechanicsManager::getGreetingTimer(const MWWorld::Ptr &ptr) const
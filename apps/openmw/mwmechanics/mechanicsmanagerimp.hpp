@@ -11,6 +11,8 @@
 #include "npcstats.hpp"
 #include "objects.hpp"
 #include "actors.hpp"
+#include "aischeduler.hpp"
+#include "crowdsteering.hpp"
 
 namespace MWWorld
 {
@@ -28,6 +30,8 @@ namespace MWMechanics
 
             Objects mObjects;
             Actors mActors;
+            AiScheduler mAiScheduler;
+            CrowdSteering mCrowdSteering;
 
             typedef std::pair<std::string, bool> Owner; // < Owner id, bool isFaction >
             typedef std::map<Owner, int> OwnerMap; // < Owner, number of stolen items with this id from this owner >
@@ -51,6 +55,9 @@ namespace MWMechanics
             virtual void updateCell(const MWWorld::Ptr &old, const MWWorld::Ptr &ptr) override;
             ///< Moves an object to a new cell
 
+            virtual void updatePosition(const MWWorld::Ptr& ptr) override;
+            ///< Notifies that an object was moved within the world
+
             virtual void drop(const MWWorld::CellStore *cellStore) override;
             ///< Deregister all objects in the given cell.
 
@@ -84,6 +91,9 @@ namespace MWMechanics
             virtual int getHoursToRest() const override;
             ///< Calculate how many hours the player needs to rest in order to be fully healed
 
+            virtual int getHoursToDeath(int hours, bool sleep) const override;
+            ///< Hour of a rest of the given length at which effects over time kill the player, 0 if the player survives
+
             virtual int getBarterOffer(const MWWorld::Ptr& ptr,int basePrice, bool buying) override;
             ///< This is used by every service to determine the price of objects given the trading skills of the player and NPC.
 
@@ -224,6 +234,10 @@ namespace MWMechanics
 
             virtual void reportStats(unsigned int frameNumber, osg::Stats& stats) const override;
 
+            virtual AiScheduler& getAiScheduler() override;
+
+            virtual CrowdSteering& getCrowdSteering() override;
+
             virtual int getGreetingTimer(const MWWorld::Ptr& ptr) const override;
             virtual float getAngleToPlayer(const MWWorld::Ptr& ptr) const override;
             virtual GreetingState getGreetingState(const MWWorld::Ptr& ptr) const override;
@@ -293,6 +293,7 @@ namespace MWMechanics
     void PathFinder::buildStraightPath(const osg::Vec3f& endPoint)
     {
         mPath.clear();
+        mPendingRequest = nullptr;
         mPath.push_back(endPoint);
         mConstructed = true;
     }
@@ -301,6 +302,7 @@ namespace MWMechanics
         const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph)
     {
         mPath.clear();
+        mPendingRequest = nullptr;
         mCell = cell;
 
         buildPathByPathgridImpl(startPoint, endPoint, pathgridGraph, std::back_inserter(mPath));
@@ -313,6 +315,7 @@ namespace MWMechanics
         const DetourNavigator::AreaCosts& areaCosts)
     {
         mPath.clear();
+        mPendingRequest = nullptr;
 
         // If it's not possible to build path over navmesh due to disabled navmesh generation fallback to straight path
         if (!buildPathByNavigatorImpl(actor, startPoint, endPoint, halfExtents, flags, areaCosts, std::back_inserter(mPath)))
@@ -326,6 +329,7 @@ namespace MWMechanics
         const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts)
     {
         mPath.clear();
+        mPendingRequest = nullptr;
         mCell = cell;
 
         bool hasNavMesh = false;
@@ -346,6 +350,54 @@ namespace MWMechanics
         mConstructed = true;
     }
 
+    void PathFinder::buildPathAsync(const MWWorld::ConstPtr& actor, const osg::Vec3f& startPoint,
+        const osg::Vec3f& endPoint, const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph,
+        const osg::Vec3f& halfExtents, const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts)
+    {
+        if (!isPathConstructed() || cell != mCell
+            || actor.getClass().isPureWaterCreature(actor) || actor.getClass().isPureFlyingCreature(actor))
+        {
+            buildPath(actor, startPoint, endPoint, cell, pathgridGraph, halfExtents, flags, areaCosts);
+            return;
+        }
+
+        // already looking for a path to there
+        if (mPendingRequest != nullptr && mPendingCell == cell && distance(mPendingRequest->getEnd(), endPoint) <= 10)
+            return;
+
+        const auto navigator = MWBase::Environment::get().getWorld()->getNavigator();
+        mPendingRequest = navigator->findPathAsync(halfExtents, getPathStepSize(actor), startPoint, endPoint, flags,
+                                                   areaCosts);
+        mPendingCell = cell;
+
+        // the navigator may find paths without background threads
+        updatePendingPath(actor, pathgridGraph);
+    }
+
+    bool PathFinder::updatePendingPath(const MWWorld::ConstPtr& actor, const PathgridGraph& pathgridGraph)
+    {
+        if (mPendingRequest == nullptr || !mPendingRequest->isDone())
+            return false;
+
+        const auto request = std::move(mPendingRequest);
+
+        if (request->getStatus() == DetourNavigator::Status::Success && !request->getPath().empty())
+        {
+            mPath = request->getPath();
+            mCell = mPendingCell;
+            mConstructed = true;
+            return true;
+        }
+
+        // the actor has left the cell, the next decision builds a new path anyway
+        if (mPendingCell != actor.getCell())
+            return false;
+
+        buildPath(actor, actor.getRefData().getPosition().asVec3(), request->getEnd(), mPendingCell, pathgridGraph,
+                  request->getAgentHalfExtents(), request->getIncludeFlags(), request->getAreaCosts());
+        return true;
+    }
+
     bool PathFinder::buildPathByNavigatorImpl(const MWWorld::ConstPtr& actor, const osg::Vec3f& startPoint,
         const osg::Vec3f& endPoint, const osg::Vec3f& halfExtents, const DetourNavigator::Flags flags,
         const DetourNavigator::AreaCosts& areaCosts, std::back_insert_iterator<std::deque<osg::Vec3f>> out)
@@ -4,12 +4,18 @@
 #include <deque>
 #include <cassert>
 #include <iterator>
+#include <memory>
 
 #include <components/detournavigator/flags.hpp>
 #include <components/detournavigator/areatype.hpp>
 #include <components/esm/defs.hpp>
 #include <components/esm/loadpgrd.hpp>
 
+namespace DetourNavigator
+{
+    class PathRequest;
+}
+
 namespace MWWorld
 {
     class CellStore;
@@ -75,6 +81,7 @@ namespace MWMechanics
             PathFinder()
                 : mConstructed(false)
                 , mCell(nullptr)
+                , mPendingCell(nullptr)
             {
             }
 
@@ -83,6 +90,7 @@ namespace MWMechanics
                 mConstructed = false;
                 mPath.clear();
                 mCell = nullptr;
+                mPendingRequest = nullptr;
             }
 
             void buildStraightPath(const osg::Vec3f& endPoint);
@@ -98,6 +106,22 @@ namespace MWMechanics
                 const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph, const osg::Vec3f& halfExtents,
                 const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts);
 
+            /// Like buildPath, but the path over navmesh is found in the background while the current path is
+            /// followed, see updatePendingPath. Builds the path at once when there is no current path in the cell.
+            void buildPathAsync(const MWWorld::ConstPtr& actor, const osg::Vec3f& startPoint, const osg::Vec3f& endPoint,
+                const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph, const osg::Vec3f& halfExtents,
+                const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts);
+
+            /// Replace the path by the one found in the background once it is ready. Falls back to buildPath from
+            /// the current position if no path over navmesh was found.
+            /// @return true if the path was replaced
+            bool updatePendingPath(const MWWorld::ConstPtr& actor, const PathgridGraph& pathgridGraph);
+
+            bool hasPendingPath() const
+            {
+                return mPendingRequest != nullptr;
+            }
+
             void buildPathByNavMeshToNextPoint(const MWWorld::ConstPtr& actor, const osg::Vec3f& halfExtents,
                 const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts);
 
@@ -200,6 +224,9 @@ namespace MWMechanics
 
             const MWWorld::CellStore* mCell;
 
+            std::shared_ptr<const DetourNavigator::PathRequest> mPendingRequest;
+            const MWWorld::CellStore* mPendingCell;
+
             void buildPathByPathgridImpl(const osg::Vec3f& startPoint, const osg::Vec3f& endPoint,
                 const PathgridGraph& pathgridGraph, std::back_insert_iterator<std::deque<osg::Vec3f>> out);
 
@@ -1,10 +1,9 @@
 #include "pathgrid.hpp"
 
-#include "../mwbase/world.hpp"
-#include "../mwbase/environment.hpp"
-
-#include "../mwworld/cellstore.hpp"
-#include "../mwworld/esmstore.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
 
 namespace
 {
@@ -45,19 +44,22 @@ namespace
         //return distance(a, b);
         return manhattan(a, b);
     }
+
+    // Pathgrids with up to this many points keep routing tables, which take
+    // one index per point for each end point used
+    const std::size_t maxRoutingTablePoints = 256;
 }
 
 namespace MWMechanics
 {
-    PathgridGraph::PathgridGraph(const MWWorld::CellStore *cell)
-        : mCell(nullptr)
-        , mPathgrid(nullptr)
+    PathgridGraph::PathgridGraph(const ESM::Pathgrid* pathgrid)
+        : mPathgrid(nullptr)
         , mGraph(0)
         , mIsGraphConstructed(false)
         , mSCCId(0)
         , mSCCIndex(0)
     {
-        load(cell);
+        load(pathgrid);
     }
 
     /*
@@ -96,18 +98,15 @@ namespace MWMechanics
      *    +---------------->
      *      high cost
      */
-    bool PathgridGraph::load(const MWWorld::CellStore *cell)
+    bool PathgridGraph::load(const ESM::Pathgrid* pathgrid)
     {
-        if(!cell)
+        if(!pathgrid)
             return false;
 
         if(mIsGraphConstructed)
             return true;
 
-        mCell = cell->getCell();
-        mPathgrid = MWBase::Environment::get().getWorld()->getStore().get<ESM::Pathgrid>().search(*cell->getCell());
-        if(!mPathgrid)
-            return false;
+        mPathgrid = pathgrid;
 
 
         mGraph.resize(mPathgrid->mPoints.size());
@@ -119,6 +118,9 @@ namespace MWMechanics
             // forward path of the edge
             neighbour.index = mPathgrid->mEdges[i].mV1;
             mGraph[mPathgrid->mEdges[i].mV0].edges.push_back(neighbour);
+            // the same edge seen from its end to build routing tables
+            neighbour.index = mPathgrid->mEdges[i].mV0;
+            mGraph[mPathgrid->mEdges[i].mV1].reverseEdges.push_back(neighbour);
             // reverse path of the edge
             // NOTE: These are redundant, ESM already contains the required reverse paths
             //neighbour.index = mPathgrid->mEdges[i].mV0;
@@ -228,32 +230,126 @@ namespace MWMechanics
         }
     }
 
+    /*
+     * Builds the routing table of the end point with Dijkstra's algorithm
+     * along the reversed edges, starting at the end point. The point each
+     * point is reached from is the next point on its shortest path to the end
+     * point.
+     *
+     * Variables:
+     *   mOpenSet - heap of point indexes to be traversed, lowest cost at the front
+     *   mClosed - point indexes already traversed
+     *   mCosts - accumulated costs to the end point indexed by point index
+     */
+    const std::vector<int>& PathgridGraph::getRoutingTable(int end) const
+    {
+        if (mRoutingTables.empty())
+            mRoutingTables.resize(mGraph.size());
+
+        std::vector<int>& table = mRoutingTables[end];
+        if (!table.empty())
+            return table;
+
+        const std::size_t graphSize = mGraph.size();
+        table.assign(graphSize, -1);
+        mCosts.assign(graphSize, std::numeric_limits<float>::max());
+        mClosed.assign(graphSize, false);
+        mOpenSet.clear();
+
+        const std::greater<OpenPoint> lowestCostFirst;
+        mCosts[end] = 0;
+        mOpenSet.emplace_back(0, end);
+
+        while (!mOpenSet.empty())
+        {
+            std::pop_heap(mOpenSet.begin(), mOpenSet.end(), lowestCostFirst);
+            const int current = mOpenSet.back().second;
+            mOpenSet.pop_back();
+
+            if (mClosed[current])
+                continue; // already traversed with a lower cost
+            mClosed[current] = true;
+
+            for (const ConnectedPoint& edge : mGraph[current].reverseEdges)
+            {
+                const float cost = mCosts[current] + edge.cost;
+                if (mClosed[edge.index] || cost >= mCosts[edge.index])
+                    continue;
+                mCosts[edge.index] = cost;
+                table[edge.index] = current;
+                mOpenSet.emplace_back(cost, edge.index);
+                std::push_heap(mOpenSet.begin(), mOpenSet.end(), lowestCostFirst);
+            }
+        }
+
+        return table;
+    }
+
     /*
      * NOTE: Based on buildPath2(), please check git history if interested
-     *       Should consider using a 3rd party library version (e.g. boost)
      *
      * Find the shortest path to the target goal using a well known algorithm.
      * Uses mGraph which has pre-computed costs for allowed edges.  It is assumed
      * that mGraph is already constructed.
      *
-     * Should be possible to make this MT safe.
-     *
-     * Returns path which may be empty.  path contains pathgrid points in local
-     * cell coordinates (indoors) or world coordinates (external).
+     * Returns true if the goal was reached, mParents then has the previous
+     * point on the path for each point of it.
      *
      * Input params:
      *   start, goal - pathgrid point indexes (for this cell)
      *
      * Variables:
-     *   openset - point indexes to be traversed, lowest cost at the front
-     *   closedset - point indexes already traversed
-     *   gScore - past accumulated costs vector indexed by point index
-     *   fScore - future estimated costs vector indexed by point index
+     *   mOpenSet - heap of point indexes to be traversed, lowest estimated cost at the front
+     *   mClosed - point indexes already traversed
+     *   mCosts - past accumulated costs indexed by point index
+     */
+    bool PathgridGraph::search(int start, int goal) const
+    {
+        const std::size_t graphSize = mGraph.size();
+        mCosts.assign(graphSize, std::numeric_limits<float>::max());
+        mParents.assign(graphSize, -1);
+        mClosed.assign(graphSize, false);
+        mOpenSet.clear();
+
+        const std::greater<OpenPoint> lowestCostFirst;
+        mCosts[start] = 0;
+        mOpenSet.emplace_back(costAStar(mPathgrid->mPoints[start], mPathgrid->mPoints[goal]), start);
+
+        while (!mOpenSet.empty())
+        {
+            std::pop_heap(mOpenSet.begin(), mOpenSet.end(), lowestCostFirst);
+            const int current = mOpenSet.back().second;
+            mOpenSet.pop_back();
+
+            if (current == goal)
+                return true;
+
+            if (mClosed[current])
+                continue; // already traversed with a lower cost
+            mClosed[current] = true;
+
+            for (const ConnectedPoint& edge : mGraph[current].edges)
+            {
+                const float cost = mCosts[current] + edge.cost;
+                if (mClosed[edge.index] || cost >= mCosts[edge.index])
+                    continue;
+                mCosts[edge.index] = cost;
+                mParents[edge.index] = current;
+                mOpenSet.emplace_back(cost + costAStar(mPathgrid->mPoints[edge.index], mPathgrid->mPoints[goal]),
+                                      edge.index);
+                std::push_heap(mOpenSet.begin(), mOpenSet.end(), lowestCostFirst);
+            }
+        }
+
+        return false;
+    }
+
+    /*
+     * Returns path which may be empty.  path contains pathgrid points in local
+     * cell coordinates (indoors) or world coordinates (external).
      *
-     * TODO: An intersting exercise might be to cache the paths created for a
-     *       start/goal pair.  To cache the results the paths need to be in
-     *       pathgrid points form (currently they are converted to world
-     *       coordinates).  Essentially trading speed w/ memory.
+     * Most pathgrids are small enough to keep the shortest paths to every end
+     * point that was used once, wandering actors keep choosing the same few.
      */
     std::deque<ESM::Pathgrid::Point> PathgridGraph::aStarSearch(const int start, const int goal) const
     {
@@ -263,78 +359,27 @@ namespace MWMechanics
             return path; // there is no path, return an empty path
         }
 
-        int graphSize = static_cast<int> (mGraph.size());
-        std::vector<float> gScore (graphSize, -1);
-        std::vector<float> fScore (graphSize, -1);
-        std::vector<int> graphParent (graphSize, -1);
-
-        // gScore & fScore keep costs for each pathgrid point in mPoints
-        gScore[start] = 0;
-        fScore[start] = costAStar(mPathgrid->mPoints[start], mPathgrid->mPoints[goal]);
-
-        std::list<int> openset;
-        std::list<int> closedset;
-        openset.push_back(start);
-
-        int current = -1;
-
-        while(!openset.empty())
+        if (mGraph.size() <= maxRoutingTablePoints)
         {
-            current = openset.front(); // front has the lowest cost
-            openset.pop_front();
-
-            if(current == goal)
-                break;
-
-            closedset.push_back(current); // remember we've been here
-
-            // check all edges for the current point index
-            for(int j = 0; j < static_cast<int> (mGraph[current].edges.size()); j++)
+            // start is strongly connected to goal, so every next point is too
+            const std::vector<int>& table = getRoutingTable(goal);
+            int current = start;
+            path.push_back(mPathgrid->mPoints[current]);
+            while (current != goal)
             {
-                if(std::find(closedset.begin(), closedset.end(), mGraph[current].edges[j].index) ==
-                   closedset.end())
-                {
-                    // not in closedset - i.e. have not traversed this edge destination
-                    int dest = mGraph[current].edges[j].index;
-                    float tentative_g = gScore[current] + mGraph[current].edges[j].cost;
-                    bool isInOpenSet = std::find(openset.begin(), openset.end(), dest) != openset.end();
-                    if(!isInOpenSet
-                        || tentative_g < gScore[dest])
-                    {
-                        graphParent[dest] = current;
-                        gScore[dest] = tentative_g;
-                        fScore[dest] = tentative_g + costAStar(mPathgrid->mPoints[dest],
-                                                               mPathgrid->mPoints[goal]);
-                        if(!isInOpenSet)
-                        {
-                            // add this edge to openset, lowest cost goes to the front
-                            // TODO: if this causes performance problems a hash table may help
-                            std::list<int>::iterator it = openset.begin();
-                            for(it = openset.begin(); it!= openset.end(); ++it)
-                            {
-                                if(fScore[*it] > fScore[dest])
-                                    break;
-                            }
-                            openset.insert(it, dest);
-                        }
-                    }
-                } // if in closedset, i.e. traversed this edge already, try the next edge
+                current = table[current];
+                path.push_back(mPathgrid->mPoints[current]);
             }
+            return path;
         }
 
-        if(current != goal)
+        if (!search(start, goal))
             return path; // for some reason couldn't build a path
 
         // reconstruct path to return, using local coordinates
-        while(graphParent[current] != -1)
-        {
+        for (int current = goal; current != -1; current = mParents[current])
             path.push_front(mPathgrid->mPoints[current]);
-            current = graphParent[current];
-        }
 
-        // add first node to path explicitly
-        path.push_front(mPathgrid->mPoints[start]);
         return path;
     }
 }
-
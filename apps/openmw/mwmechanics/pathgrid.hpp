@@ -2,27 +2,20 @@
 #define GAME_MWMECHANICS_PATHGRID_H
 
 #include <deque>
+#include <vector>
 
 #include <components/esm/loadpgrd.hpp>
 
-namespace ESM
-{
-    struct Cell;
-}
-
-namespace MWWorld
-{
-    class CellStore;
-}
-
 namespace MWMechanics
 {
     class PathgridGraph
     {
         public:
-            PathgridGraph(const MWWorld::CellStore* cell);
+            // pathgrid may be nullptr for cells without one, it has to
+            // outlive the graph
+            PathgridGraph(const ESM::Pathgrid* pathgrid);
 
-            bool load(const MWWorld::CellStore *cell);
+            bool load(const ESM::Pathgrid* pathgrid);
 
             const ESM::Pathgrid* getPathgrid() const;
 
@@ -37,12 +30,15 @@ namespace MWMechanics
             // the output list is in local (internal cells) or world (external
             // cells) coordinates
             //
-            // NOTE: if start equals end an empty path is returned
+            // NOTE: if start equals end a path of only that point is returned
+            //
+            // Small pathgrids answer from a routing table per end point built
+            // on its first use, larger ones run A*. Both reuse their working
+            // memory, so this is not MT safe.
             std::deque<ESM::Pathgrid::Point> aStarSearch(const int start, const int end) const;
 
         private:
 
-            const ESM::Cell *mCell;
             const ESM::Pathgrid *mPathgrid;
 
             struct ConnectedPoint // edge
@@ -55,6 +51,7 @@ namespace MWMechanics
             {
                 int componentId;
                 std::vector<ConnectedPoint> edges; // neighbours
+                std::vector<ConnectedPoint> reverseEdges; // neighbours with an edge to this point
             };
 
             // componentId is an integer indicating the groups of connected
@@ -78,6 +75,20 @@ namespace MWMechanics
             // methods used to calculate connected components
             void recursiveStrongConnect(int v);
             void buildConnectedPoints();
+
+            // next point on the shortest path to the end point for each
+            // point, indexed by end point, empty until first used
+            mutable std::vector<std::vector<int>> mRoutingTables;
+
+            // working memory of searches
+            typedef std::pair<float, int> OpenPoint; // first is cost, second is index
+            mutable std::vector<OpenPoint> mOpenSet;
+            mutable std::vector<float> mCosts;
+            mutable std::vector<int> mParents;
+            mutable std::vector<bool> mClosed;
+
+            const std::vector<int>& getRoutingTable(int end) const;
+            bool search(int start, int end) const;
     };
 }
 
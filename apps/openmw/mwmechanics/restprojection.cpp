@@ -0,0 +1,147 @@
+#include "restprojection.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    using MWMechanics::RestedDynamicStat;
+
+    struct HourlyChange
+    {
+        float mMax;
+        float mMin;
+        float mDepletedBelow;
+        float mRestore;
+        float mTick;
+    };
+
+    void deplete(RestedDynamicStat& result, int hour)
+    {
+        if (result.mDepletionHour == 0)
+            result.mDepletionHour = hour;
+    }
+
+    /// Hours after the given one until the stat falls below the depletion value, when it falls steadily
+    float getHoursToDepletion(float value, float change, float depletedBelow)
+    {
+        return std::floor((value - depletedBelow) / -change) + 1;
+    }
+
+    /// Rest the given number of hours with the same restoration and ticks in each of them
+    void rest(RestedDynamicStat& result, const HourlyChange& change, int hour, int hours)
+    {
+        float& value = result.mValue;
+
+        // Above the maximum neither restoration nor positive effects raise the stat
+        if (value > change.mMax)
+        {
+            if (change.mTick >= 0)
+                return;
+            const int above = std::min(hours, static_cast<int>(std::ceil((value - change.mMax) / -change.mTick)));
+            const float depletion = getHoursToDepletion(value, change.mTick, change.mDepletedBelow);
+            if (depletion <= above)
+                deplete(result, hour + static_cast<int>(depletion));
+            value = std::max(change.mMin, value + above * change.mTick);
+            hour += above;
+            hours -= above;
+            if (hours == 0)
+                return;
+        }
+
+        // The first hour may cut the restoration at the maximum
+        value = std::min(change.mMax, value + change.mRestore) + change.mTick;
+        if (change.mTick > 0)
+            value = std::min(change.mMax, value);
+        ++hour;
+        --hours;
+        if (value < change.mDepletedBelow)
+            deplete(result, hour);
+        value = std::max(change.mMin, value);
+        if (hours == 0)
+            return;
+
+        const float perHour = change.mRestore + change.mTick;
+        if (perHour <= 0)
+        {
+            // Falling steadily, the restoration does not reach the maximum anymore
+            if (perHour < 0 && value >= change.mDepletedBelow)
+            {
+                const float depletion = getHoursToDepletion(value, perHour, change.mDepletedBelow);
+                if (depletion <= hours)
+                    deplete(result, hour + static_cast<int>(depletion));
+            }
+            value = std::max(change.mMin, value + hours * perHour);
+            return;
+        }
+
+        if (change.mTick >= 0)
+        {
+            value = std::min(change.mMax, value + hours * perHour);
+            return;
+        }
+
+        // Rising until the restoration is cut at the maximum, from then on held at the maximum less the ticks
+        const float top = change.mMax + change.mTick;
+        const float rising = value + change.mRestore > change.mMax
+            ? 0 : std::floor((change.mMax - change.mRestore - value) / perHour) + 1;
+        if (hours <= rising)
+        {
+            value += hours * perHour;
+            return;
+        }
+        if (top < change.mDepletedBelow)
+            deplete(result, hour + static_cast<int>(rising) + 1);
+        value = std::max(change.mMin, top);
+    }
+
+    /// Part of the hour starting at the given one before the given time
+    float getPartBefore(float time, int hour)
+    {
+        return std::min(1.f, std::max(0.f, time - hour));
+    }
+}
+
+namespace MWMechanics
+{
+    RestedDynamicStat projectRest(const DynamicStatRest& stat, int hours)
+    {
+        // Every hour between these is the same. The hour an effect expires in or restoration starts in
+        // is only partially affected, so it is taken on its own.
+        std::vector<int> changes;
+        const auto addChange = [&] (float time)
+        {
+            changes.push_back(static_cast<int>(std::floor(time)));
+            changes.push_back(static_cast<int>(std::ceil(time)));
+        };
+        if (stat.mRestoreDelay > 0)
+            addChange(stat.mRestoreDelay);
+        for (const DynamicStatTick& tick : stat.mTicks)
+        {
+            if (tick.mHours >= 0)
+                addChange(tick.mHours);
+        }
+
+        RestedDynamicStat result {stat.mCurrent, 0};
+        int hour = 0;
+        while (hour < hours)
+        {
+            int next = hours;
+            for (const int change : changes)
+            {
+                if (change > hour)
+                    next = std::min(next, change);
+            }
+
+            HourlyChange change {stat.mMax, stat.mMin, stat.mDepletedBelow, 0, 0};
+            change.mRestore = stat.mRestorePerHour * (1 - getPartBefore(stat.mRestoreDelay, hour));
+            for (const DynamicStatTick& tick : stat.mTicks)
+                change.mTick += tick.mHours < 0 ? tick.mPerHour : tick.mPerHour * getPartBefore(tick.mHours, hour);
+
+            rest(result, change, hour, next - hour);
+            hour = next;
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef GAME_MWMECHANICS_RESTPROJECTION_H
+#define GAME_MWMECHANICS_RESTPROJECTION_H
+
+#include <vector>
+
+namespace MWMechanics
+{
+    /// Effect over time changing a dynamic stat while resting
+    struct DynamicStatTick
+    {
+        /// Change per game hour, negative for damage
+        float mPerHour;
+
+        /// Game hours until the effect expires, negative for a constant effect
+        float mHours;
+    };
+
+    /// \brief Dynamic stat of a resting actor
+    ///
+    /// Every hour the restoration is applied first and is cut at the maximum, then effects over time tick.
+    struct DynamicStatRest
+    {
+        float mCurrent;
+        float mMax;
+
+        /// Lowest value effects over time can bring the stat to
+        float mMin;
+
+        /// Value below which the stat counts as depleted
+        float mDepletedBelow;
+
+        float mRestorePerHour;
+
+        /// Game hours before restoration starts
+        float mRestoreDelay;
+
+        std::vector<DynamicStatTick> mTicks;
+    };
+
+    struct RestedDynamicStat
+    {
+        float mValue;
+
+        /// First hour at the end of which the stat was depleted, 0 if it was not
+        int mDepletionHour;
+    };
+
+    /// Result of resting the given number of hours one by one. The cost only depends on the number of ticks,
+    /// since hours without an effect expiring or restoration starting are taken together in closed form.
+    RestedDynamicStat projectRest(const DynamicStatRest& stat, int hours);
+}
+
+#endif
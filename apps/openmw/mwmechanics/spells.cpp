@@ -136,7 +136,7 @@ namespace MWMechanics
         }
     }
 
-    MagicEffects Spells::getMagicEffects() const
+    const MagicEffects& Spells::getMagicEffects() const
     {
         if (mSpellsChanged) {
             rebuildEffects();
@@ -24,6 +24,22 @@ namespace MWMechanics
         creatureStats.setDynamic(index, stat);
     }
 
+    float getSunDamageScale()
+    {
+        float time = MWBase::Environment::get().getWorld()->getTimeStamp().getHour();
+        float timeDiff = std::min(7.f, std::max(0.f, std::abs(time - 13)));
+        float damageScale = 1.f - timeDiff / 7.f;
+        // When cloudy, the sun damage effect is halved
+        static float fMagicSunBlockedMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find(
+                    "fMagicSunBlockedMult")->mValue.getFloat();
+
+        int weather = MWBase::Environment::get().getWorld()->getCurrentWeather();
+        if (weather > 1)
+            damageScale *= fMagicSunBlockedMult;
+
+        return damageScale;
+    }
+
     bool disintegrateSlot (const MWWorld::Ptr& ptr, int slot, float disintegrate)
     {
         if (!ptr.getClass().hasInventoryStore(ptr))
@@ -146,17 +162,7 @@ namespace MWMechanics
             // isInCell shouldn't be needed, but updateActor called during game start
             if (!actor.isInCell() || !actor.getCell()->isExterior())
                 break;
-            float time = MWBase::Environment::get().getWorld()->getTimeStamp().getHour();
-            float timeDiff = std::min(7.f, std::max(0.f, std::abs(time - 13)));
-            float damageScale = 1.f - timeDiff / 7.f;
-            // When cloudy, the sun damage effect is halved
-            static float fMagicSunBlockedMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find(
-                        "fMagicSunBlockedMult")->mValue.getFloat();
-
-            int weather = MWBase::Environment::get().getWorld()->getCurrentWeather();
-            if (weather > 1)
-                damageScale *= fMagicSunBlockedMult;
-
+            float damageScale = getSunDamageScale();
             adjustDynamicStat(creatureStats, 0, -magnitude * damageScale);
             if (magnitude * damageScale > 0.f)
                 receivedMagicDamage = true;
@@ -214,4 +220,34 @@ namespace MWMechanics
             MWBase::Environment::get().getWindowManager()->activateHitOverlay(false);
         return true;
     }
+
+    float getDynamicStatTick(const MWWorld::Ptr& actor, const EffectKey& effectKey, int index)
+    {
+        switch (effectKey.mId)
+        {
+        case ESM::MagicEffect::RestoreHealth:
+        case ESM::MagicEffect::RestoreMagicka:
+        case ESM::MagicEffect::RestoreFatigue:
+            return effectKey.mId - ESM::MagicEffect::RestoreHealth == index ? 1.f : 0.f;
+        case ESM::MagicEffect::DamageHealth:
+        case ESM::MagicEffect::DamageMagicka:
+        case ESM::MagicEffect::DamageFatigue:
+            return effectKey.mId - ESM::MagicEffect::DamageHealth == index ? -1.f : 0.f;
+        case ESM::MagicEffect::AbsorbHealth:
+        case ESM::MagicEffect::AbsorbMagicka:
+        case ESM::MagicEffect::AbsorbFatigue:
+            return effectKey.mId - ESM::MagicEffect::AbsorbHealth == index ? -1.f : 0.f;
+        case ESM::MagicEffect::FireDamage:
+        case ESM::MagicEffect::ShockDamage:
+        case ESM::MagicEffect::FrostDamage:
+        case ESM::MagicEffect::Poison:
+            return index == 0 ? -1.f : 0.f;
+        case ESM::MagicEffect::SunDamage:
+            if (index != 0 || !actor.isInCell() || !actor.getCell()->isExterior())
+                return 0.f;
+            return -getSunDamageScale();
+        default:
+            return 0.f;
+        }
+    }
 }
@@ -14,6 +14,9 @@ namespace MWMechanics
     /// Apply a magic effect that is applied in tick intervals until its remaining time ends or it is removed
     /// @return Was the effect a tickable effect with a magnitude?
     bool effectTick(CreatureStats& creatureStats, const MWWorld::Ptr& actor, const EffectKey& effectKey, float magnitude);
+
+    /// Change of the given dynamic stat per unit of magnitude of an effect over time, 0 if the effect does not change it
+    float getDynamicStatTick(const MWWorld::Ptr& actor, const EffectKey& effectKey, int index);
 }
 
 #endif
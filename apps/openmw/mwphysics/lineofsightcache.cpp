@@ -0,0 +1,63 @@
+#include "lineofsightcache.hpp"
+
+namespace MWPhysics
+{
+    LineOfSightCache::LineOfSightCache(float duration, float tolerance)
+        : mDuration(duration)
+        , mTolerance2(tolerance * tolerance)
+        , mTime(0)
+        , mHits(0)
+        , mMisses(0)
+        , mLastHits(0)
+        , mLastMisses(0)
+    {
+    }
+
+    void LineOfSightCache::update(float duration)
+    {
+        mTime += duration;
+        mLastHits = mHits;
+        mLastMisses = mMisses;
+        mHits = 0;
+        mMisses = 0;
+
+        for (auto it = mEntries.begin(); it != mEntries.end();)
+        {
+            if (it->second.mExpiry <= mTime)
+                it = mEntries.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    bool LineOfSightCache::get(const Actor* actor1, const osg::Vec3f& position1, const Actor* actor2,
+                               const osg::Vec3f& position2, bool& lineOfSight)
+    {
+        const bool swapped = actor2 < actor1;
+        const auto found = mEntries.find(swapped ? Key(actor2, actor1) : Key(actor1, actor2));
+        if (found == mEntries.end()
+                || (found->second.mPosition1 - (swapped ? position2 : position1)).length2() > mTolerance2
+                || (found->second.mPosition2 - (swapped ? position1 : position2)).length2() > mTolerance2)
+        {
+            ++mMisses;
+            return false;
+        }
+        ++mHits;
+        lineOfSight = found->second.mLineOfSight;
+        return true;
+    }
+
+    void LineOfSightCache::insert(const Actor* actor1, const osg::Vec3f& position1, const Actor* actor2,
+                                  const osg::Vec3f& position2, bool lineOfSight)
+    {
+        if (actor2 < actor1)
+            mEntries[Key(actor2, actor1)] = Entry {position2, position1, lineOfSight, mTime + mDuration};
+        else
+            mEntries[Key(actor1, actor2)] = Entry {position1, position2, lineOfSight, mTime + mDuration};
+    }
+
+    void LineOfSightCache::clear()
+    {
+        mEntries.clear();
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef OPENMW_MWPHYSICS_LINEOFSIGHTCACHE_H
+#define OPENMW_MWPHYSICS_LINEOFSIGHTCACHE_H
+
+#include <osg/Vec3f>
+
+#include <map>
+#include <utility>
+
+namespace MWPhysics
+{
+    class Actor;
+
+    /// @brief Remembers line of sight checks between pairs of actors for a short time.
+    /// @par A result is reused while neither actor moved further than the tolerance from where it was checked, so
+    /// the same pair checked several times within a frame, e.g. by awareness checks and AI packages, or over
+    /// consecutive frames needs a single ray. The ray between two positions is the same in both directions, so the
+    /// order of the actors does not matter.
+    class LineOfSightCache
+    {
+    public:
+        /// @param duration Time in seconds a result is kept.
+        /// @param tolerance Distance an actor may move before its results are checked again.
+        LineOfSightCache(float duration, float tolerance);
+
+        /// Advance the time by the duration of a frame and forget expired results.
+        void update(float duration);
+
+        /// @return true if a result is known for the actors at these positions, which is then assigned to lineOfSight.
+        bool get(const Actor* actor1, const osg::Vec3f& position1, const Actor* actor2, const osg::Vec3f& position2,
+                 bool& lineOfSight);
+
+        void insert(const Actor* actor1, const osg::Vec3f& position1, const Actor* actor2, const osg::Vec3f& position2,
+                    bool lineOfSight);
+
+        void clear();
+
+        std::size_t size() const { return mEntries.size(); }
+
+        /// @return Number of checks answered from the cache during the last frame.
+        unsigned int getHits() const { return mLastHits; }
+
+        /// @return Number of checks that needed a ray during the last frame.
+        unsigned int getMisses() const { return mLastMisses; }
+
+    private:
+        struct Entry
+        {
+            osg::Vec3f mPosition1;
+            osg::Vec3f mPosition2;
+            bool mLineOfSight;
+            float mExpiry;
+        };
+
+        typedef std::pair<const Actor*, const Actor*> Key;
+
+        float mDuration;
+        float mTolerance2;
+        float mTime;
+        std::map<Key, Entry> mEntries;
+        unsigned int mHits;
+        unsigned int mMisses;
+        unsigned int mLastHits;
+        unsigned int mLastMisses;
+    };
+}
+
+#endif
@@ -51,6 +51,14 @@
 #include "constants.hpp"
 #include "movementsolver.hpp"
 
+namespace
+{
+    // long enough to share rays between AI reactions, short enough to notice opened doors soon
+    const float lineOfSightCacheDuration = 0.25f;
+    // eye positions may move this far before a cached line of sight is checked again
+    const float lineOfSightCacheTolerance = 16.f;
+}
+
 namespace MWPhysics
 {
     PhysicsSystem::PhysicsSystem(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> parentNode)
@@ -58,6 +66,7 @@ namespace MWPhysics
         , mResourceSystem(resourceSystem)
         , mDebugDrawEnabled(false)
         , mTimeAccum(0.0f)
+        , mLineOfSightCache(lineOfSightCacheDuration, lineOfSightCacheTolerance)
         , mWaterHeight(0)
         , mWaterEnabled(false)
         , mParentNode(parentNode)
@@ -346,8 +355,14 @@ namespace MWPhysics
         osg::Vec3f pos1 (physactor1->getCollisionObjectPosition() + osg::Vec3f(0,0,physactor1->getHalfExtents().z() * 0.9)); // eye level
         osg::Vec3f pos2 (physactor2->getCollisionObjectPosition() + osg::Vec3f(0,0,physactor2->getHalfExtents().z() * 0.9));
 
+        bool lineOfSight = false;
+        if (mLineOfSightCache.get(physactor1, pos1, physactor2, pos2, lineOfSight))
+            return lineOfSight;
+
         RayCastingResult result = castRay(pos1, pos2, MWWorld::ConstPtr(), std::vector<MWWorld::Ptr>(), CollisionType_World|CollisionType_HeightMap|CollisionType_Door);
 
+        mLineOfSightCache.insert(physactor1, pos1, physactor2, pos2, !result.mHit);
+
         return !result.mHit;
     }
 
@@ -504,6 +519,8 @@ namespace MWPhysics
         ActorMap::iterator foundActor = mActors.find(ptr);
         if (foundActor != mActors.end())
         {
+            // the address of the removed actor may be reused by another one
+            mLineOfSightCache.clear();
             delete foundActor->second;
             mActors.erase(foundActor);
         }
@@ -776,6 +793,8 @@ namespace MWPhysics
 
     void PhysicsSystem::stepSimulation(float dt)
     {
+        mLineOfSightCache.update(dt);
+
         for (Object* animatedObject :  mAnimatedObjects)
             animatedObject->animateCollisionShapes(mCollisionWorld);
 
@@ -898,5 +917,7 @@ namespace MWPhysics
         stats.setAttribute(frameNumber, "Physics Actors", mActors.size());
         stats.setAttribute(frameNumber, "Physics Objects", mObjects.size());
         stats.setAttribute(frameNumber, "Physics HeightFields", mHeightFields.size());
+        stats.setAttribute(frameNumber, "Physics LOS Rays", mLineOfSightCache.getMisses());
+        stats.setAttribute(frameNumber, "Physics LOS Cached", mLineOfSightCache.getHits());
     }
 }
@@ -14,6 +14,7 @@
 
 #include "collisiontype.hpp"
 #include "raycasting.hpp"
+#include "lineofsightcache.hpp"
 
 namespace osg
 {
@@ -226,6 +227,9 @@ namespace MWPhysics
 
             float mTimeAccum;
 
+            // results of getLineOfSight, which is const for the callers
+            mutable LineOfSightCache mLineOfSightCache;
+
             float mWaterHeight;
             bool mWaterEnabled;
 
@@ -1,5 +1,6 @@
 #include "objectpaging.hpp"
 
+#include <algorithm>
 #include <unordered_map>
 
 #include <osg/Version>
@@ -11,10 +12,14 @@
 
 #include <components/esm/esmreader.hpp>
 #include <components/misc/resourcehelpers.hpp>
+#include <components/resource/imagemanager.hpp>
 #include <components/resource/scenemanager.hpp>
+#include <components/sceneutil/occluderculling.hpp>
+#include <components/sceneutil/occlusionquery.hpp>
 #include <components/sceneutil/optimizer.hpp>
 #include <components/sceneutil/clone.hpp>
 #include <components/sceneutil/util.hpp>
+#include <components/sceneutil/uploadscheduler.hpp>
 #include <components/vfs/manager.hpp>
 
 #include <osgParticle/ParticleProcessor>
@@ -86,6 +91,184 @@ namespace MWRender
         }
     }
 
+    TextureLod::TextureLod(Resource::ImageManager* imageManager)
+        : mImageManager(imageManager)
+    {
+    }
+
+    osg::ref_ptr<osg::StateSet> TextureLod::getStateSet(osg::StateSet* stateset, unsigned int maxTextureSize)
+    {
+        const auto key = std::make_pair(stateset, maxTextureSize);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            const auto it = mStateSets.find(key);
+            // the caller holds a reference to the original
+            if (it != mStateSets.end() && it->second.mOriginal.valid())
+                return it->second.mReduced ? it->second.mReduced : osg::ref_ptr<osg::StateSet>(stateset);
+        }
+
+        osg::ref_ptr<osg::StateSet> result = stateset;
+        const osg::StateSet::TextureAttributeList& textureAttributes = stateset->getTextureAttributeList();
+        for (unsigned int unit = 0; unit < textureAttributes.size(); ++unit)
+        {
+            for (const auto& attribute : textureAttributes[unit])
+            {
+                if (attribute.first.first != osg::StateAttribute::TEXTURE)
+                    continue;
+                osg::Texture2D* texture = dynamic_cast<osg::Texture2D*>(attribute.second.first.get());
+                if (!texture)
+                    continue;
+                const osg::ref_ptr<osg::Texture2D> reduced = getTexture(texture, maxTextureSize);
+                if (reduced == texture)
+                    continue;
+                if (result == stateset)
+                    result = osg::clone(stateset, osg::CopyOp::SHALLOW_COPY);
+                result->setTextureAttribute(unit, reduced.get(), attribute.second.second);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        Reduced<osg::StateSet>& entry = mStateSets[key];
+        // another thread may have reduced the same stateset meanwhile, chunks have to share one to be merged
+        if (!entry.mOriginal.valid())
+        {
+            entry.mOriginal = stateset;
+            entry.mReduced = result != stateset ? result : osg::ref_ptr<osg::StateSet>();
+        }
+        return entry.mReduced ? entry.mReduced : osg::ref_ptr<osg::StateSet>(stateset);
+    }
+
+    osg::ref_ptr<osg::Texture2D> TextureLod::getTexture(osg::Texture2D* texture, unsigned int maxTextureSize)
+    {
+        const auto key = std::make_pair(texture, maxTextureSize);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            const auto it = mTextures.find(key);
+            // the caller holds a reference to the original
+            if (it != mTextures.end() && it->second.mOriginal.valid())
+                return it->second.mReduced ? it->second.mReduced : osg::ref_ptr<osg::Texture2D>(texture);
+        }
+
+        // reading the image may take a while, other threads don't wait for it
+        const osg::ref_ptr<osg::Texture2D> reduced = reduceTexture(texture, maxTextureSize);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        Reduced<osg::Texture2D>& entry = mTextures[key];
+        // another thread may have reduced the same texture meanwhile, the first one is shared
+        if (!entry.mOriginal.valid())
+        {
+            entry.mOriginal = texture;
+            entry.mReduced = reduced;
+        }
+        return entry.mReduced ? entry.mReduced : osg::ref_ptr<osg::Texture2D>(texture);
+    }
+
+    osg::ref_ptr<osg::Texture2D> TextureLod::reduceTexture(osg::Texture2D* texture, unsigned int maxTextureSize) const
+    {
+        const osg::Image* image = texture->getImage();
+        if (!image || image->getFileName().empty())
+            return nullptr;
+
+        unsigned int mipLevels = 0;
+        while (mipLevels + 1 < image->getNumMipmapLevels()
+               && static_cast<unsigned int>(std::max(image->s(), image->t()) >> mipLevels) > maxTextureSize)
+            ++mipLevels;
+        if (mipLevels == 0)
+            return nullptr;
+
+        osg::ref_ptr<osg::Texture2D> result = osg::clone(texture, osg::CopyOp::SHALLOW_COPY);
+        result->setImage(mImageManager->getImage(image->getFileName(), mipLevels));
+        return result;
+    }
+
+    void TextureLod::clearUnused()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        // the cache holds the only reference to a reduced object no chunk uses anymore
+        const auto isUnused = [] (const auto& entry)
+        {
+            return !entry.mOriginal.valid() || (entry.mReduced && entry.mReduced->referenceCount() == 1);
+        };
+        for (auto it = mStateSets.begin(); it != mStateSets.end();)
+        {
+            if (isUnused(it->second))
+                it = mStateSets.erase(it);
+            else
+                ++it;
+        }
+        for (auto it = mTextures.begin(); it != mTextures.end();)
+        {
+            if (isUnused(it->second))
+                it = mTextures.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    void TextureLod::clear()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStateSets.clear();
+        mTextures.clear();
+    }
+
+    const osg::Geometry* MeshLod::getGeometry(const osg::Geometry* geometry, float maxError)
+    {
+        const auto select = [&] (const std::vector<SceneUtil::SimplifiedGeometry>& levels)
+        {
+            const osg::Geometry* result = geometry;
+            for (const auto& level : levels)
+            {
+                if (level.mError > maxError)
+                    break;
+                result = level.mGeometry;
+            }
+            return result;
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto found = mLevels.find(geometry);
+            if (found != mLevels.end())
+                return select(found->second);
+        }
+
+        // don't block other chunks while simplifying, the chunk being built keeps the template alive
+        std::vector<SceneUtil::SimplifiedGeometry> levels = SceneUtil::simplifyGeometry(*geometry, 3, 0.5f, 64);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        return select(mLevels.emplace(geometry, std::move(levels)).first->second);
+    }
+
+    void MeshLod::clearUnused()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        for (auto it = mLevels.begin(); it != mLevels.end();)
+        {
+            const auto isUnused = [] (const SceneUtil::SimplifiedGeometry& level) { return level.mGeometry->referenceCount() == 1; };
+            if (it->first->referenceCount() == 1 && std::all_of(it->second.begin(), it->second.end(), isUnused))
+                it = mLevels.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    void MeshLod::clear()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mLevels.clear();
+    }
+
+    unsigned int getMaxTextureSize(float screenSize, unsigned int bias)
+    {
+        unsigned int result = 1;
+        while (result < screenSize)
+            result *= 2;
+        return std::max(result >> bias, 1u);
+    }
+
     class CanOptimizeCallback : public SceneUtil::Optimizer::IsOperationPermissibleForObjectCallback
     {
     public:
@@ -106,6 +289,30 @@ namespace MWRender
         float mSqrDistance = 0.f;
         osg::Vec3f mViewVector;
         mutable std::vector<const osg::Node*> mNodePath;
+        TextureLod* mTextureLod = nullptr;
+        /// Set once a copied stateset uses reduced textures.
+        mutable bool mUsesReducedTextures = false;
+        unsigned int mMaxTextureSize = 0;
+        MeshLod* mMeshLod = nullptr;
+        float mMaxGeometricError = 0.f;
+        mutable std::map<std::pair<const osg::Drawable*, unsigned int>, osg::ref_ptr<osg::Drawable>> mReducedDrawables;
+
+        osg::ref_ptr<osg::StateSet> getReducedStateSet(osg::StateSet* stateset) const
+        {
+            if (!mTextureLod || !mMaxTextureSize || !stateset)
+                return stateset;
+            osg::ref_ptr<osg::StateSet> result = mTextureLod->getStateSet(stateset, mMaxTextureSize);
+            if (result != stateset)
+                mUsesReducedTextures = true;
+            return result;
+        }
+
+        const osg::Drawable* getSimplifiedDrawable(const osg::Drawable* drawable) const
+        {
+            if (!mMeshLod || mMaxGeometricError <= 0.f || drawable->className() != std::string("Geometry"))
+                return drawable;
+            return mMeshLod->getGeometry(static_cast<const osg::Geometry*>(drawable), mMaxGeometricError);
+        }
 
         void copy(const osg::Node* toCopy, osg::Group* attachTo)
         {
@@ -154,6 +361,7 @@ namespace MWRender
             cloned->setDataVariance(osg::Object::STATIC);
             cloned->setUserDataContainer(nullptr);
             cloned->setName("");
+            cloned->setStateSet(getReducedStateSet(cloned->getStateSet()));
 
             mNodePath.pop_back();
 
@@ -232,16 +440,31 @@ namespace MWRender
             if (const SceneUtil::MorphGeometry* morph = dynamic_cast<const SceneUtil::MorphGeometry*>(drawable))
                 return operator()(morph->getSourceGeometry());
 
+            drawable = getSimplifiedDrawable(drawable);
+
             if (getCopyFlags() & DEEP_COPY_DRAWABLES)
             {
                 osg::Drawable* d = static_cast<osg::Drawable*>(drawable->clone(*this));
                 d->setDataVariance(osg::Object::STATIC);
                 d->setUserDataContainer(nullptr);
                 d->setName("");
+                d->setStateSet(getReducedStateSet(d->getStateSet()));
                 return d;
             }
-            else
+
+            osg::StateSet* stateset = const_cast<osg::StateSet*>(drawable->getStateSet());
+            osg::ref_ptr<osg::StateSet> reduced = getReducedStateSet(stateset);
+            if (reduced == stateset)
                 return const_cast<osg::Drawable*>(drawable);
+
+            // shallow copy shares vertex data with the template, share the copy between instances in the chunk as well
+            osg::ref_ptr<osg::Drawable>& copy = mReducedDrawables[std::make_pair(drawable, mMaxTextureSize)];
+            if (!copy)
+            {
+                copy = osg::clone(drawable, osg::CopyOp::SHALLOW_COPY);
+                copy->setStateSet(reduced);
+            }
+            return copy.get();
         }
         virtual osg::Callback* operator() (const osg::Callback* callback) const
         {
@@ -359,9 +582,12 @@ namespace MWRender
         }
     };
 
-    ObjectPaging::ObjectPaging(Resource::SceneManager* sceneManager)
+    ObjectPaging::ObjectPaging(Resource::SceneManager* sceneManager, SceneUtil::OcclusionCulling* occlusionCulling,
+                               SceneUtil::OccluderCulling* occluderCulling)
             : GenericResourceManager<ChunkId>(nullptr)
          , mSceneManager(sceneManager)
+         , mOcclusionCulling(occlusionCulling)
+         , mOccluderCulling(occluderCulling)
          , mRefTrackerLocked(false)
     {
         mActiveGrid = Settings::Manager::getBool("object paging active grid", "Terrain");
@@ -370,6 +596,27 @@ namespace MWRender
         mMinSize = Settings::Manager::getFloat("object paging min size", "Terrain");
         mMinSizeMergeFactor = Settings::Manager::getFloat("object paging min size merge factor", "Terrain");
         mMinSizeCostMultiplier = Settings::Manager::getFloat("object paging min size cost multiplier", "Terrain");
+        if (Settings::Manager::getBool("object paging texture lod", "Terrain"))
+            mTextureLod.reset(new TextureLod(mSceneManager->getImageManager()));
+        mMeshLodError = Settings::Manager::getFloat("object paging mesh lod error", "Terrain");
+        if (mMeshLodError > 0)
+            mMeshLod.reset(new MeshLod);
+        const float fov = Settings::Manager::getFloat("field of view", "Camera");
+        mPixelsPerUnit = Settings::Manager::getInt("resolution y", "Video") / (2.f * std::tan(osg::DegreesToRadians(fov) / 2.f));
+        mTextureMemoryBudget = static_cast<std::size_t>(std::max(0, Settings::Manager::getInt("texture memory budget", "General"))) * 1024 * 1024;
+    }
+
+    unsigned int ObjectPaging::getTextureLodBias() const
+    {
+        if (mTextureMemoryBudget == 0)
+            return 0;
+
+        // each mip level less reduces the memory used by a texture four times
+        const std::size_t memoryUsage = mSceneManager->getImageManager()->getMemoryUsage();
+        unsigned int bias = 0;
+        for (std::size_t budget = mTextureMemoryBudget; memoryUsage > budget; budget *= 4)
+            ++bias;
+        return bias;
     }
 
     osg::ref_ptr<osg::Node> ObjectPaging::createChunk(float size, const osg::Vec2f& center, bool activeGrid, const osg::Vec3f& viewPoint, bool compile)
@@ -442,6 +689,7 @@ namespace MWRender
             std::vector<const ESM::CellRef*> mInstances;
             AnalyzeVisitor::Result mAnalyzeResult;
             bool mNeedCompile = false;
+            float mMaxScreenSize = 0;
         };
         typedef std::map<osg::ref_ptr<const osg::Node>, InstanceList> NodeMap;
         NodeMap nodes;
@@ -526,17 +774,35 @@ namespace MWRender
             else
                 analyzeVisitor.addInstance(emplaced.first->second.mAnalyzeResult);
             emplaced.first->second.mInstances.push_back(&ref);
+            // diameter in pixels of the nearest instance
+            const float screenSize = 2 * std::sqrt(radius2 / std::max(dSqr, 1.f)) * mPixelsPerUnit;
+            emplaced.first->second.mMaxScreenSize = std::max(emplaced.first->second.mMaxScreenSize, screenSize);
         }
 
+        const bool useTextureLod = mTextureLod && !activeGrid;
+        const unsigned int textureLodBias = useTextureLod ? getTextureLodBias() : 0;
+        const bool useMeshLod = mMeshLod && !activeGrid;
+
         osg::ref_ptr<osg::Group> group = new osg::Group;
         osg::ref_ptr<osg::Group> mergeGroup = new osg::Group;
         osg::ref_ptr<TemplateRef> templateRefs = new TemplateRef;
         osgUtil::StateToCompile stateToCompile(0, nullptr);
         CopyOp copyop;
+        if (useTextureLod)
+            copyop.mTextureLod = mTextureLod.get();
+        if (useMeshLod)
+            copyop.mMeshLod = mMeshLod.get();
         for (const auto& pair : nodes)
         {
             const osg::Node* cnode = pair.first;
 
+            if (useTextureLod)
+                copyop.mMaxTextureSize = getMaxTextureSize(pair.second.mMaxScreenSize, textureLodBias);
+            copyop.mUsesReducedTextures = false;
+            // the allowed error in pixels relative to the diameter of the nearest instance is independent of its scale
+            if (useMeshLod)
+                copyop.mMaxGeometricError = mMeshLodError * 2 * cnode->getBound().radius() / std::max(pair.second.mMaxScreenSize, 1.f);
+
             const AnalyzeVisitor::Result& analyzeResult = pair.second.mAnalyzeResult;
 
             float mergeCost = analyzeResult.mNumVerts * size;
@@ -596,15 +862,21 @@ namespace MWRender
             if (numinstances > 0)
             {
                 // add a ref to the original template, to hint to the cache that it's still being used and should be kept in cache
-                templateRefs->mObjects.push_back(cnode);
+                // unless the chunk uses reduced textures instead of its full size ones, then they can be released with the template
+                if (!copyop.mUsesReducedTextures)
+                    templateRefs->mObjects.push_back(cnode);
 
                 if (pair.second.mNeedCompile)
                 {
-                    int mode = osgUtil::GLObjectsVisitor::COMPILE_STATE_ATTRIBUTES;
+                    // state used by the chunk is compiled below when the template's textures are replaced
+                    int mode = copyop.mUsesReducedTextures ? 0 : osgUtil::GLObjectsVisitor::COMPILE_STATE_ATTRIBUTES;
                     if (!merge)
                         mode |= osgUtil::GLObjectsVisitor::COMPILE_DISPLAY_LISTS;
-                    stateToCompile._mode = mode;
-                    const_cast<osg::Node*>(cnode)->accept(stateToCompile);
+                    if (mode)
+                    {
+                        stateToCompile._mode = mode;
+                        const_cast<osg::Node*>(cnode)->accept(stateToCompile);
+                    }
                 }
             }
         }
@@ -635,14 +907,39 @@ namespace MWRender
             }
         }
 
+        if (compile && (useTextureLod || useMeshLod))
+        {
+            // reduced textures and simplified geometry are not a part of the templates compiled above
+            int mode = 0;
+            if (useTextureLod)
+                mode |= osgUtil::GLObjectsVisitor::COMPILE_STATE_ATTRIBUTES;
+            if (useMeshLod)
+                mode |= osgUtil::GLObjectsVisitor::COMPILE_DISPLAY_LISTS;
+            stateToCompile._mode = mode;
+            group->accept(stateToCompile);
+        }
+
         auto ico = mSceneManager->getIncrementalCompileOperation();
         if (!stateToCompile.empty() && ico)
         {
-            auto compileSet = new osgUtil::IncrementalCompileOperation::CompileSet(group);
+            auto compileSet = new SceneUtil::PositionedCompileSet(group, worldCenter);
             compileSet->buildCompileMap(ico->getContextSet(), stateToCompile);
             ico->add(compileSet, false);
         }
 
+        if (mOcclusionCulling && group->getNumChildren())
+        {
+            // one query for the whole chunk, so an occluded chunk skips all of its draws
+            osg::ref_ptr<SceneUtil::OcclusionQueryNode> queryNode = mOcclusionCulling->createQueryNode(Mask_Static);
+            for (unsigned int i = 0; i < group->getNumChildren(); ++i)
+                queryNode->addChild(group->getChild(i));
+            group->removeChildren(0, group->getNumChildren());
+            group->addChild(queryNode);
+        }
+
+        if (mOccluderCulling && group->getNumChildren())
+            group->addCullCallback(new SceneUtil::OccluderCullCallback(mOccluderCulling));
+
         group->getBound();
         group->setNodeMask(Mask_Static);
         osg::UserDataContainer* udc = group->getOrCreateUserDataContainer();
@@ -789,9 +1086,27 @@ namespace MWRender
         mCache->call(grf);
     }
 
+    void ObjectPaging::updateCache(double referenceTime)
+    {
+        GenericResourceManager<ChunkId>::updateCache(referenceTime);
+        if (mTextureLod)
+            mTextureLod->clearUnused();
+        if (mMeshLod)
+            mMeshLod->clearUnused();
+    }
+
+    void ObjectPaging::clearCache()
+    {
+        GenericResourceManager<ChunkId>::clearCache();
+        if (mTextureLod)
+            mTextureLod->clear();
+        if (mMeshLod)
+            mMeshLod->clear();
+    }
+
     void ObjectPaging::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
-        stats->setAttribute(frameNumber, "Object Chunk", mCache->getCacheSize());
+        reportCacheStats(frameNumber, stats, "Object Chunk");
     }
 
 }
@@ -4,27 +4,99 @@
 #include <components/terrain/quadtreeworld.hpp>
 #include <components/resource/resourcemanager.hpp>
 #include <components/esm/loadcell.hpp>
+#include <components/sceneutil/meshsimplifier.hpp>
 
+#include <osg/StateSet>
+#include <osg/Texture2D>
+#include <osg/observer_ptr>
+
+#include <map>
+#include <memory>
 #include <mutex>
 
 namespace Resource
 {
+    class ImageManager;
     class SceneManager;
 }
 namespace MWWorld
 {
     class ESMStore;
 }
+namespace SceneUtil
+{
+    class OccluderCulling;
+    class OcclusionCulling;
+}
 
 namespace MWRender
 {
 
     typedef std::tuple<osg::Vec2f, float, bool> ChunkId; // Center, Size, ActiveGrid
 
+    /// Shares statesets with textures reduced to a maximum size between chunks, so geometry using them can still be merged.
+    /// @note Originals are observed, not referenced, so the full size textures can be released when only reduced ones are used.
+    class TextureLod
+    {
+    public:
+        TextureLod(Resource::ImageManager* imageManager);
+
+        /// @return the given stateset if none of its textures is larger than maxTextureSize.
+        osg::ref_ptr<osg::StateSet> getStateSet(osg::StateSet* stateset, unsigned int maxTextureSize);
+
+        /// Release reduced statesets and textures no longer used by any chunk.
+        void clearUnused();
+
+        void clear();
+
+    private:
+        Resource::ImageManager* mImageManager;
+        std::mutex mMutex;
+
+        template <class T>
+        struct Reduced
+        {
+            /// An entry is stale once the original is deleted, another object may be created at the same address.
+            osg::observer_ptr<T> mOriginal;
+            /// nullptr if the original is used as it is.
+            osg::ref_ptr<T> mReduced;
+        };
+
+        std::map<std::pair<const osg::StateSet*, unsigned int>, Reduced<osg::StateSet>> mStateSets;
+        std::map<std::pair<const osg::Texture2D*, unsigned int>, Reduced<osg::Texture2D>> mTextures;
+
+        osg::ref_ptr<osg::Texture2D> getTexture(osg::Texture2D* texture, unsigned int maxTextureSize);
+
+        /// @return nullptr if the texture is not larger than maxTextureSize.
+        osg::ref_ptr<osg::Texture2D> reduceTexture(osg::Texture2D* texture, unsigned int maxTextureSize) const;
+    };
+
+    /// Shares simplified versions of template geometry between chunks. Levels are built once per geometry when a chunk
+    /// first needs them.
+    class MeshLod
+    {
+    public:
+        /// @param maxError Approximate geometric error threshold in the local coordinates of the geometry.
+        /// @return the coarsest level not exceeding maxError or the given geometry if there is none.
+        const osg::Geometry* getGeometry(const osg::Geometry* geometry, float maxError);
+
+        /// Release levels of geometry no longer used by any template or chunk.
+        void clearUnused();
+
+        void clear();
+
+    private:
+        std::mutex mMutex;
+        std::map<osg::ref_ptr<const osg::Geometry>, std::vector<SceneUtil::SimplifiedGeometry>> mLevels;
+    };
+
     class ObjectPaging : public Resource::GenericResourceManager<ChunkId>, public Terrain::QuadTreeWorld::ChunkManager
     {
     public:
-        ObjectPaging(Resource::SceneManager* sceneManager);
+        /// @param occlusionCulling Wrap each chunk in an occlusion query node created by it, optional.
+        /// @param occluderCulling Test each chunk against its occluders, optional.
+        ObjectPaging(Resource::SceneManager* sceneManager, SceneUtil::OcclusionCulling* occlusionCulling,
+                     SceneUtil::OccluderCulling* occluderCulling);
         ~ObjectPaging() = default;
 
         osg::ref_ptr<osg::Node> getChunk(float size, const osg::Vec2f& center, unsigned char lod, unsigned int lodFlags, bool activeGrid, const osg::Vec3f& viewPoint, bool compile) override;
@@ -45,18 +117,32 @@ namespace MWRender
         /// @return true if view needs rebuild
         bool unlockCache();
 
+        void updateCache(double referenceTime) override;
+
+        void clearCache() override;
+
         void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
 
         void getPagedRefnums(const osg::Vec4i &activeGrid, std::set<ESM::RefNum> &out);
 
     private:
         Resource::SceneManager* mSceneManager;
+        osg::ref_ptr<SceneUtil::OcclusionCulling> mOcclusionCulling;
+        osg::ref_ptr<SceneUtil::OccluderCulling> mOccluderCulling;
         bool mActiveGrid;
         bool mDebugBatches;
         float mMergeFactor;
         float mMinSize;
         float mMinSizeMergeFactor;
         float mMinSizeCostMultiplier;
+        std::unique_ptr<TextureLod> mTextureLod;
+        std::unique_ptr<MeshLod> mMeshLod;
+        float mMeshLodError;
+        float mPixelsPerUnit;
+        std::size_t mTextureMemoryBudget;
+
+        /// How many times to halve texture sizes of distant objects in addition to their size on screen.
+        unsigned int getTextureLodBias() const;
 
         std::mutex mRefTrackerMutex;
         struct RefTracker
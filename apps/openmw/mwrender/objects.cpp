@@ -3,6 +3,8 @@
 #include <osg/Group>
 #include <osg/UserDataContainer>
 
+#include <components/sceneutil/occluderculling.hpp>
+#include <components/sceneutil/occlusionquery.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/unrefqueue.hpp>
 
@@ -15,13 +17,32 @@
 #include "vismask.hpp"
 
 
+namespace
+{
+
+/// @return the node attached to the cell node, either the object node itself or the occlusion query node wrapping it.
+osg::Node* getCellChild(osg::Node* objectNode)
+{
+    if (objectNode->getNumParents() == 0)
+        return objectNode;
+    osg::Group* parent = objectNode->getParent(0);
+    if (dynamic_cast<SceneUtil::OcclusionQueryNode*>(parent))
+        return parent;
+    return objectNode;
+}
+
+}
+
 namespace MWRender
 {
 
-Objects::Objects(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> rootNode, SceneUtil::UnrefQueue* unrefQueue)
+Objects::Objects(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> rootNode, SceneUtil::UnrefQueue* unrefQueue,
+                 SceneUtil::OcclusionCulling* occlusionCulling, SceneUtil::OccluderCulling* occluderCulling)
     : mRootNode(rootNode)
     , mResourceSystem(resourceSystem)
     , mUnrefQueue(unrefQueue)
+    , mOcclusionCulling(occlusionCulling)
+    , mOccluderCulling(occluderCulling)
 {
 }
 
@@ -34,7 +55,7 @@ Objects::~Objects()
     mCellSceneNodes.clear();
 }
 
-void Objects::insertBegin(const MWWorld::Ptr& ptr)
+void Objects::insertBegin(const MWWorld::Ptr& ptr, unsigned int nodeMask)
 {
     assert(mObjects.find(ptr) == mObjects.end());
 
@@ -52,7 +73,17 @@ void Objects::insertBegin(const MWWorld::Ptr& ptr)
         cellnode = found->second;
 
     osg::ref_ptr<SceneUtil::PositionAttitudeTransform> insert (new SceneUtil::PositionAttitudeTransform);
-    cellnode->addChild(insert);
+    insert->setNodeMask(nodeMask);
+    if (mOccluderCulling && nodeMask == Mask_Actor)
+        insert->addCullCallback(new SceneUtil::OccluderCullCallback(mOccluderCulling));
+    if (mOcclusionCulling)
+    {
+        osg::ref_ptr<SceneUtil::OcclusionQueryNode> queryNode = mOcclusionCulling->createQueryNode(nodeMask);
+        queryNode->addChild(insert);
+        cellnode->addChild(queryNode);
+    }
+    else
+        cellnode->addChild(insert);
 
     insert->getOrCreateUserDataContainer()->addUserObject(new PtrHolder(ptr));
 
@@ -70,8 +101,7 @@ void Objects::insertBegin(const MWWorld::Ptr& ptr)
 
 void Objects::insertModel(const MWWorld::Ptr &ptr, const std::string &mesh, bool animated, bool allowLight)
 {
-    insertBegin(ptr);
-    ptr.getRefData().getBaseNode()->setNodeMask(Mask_Object);
+    insertBegin(ptr, Mask_Object);
 
     osg::ref_ptr<ObjectAnimation> anim (new ObjectAnimation(ptr, mesh, mResourceSystem, animated, allowLight));
 
@@ -80,8 +110,7 @@ void Objects::insertModel(const MWWorld::Ptr &ptr, const std::string &mesh, bool
 
 void Objects::insertCreature(const MWWorld::Ptr &ptr, const std::string &mesh, bool weaponsShields)
 {
-    insertBegin(ptr);
-    ptr.getRefData().getBaseNode()->setNodeMask(Mask_Actor);
+    insertBegin(ptr, Mask_Actor);
 
     // CreatureAnimation
     osg::ref_ptr<Animation> anim;
@@ -97,8 +126,7 @@ void Objects::insertCreature(const MWWorld::Ptr &ptr, const std::string &mesh, b
 
 void Objects::insertNPC(const MWWorld::Ptr &ptr)
 {
-    insertBegin(ptr);
-    ptr.getRefData().getBaseNode()->setNodeMask(Mask_Actor);
+    insertBegin(ptr, Mask_Actor);
 
     osg::ref_ptr<NpcAnimation> anim (new NpcAnimation(ptr, osg::ref_ptr<osg::Group>(ptr.getRefData().getBaseNode()), mResourceSystem));
 
@@ -130,7 +158,8 @@ bool Objects::removeObject (const MWWorld::Ptr& ptr)
             ptr.getClass().getContainerStore(ptr).setContListener(nullptr);
         }
 
-        ptr.getRefData().getBaseNode()->getParent(0)->removeChild(ptr.getRefData().getBaseNode());
+        osg::Node* cellChild = getCellChild(ptr.getRefData().getBaseNode());
+        cellChild->getParent(0)->removeChild(cellChild);
 
         ptr.getRefData().setBaseNode(nullptr);
         return true;
@@ -197,9 +226,10 @@ void Objects::updatePtr(const MWWorld::Ptr &old, const MWWorld::Ptr &cur)
                 userDataContainer->setUserObject(i, new PtrHolder(cur));
         }
 
-    if (objectNode->getNumParents())
-        objectNode->getParent(0)->removeChild(objectNode);
-    cellnode->addChild(objectNode);
+    osg::ref_ptr<osg::Node> cellChild = getCellChild(objectNode);
+    if (cellChild->getNumParents())
+        cellChild->getParent(0)->removeChild(cellChild);
+    cellnode->addChild(cellChild);
 
     PtrAnimationMap::iterator iter = mObjects.find(old);
     if(iter != mObjects.end())
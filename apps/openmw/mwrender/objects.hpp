@@ -26,6 +26,8 @@ namespace MWWorld
 
 namespace SceneUtil
 {
+    class OccluderCulling;
+    class OcclusionCulling;
     class UnrefQueue;
 }
 
@@ -68,10 +70,17 @@ class Objects{
 
     osg::ref_ptr<SceneUtil::UnrefQueue> mUnrefQueue;
 
-    void insertBegin(const MWWorld::Ptr& ptr);
+    osg::ref_ptr<SceneUtil::OcclusionCulling> mOcclusionCulling;
+
+    osg::ref_ptr<SceneUtil::OccluderCulling> mOccluderCulling;
+
+    void insertBegin(const MWWorld::Ptr& ptr, unsigned int nodeMask);
 
 public:
-    Objects(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> rootNode, SceneUtil::UnrefQueue* unrefQueue);
+    /// @param occlusionCulling Wrap each object in an occlusion query node created by it, optional.
+    /// @param occluderCulling Test actors against its occluders, optional.
+    Objects(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> rootNode, SceneUtil::UnrefQueue* unrefQueue,
+            SceneUtil::OcclusionCulling* occlusionCulling, SceneUtil::OccluderCulling* occluderCulling);
     ~Objects();
 
     /// @param animated Attempt to load separate keyframes from a .kf file matching the model file?
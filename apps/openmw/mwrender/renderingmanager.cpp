@@ -41,7 +41,10 @@
 #include <components/sceneutil/statesetupdater.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/workqueue.hpp>
+#include <components/sceneutil/occluderculling.hpp>
+#include <components/sceneutil/occlusionquery.hpp>
 #include <components/sceneutil/unrefqueue.hpp>
+#include <components/sceneutil/uploadscheduler.hpp>
 #include <components/sceneutil/writescene.hpp>
 #include <components/sceneutil/shadow.hpp>
 
@@ -198,7 +201,7 @@ namespace MWRender
         , mRootNode(rootNode)
         , mResourceSystem(resourceSystem)
         , mWorkQueue(workQueue)
-        , mUnrefQueue(new SceneUtil::UnrefQueue)
+        , mUnrefQueue(new SceneUtil::UnrefQueue(Settings::Manager::getFloat("unref time budget", "Cells")))
         , mNavigator(navigator)
         , mNightEyeFactor(0.f)
         , mFieldOfViewOverridden(false)
@@ -257,12 +260,30 @@ namespace MWRender
         mRecastMesh.reset(new RecastMesh(mRootNode, Settings::Manager::getBool("enable recast mesh render", "Navigator")));
         mPathgrid.reset(new Pathgrid(mRootNode));
 
-        mObjects.reset(new Objects(mResourceSystem, sceneRoot, mUnrefQueue.get()));
+        if (Settings::Manager::getBool("occlusion culling", "Camera"))
+            mOcclusionCulling = new SceneUtil::OcclusionCulling(
+                static_cast<unsigned int>(std::max(1, Settings::Manager::getInt("occlusion query frame count", "Camera"))),
+                static_cast<unsigned int>(std::max(1, Settings::Manager::getInt("occlusion query sample threshold", "Camera"))));
+
+        const bool distantTerrain = Settings::Manager::getBool("distant terrain", "Terrain");
+        if (distantTerrain && Settings::Manager::getBool("terrain occlusion culling", "Camera"))
+        {
+            const int width = std::max(16, Settings::Manager::getInt("terrain occluder resolution", "Camera"));
+            const float aspect = static_cast<float>(std::max(1, Settings::Manager::getInt("resolution y", "Video")))
+                / std::max(1, Settings::Manager::getInt("resolution x", "Video"));
+            mOccluderCulling = new SceneUtil::OccluderCulling(static_cast<unsigned int>(width),
+                static_cast<unsigned int>(std::max(1.f, width * aspect)));
+            mOccluderCulling->addCamera(mViewer->getCamera());
+        }
+
+        mObjects.reset(new Objects(mResourceSystem, sceneRoot, mUnrefQueue.get(), mOcclusionCulling.get(), mOccluderCulling.get()));
 
         if (getenv("OPENMW_DONT_PRECOMPILE") == nullptr)
         {
-            mViewer->setIncrementalCompileOperation(new osgUtil::IncrementalCompileOperation);
-            mViewer->getIncrementalCompileOperation()->setTargetFrameRate(Settings::Manager::getFloat("target framerate", "Cells"));
+            mUploadScheduler = new SceneUtil::UploadScheduler;
+            mUploadScheduler->setTargetFrameRate(Settings::Manager::getFloat("target framerate", "Cells"));
+            mUploadScheduler->setMinimumTimeAvailable(Settings::Manager::getFloat("minimum upload time", "Cells"));
+            mViewer->setIncrementalCompileOperation(mUploadScheduler);
         }
 
         mResourceSystem->getSceneManager()->setIncrementalCompileOperation(mViewer->getIncrementalCompileOperation());
@@ -277,7 +298,7 @@ namespace MWRender
 
         mTerrainStorage = new TerrainStorage(mResourceSystem, normalMapPattern, heightMapPattern, useTerrainNormalMaps, specularMapPattern, useTerrainSpecularMaps);
 
-        if (Settings::Manager::getBool("distant terrain", "Terrain"))
+        if (distantTerrain)
         {
             const int compMapResolution = Settings::Manager::getInt("composite map resolution", "Terrain");
             int compMapPower = Settings::Manager::getInt("composite map level", "Terrain");
@@ -292,16 +313,24 @@ namespace MWRender
                 compMapResolution, compMapLevel, lodFactor, vertexLodMod, maxCompGeometrySize));
             if (Settings::Manager::getBool("object paging", "Terrain"))
             {
-                mObjectPaging.reset(new ObjectPaging(mResourceSystem->getSceneManager()));
+                mObjectPaging.reset(new ObjectPaging(mResourceSystem->getSceneManager(), mOcclusionCulling.get(), mOccluderCulling.get()));
                 static_cast<Terrain::QuadTreeWorld*>(mTerrain.get())->addChunkManager(mObjectPaging.get());
                 mResourceSystem->addResourceManager(mObjectPaging.get());
             }
+            if (mOccluderCulling)
+            {
+                Terrain::QuadTreeWorld* quadTreeWorld = static_cast<Terrain::QuadTreeWorld*>(mTerrain.get());
+                quadTreeWorld->setOccluderDistance(Settings::Manager::getFloat("terrain occluder distance", "Camera"));
+                mOccluderCulling->setSource(quadTreeWorld);
+            }
         }
         else
             mTerrain.reset(new Terrain::TerrainGrid(sceneRoot, mRootNode, mResourceSystem, mTerrainStorage, Mask_Terrain, Mask_PreCompile, Mask_Debug));
 
         mTerrain->setTargetFrameRate(Settings::Manager::getFloat("target framerate", "Cells"));
-        mTerrain->setWorkQueue(mWorkQueue.get());
+        mTerrain->setUnrefQueue(mUnrefQueue.get());
+        if (mUploadScheduler)
+            mTerrain->setUploadScheduler(mUploadScheduler.get());
 
         // water goes after terrain for correct waterculling order
         mWater.reset(new Water(mRootNode, sceneRoot, mResourceSystem, mViewer->getIncrementalCompileOperation(), resourcePath));
@@ -608,7 +637,7 @@ namespace MWRender
     {
         reportStats();
 
-        mUnrefQueue->flush(mWorkQueue.get());
+        mUnrefQueue->flush();
 
         if (!paused)
         {
@@ -628,6 +657,9 @@ namespace MWRender
         mCamera->getPosition(focal, cameraPos);
         mCurrentCameraPos = cameraPos;
 
+        if (mUploadScheduler)
+            mUploadScheduler->update(cameraPos);
+
         bool isUnderwater = mWater->isUnderwater(cameraPos);
         mStateUpdater->setFogStart(mFog->getFogStart(isUnderwater));
         mStateUpdater->setFogEnd(mFog->getFogEnd(isUnderwater));
@@ -1277,6 +1309,15 @@ namespace MWRender
         {
             stats->setAttribute(frameNumber, "UnrefQueue", mUnrefQueue->getNumItems());
 
+            if (mUploadScheduler)
+                mUploadScheduler->reportStats(frameNumber, stats);
+
+            if (mOcclusionCulling)
+                mOcclusionCulling->reportStats(frameNumber, stats);
+
+            if (mOccluderCulling)
+                mOccluderCulling->reportStats(frameNumber, stats);
+
             mTerrain->reportStats(frameNumber, stats);
         }
     }
@@ -60,6 +60,9 @@ namespace SceneUtil
     class ShadowManager;
     class WorkQueue;
     class UnrefQueue;
+    class UploadScheduler;
+    class OccluderCulling;
+    class OcclusionCulling;
 }
 
 namespace DetourNavigator
@@ -265,6 +268,9 @@ namespace MWRender
 
         osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
         osg::ref_ptr<SceneUtil::UnrefQueue> mUnrefQueue;
+        osg::ref_ptr<SceneUtil::UploadScheduler> mUploadScheduler;
+        osg::ref_ptr<SceneUtil::OcclusionCulling> mOcclusionCulling;
+        osg::ref_ptr<SceneUtil::OccluderCulling> mOccluderCulling;
 
         osg::ref_ptr<osg::Light> mSunLight;
 
@@ -1,12 +1,14 @@
 #include "miscextensions.hpp"
 
 #include <cstdlib>
+#include <fstream>
 #include <iomanip>
 
 #include <components/compiler/opcodes.hpp>
 #include <components/compiler/locals.hpp>
 
 #include <components/debug/debuglog.hpp>
+#include <components/debug/trace.hpp>
 
 #include <components/interpreter/interpreter.hpp>
 #include <components/interpreter/runtime.hpp>
@@ -1567,6 +1569,38 @@ namespace MWScript
                 }
         };
 
+        class OpToggleTrace : public Interpreter::Opcode0
+        {
+            public:
+
+                virtual void execute (Interpreter::Runtime& runtime)
+                {
+                    bool enabled = !Debug::Tracer::isEnabled();
+                    Debug::Tracer::setEnabled(enabled);
+
+                    runtime.getContext().report (enabled ?
+                        "Trace Recording -> On" : "Trace Recording -> Off");
+                }
+        };
+
+        class OpWriteTrace : public Interpreter::Opcode0
+        {
+            public:
+
+                virtual void execute (Interpreter::Runtime& runtime)
+                {
+                    std::string path = runtime.getStringLiteral (runtime[0].mInteger);
+                    runtime.pop();
+
+                    std::ofstream stream(path);
+                    if (stream)
+                        Debug::Tracer::write(stream);
+
+                    runtime.getContext().report (stream ?
+                        "Trace written to " + path : "Failed to open file for trace: " + path);
+                }
+        };
+
         void installOpcodes (Interpreter::Interpreter& interpreter)
         {
             interpreter.installSegment5 (Compiler::Misc::opcodeMenuMode, new OpMenuMode);
@@ -1686,6 +1720,8 @@ namespace MWScript
             interpreter.installSegment5 (Compiler::Misc::opcodeRepairedOnMe, new OpRepairedOnMe<ImplicitRef>);
             interpreter.installSegment5 (Compiler::Misc::opcodeRepairedOnMeExplicit, new OpRepairedOnMe<ExplicitRef>);
             interpreter.installSegment5 (Compiler::Misc::opcodeToggleRecastMesh, new OpToggleRecastMesh);
+            interpreter.installSegment5 (Compiler::Misc::opcodeToggleTrace, new OpToggleTrace);
+            interpreter.installSegment5 (Compiler::Misc::opcodeWriteTrace, new OpWriteTrace);
         }
     }
 }
@@ -12,6 +12,7 @@
 #include <stdint.h>
 
 #include <components/debug/debuglog.hpp>
+#include <components/debug/trace.hpp>
 #include <components/misc/constants.hpp>
 #include <components/vfs/manager.hpp>
 
@@ -334,16 +335,20 @@ struct OpenAL_Output::StreamThread
     // thread entry point
     void run()
     {
+        Debug::Tracer::setThreadName("SoundStreams");
         std::unique_lock<std::mutex> lock(mMutex);
         while(!mQuitNow)
         {
-            StreamVec::iterator iter = mStreams.begin();
-            while(iter != mStreams.end())
             {
-                if((*iter)->process() == false)
-                    iter = mStreams.erase(iter);
-                else
-                    ++iter;
+                Debug::TraceZone zone("SoundStreams");
+                StreamVec::iterator iter = mStreams.begin();
+                while(iter != mStreams.end())
+                {
+                    if((*iter)->process() == false)
+                        iter = mStreams.erase(iter);
+                    else
+                        ++iter;
+                }
             }
 
             mCondVar.wait_for(lock, std::chrono::milliseconds(50));
@@ -0,0 +1,95 @@
+#include "benchmarkpath.hpp"
+
+#include <osg/Math>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    float interpolateAngle(float from, float to, float factor)
+    {
+        // turn the shorter way around
+        float difference = std::fmod(to - from, 2 * osg::PIf);
+        if (difference > osg::PIf)
+            difference -= 2 * osg::PIf;
+        else if (difference < -osg::PIf)
+            difference += 2 * osg::PIf;
+        return from + difference * factor;
+    }
+}
+
+namespace MWWorld
+{
+    BenchmarkPath BenchmarkPath::read(std::istream& stream)
+    {
+        BenchmarkPath result;
+        std::string line;
+        std::size_t lineNumber = 0;
+        while (std::getline(stream, line))
+        {
+            ++lineNumber;
+            std::istringstream lineStream(line);
+            std::string first;
+            if (!(lineStream >> first) || first[0] == '#')
+                continue;
+
+            BenchmarkWaypoint waypoint;
+            waypoint.mPosition.pos[0] = waypoint.mPosition.pos[1] = waypoint.mPosition.pos[2] = 0;
+            waypoint.mPosition.rot[0] = waypoint.mPosition.rot[1] = waypoint.mPosition.rot[2] = 0;
+
+            lineStream.clear();
+            lineStream.seekg(0);
+            if (!(lineStream >> waypoint.mTime >> waypoint.mPosition.pos[0] >> waypoint.mPosition.pos[1] >> waypoint.mPosition.pos[2]))
+                throw std::runtime_error("Invalid benchmark path waypoint at line " + std::to_string(lineNumber));
+
+            float zRotation = 0;
+            float xRotation = 0;
+            if (lineStream >> zRotation)
+            {
+                lineStream >> xRotation;
+                std::getline(lineStream >> std::ws, waypoint.mCell);
+                waypoint.mCell.erase(waypoint.mCell.find_last_not_of(" \t\r") + 1);
+            }
+            if (lineStream.fail() && !lineStream.eof())
+                throw std::runtime_error("Invalid benchmark path waypoint rotation at line " + std::to_string(lineNumber));
+            waypoint.mPosition.rot[0] = osg::DegreesToRadians(xRotation);
+            waypoint.mPosition.rot[2] = osg::DegreesToRadians(zRotation);
+
+            if (!result.mWaypoints.empty() && waypoint.mTime < result.mWaypoints.back().mTime)
+                throw std::runtime_error("Benchmark path waypoint at line " + std::to_string(lineNumber)
+                                         + " is earlier than the previous one");
+
+            result.mWaypoints.push_back(std::move(waypoint));
+        }
+        return result;
+    }
+
+    double BenchmarkPath::getDuration() const
+    {
+        return mWaypoints.empty() ? 0.0 : mWaypoints.back().mTime;
+    }
+
+    BenchmarkWaypoint BenchmarkPath::getWaypoint(double time) const
+    {
+        const auto next = std::upper_bound(mWaypoints.begin(), mWaypoints.end(), time,
+            [] (double time, const BenchmarkWaypoint& waypoint) { return time < waypoint.mTime; });
+        if (next == mWaypoints.begin())
+            return mWaypoints.front();
+        const auto previous = next - 1;
+        if (next == mWaypoints.end() || next->mCell != previous->mCell || next->mTime <= previous->mTime)
+            return *previous;
+
+        const float factor = static_cast<float>((time - previous->mTime) / (next->mTime - previous->mTime));
+        BenchmarkWaypoint result = *previous;
+        result.mTime = time;
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            result.mPosition.pos[i] += (next->mPosition.pos[i] - previous->mPosition.pos[i]) * factor;
+            result.mPosition.rot[i] = interpolateAngle(previous->mPosition.rot[i], next->mPosition.rot[i], factor);
+        }
+        return result;
+    }
+}
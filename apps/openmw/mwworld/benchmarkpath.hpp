@@ -0,0 +1,45 @@
+#ifndef GAME_MWWORLD_BENCHMARKPATH_H
+#define GAME_MWWORLD_BENCHMARKPATH_H
+
+#include <components/esm/defs.hpp>
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace MWWorld
+{
+    struct BenchmarkWaypoint
+    {
+        /// Seconds since the start of the path
+        double mTime;
+
+        /// Name of the interior cell, empty for the exterior
+        std::string mCell;
+
+        ESM::Position mPosition;
+    };
+
+    /// \brief Scripted player path of the benchmark mode
+    class BenchmarkPath
+    {
+        std::vector<BenchmarkWaypoint> mWaypoints;
+
+    public:
+        /// Read one waypoint per line as "<time> <x> <y> <z> [<z rotation> [<x rotation> [<interior cell name>]]]",
+        /// with time in seconds and rotations in degrees. Empty lines and lines starting with # are ignored.
+        /// \throw std::runtime_error on malformed lines or times not in increasing order
+        static BenchmarkPath read(std::istream& stream);
+
+        bool empty() const { return mWaypoints.empty(); }
+
+        /// Time of the last waypoint
+        double getDuration() const;
+
+        /// Position at the given time, interpolated between waypoints in the same cell.
+        /// The cell changes when the time of a waypoint in another cell is reached.
+        BenchmarkWaypoint getWaypoint(double time) const;
+    };
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <limits>
 
 #include <components/debug/debuglog.hpp>
+#include <components/debug/trace.hpp>
 #include <components/resource/scenemanager.hpp>
 #include <components/resource/resourcesystem.hpp>
 #include <components/resource/bulletshapemanager.hpp>
@@ -77,6 +78,8 @@ namespace MWWorld
         /// Preload work to be called from the worker thread.
         virtual void doWork()
         {
+            Debug::TraceZone zone("PreloadItem");
+
             if (mIsExterior)
             {
                 try
@@ -89,6 +92,8 @@ namespace MWWorld
                 }
             }
 
+            // start loading all templates of the cell so other worker threads can convert them in parallel,
+            // the loop below picks up those not started yet and waits for the others
             for (std::string& mesh: mMeshes)
             {
                 if (mAbort)
@@ -97,7 +102,21 @@ namespace MWWorld
                 try
                 {
                     mesh = Misc::ResourceHelpers::correctActorModelPath(mesh, mSceneManager->getVFS());
+                    mSceneManager->getTemplateAsync(mesh);
+                }
+                catch (std::exception& e)
+                {
+                    // ignore error for now, same as below
+                }
+            }
 
+            for (std::string& mesh: mMeshes)
+            {
+                if (mAbort)
+                    break;
+
+                try
+                {
                     bool animated = false;
                     size_t slashpos = mesh.find_last_of("/\\");
                     if (slashpos != std::string::npos && slashpos != mesh.size()-1)
@@ -179,6 +198,8 @@ namespace MWWorld
 
         virtual void doWork()
         {
+            Debug::TraceZone zone("TerrainPreloadItem");
+
             for (unsigned int i=0; i<mTerrainViews.size() && i<mPreloadPositions.size() && !mAbort; ++i)
             {
                 mTerrainViews[i]->reset();
@@ -344,6 +365,8 @@ namespace MWWorld
 
     void CellPreloader::updateCache(double timestamp)
     {
+        Debug::TraceZone zone("CellPreloader::updateCache");
+
         for (PreloadMap::iterator it = mPreloadCells.begin(); it != mPreloadCells.end();)
         {
             if (mPreloadCells.size() >= mMinCacheSize && it->second.mTimeStamp < timestamp - mExpiryDelay)
@@ -1,5 +1,6 @@
 #include "scene.hpp"
 
+#include <algorithm>
 #include <limits>
 #include <chrono>
 #include <thread>
@@ -8,6 +9,7 @@
 #include <BulletCollision/CollisionShapes/btCompoundShape.h>
 
 #include <components/debug/debuglog.hpp>
+#include <components/debug/trace.hpp>
 #include <components/loadinglistener/loadinglistener.hpp>
 #include <components/misc/resourcehelpers.hpp>
 #include <components/settings/settings.hpp>
@@ -315,6 +317,8 @@ namespace MWWorld
 
     void Scene::unloadCell (CellStoreCollection::iterator iter, bool test)
     {
+        Debug::TraceZone zone("Scene::unloadCell");
+
         if (!test)
             Log(Debug::Info) << "Unloading cell " << (*iter)->getCell()->getDescription();
 
@@ -375,6 +379,8 @@ namespace MWWorld
 
     void Scene::loadCell (CellStore *cell, Loading::Listener* loadingListener, bool respawn, bool test)
     {
+        Debug::TraceZone zone("Scene::loadCell");
+
         std::pair<CellStoreCollection::iterator, bool> result = mActiveCells.insert(cell);
 
         if(result.second)
@@ -516,6 +522,8 @@ namespace MWWorld
 
     void Scene::changeCellGrid (const osg::Vec3f &pos, int playerCellX, int playerCellY, bool changeEvent)
     {
+        Debug::TraceZone zone("Scene::changeCellGrid");
+
         CellStoreCollection::iterator active = mActiveCells.begin();
         while (active!=mActiveCells.end())
         {
@@ -662,7 +670,7 @@ namespace MWWorld
             }
 
             mRendering.getResourceSystem()->updateCache(mRendering.getReferenceTime());
-            mRendering.getUnrefQueue()->flush(mRendering.getWorkQueue());
+            mRendering.getUnrefQueue()->flush();
 
             loadingListener->increaseProgress (1);
             i++;
@@ -709,7 +717,7 @@ namespace MWWorld
             }
 
             mRendering.getResourceSystem()->updateCache(mRendering.getReferenceTime());
-            mRendering.getUnrefQueue()->flush(mRendering.getWorkQueue());
+            mRendering.getUnrefQueue()->flush();
 
             loadingListener->increaseProgress (1);
             i++;
@@ -771,6 +779,8 @@ namespace MWWorld
         mPhysics->setUnrefQueue(rendering.getUnrefQueue());
 
         rendering.getResourceSystem()->setExpiryDelay(Settings::Manager::getFloat("cache expiry delay", "Cells"));
+        rendering.getResourceSystem()->setMaxCacheMemory(static_cast<std::size_t>(
+            std::max(0, Settings::Manager::getInt("cache memory budget", "Cells"))) * 1024 * 1024);
 
         mPreloader->setExpiryDelay(Settings::Manager::getFloat("preload cell expiry delay", "Cells"));
         mPreloader->setMinCacheSize(Settings::Manager::getInt("preload cell cache min", "Cells"));
@@ -988,6 +998,8 @@ namespace MWWorld
 
     void Scene::preloadCells(float dt)
     {
+        Debug::TraceZone zone("Scene::preloadCells");
+
         if (dt<=1e-06) return;
         std::vector<PositionCellGrid> exteriorPositions;
 
@@ -7,6 +7,7 @@
 #include <BulletCollision/CollisionShapes/btCompoundShape.h>
 
 #include <components/debug/debuglog.hpp>
+#include <components/debug/trace.hpp>
 
 #include <components/esm/esmreader.hpp>
 #include <components/esm/esmwriter.hpp>
@@ -869,7 +870,7 @@ namespace MWWorld
 
     void World::advanceTime (double hours, bool incremental)
     {
-        if (!incremental)
+        if (!incremental && hours > 0)
         {
             // When we fast-forward time, we should recharge magic items
             // in all loaded cells, using game world time
@@ -1216,6 +1217,8 @@ namespace MWWorld
             }
         }
 
+        MWBase::Environment::get().getMechanicsManager()->updatePosition(newPtr);
+
         if (isPlayer)
             mWorldScene->playerMoved(vec);
         else
@@ -1494,6 +1497,8 @@ namespace MWWorld
 
     void World::doPhysics(float duration)
     {
+        Debug::TraceZone zone("World::doPhysics");
+
         mPhysics->stepSimulation(duration);
         processDoors(duration);
 
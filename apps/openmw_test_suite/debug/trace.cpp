@@ -0,0 +1,97 @@
+#include <components/debug/trace.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+    using namespace testing;
+    using namespace Debug;
+
+    struct DebugTraceTest : Test
+    {
+        ~DebugTraceTest()
+        {
+            Tracer::setEnabled(false);
+        }
+
+        std::string write() const
+        {
+            std::ostringstream stream;
+            Tracer::write(stream);
+            return stream.str();
+        }
+    };
+
+    TEST_F(DebugTraceTest, zone_should_not_be_recorded_while_disabled)
+    {
+        Tracer::setEnabled(false);
+        {
+            TraceZone zone("disabled zone");
+        }
+        EXPECT_THAT(write(), Not(HasSubstr("disabled zone")));
+    }
+
+    TEST_F(DebugTraceTest, zone_should_be_recorded_as_complete_event)
+    {
+        Tracer::setEnabled(true);
+        {
+            TraceZone zone("enabled zone");
+        }
+        Tracer::setEnabled(false);
+        const std::string trace = write();
+        EXPECT_THAT(trace, StartsWith("{\"traceEvents\":["));
+        EXPECT_THAT(trace, HasSubstr("{\"name\":\"enabled zone\",\"ph\":\"X\""));
+    }
+
+    TEST_F(DebugTraceTest, events_should_be_written_with_microseconds)
+    {
+        Tracer::setEnabled(true);
+        Tracer::record("fixed event", 1234567, 1236567);
+        Tracer::setEnabled(false);
+        EXPECT_THAT(write(), HasSubstr("\"ts\":1234.567,\"dur\":2.000}"));
+    }
+
+    TEST_F(DebugTraceTest, write_while_recording_should_produce_only_complete_events)
+    {
+        Tracer::setEnabled(true);
+        std::atomic<bool> done {false};
+        std::thread recorder([&] {
+            while (!done)
+                Tracer::record("concurrent event", 1000, 3000);
+        });
+        for (int i = 0; i < 10; ++i)
+        {
+            const std::string trace = write();
+            std::size_t position = 0;
+            while ((position = trace.find("\"concurrent event\"", position)) != std::string::npos)
+            {
+                const std::size_t end = trace.find('}', position);
+                ASSERT_NE(end, std::string::npos);
+                EXPECT_THAT(trace.substr(position, end - position), EndsWith(",\"ts\":1.000,\"dur\":2.000"));
+                position = end;
+            }
+        }
+        done = true;
+        recorder.join();
+        Tracer::setEnabled(false);
+    }
+
+    TEST_F(DebugTraceTest, threads_should_be_named)
+    {
+        Tracer::setEnabled(true);
+        std::thread([] {
+            Tracer::setThreadName("worker \"1\"");
+            TraceZone zone("worker zone");
+        }).join();
+        Tracer::setEnabled(false);
+        const std::string trace = write();
+        EXPECT_THAT(trace, HasSubstr("\"args\":{\"name\":\"worker \\\"1\\\"\"}"));
+        EXPECT_THAT(trace, HasSubstr("worker zone"));
+    }
+}
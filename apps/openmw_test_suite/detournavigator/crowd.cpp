@@ -0,0 +1,178 @@
+#include <components/detournavigator/crowd.hpp>
+
+#include <DetourNavMesh.h>
+#include <DetourNavMeshBuilder.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+
+    struct DetourNavigatorCrowdTest : Test
+    {
+        Settings mSettings {};
+        const osg::Vec3f mAgentHalfExtents {5, 5, 10};
+        const float mMaxSpeed = 20;
+        const float mDuration = 0.1f;
+        SharedNavMeshCacheItem mNavMeshCacheItem;
+        int mFirst = 1;
+        int mSecond = 2;
+
+        DetourNavigatorCrowdTest()
+        {
+            mSettings.mRecastScaleFactor = 1;
+            mSettings.mCellSize = 1;
+            mSettings.mCellHeight = 1;
+        }
+
+        /// Single square polygon from (-100, -100) to (100, 100) at zero height.
+        void makeNavMesh()
+        {
+            unsigned short vertices[] = {0, 0, 0, 0, 0, 200, 200, 0, 200, 200, 0, 0};
+            unsigned short polygons[] = {0, 1, 2, 3, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff};
+            unsigned short flags[] = {Flag_walk};
+            unsigned char areas[] = {0};
+
+            dtNavMeshCreateParams params;
+            std::memset(&params, 0, sizeof(params));
+            params.verts = vertices;
+            params.vertCount = 4;
+            params.polys = polygons;
+            params.polyFlags = flags;
+            params.polyAreas = areas;
+            params.polyCount = 1;
+            params.nvp = 6;
+            params.walkableHeight = 20;
+            params.walkableRadius = 5;
+            params.walkableClimb = 1;
+            params.cs = 1;
+            params.ch = 1;
+            params.buildBvTree = true;
+            params.bmin[0] = -100;
+            params.bmin[1] = -1;
+            params.bmin[2] = -100;
+            params.bmax[0] = 100;
+            params.bmax[1] = 1;
+            params.bmax[2] = 100;
+
+            unsigned char* data = nullptr;
+            int size = 0;
+            ASSERT_TRUE(dtCreateNavMeshData(&params, &data, &size));
+            const NavMeshPtr navMesh(dtAllocNavMesh(), &dtFreeNavMesh);
+            ASSERT_TRUE(dtStatusSucceed(navMesh->init(data, size, DT_TILE_FREE_DATA)));
+            mNavMeshCacheItem = std::make_shared<GuardedNavMeshCacheItem>(navMesh, 1);
+        }
+    };
+
+    TEST_F(DetourNavigatorCrowdTest, agent_without_nav_mesh_should_have_no_velocity)
+    {
+        Crowd crowd(mSettings, mAgentHalfExtents);
+        crowd.setAgent(ObjectId(&mFirst), osg::Vec3f(-50, 0, 0), osg::Vec3f(50, 0, 0), mMaxSpeed, Flag_walk);
+        crowd.update(nullptr, mDuration);
+        EXPECT_EQ(crowd.getAgentsCount(), 1u);
+        EXPECT_FALSE(crowd.getVelocity(ObjectId(&mFirst)));
+    }
+
+    TEST_F(DetourNavigatorCrowdTest, agent_should_move_to_target)
+    {
+        makeNavMesh();
+        Crowd crowd(mSettings, mAgentHalfExtents);
+        osg::Vec3f position(-50, 0, 0);
+        const osg::Vec3f target(50, 0, 0);
+        for (int i = 0; i < 100; ++i)
+        {
+            crowd.setAgent(ObjectId(&mFirst), position, target, mMaxSpeed, Flag_walk);
+            crowd.update(mNavMeshCacheItem, mDuration);
+            const auto velocity = crowd.getVelocity(ObjectId(&mFirst));
+            ASSERT_TRUE(velocity);
+            EXPECT_LE(velocity->length(), mMaxSpeed * 1.01f);
+            position = position + *velocity * mDuration;
+        }
+        EXPECT_LT((position - target).length(), mAgentHalfExtents.x());
+    }
+
+    TEST_F(DetourNavigatorCrowdTest, agent_should_slow_down_only_close_to_target)
+    {
+        makeNavMesh();
+        Crowd crowd(mSettings, mAgentHalfExtents);
+        osg::Vec3f position(-80, 0, 0);
+        const osg::Vec3f target(80, 0, 0);
+        for (int i = 0; i < 100 && (position - target).length() > 4 * mAgentHalfExtents.x(); ++i)
+        {
+            crowd.setAgent(ObjectId(&mFirst), position, target, mMaxSpeed, Flag_walk);
+            crowd.update(mNavMeshCacheItem, mDuration);
+            const auto velocity = crowd.getVelocity(ObjectId(&mFirst));
+            ASSERT_TRUE(velocity);
+            if (i > 0)
+                EXPECT_GT(velocity->length(), mMaxSpeed * 0.99f) << i;
+            position = position + *velocity * mDuration;
+        }
+        EXPECT_LE((position - target).length(), 4 * mAgentHalfExtents.x());
+    }
+
+    TEST_F(DetourNavigatorCrowdTest, agent_with_unreachable_target_should_have_no_velocity)
+    {
+        makeNavMesh();
+        Crowd crowd(mSettings, mAgentHalfExtents);
+        crowd.setAgent(ObjectId(&mFirst), osg::Vec3f(-50, 0, 0), osg::Vec3f(50, 0, 0), mMaxSpeed, Flag_walk);
+        crowd.update(mNavMeshCacheItem, mDuration);
+        EXPECT_TRUE(crowd.getVelocity(ObjectId(&mFirst)));
+        crowd.setAgent(ObjectId(&mFirst), osg::Vec3f(-50, 0, 0), osg::Vec3f(50, 0, 500), mMaxSpeed, Flag_walk);
+        crowd.update(mNavMeshCacheItem, mDuration);
+        EXPECT_FALSE(crowd.getVelocity(ObjectId(&mFirst)));
+    }
+
+    TEST_F(DetourNavigatorCrowdTest, agents_moving_towards_each_other_should_avoid_collision)
+    {
+        makeNavMesh();
+        Crowd crowd(mSettings, mAgentHalfExtents);
+        osg::Vec3f first(-50, 0, 0);
+        osg::Vec3f second(50, 0.5f, 0);
+        float minDistance = (first - second).length();
+        for (int i = 0; i < 100; ++i)
+        {
+            crowd.setAgent(ObjectId(&mFirst), first, osg::Vec3f(80, 0, 0), mMaxSpeed, Flag_walk);
+            crowd.setAgent(ObjectId(&mSecond), second, osg::Vec3f(-80, 0, 0), mMaxSpeed, Flag_walk);
+            crowd.update(mNavMeshCacheItem, mDuration);
+            const auto firstVelocity = crowd.getVelocity(ObjectId(&mFirst));
+            const auto secondVelocity = crowd.getVelocity(ObjectId(&mSecond));
+            ASSERT_TRUE(firstVelocity);
+            ASSERT_TRUE(secondVelocity);
+            first = first + *firstVelocity * mDuration;
+            second = second + *secondVelocity * mDuration;
+            minDistance = std::min(minDistance, (first - second).length());
+        }
+        EXPECT_GT(minDistance, 2 * mAgentHalfExtents.x());
+        EXPECT_GT(first.x(), 70);
+        EXPECT_LT(second.x(), -70);
+    }
+
+    TEST_F(DetourNavigatorCrowdTest, agent_not_set_before_update_should_be_removed)
+    {
+        makeNavMesh();
+        Crowd crowd(mSettings, mAgentHalfExtents);
+        crowd.setAgent(ObjectId(&mFirst), osg::Vec3f(-50, 0, 0), osg::Vec3f(50, 0, 0), mMaxSpeed, Flag_walk);
+        crowd.setAgent(ObjectId(&mSecond), osg::Vec3f(50, 0, 0), osg::Vec3f(-50, 0, 0), mMaxSpeed, Flag_walk);
+        crowd.update(mNavMeshCacheItem, mDuration);
+        EXPECT_EQ(crowd.getAgentsCount(), 2u);
+        crowd.setAgent(ObjectId(&mFirst), osg::Vec3f(-50, 0, 0), osg::Vec3f(50, 0, 0), mMaxSpeed, Flag_walk);
+        crowd.update(mNavMeshCacheItem, mDuration);
+        EXPECT_EQ(crowd.getAgentsCount(), 1u);
+        EXPECT_TRUE(crowd.getVelocity(ObjectId(&mFirst)));
+        EXPECT_FALSE(crowd.getVelocity(ObjectId(&mSecond)));
+    }
+
+    TEST_F(DetourNavigatorCrowdTest, agent_with_not_allowed_flags_should_have_no_velocity)
+    {
+        makeNavMesh();
+        Crowd crowd(mSettings, mAgentHalfExtents);
+        crowd.setAgent(ObjectId(&mFirst), osg::Vec3f(-50, 0, 0), osg::Vec3f(50, 0, 0), mMaxSpeed, Flag_swim);
+        crowd.update(mNavMeshCacheItem, mDuration);
+        EXPECT_FALSE(crowd.getVelocity(ObjectId(&mFirst)));
+    }
+}
@@ -68,6 +68,7 @@ namespace
             mSettings.mRegionMinSize = 8;
             mSettings.mTileSize = 64;
             mSettings.mAsyncNavMeshUpdaterThreads = 1;
+            mSettings.mAsyncPathFinderThreads = 1;
             mSettings.mMaxNavMeshTilesCacheSize = 1024 * 1024;
             mSettings.mMaxPolygonPathSize = 1024;
             mSettings.mMaxSmoothPathSize = 1024;
@@ -148,6 +149,41 @@ namespace
         ));
     }
 
+    TEST_F(DetourNavigatorNavigatorTest, find_path_async_for_empty_should_return_navmesh_not_found)
+    {
+        const auto request = mNavigator->findPathAsync(mAgentHalfExtents, mStepSize, mStart, mEnd, Flag_walk, mAreaCosts);
+        ASSERT_TRUE(request->isDone());
+        EXPECT_EQ(request->getStatus(), Status::NavMeshNotFound);
+        EXPECT_EQ(request->getPath(), std::deque<osg::Vec3f>());
+    }
+
+    TEST_F(DetourNavigatorNavigatorTest, find_path_async_should_return_same_path_as_find_path)
+    {
+        const std::array<btScalar, 5 * 5> heightfieldData {{
+            0,   0,    0,    0,    0,
+            0, -25,  -25,  -25,  -25,
+            0, -25, -100, -100, -100,
+            0, -25, -100, -100, -100,
+            0, -25, -100, -100, -100,
+        }};
+        btHeightfieldTerrainShape shape(5, 5, heightfieldData.data(), 1, 0, 0, 2, PHY_FLOAT, false);
+        shape.setLocalScaling(btVector3(128, 128, 1));
+
+        mNavigator->addAgent(mAgentHalfExtents);
+        mNavigator->addObject(ObjectId(&shape), shape, btTransform::getIdentity());
+        mNavigator->update(mPlayerPosition);
+        mNavigator->wait();
+
+        EXPECT_EQ(mNavigator->findPath(mAgentHalfExtents, mStepSize, mStart, mEnd, Flag_walk, mAreaCosts, mOut), Status::Success);
+
+        const auto request = mNavigator->findPathAsync(mAgentHalfExtents, mStepSize, mStart, mEnd, Flag_walk, mAreaCosts);
+        mNavigator->wait();
+
+        ASSERT_TRUE(request->isDone());
+        EXPECT_EQ(request->getStatus(), Status::Success);
+        EXPECT_EQ(request->getPath(), mPath);
+    }
+
     TEST_F(DetourNavigatorNavigatorTest, add_object_should_change_navmesh)
     {
         const std::array<btScalar, 5 * 5> heightfieldData {{
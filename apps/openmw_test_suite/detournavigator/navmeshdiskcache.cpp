@@ -0,0 +1,128 @@
+#include "operators.hpp"
+
+#include <components/detournavigator/navmeshdiskcache.hpp>
+#include <components/detournavigator/recastmesh.hpp>
+#include <components/detournavigator/settings.hpp>
+
+#include <LinearMath/btTransform.h>
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+
+    struct DetourNavigatorNavMeshDiskCacheTest : Test
+    {
+        const osg::Vec3f mAgentHalfExtents {1, 2, 3};
+        const TilePosition mTilePosition {0, 0};
+        const std::size_t mGeneration = 0;
+        const std::size_t mRevision = 0;
+        const std::vector<int> mIndices {{0, 1, 2}};
+        const std::vector<float> mVertices {{0, 0, 0, 1, 0, 0, 1, 1, 0}};
+        const std::vector<AreaType> mAreaTypes {1, AreaType_ground};
+        const std::vector<RecastMesh::Water> mWater {};
+        const std::size_t mTrianglesPerChunk {1};
+        const RecastMesh mRecastMesh {mGeneration, mRevision, mIndices, mVertices,
+                                      mAreaTypes, mWater, mTrianglesPerChunk};
+        const std::vector<OffMeshConnection> mOffMeshConnections {};
+        const std::string mData {"navmesh"};
+        NavMeshData mNavMeshData {makeData(mData), static_cast<int>(mData.size())};
+        Settings mSettings;
+        boost::filesystem::path mPath;
+
+        DetourNavigatorNavMeshDiskCacheTest()
+            : mPath(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+        {
+            mSettings.mTileSize = 64;
+        }
+
+        ~DetourNavigatorNavMeshDiskCacheTest()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all(mPath, ec);
+        }
+
+        static unsigned char* makeData(const std::string& value)
+        {
+            const auto result = reinterpret_cast<unsigned char*>(dtAlloc(static_cast<int>(value.size()), DT_ALLOC_PERM));
+            std::memcpy(result, value.data(), value.size());
+            return result;
+        }
+
+        static std::string toString(const NavMeshData& value)
+        {
+            return std::string(reinterpret_cast<const char*>(value.mValue.get()), static_cast<std::size_t>(value.mSize));
+        }
+    };
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, get_for_empty_cache_should_return_empty_value)
+    {
+        const NavMeshDiskCache cache(mPath.string(), mSettings);
+        EXPECT_FALSE(cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections).mValue);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, get_after_set_should_return_stored_value)
+    {
+        const NavMeshDiskCache cache(mPath.string(), mSettings);
+        cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, mNavMeshData);
+        const auto result = cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections);
+        ASSERT_TRUE(result.mValue);
+        EXPECT_EQ(toString(result), mData);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, get_for_same_triangles_in_other_order_should_return_stored_value)
+    {
+        const std::vector<float> vertices {{0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0}};
+        const RecastMesh recastMesh(mGeneration, mRevision, {0, 1, 2, 0, 2, 3}, vertices,
+            {AreaType_ground, AreaType_null}, mWater, mTrianglesPerChunk);
+        const std::vector<float> otherVertices {{1, 1, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0}};
+        const RecastMesh otherRecastMesh(mGeneration, mRevision, {1, 2, 0, 2, 3, 0}, otherVertices,
+            {AreaType_null, AreaType_ground}, mWater, mTrianglesPerChunk);
+        const NavMeshDiskCache cache(mPath.string(), mSettings);
+        cache.set(mAgentHalfExtents, mTilePosition, recastMesh, mOffMeshConnections, mNavMeshData);
+        const auto result = cache.get(mAgentHalfExtents, mTilePosition, otherRecastMesh, mOffMeshConnections);
+        ASSERT_TRUE(result.mValue);
+        EXPECT_EQ(toString(result), mData);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, get_for_triangle_with_other_winding_should_return_empty_value)
+    {
+        const RecastMesh recastMesh(mGeneration, mRevision, {0, 2, 1}, mVertices, {AreaType_ground}, mWater,
+            mTrianglesPerChunk);
+        const NavMeshDiskCache cache(mPath.string(), mSettings);
+        cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, mNavMeshData);
+        EXPECT_FALSE(cache.get(mAgentHalfExtents, mTilePosition, recastMesh, mOffMeshConnections).mValue);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, get_for_other_tile_should_return_empty_value)
+    {
+        const NavMeshDiskCache cache(mPath.string(), mSettings);
+        cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, mNavMeshData);
+        EXPECT_FALSE(cache.get(mAgentHalfExtents, TilePosition(1, 0), mRecastMesh, mOffMeshConnections).mValue);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, get_for_other_off_mesh_connections_should_return_empty_value)
+    {
+        const NavMeshDiskCache cache(mPath.string(), mSettings);
+        cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, mNavMeshData);
+        const std::vector<OffMeshConnection> offMeshConnections {
+            {osg::Vec3f(0, 0, 0), osg::Vec3f(1, 1, 0), AreaType_door}
+        };
+        EXPECT_FALSE(cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh, offMeshConnections).mValue);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, get_for_other_settings_should_return_empty_value)
+    {
+        NavMeshDiskCache(mPath.string(), mSettings)
+            .set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, mNavMeshData);
+        mSettings.mTileSize = 32;
+        const NavMeshDiskCache cache(mPath.string(), mSettings);
+        EXPECT_FALSE(cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections).mValue);
+    }
+}
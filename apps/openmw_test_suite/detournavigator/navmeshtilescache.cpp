@@ -106,6 +106,35 @@ namespace
         EXPECT_EQ(result.get(), (NavMeshDataRef {mData, 1}));
     }
 
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, get_for_other_recast_mesh_with_same_content_should_return_cached_value)
+    {
+        const std::size_t navMeshDataSize = 1;
+        const std::size_t navMeshKeySize = cRecastMeshKeySize;
+        const std::size_t maxSize = navMeshDataSize + 2 * navMeshKeySize;
+        NavMeshTilesCache cache(maxSize);
+        const RecastMesh sameRecastMesh {mGeneration, mRevision + 1, mIndices, mVertices,
+            mAreaTypes, mWater, mTrianglesPerChunk};
+
+        cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, std::move(mNavMeshData));
+        const auto result = cache.get(mAgentHalfExtents, mTilePosition, sameRecastMesh, mOffMeshConnections);
+        ASSERT_TRUE(result);
+        EXPECT_EQ(result.get(), (NavMeshDataRef {mData, 1}));
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, get_for_cache_miss_by_off_mesh_connections_should_return_empty_value)
+    {
+        const std::size_t navMeshDataSize = 1;
+        const std::size_t navMeshKeySize = cRecastMeshKeySize;
+        const std::size_t maxSize = navMeshDataSize + 2 * navMeshKeySize;
+        NavMeshTilesCache cache(maxSize);
+        const std::vector<OffMeshConnection> offMeshConnections {
+            OffMeshConnection {osg::Vec3f(0, 0, 0), osg::Vec3f(1, 1, 0), AreaType_door}
+        };
+
+        cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, std::move(mNavMeshData));
+        EXPECT_FALSE(cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh, offMeshConnections));
+    }
+
     TEST_F(DetourNavigatorNavMeshTilesCacheTest, get_for_cache_miss_by_agent_half_extents_should_return_empty_value)
     {
         const std::size_t maxSize = 1;
@@ -429,4 +429,41 @@ namespace
         EXPECT_EQ(recastMesh->getIndices(), std::vector<int>({2, 1, 0, 2, 1, 3}));
         EXPECT_EQ(recastMesh->getAreaTypes(), std::vector<AreaType>({AreaType_ground, AreaType_ground}));
     }
+
+    TEST_F(DetourNavigatorRecastMeshBuilderTest, create_for_same_input_should_return_recast_meshes_with_equal_hash)
+    {
+        btBoxShape shape(btVector3(2, 3, 4));
+        RecastMeshBuilder builder(mSettings, mBounds);
+        builder.addObject(static_cast<const btCollisionShape&>(shape), btTransform::getIdentity(), AreaType_ground);
+        builder.addWater(1000, btTransform(btMatrix3x3::getIdentity(), btVector3(100, 200, 300)));
+        const auto first = builder.create(mGeneration, mRevision);
+        const auto second = builder.create(mGeneration, mRevision + 1);
+        EXPECT_EQ(first->getHash(), second->getHash());
+    }
+
+    TEST_F(DetourNavigatorRecastMeshBuilderTest, create_for_different_water_should_return_recast_meshes_with_different_hash)
+    {
+        btBoxShape shape(btVector3(2, 3, 4));
+        RecastMeshBuilder builder(mSettings, mBounds);
+        builder.addObject(static_cast<const btCollisionShape&>(shape), btTransform::getIdentity(), AreaType_ground);
+        const auto first = builder.create(mGeneration, mRevision);
+        builder.addWater(1000, btTransform(btMatrix3x3::getIdentity(), btVector3(100, 200, 300)));
+        const auto second = builder.create(mGeneration, mRevision);
+        EXPECT_NE(first->getHash(), second->getHash());
+    }
+
+    TEST_F(DetourNavigatorRecastMeshBuilderTest, add_objects_after_start_dynamic_objects_should_mark_their_triangles_dynamic)
+    {
+        btBoxShape staticShape(btVector3(2, 3, 4));
+        btBoxShape dynamicShape(btVector3(1, 1, 1));
+        RecastMeshBuilder builder(mSettings, mBounds);
+        builder.addObject(static_cast<const btCollisionShape&>(staticShape), btTransform::getIdentity(), AreaType_ground);
+        builder.startDynamicObjects();
+        builder.addObject(static_cast<const btCollisionShape&>(dynamicShape),
+            btTransform(btMatrix3x3::getIdentity(), btVector3(10, 0, 0)), AreaType_ground);
+        const auto recastMesh = builder.create(mGeneration, mRevision);
+        EXPECT_EQ(recastMesh->getStaticTrianglesCount(), 12u);
+        EXPECT_EQ(recastMesh->getTrianglesCount(), 24u);
+        EXPECT_TRUE(recastMesh->hasStaticAndDynamicTriangles());
+    }
 }
@@ -0,0 +1,87 @@
+#include <components/detournavigator/staticheightfieldcache.hpp>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+
+    struct DetourNavigatorStaticHeightfieldCacheTest : Test
+    {
+        const osg::Vec3f mAgentHalfExtents {1, 2, 3};
+        const TilePosition mTilePosition {0, 0};
+
+        std::shared_ptr<const StaticHeightfield> makeHeightfield(std::size_t spans) const
+        {
+            auto result = std::make_shared<StaticHeightfield>();
+            result->mWidth = 1;
+            result->mHeight = 1;
+            result->mHasTriangles = true;
+            result->mSpans.resize(spans, HeightfieldSpan {0, 0, 0, 1, 1});
+            return result;
+        }
+
+        static std::size_t getSize(const StaticHeightfield& value)
+        {
+            return sizeof(value) + value.mSpans.size() * sizeof(HeightfieldSpan);
+        }
+    };
+
+    TEST_F(DetourNavigatorStaticHeightfieldCacheTest, get_for_empty_cache_should_return_nullptr)
+    {
+        StaticHeightfieldCache cache(1024);
+        EXPECT_EQ(cache.get(mAgentHalfExtents, mTilePosition), nullptr);
+    }
+
+    TEST_F(DetourNavigatorStaticHeightfieldCacheTest, get_should_return_set_value)
+    {
+        StaticHeightfieldCache cache(1024);
+        const auto value = makeHeightfield(1);
+        cache.set(mAgentHalfExtents, mTilePosition, value);
+        EXPECT_EQ(cache.get(mAgentHalfExtents, mTilePosition), value);
+        EXPECT_EQ(cache.getSize(), getSize(*value));
+    }
+
+    TEST_F(DetourNavigatorStaticHeightfieldCacheTest, get_for_other_tile_should_return_nullptr)
+    {
+        StaticHeightfieldCache cache(1024);
+        cache.set(mAgentHalfExtents, mTilePosition, makeHeightfield(1));
+        EXPECT_EQ(cache.get(mAgentHalfExtents, TilePosition(1, 0)), nullptr);
+        EXPECT_EQ(cache.get(osg::Vec3f(1, 1, 1), mTilePosition), nullptr);
+    }
+
+    TEST_F(DetourNavigatorStaticHeightfieldCacheTest, set_should_replace_existing_value)
+    {
+        StaticHeightfieldCache cache(1024);
+        cache.set(mAgentHalfExtents, mTilePosition, makeHeightfield(1));
+        const auto value = makeHeightfield(2);
+        cache.set(mAgentHalfExtents, mTilePosition, value);
+        EXPECT_EQ(cache.get(mAgentHalfExtents, mTilePosition), value);
+        EXPECT_EQ(cache.getSize(), getSize(*value));
+    }
+
+    TEST_F(DetourNavigatorStaticHeightfieldCacheTest, set_too_big_value_should_not_store_it)
+    {
+        const auto value = makeHeightfield(2);
+        StaticHeightfieldCache cache(getSize(*value) - 1);
+        cache.set(mAgentHalfExtents, mTilePosition, value);
+        EXPECT_EQ(cache.get(mAgentHalfExtents, mTilePosition), nullptr);
+        EXPECT_EQ(cache.getSize(), 0u);
+    }
+
+    TEST_F(DetourNavigatorStaticHeightfieldCacheTest, set_should_remove_least_recently_used_value)
+    {
+        const auto first = makeHeightfield(1);
+        const auto second = makeHeightfield(1);
+        const auto third = makeHeightfield(1);
+        StaticHeightfieldCache cache(2 * getSize(*first));
+        cache.set(mAgentHalfExtents, TilePosition(0, 0), first);
+        cache.set(mAgentHalfExtents, TilePosition(1, 0), second);
+        EXPECT_EQ(cache.get(mAgentHalfExtents, TilePosition(0, 0)), first);
+        cache.set(mAgentHalfExtents, TilePosition(2, 0), third);
+        EXPECT_EQ(cache.get(mAgentHalfExtents, TilePosition(0, 0)), first);
+        EXPECT_EQ(cache.get(mAgentHalfExtents, TilePosition(1, 0)), nullptr);
+        EXPECT_EQ(cache.get(mAgentHalfExtents, TilePosition(2, 0)), third);
+    }
+}
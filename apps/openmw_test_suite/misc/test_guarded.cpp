@@ -0,0 +1,42 @@
+#include <components/misc/guarded.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+
+namespace
+{
+    using namespace testing;
+    using namespace Misc;
+
+    TEST(MiscSharedGuardedTest, lock_should_give_mutable_access)
+    {
+        SharedGuarded<int> guarded(13);
+        *guarded.lock() = 42;
+        EXPECT_EQ(*guarded.lockConst(), 42);
+    }
+
+    TEST(MiscSharedGuardedTest, lock_const_should_not_wait_for_other_lock_const)
+    {
+        SharedGuarded<int> guarded(42);
+        const auto locked = guarded.lockConst();
+        auto result = std::async(std::launch::async, [&] { return *guarded.lockConst(); });
+        ASSERT_EQ(result.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+        EXPECT_EQ(result.get(), 42);
+    }
+
+    TEST(MiscSharedGuardedTest, lock_should_wait_for_lock_const)
+    {
+        SharedGuarded<int> guarded(13);
+        std::future<void> result;
+        {
+            const auto locked = guarded.lockConst();
+            result = std::async(std::launch::async, [&] { *guarded.lock() = 42; });
+            EXPECT_EQ(result.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+            EXPECT_EQ(*locked, 13);
+        }
+        result.wait();
+        EXPECT_EQ(*guarded.lockConst(), 42);
+    }
+}
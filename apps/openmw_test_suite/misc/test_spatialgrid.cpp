@@ -0,0 +1,80 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "components/misc/spatialgrid.hpp"
+
+namespace
+{
+    using namespace testing;
+    using namespace Misc;
+
+    TEST(MiscSpatialGridTest, should_find_keys_within_radius)
+    {
+        SpatialGrid<int> grid(100);
+        grid.update(1, osg::Vec3f(0, 0, 0));
+        grid.update(2, osg::Vec3f(150, 0, 0));
+        grid.update(3, osg::Vec3f(0, 0, 250));
+        grid.update(4, osg::Vec3f(-1000, -1000, 0));
+        std::vector<int> result;
+        grid.getInRange(osg::Vec3f(10, 10, 0), 200, result);
+        EXPECT_THAT(result, ElementsAre(1, 2));
+    }
+
+    TEST(MiscSpatialGridTest, should_return_keys_ordered_by_compare)
+    {
+        SpatialGrid<int, std::greater<int>> grid(10);
+        for (int i = 0; i < 10; ++i)
+            grid.update(i, osg::Vec3f(static_cast<float>((i * 7) % 10) * 10, 0, 0));
+        std::vector<int> result;
+        grid.getInRange(osg::Vec3f(50, 0, 0), 1000, result);
+        EXPECT_THAT(result, ElementsAre(9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+    }
+
+    TEST(MiscSpatialGridTest, should_find_keys_within_radius_in_dense_grid)
+    {
+        SpatialGrid<int, std::greater<int>> grid(100);
+        for (int x = 0; x < 10; ++x)
+            for (int y = 0; y < 10; ++y)
+                grid.update(x * 10 + y, osg::Vec3f(x * 100.f + 50, y * 100.f + 50, 0));
+        std::vector<int> result;
+        grid.getInRange(osg::Vec3f(450, 450, 0), 100, result);
+        EXPECT_THAT(result, ElementsAre(54, 45, 44, 43, 34));
+    }
+
+    TEST(MiscSpatialGridTest, should_append_to_output)
+    {
+        SpatialGrid<int> grid(100);
+        grid.update(1, osg::Vec3f(0, 0, 0));
+        std::vector<int> result {42};
+        grid.getInRange(osg::Vec3f(0, 0, 0), 1, result);
+        EXPECT_THAT(result, ElementsAre(42, 1));
+    }
+
+    TEST(MiscSpatialGridTest, update_should_move_key)
+    {
+        SpatialGrid<int> grid(100);
+        grid.update(1, osg::Vec3f(0, 0, 0));
+        grid.update(1, osg::Vec3f(-550, 550, 0));
+        EXPECT_EQ(grid.size(), 1u);
+        std::vector<int> result;
+        grid.getInRange(osg::Vec3f(0, 0, 0), 100, result);
+        EXPECT_THAT(result, IsEmpty());
+        grid.getInRange(osg::Vec3f(-500, 500, 0), 100, result);
+        EXPECT_THAT(result, ElementsAre(1));
+    }
+
+    TEST(MiscSpatialGridTest, removed_key_should_not_be_found)
+    {
+        SpatialGrid<int> grid(100);
+        grid.update(1, osg::Vec3f(0, 0, 0));
+        grid.update(2, osg::Vec3f(1, 0, 0));
+        grid.remove(1);
+        grid.remove(3);
+        EXPECT_EQ(grid.size(), 1u);
+        std::vector<int> result;
+        grid.getInRange(osg::Vec3f(0, 0, 0), 10, result);
+        EXPECT_THAT(result, ElementsAre(2));
+        grid.clear();
+        EXPECT_EQ(grid.size(), 0u);
+    }
+}
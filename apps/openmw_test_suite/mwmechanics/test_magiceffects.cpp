@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include "apps/openmw/mwmechanics/magiceffects.hpp"
+
+namespace
+{
+    using namespace testing;
+    using namespace MWMechanics;
+
+    struct MWMechanicsMagicEffectsTest : Test
+    {
+        const EffectKey mKey {1, 2};
+        MagicEffects mEffects;
+    };
+
+    TEST_F(MWMechanicsMagicEffectsTest, new_effects_should_have_unique_revisions)
+    {
+        const MagicEffects other;
+        EXPECT_NE(mEffects.getRevision(), 0u);
+        EXPECT_NE(other.getRevision(), 0u);
+        EXPECT_NE(mEffects.getRevision(), other.getRevision());
+    }
+
+    TEST_F(MWMechanicsMagicEffectsTest, copy_should_keep_revision)
+    {
+        mEffects.add(mKey, EffectParam(3));
+        const MagicEffects copy = mEffects;
+        EXPECT_EQ(copy.getRevision(), mEffects.getRevision());
+    }
+
+    TEST_F(MWMechanicsMagicEffectsTest, const_access_should_keep_revision)
+    {
+        mEffects.add(mKey, EffectParam(3));
+        const std::size_t revision = mEffects.getRevision();
+        EXPECT_FLOAT_EQ(mEffects.get(mKey).getMagnitude(), 3);
+        EXPECT_EQ(mEffects.getRevision(), revision);
+    }
+
+    TEST_F(MWMechanicsMagicEffectsTest, every_change_should_renew_revision)
+    {
+        MagicEffects other;
+        other.add(mKey, EffectParam(1));
+
+        std::size_t revision = mEffects.getRevision();
+        const auto expectChanged = [&] (const char* change)
+        {
+            EXPECT_NE(mEffects.getRevision(), revision) << change;
+            revision = mEffects.getRevision();
+        };
+
+        mEffects.add(mKey, EffectParam(3));
+        expectChanged("add");
+        mEffects.modifyBase(mKey, 1);
+        expectChanged("modifyBase");
+        mEffects.setModifiers(other);
+        expectChanged("setModifiers");
+        mEffects += other;
+        expectChanged("operator+=");
+        mEffects.remove(mKey);
+        expectChanged("remove");
+    }
+
+    TEST_F(MWMechanicsMagicEffectsTest, copy_should_not_share_changes)
+    {
+        MagicEffects copy = mEffects;
+        copy.add(mKey, EffectParam(3));
+        EXPECT_NE(copy.getRevision(), mEffects.getRevision());
+        EXPECT_FLOAT_EQ(mEffects.get(mKey).getMagnitude(), 0);
+    }
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include "apps/openmw/mwmechanics/pathgrid.hpp"
+
+#include <deque>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWMechanics;
+
+    using Position = std::tuple<int, int, int>;
+
+    std::vector<Position> getPositions(const std::deque<ESM::Pathgrid::Point>& path)
+    {
+        std::vector<Position> result;
+        for (const ESM::Pathgrid::Point& point : path)
+            result.emplace_back(point.mX, point.mY, point.mZ);
+        return result;
+    }
+
+    struct MWMechanicsPathgridGraphTest : Test
+    {
+        ESM::Pathgrid mPathgrid;
+        const Position mFirst {0, 0, 0};
+        const Position mSecond {100, 50, 0};
+        const Position mThird {200, 0, 0};
+        const Position mFourth {50, -150, 0};
+
+        /// Points 0, 1, 2 and 3 connected both ways in a loop, except for a one way shortcut from 0 to 2. Point 4 is
+        /// not connected.
+        MWMechanicsPathgridGraphTest()
+        {
+            for (const Position& position : {mFirst, mSecond, mThird, mFourth, Position(1000, 1000, 0)})
+                mPathgrid.mPoints.emplace_back(std::get<0>(position), std::get<1>(position), std::get<2>(position));
+            for (const auto& edge : {std::make_pair(0, 1), std::make_pair(1, 2), std::make_pair(2, 3), std::make_pair(3, 0)})
+            {
+                mPathgrid.mEdges.push_back(ESM::Pathgrid::Edge {edge.first, edge.second});
+                mPathgrid.mEdges.push_back(ESM::Pathgrid::Edge {edge.second, edge.first});
+            }
+            mPathgrid.mEdges.push_back(ESM::Pathgrid::Edge {0, 2});
+        }
+
+        /// Enough points not to keep routing tables.
+        void addUnconnectedPoints()
+        {
+            for (int i = 0; i < 300; ++i)
+                mPathgrid.mPoints.emplace_back(-1000 * (i + 1), 0, 0);
+        }
+    };
+
+    TEST_F(MWMechanicsPathgridGraphTest, path_to_unconnected_point_should_be_empty)
+    {
+        const PathgridGraph graph(&mPathgrid);
+        EXPECT_TRUE(graph.aStarSearch(0, 4).empty());
+    }
+
+    TEST_F(MWMechanicsPathgridGraphTest, path_to_start_should_contain_only_start)
+    {
+        const PathgridGraph graph(&mPathgrid);
+        EXPECT_EQ(getPositions(graph.aStarSearch(1, 1)), std::vector<Position>({mSecond}));
+    }
+
+    TEST_F(MWMechanicsPathgridGraphTest, path_should_follow_one_way_edge_only_in_its_direction)
+    {
+        const PathgridGraph graph(&mPathgrid);
+        EXPECT_EQ(getPositions(graph.aStarSearch(0, 2)), std::vector<Position>({mFirst, mThird}));
+        EXPECT_EQ(getPositions(graph.aStarSearch(2, 0)), std::vector<Position>({mThird, mSecond, mFirst}));
+    }
+
+    TEST_F(MWMechanicsPathgridGraphTest, routing_table_should_stay_valid_after_building_others)
+    {
+        const PathgridGraph graph(&mPathgrid);
+        EXPECT_EQ(getPositions(graph.aStarSearch(0, 2)), std::vector<Position>({mFirst, mThird}));
+        EXPECT_EQ(getPositions(graph.aStarSearch(2, 0)), std::vector<Position>({mThird, mSecond, mFirst}));
+        EXPECT_EQ(getPositions(graph.aStarSearch(1, 3)), std::vector<Position>({mSecond, mFirst, mFourth}));
+        EXPECT_EQ(getPositions(graph.aStarSearch(0, 2)), std::vector<Position>({mFirst, mThird}));
+        EXPECT_EQ(getPositions(graph.aStarSearch(3, 2)), std::vector<Position>({mFourth, mThird}));
+        EXPECT_EQ(getPositions(graph.aStarSearch(1, 0)), std::vector<Position>({mSecond, mFirst}));
+    }
+
+    TEST_F(MWMechanicsPathgridGraphTest, copy_should_keep_routing_tables_valid)
+    {
+        const PathgridGraph graph(&mPathgrid);
+        EXPECT_EQ(getPositions(graph.aStarSearch(2, 0)), std::vector<Position>({mThird, mSecond, mFirst}));
+        const PathgridGraph copy(graph);
+        EXPECT_EQ(getPositions(copy.aStarSearch(3, 0)), std::vector<Position>({mFourth, mFirst}));
+        EXPECT_EQ(getPositions(copy.aStarSearch(2, 0)), std::vector<Position>({mThird, mSecond, mFirst}));
+    }
+
+    TEST_F(MWMechanicsPathgridGraphTest, large_pathgrid_should_find_same_paths_without_routing_tables)
+    {
+        std::vector<std::vector<Position>> expected;
+        {
+            const PathgridGraph small(&mPathgrid);
+            for (int start = 0; start < 5; ++start)
+                for (int end = 0; end < 5; ++end)
+                    expected.push_back(getPositions(small.aStarSearch(start, end)));
+        }
+        addUnconnectedPoints();
+        const PathgridGraph large(&mPathgrid);
+        for (int start = 0; start < 5; ++start)
+            for (int end = 0; end < 5; ++end)
+                EXPECT_EQ(getPositions(large.aStarSearch(start, end)), expected[start * 5 + end]) << start << " " << end;
+    }
+
+    TEST_F(MWMechanicsPathgridGraphTest, graph_without_pathgrid_should_have_none)
+    {
+        const PathgridGraph graph(nullptr);
+        EXPECT_EQ(graph.getPathgrid(), nullptr);
+    }
+}
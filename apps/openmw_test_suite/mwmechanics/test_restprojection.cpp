@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include "apps/openmw/mwmechanics/restprojection.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWMechanics;
+
+    /// Rest hour by hour the way Actors::rest did for every hour of a wait
+    RestedDynamicStat restHourly(const DynamicStatRest& stat, int hours)
+    {
+        RestedDynamicStat result {stat.mCurrent, 0};
+        for (int hour = 0; hour < hours; ++hour)
+        {
+            if (result.mValue < stat.mMax)
+            {
+                const float restore = stat.mRestorePerHour * std::min(1.f, std::max(0.f, hour + 1 - stat.mRestoreDelay));
+                result.mValue = std::min(stat.mMax, result.mValue + restore);
+            }
+
+            float tick = 0;
+            for (const DynamicStatTick& effect : stat.mTicks)
+                tick += effect.mHours < 0 ? effect.mPerHour : effect.mPerHour * std::min(1.f, std::max(0.f, effect.mHours - hour));
+
+            float value = result.mValue + tick;
+            if (tick > 0)
+                value = result.mValue > stat.mMax ? result.mValue : std::min(stat.mMax, value);
+            if (value < stat.mDepletedBelow && result.mDepletionHour == 0)
+                result.mDepletionHour = hour + 1;
+            result.mValue = std::max(stat.mMin, value);
+        }
+        return result;
+    }
+
+    struct MWMechanicsRestProjectionTest : Test
+    {
+        DynamicStatRest mHealth {50, 100, 0, 1, 10, 0, {}};
+    };
+
+    TEST_F(MWMechanicsRestProjectionTest, restoration_should_stop_at_max)
+    {
+        EXPECT_FLOAT_EQ(projectRest(mHealth, 3).mValue, 80);
+        EXPECT_FLOAT_EQ(projectRest(mHealth, 24).mValue, 100);
+        EXPECT_EQ(projectRest(mHealth, 24).mDepletionHour, 0);
+    }
+
+    TEST_F(MWMechanicsRestProjectionTest, constant_damage_should_hold_stat_below_max_once_restoration_is_cut)
+    {
+        mHealth.mTicks.push_back({-4, -1});
+        EXPECT_FLOAT_EQ(projectRest(mHealth, 24).mValue, 96);
+        EXPECT_FLOAT_EQ(projectRest(mHealth, 1000).mValue, 96);
+        EXPECT_FLOAT_EQ(projectRest(mHealth, 5).mValue, 80);
+    }
+
+    TEST_F(MWMechanicsRestProjectionTest, lethal_damage_should_report_hour_of_depletion)
+    {
+        mHealth.mTicks.push_back({-25, -1});
+        const RestedDynamicStat result = projectRest(mHealth, 24);
+        EXPECT_EQ(result.mDepletionHour, 4);
+        EXPECT_FLOAT_EQ(result.mValue, 0);
+    }
+
+    TEST_F(MWMechanicsRestProjectionTest, stat_should_not_deplete_after_damage_expires)
+    {
+        mHealth.mTicks.push_back({-25, 1.5f});
+        const RestedDynamicStat result = projectRest(mHealth, 24);
+        EXPECT_EQ(result.mDepletionHour, 0);
+        EXPECT_FLOAT_EQ(result.mValue, 100);
+    }
+
+    TEST_F(MWMechanicsRestProjectionTest, stunted_restoration_should_start_after_delay)
+    {
+        mHealth.mRestoreDelay = 2.5f;
+        EXPECT_FLOAT_EQ(projectRest(mHealth, 2).mValue, 50);
+        EXPECT_FLOAT_EQ(projectRest(mHealth, 4).mValue, 65);
+    }
+
+    TEST_F(MWMechanicsRestProjectionTest, projection_should_match_resting_hour_by_hour)
+    {
+        const float lowest = std::numeric_limits<float>::lowest();
+        const std::vector<DynamicStatRest> stats {
+            {50, 100, 0, 1, 10, 0, {{-4, -1}}},
+            {50, 100, 0, 1, 10, 0, {{-4, -1}, {6, 3.25f}}},
+            {90, 100, 0, 1, 0, 0, {{5, -1}}},
+            {100, 100, 0, 1, 10, 0, {{-30, 2}, {-2, -1}}},
+            {120, 100, 0, 1, 10, 0, {{-7, -1}}},
+            {120, 100, 0, 1, 10, 0, {{3, -1}}},
+            {10, 100, 0, 1, 50, 0, {{-20, -1}}},
+            {40, 100, 0, 1, 5, 1.5f, {{-8, 6.5f}}},
+            {40, 100, lowest, lowest, 5, 0, {{-12, -1}}},
+            {30, 50, 0, lowest, 20, 0, {{-5, 0.75f}, {-5, 10}, {2, 4}}},
+        };
+        for (std::size_t i = 0; i < stats.size(); ++i)
+        {
+            for (const int hours : {1, 2, 5, 13, 24, 72})
+            {
+                const RestedDynamicStat expected = restHourly(stats[i], hours);
+                const RestedDynamicStat projected = projectRest(stats[i], hours);
+                EXPECT_NEAR(projected.mValue, expected.mValue, 1e-3f) << "stat " << i << " hours " << hours;
+                EXPECT_EQ(projected.mDepletionHour, expected.mDepletionHour) << "stat " << i << " hours " << hours;
+            }
+        }
+    }
+}
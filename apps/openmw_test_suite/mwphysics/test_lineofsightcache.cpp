@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <array>
+
+#include "apps/openmw/mwphysics/lineofsightcache.hpp"
+
+namespace
+{
+    using namespace testing;
+    using namespace MWPhysics;
+
+    struct MWPhysicsLineOfSightCacheTest : Test
+    {
+        // actors are only used as keys
+        std::array<char, 3> mStorage;
+        const Actor* const mActor1 = reinterpret_cast<const Actor*>(&mStorage[0]);
+        const Actor* const mActor2 = reinterpret_cast<const Actor*>(&mStorage[1]);
+        const Actor* const mActor3 = reinterpret_cast<const Actor*>(&mStorage[2]);
+        const osg::Vec3f mPosition1 {0, 0, 0};
+        const osg::Vec3f mPosition2 {1000, 0, 0};
+        LineOfSightCache mCache {0.25f, 16};
+    };
+
+    TEST_F(MWPhysicsLineOfSightCacheTest, get_should_return_false_when_empty)
+    {
+        bool lineOfSight = false;
+        EXPECT_FALSE(mCache.get(mActor1, mPosition1, mActor2, mPosition2, lineOfSight));
+    }
+
+    TEST_F(MWPhysicsLineOfSightCacheTest, get_should_return_inserted_result)
+    {
+        mCache.insert(mActor1, mPosition1, mActor2, mPosition2, true);
+        bool lineOfSight = false;
+        EXPECT_TRUE(mCache.get(mActor1, mPosition1, mActor2, mPosition2, lineOfSight));
+        EXPECT_TRUE(lineOfSight);
+        EXPECT_FALSE(mCache.get(mActor1, mPosition1, mActor3, mPosition2, lineOfSight));
+    }
+
+    TEST_F(MWPhysicsLineOfSightCacheTest, get_should_ignore_order_of_actors)
+    {
+        mCache.insert(mActor2, mPosition2, mActor1, mPosition1, true);
+        bool lineOfSight = false;
+        EXPECT_TRUE(mCache.get(mActor1, mPosition1, mActor2, mPosition2, lineOfSight));
+        EXPECT_TRUE(lineOfSight);
+        EXPECT_EQ(mCache.size(), 1u);
+    }
+
+    TEST_F(MWPhysicsLineOfSightCacheTest, get_should_return_false_when_actor_moved_further_than_tolerance)
+    {
+        mCache.insert(mActor1, mPosition1, mActor2, mPosition2, false);
+        bool lineOfSight = true;
+        EXPECT_TRUE(mCache.get(mActor1, mPosition1 + osg::Vec3f(10, 0, 0), mActor2, mPosition2, lineOfSight));
+        EXPECT_FALSE(lineOfSight);
+        EXPECT_FALSE(mCache.get(mActor1, mPosition1, mActor2, mPosition2 + osg::Vec3f(0, 20, 0), lineOfSight));
+    }
+
+    TEST_F(MWPhysicsLineOfSightCacheTest, update_should_remove_expired_results)
+    {
+        mCache.insert(mActor1, mPosition1, mActor2, mPosition2, true);
+        mCache.update(0.1f);
+        EXPECT_EQ(mCache.size(), 1u);
+        mCache.update(0.2f);
+        EXPECT_EQ(mCache.size(), 0u);
+    }
+
+    TEST_F(MWPhysicsLineOfSightCacheTest, update_should_report_hits_and_misses_of_last_frame)
+    {
+        bool lineOfSight = false;
+        mCache.get(mActor1, mPosition1, mActor2, mPosition2, lineOfSight);
+        mCache.insert(mActor1, mPosition1, mActor2, mPosition2, true);
+        mCache.get(mActor1, mPosition1, mActor2, mPosition2, lineOfSight);
+        mCache.get(mActor2, mPosition2, mActor1, mPosition1, lineOfSight);
+        mCache.update(0.1f);
+        EXPECT_EQ(mCache.getMisses(), 1u);
+        EXPECT_EQ(mCache.getHits(), 2u);
+        mCache.update(0.1f);
+        EXPECT_EQ(mCache.getMisses(), 0u);
+        EXPECT_EQ(mCache.getHits(), 0u);
+    }
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <osg/Math>
+
+#include <sstream>
+#include <stdexcept>
+
+#include "apps/openmw/mwworld/benchmarkpath.hpp"
+
+namespace
+{
+    using namespace testing;
+    using namespace MWWorld;
+
+    BenchmarkPath readPath(const std::string& text)
+    {
+        std::istringstream stream(text);
+        return BenchmarkPath::read(stream);
+    }
+
+    TEST(MWWorldBenchmarkPathTest, should_skip_empty_lines_and_comments)
+    {
+        const BenchmarkPath path = readPath("# time x y z\n\n  \n0 1 2 3\n");
+        ASSERT_FALSE(path.empty());
+        EXPECT_EQ(path.getDuration(), 0);
+        const BenchmarkWaypoint waypoint = path.getWaypoint(0);
+        EXPECT_EQ(waypoint.mPosition.asVec3(), osg::Vec3f(1, 2, 3));
+        EXPECT_EQ(waypoint.mCell, "");
+    }
+
+    TEST(MWWorldBenchmarkPathTest, should_read_rotation_and_interior_cell_name)
+    {
+        const BenchmarkPath path = readPath("1.5 1 2 3 90 -45 Balmora, Caius Cosades' House\r\n");
+        const BenchmarkWaypoint waypoint = path.getWaypoint(1.5);
+        EXPECT_FLOAT_EQ(waypoint.mPosition.rot[2], osg::PI_2f);
+        EXPECT_FLOAT_EQ(waypoint.mPosition.rot[0], -osg::PI_4f);
+        EXPECT_EQ(waypoint.mCell, "Balmora, Caius Cosades' House");
+    }
+
+    TEST(MWWorldBenchmarkPathTest, should_throw_on_malformed_line)
+    {
+        EXPECT_THROW(readPath("0 1 2\n"), std::runtime_error);
+        EXPECT_THROW(readPath("0 1 2 3 north\n"), std::runtime_error);
+    }
+
+    TEST(MWWorldBenchmarkPathTest, should_throw_on_decreasing_time)
+    {
+        EXPECT_THROW(readPath("1 0 0 0\n0 0 0 0\n"), std::runtime_error);
+    }
+
+    TEST(MWWorldBenchmarkPathTest, should_interpolate_between_waypoints_in_same_cell)
+    {
+        const BenchmarkPath path = readPath("0 0 0 0 170\n10 1000 -1000 100 -170\n");
+        EXPECT_EQ(path.getDuration(), 10);
+        const BenchmarkWaypoint waypoint = path.getWaypoint(2.5);
+        EXPECT_EQ(waypoint.mPosition.asVec3(), osg::Vec3f(250, -250, 25));
+        // the shorter way around is through 180 degrees
+        EXPECT_FLOAT_EQ(waypoint.mPosition.rot[2], osg::DegreesToRadians(175.f));
+    }
+
+    TEST(MWWorldBenchmarkPathTest, should_not_interpolate_between_cells)
+    {
+        const BenchmarkPath path = readPath("0 0 0 0\n10 1000 0 0 0 0 Vivec, Arena\n");
+        EXPECT_EQ(path.getWaypoint(9.9).mPosition.asVec3(), osg::Vec3f(0, 0, 0));
+        EXPECT_EQ(path.getWaypoint(9.9).mCell, "");
+        EXPECT_EQ(path.getWaypoint(10).mCell, "Vivec, Arena");
+    }
+
+    TEST(MWWorldBenchmarkPathTest, should_clamp_time_to_path)
+    {
+        const BenchmarkPath path = readPath("1 0 0 0\n2 10 0 0\n");
+        EXPECT_EQ(path.getWaypoint(0).mPosition.asVec3(), osg::Vec3f(0, 0, 0));
+        EXPECT_EQ(path.getWaypoint(3).mPosition.asVec3(), osg::Vec3f(10, 0, 0));
+    }
+}
@@ -0,0 +1,159 @@
+#include <components/resource/objectcache.hpp>
+
+#include <osg/Object>
+
+#include <gtest/gtest.h>
+
+#include <tuple>
+
+namespace
+{
+    using namespace testing;
+    using namespace Resource;
+
+    struct ResourceObjectCacheTest : Test
+    {
+        osg::ref_ptr<ObjectCache> mCache {new ObjectCache};
+        osg::ref_ptr<osg::Object> mFirst {new osg::Node};
+        osg::ref_ptr<osg::Object> mSecond {new osg::Node};
+        osg::ref_ptr<osg::Object> mThird {new osg::Node};
+    };
+
+    TEST_F(ResourceObjectCacheTest, get_for_empty_cache_should_return_nullptr_and_count_miss)
+    {
+        EXPECT_EQ(mCache->getRefFromObjectCache("first"), nullptr);
+        EXPECT_EQ(mCache->getHits(), 0u);
+        EXPECT_EQ(mCache->getMisses(), 1u);
+    }
+
+    TEST_F(ResourceObjectCacheTest, get_should_return_added_object_and_count_hit)
+    {
+        mCache->addEntryToObjectCache("first", mFirst);
+        EXPECT_EQ(mCache->getRefFromObjectCache("first"), mFirst);
+        EXPECT_EQ(mCache->getHits(), 1u);
+        EXPECT_EQ(mCache->getMisses(), 0u);
+    }
+
+    TEST_F(ResourceObjectCacheTest, get_cache_size_should_count_objects_in_all_shards)
+    {
+        for (int i = 0; i < 100; ++i)
+            mCache->addEntryToObjectCache(std::to_string(i), mFirst);
+        EXPECT_EQ(mCache->getCacheSize(), 100u);
+    }
+
+    TEST_F(ResourceObjectCacheTest, total_cost_should_be_sum_of_costs)
+    {
+        mCache->addEntryToObjectCache("first", mFirst, 0.0, 1);
+        mCache->addEntryToObjectCache("second", mSecond, 0.0, 2);
+        EXPECT_EQ(mCache->getTotalCost(), 3u);
+    }
+
+    TEST_F(ResourceObjectCacheTest, add_should_replace_cost_of_existing_object)
+    {
+        mCache->addEntryToObjectCache("first", mFirst, 0.0, 1);
+        mCache->addEntryToObjectCache("first", mSecond, 0.0, 2);
+        EXPECT_EQ(mCache->getRefFromObjectCache("first"), mSecond);
+        EXPECT_EQ(mCache->getTotalCost(), 2u);
+    }
+
+    TEST_F(ResourceObjectCacheTest, remove_and_clear_should_subtract_cost)
+    {
+        mCache->addEntryToObjectCache("first", mFirst, 0.0, 1);
+        mCache->addEntryToObjectCache("second", mSecond, 0.0, 2);
+        mCache->removeFromObjectCache("first");
+        EXPECT_EQ(mCache->getTotalCost(), 2u);
+        mCache->clear();
+        EXPECT_EQ(mCache->getTotalCost(), 0u);
+        EXPECT_EQ(mCache->getCacheSize(), 0u);
+    }
+
+    TEST_F(ResourceObjectCacheTest, remove_expired_should_subtract_cost)
+    {
+        mCache->addEntryToObjectCache("first", mFirst, 1.0, 1);
+        mCache->addEntryToObjectCache("second", mSecond, 3.0, 2);
+        mCache->removeExpiredObjectsInCache(2.0);
+        EXPECT_EQ(mCache->getRefFromObjectCache("first"), nullptr);
+        EXPECT_EQ(mCache->getTotalCost(), 2u);
+    }
+
+    TEST_F(ResourceObjectCacheTest, remove_least_recently_used_without_limit_should_keep_all)
+    {
+        mCache->addEntryToObjectCache("first", mFirst, 0.0, 1);
+        mCache->removeLeastRecentlyUsedObjectsInCache();
+        EXPECT_EQ(mCache->getCacheSize(), 1u);
+        EXPECT_EQ(mCache->getEvictions(), 0u);
+    }
+
+    TEST_F(ResourceObjectCacheTest, remove_least_recently_used_should_remove_unreferenced_until_within_limit)
+    {
+        mCache->setMaxCost(2);
+        mCache->addEntryToObjectCache("first", mFirst.get(), 0.0, 1);
+        mCache->addEntryToObjectCache("second", mSecond.get(), 0.0, 1);
+        mCache->addEntryToObjectCache("third", mThird.get(), 0.0, 1);
+        mFirst = nullptr;
+        mSecond = nullptr;
+        mThird = nullptr;
+        EXPECT_NE(mCache->getRefFromObjectCache("first"), nullptr);
+        mCache->removeLeastRecentlyUsedObjectsInCache();
+        EXPECT_EQ(mCache->getEvictions(), 1u);
+        EXPECT_EQ(mCache->getTotalCost(), 2u);
+        EXPECT_NE(mCache->getRefFromObjectCache("first"), nullptr);
+        EXPECT_EQ(mCache->getRefFromObjectCache("second"), nullptr);
+        EXPECT_NE(mCache->getRefFromObjectCache("third"), nullptr);
+    }
+
+    TEST_F(ResourceObjectCacheTest, remove_least_recently_used_should_keep_referenced_objects)
+    {
+        mCache->setMaxCost(1);
+        mCache->addEntryToObjectCache("first", mFirst.get(), 0.0, 1);
+        mCache->addEntryToObjectCache("second", mSecond.get(), 0.0, 1);
+        mSecond = nullptr;
+        mCache->removeLeastRecentlyUsedObjectsInCache();
+        EXPECT_EQ(mCache->getRefFromObjectCache("first"), mFirst);
+        EXPECT_EQ(mCache->getRefFromObjectCache("second"), nullptr);
+        EXPECT_EQ(mCache->getTotalCost(), 1u);
+    }
+
+    TEST_F(ResourceObjectCacheTest, caches_sharing_budget_should_remove_least_recently_used_from_any_cache)
+    {
+        using Key = std::pair<int, int>;
+        osg::ref_ptr<GenericObjectCache<Key>> other(new GenericObjectCache<Key>);
+        other->setBudget(mCache->getBudget());
+        mCache->setMaxCost(2);
+        mCache->addEntryToObjectCache("first", mFirst.get(), 0.0, 1);
+        other->addEntryToObjectCache(Key(1, 2), mSecond.get(), 0.0, 1);
+        mCache->addEntryToObjectCache("third", mThird.get(), 0.0, 1);
+        mFirst = nullptr;
+        mSecond = nullptr;
+        mThird = nullptr;
+        EXPECT_EQ(mCache->getBudget()->getTotalCost(), 3u);
+        EXPECT_NE(mCache->getRefFromObjectCache("first"), nullptr);
+        mCache->removeLeastRecentlyUsedObjectsInCache();
+        EXPECT_EQ(mCache->getBudget()->getTotalCost(), 2u);
+        EXPECT_EQ(mCache->getTotalCost(), 2u);
+        EXPECT_EQ(other->getTotalCost(), 0u);
+        EXPECT_EQ(other->getEvictions(), 1u);
+        EXPECT_EQ(other->getRefFromObjectCache(Key(1, 2)), nullptr);
+    }
+
+    TEST_F(ResourceObjectCacheTest, set_budget_should_move_cost_to_new_budget)
+    {
+        osg::ref_ptr<CacheBudget> budget(new CacheBudget);
+        mCache->addEntryToObjectCache("first", mFirst, 0.0, 1);
+        osg::ref_ptr<CacheBudget> previous = mCache->getBudget();
+        mCache->setBudget(budget);
+        EXPECT_EQ(previous->getTotalCost(), 0u);
+        EXPECT_EQ(budget->getTotalCost(), 1u);
+        mCache = nullptr;
+        EXPECT_EQ(budget->getTotalCost(), 0u);
+    }
+
+    TEST_F(ResourceObjectCacheTest, should_support_tuple_keys)
+    {
+        using Key = std::tuple<osg::Vec2f, unsigned char, unsigned int>;
+        osg::ref_ptr<GenericObjectCache<Key>> cache(new GenericObjectCache<Key>);
+        cache->addEntryToObjectCache(Key(osg::Vec2f(1, 2), 3, 4), mFirst);
+        EXPECT_EQ(cache->getRefFromObjectCache(Key(osg::Vec2f(1, 2), 3, 4)), mFirst);
+        EXPECT_EQ(cache->getRefFromObjectCache(Key(osg::Vec2f(1, 2), 3, 5)), nullptr);
+    }
+}
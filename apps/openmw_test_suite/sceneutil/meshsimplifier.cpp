@@ -0,0 +1,111 @@
+#include <components/sceneutil/meshsimplifier.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    struct SceneUtilMeshSimplifierTest : Test
+    {
+        std::vector<osg::Vec3f> mVertices;
+        std::vector<unsigned int> mIndices;
+
+        /// Grid of size x size quads split into two triangles each.
+        void makeGrid(unsigned int size, float height = 0)
+        {
+            for (unsigned int y = 0; y <= size; ++y)
+                for (unsigned int x = 0; x <= size; ++x)
+                    mVertices.emplace_back(x, y, (x % 2) * height);
+            for (unsigned int y = 0; y < size; ++y)
+            {
+                for (unsigned int x = 0; x < size; ++x)
+                {
+                    const unsigned int v = y * (size + 1) + x;
+                    mIndices.insert(mIndices.end(), {v, v + 1, v + size + 2, v, v + size + 2, v + size + 1});
+                }
+            }
+        }
+
+        void expectValidTriangles() const
+        {
+            ASSERT_EQ(mIndices.size() % 3, 0u);
+            for (std::size_t i = 0; i < mIndices.size(); i += 3)
+            {
+                for (std::size_t j = 0; j < 3; ++j)
+                    EXPECT_LT(mIndices[i + j], mVertices.size());
+                const osg::Vec3f& v0 = mVertices[mIndices[i]];
+                const osg::Vec3f normal = (mVertices[mIndices[i + 1]] - v0) ^ (mVertices[mIndices[i + 2]] - v0);
+                EXPECT_GT(normal.z(), 0) << "triangle " << i / 3;
+            }
+        }
+    };
+
+    TEST_F(SceneUtilMeshSimplifierTest, flat_grid_should_be_reduced_to_its_corners)
+    {
+        makeGrid(8);
+        const float error = simplifyTriangles(mVertices, mIndices, 0, 1e-3f);
+        EXPECT_EQ(mIndices.size(), 6u);
+        EXPECT_FLOAT_EQ(error, 0);
+        expectValidTriangles();
+        std::vector<unsigned int> corners = mIndices;
+        std::sort(corners.begin(), corners.end());
+        corners.erase(std::unique(corners.begin(), corners.end()), corners.end());
+        EXPECT_THAT(corners, ElementsAre(0u, 8u, 72u, 80u));
+    }
+
+    TEST_F(SceneUtilMeshSimplifierTest, should_stop_at_target_number_of_triangles)
+    {
+        makeGrid(8, 1);
+        simplifyTriangles(mVertices, mIndices, 64, std::numeric_limits<float>::max());
+        EXPECT_LE(mIndices.size(), 64u * 3);
+        EXPECT_GE(mIndices.size(), 62u * 3);
+        expectValidTriangles();
+    }
+
+    TEST_F(SceneUtilMeshSimplifierTest, should_not_exceed_max_error)
+    {
+        makeGrid(8, 1);
+        const float error = simplifyTriangles(mVertices, mIndices, 0, 0.5f);
+        EXPECT_LE(error, 0.5f);
+        // each flat strip between the ridges is reduced to two triangles
+        EXPECT_EQ(mIndices.size(), 16u * 3);
+        expectValidTriangles();
+    }
+
+    TEST_F(SceneUtilMeshSimplifierTest, should_return_error_of_collapsed_edges)
+    {
+        makeGrid(8, 1);
+        const float error = simplifyTriangles(mVertices, mIndices, 8, std::numeric_limits<float>::max());
+        EXPECT_GT(error, 0.5f);
+        EXPECT_LE(mIndices.size(), 8u * 3);
+    }
+
+    TEST_F(SceneUtilMeshSimplifierTest, should_keep_vertices_on_seams)
+    {
+        makeGrid(2);
+        // split the center vertex as if it had different texture coordinates in the triangles of the upper row
+        mVertices.push_back(mVertices[4]);
+        for (std::size_t i = 12; i < mIndices.size(); ++i)
+            if (mIndices[i] == 4)
+                mIndices[i] = 9;
+        simplifyTriangles(mVertices, mIndices, 0, 1e-3f);
+        EXPECT_THAT(mIndices, Contains(4u));
+        EXPECT_THAT(mIndices, Contains(9u));
+        expectValidTriangles();
+    }
+
+    TEST_F(SceneUtilMeshSimplifierTest, should_ignore_degenerate_triangles)
+    {
+        makeGrid(1);
+        mIndices.insert(mIndices.end(), {0, 0, 1});
+        simplifyTriangles(mVertices, mIndices, 0, 1e-3f);
+        EXPECT_EQ(mIndices.size(), 6u);
+        expectValidTriangles();
+    }
+}
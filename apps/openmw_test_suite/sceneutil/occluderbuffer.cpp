@@ -0,0 +1,94 @@
+#include <components/sceneutil/occluderbuffer.hpp>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    struct SceneUtilOccluderBufferTest : Test
+    {
+        OccluderBuffer mBuffer {64, 64};
+
+        SceneUtilOccluderBufferTest()
+        {
+            // looking along the y axis from the origin
+            const osg::Matrixf view = osg::Matrixf::lookAt(osg::Vec3f(0, 0, 0), osg::Vec3f(0, 1, 0), osg::Vec3f(0, 0, 1));
+            const osg::Matrixf projection = osg::Matrixf::perspective(90, 1, 1, 10000);
+            mBuffer.reset(view * projection);
+        }
+
+        void addQuad(const osg::Vec3f& a, const osg::Vec3f& b, const osg::Vec3f& c, const osg::Vec3f& d)
+        {
+            mBuffer.addTriangles({a, b, c, d}, {0, 1, 2, 0, 2, 3});
+        }
+
+        /// Square facing the eye at the given distance.
+        void addWall(float distance, float halfSize)
+        {
+            addQuad(osg::Vec3f(-halfSize, distance, -halfSize), osg::Vec3f(halfSize, distance, -halfSize),
+                    osg::Vec3f(halfSize, distance, halfSize), osg::Vec3f(-halfSize, distance, halfSize));
+        }
+    };
+
+    TEST_F(SceneUtilOccluderBufferTest, empty_buffer_should_have_far_depth)
+    {
+        EXPECT_EQ(mBuffer.getNumTriangles(), 0u);
+        EXPECT_EQ(mBuffer.getDepth(32, 32), 1.f);
+        EXPECT_TRUE(mBuffer.isVisible(osg::BoundingBox(-1, 99, -1, 1, 101, 1)));
+    }
+
+    TEST_F(SceneUtilOccluderBufferTest, box_behind_occluder_should_be_hidden)
+    {
+        addWall(100, 10);
+        EXPECT_EQ(mBuffer.getNumTriangles(), 2u);
+        EXPECT_LT(mBuffer.getDepth(32, 32), 1.f);
+        EXPECT_FALSE(mBuffer.isVisible(osg::BoundingBox(-1, 199, -1, 1, 201, 1)));
+    }
+
+    TEST_F(SceneUtilOccluderBufferTest, box_in_front_of_occluder_should_be_visible)
+    {
+        addWall(100, 10);
+        EXPECT_TRUE(mBuffer.isVisible(osg::BoundingBox(-1, 49, -1, 1, 51, 1)));
+    }
+
+    TEST_F(SceneUtilOccluderBufferTest, box_intersecting_occluder_should_be_visible)
+    {
+        addWall(100, 10);
+        EXPECT_TRUE(mBuffer.isVisible(osg::BoundingBox(-1, 99, -1, 1, 101, 1)));
+    }
+
+    TEST_F(SceneUtilOccluderBufferTest, box_reaching_out_of_occluder_should_be_visible)
+    {
+        addWall(100, 10);
+        EXPECT_TRUE(mBuffer.isVisible(osg::BoundingBox(15, 199, -1, 25, 201, 1)));
+    }
+
+    TEST_F(SceneUtilOccluderBufferTest, box_reaching_through_near_plane_should_be_visible)
+    {
+        addWall(100, 10);
+        EXPECT_TRUE(mBuffer.isVisible(osg::BoundingBox(-1, -10, -1, 1, 201, 1)));
+    }
+
+    TEST_F(SceneUtilOccluderBufferTest, occluder_crossing_near_plane_should_be_clipped)
+    {
+        // slope rising from behind the eye, crossing the view direction 50 units ahead
+        addQuad(osg::Vec3f(-1000, -50, -100), osg::Vec3f(1000, -50, -100),
+                osg::Vec3f(1000, 1050, 1000), osg::Vec3f(-1000, 1050, 1000));
+        EXPECT_EQ(mBuffer.getNumTriangles(), 2u);
+        EXPECT_FALSE(mBuffer.isVisible(osg::BoundingBox(-1, 299, -1, 1, 301, 1)));
+        EXPECT_TRUE(mBuffer.isVisible(osg::BoundingBox(-1, 29, -1, 1, 31, 1)));
+    }
+
+    TEST_F(SceneUtilOccluderBufferTest, box_should_be_tested_in_given_space)
+    {
+        addWall(100, 10);
+        const osg::Matrixf view = osg::Matrixf::lookAt(osg::Vec3f(0, 0, 0), osg::Vec3f(0, 1, 0), osg::Vec3f(0, 0, 1));
+        const osg::Matrixf projection = osg::Matrixf::perspective(90, 1, 1, 10000);
+        const osg::Matrixf behind = osg::Matrixf::translate(0, 200, 0) * view * projection;
+        EXPECT_FALSE(mBuffer.isVisible(osg::BoundingBox(-1, -1, -1, 1, 1, 1), behind));
+        const osg::Matrixf aside = osg::Matrixf::translate(100, 200, 0) * view * projection;
+        EXPECT_TRUE(mBuffer.isVisible(osg::BoundingBox(-1, -1, -1, 1, 1, 1), aside));
+    }
+}
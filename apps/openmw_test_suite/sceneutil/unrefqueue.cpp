@@ -0,0 +1,81 @@
+#include <components/sceneutil/unrefqueue.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    struct Counted : osg::Referenced
+    {
+        std::atomic<int>& mDeleted;
+
+        Counted(std::atomic<int>& deleted) : mDeleted(deleted) {}
+
+        ~Counted() { ++mDeleted; }
+    };
+
+    struct SceneUtilUnrefQueueTest : Test
+    {
+        std::atomic<int> mDeleted {0};
+
+        void waitForDeleted(int expected)
+        {
+            const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while (mDeleted < expected && std::chrono::steady_clock::now() < end)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+
+    TEST_F(SceneUtilUnrefQueueTest, push_should_keep_object_until_flush)
+    {
+        osg::ref_ptr<UnrefQueue> queue(new UnrefQueue);
+        queue->push(new Counted(mDeleted));
+        EXPECT_EQ(queue->getNumItems(), 1u);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        EXPECT_EQ(mDeleted, 0);
+        queue->flush();
+        waitForDeleted(1);
+        EXPECT_EQ(mDeleted, 1);
+        EXPECT_EQ(queue->getNumItems(), 0u);
+    }
+
+    TEST_F(SceneUtilUnrefQueueTest, destructor_should_unref_remaining_objects)
+    {
+        osg::ref_ptr<UnrefQueue> queue(new UnrefQueue);
+        queue->push(new Counted(mDeleted));
+        queue->push(new Counted(mDeleted));
+        queue->flush();
+        queue->push(new Counted(mDeleted));
+        queue = nullptr;
+        EXPECT_EQ(mDeleted, 3);
+    }
+
+    TEST_F(SceneUtilUnrefQueueTest, push_from_multiple_threads_should_unref_all_objects)
+    {
+        constexpr int threadsCount = 4;
+        constexpr int objectsCount = 10000;
+        osg::ref_ptr<UnrefQueue> queue(new UnrefQueue(0.0001));
+        std::vector<std::thread> threads;
+        for (int i = 0; i < threadsCount; ++i)
+            threads.emplace_back([&] {
+                for (int j = 0; j < objectsCount; ++j)
+                    queue->push(new Counted(mDeleted));
+            });
+        for (int i = 0; i < 100 && mDeleted < threadsCount * objectsCount; ++i)
+        {
+            queue->flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        for (auto& thread : threads)
+            thread.join();
+        queue = nullptr;
+        EXPECT_EQ(mDeleted, threadsCount * objectsCount);
+    }
+}
@@ -318,6 +318,8 @@ namespace Compiler
         const int opcodeDisableExplicit = 0x200031b;
         const int opcodeGetDisabledExplicit = 0x200031c;
         const int opcodeStartScriptExplicit = 0x200031d;
+        const int opcodeToggleTrace = 0x2000320;
+        const int opcodeWriteTrace = 0x2000321;
     }
 
     namespace Sky
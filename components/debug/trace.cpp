@@ -0,0 +1,165 @@
+#include "trace.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Debug
+{
+    namespace
+    {
+        struct TraceEvent
+        {
+            const char* mName;
+            std::int64_t mBegin;
+            std::int64_t mEnd;
+        };
+
+        /// Ring buffer slot. The sequence is the index of the event in the slot plus one, or zero while the owning
+        /// thread writes to it, so a reader can tell a complete event from one overwritten during the read.
+        struct TraceSlot
+        {
+            std::atomic<std::size_t> mSequence {0};
+            std::atomic<const char*> mName {nullptr};
+            std::atomic<std::int64_t> mBegin {0};
+            std::atomic<std::int64_t> mEnd {0};
+        };
+
+        struct ThreadEvents
+        {
+            static constexpr std::size_t sCapacity = 1 << 16;
+
+            const unsigned int mId;
+            const char* mName = nullptr;
+            std::unique_ptr<TraceSlot[]> mEvents;
+            std::atomic<std::size_t> mCount {0};
+
+            explicit ThreadEvents(unsigned int id) : mId(id) {}
+        };
+
+        constexpr std::size_t ThreadEvents::sCapacity;
+
+        const std::chrono::steady_clock::time_point sStart = std::chrono::steady_clock::now();
+
+        std::mutex sThreadsMutex;
+        std::vector<std::unique_ptr<ThreadEvents>> sThreads;
+
+        thread_local ThreadEvents* sThreadEvents = nullptr;
+
+        ThreadEvents& getThreadEvents()
+        {
+            if (sThreadEvents == nullptr)
+            {
+                std::lock_guard<std::mutex> lock(sThreadsMutex);
+                sThreads.emplace_back(new ThreadEvents(static_cast<unsigned int>(sThreads.size())));
+                sThreadEvents = sThreads.back().get();
+            }
+            return *sThreadEvents;
+        }
+
+        void writeString(std::ostream& stream, const char* value)
+        {
+            stream << '"';
+            for (; *value != '\0'; ++value)
+            {
+                if (*value == '"' || *value == '\\')
+                    stream << '\\';
+                stream << *value;
+            }
+            stream << '"';
+        }
+
+        /// @return False if the event was not written yet or was overwritten while reading.
+        bool readEvent(const ThreadEvents& events, std::size_t index, TraceEvent& event)
+        {
+            const TraceSlot& slot = events.mEvents[index % ThreadEvents::sCapacity];
+            if (slot.mSequence.load(std::memory_order_acquire) != index + 1)
+                return false;
+            event.mName = slot.mName.load(std::memory_order_relaxed);
+            event.mBegin = slot.mBegin.load(std::memory_order_relaxed);
+            event.mEnd = slot.mEnd.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return slot.mSequence.load(std::memory_order_relaxed) == index + 1;
+        }
+
+        void writeMicroseconds(std::ostream& stream, std::int64_t nanoseconds)
+        {
+            stream << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000;
+        }
+    }
+
+    std::atomic<bool> Tracer::sEnabled {false};
+
+    void Tracer::setEnabled(bool enabled)
+    {
+        sEnabled = enabled;
+    }
+
+    void Tracer::setThreadName(const char* name)
+    {
+        ThreadEvents& events = getThreadEvents();
+        std::lock_guard<std::mutex> lock(sThreadsMutex);
+        events.mName = name;
+    }
+
+    std::int64_t Tracer::now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sStart).count();
+    }
+
+    void Tracer::record(const char* name, std::int64_t begin, std::int64_t end)
+    {
+        ThreadEvents& events = getThreadEvents();
+        if (events.mEvents == nullptr)
+            events.mEvents.reset(new TraceSlot[ThreadEvents::sCapacity]);
+        const std::size_t count = events.mCount.load(std::memory_order_relaxed);
+        TraceSlot& slot = events.mEvents[count % ThreadEvents::sCapacity];
+        slot.mSequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.mName.store(name, std::memory_order_relaxed);
+        slot.mBegin.store(begin, std::memory_order_relaxed);
+        slot.mEnd.store(end, std::memory_order_relaxed);
+        slot.mSequence.store(count + 1, std::memory_order_release);
+        events.mCount.store(count + 1, std::memory_order_release);
+    }
+
+    void Tracer::write(std::ostream& stream)
+    {
+        std::lock_guard<std::mutex> lock(sThreadsMutex);
+        stream << "{\"traceEvents\":[";
+        bool first = true;
+        for (const auto& thread : sThreads)
+        {
+            if (thread->mName != nullptr)
+            {
+                stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->mId
+                       << ",\"args\":{\"name\":";
+                writeString(stream, thread->mName);
+                stream << "}}";
+                first = false;
+            }
+
+            // events recorded after the count is taken are not written, the ones overwritten by them are skipped
+            const std::size_t count = thread->mCount.load(std::memory_order_acquire);
+            const std::size_t begin = count > ThreadEvents::sCapacity ? count - ThreadEvents::sCapacity : 0;
+            for (std::size_t i = begin; i < count; ++i)
+            {
+                TraceEvent event;
+                if (!readEvent(*thread, i, event))
+                    continue;
+                stream << (first ? "" : ",") << "\n{\"name\":";
+                writeString(stream, event.mName);
+                stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->mId << ",\"ts\":";
+                writeMicroseconds(stream, event.mBegin);
+                stream << ",\"dur\":";
+                writeMicroseconds(stream, event.mEnd - event.mBegin);
+                stream << '}';
+                first = false;
+            }
+        }
+        stream << "\n]}\n";
+    }
+}
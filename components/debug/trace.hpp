@@ -0,0 +1,68 @@
+#ifndef OPENMW_COMPONENTS_DEBUG_TRACE_H
+#define OPENMW_COMPONENTS_DEBUG_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+namespace Debug
+{
+    /// @brief Records named time ranges of all threads, to be written in the Chrome trace event format and viewed
+    /// with chrome://tracing or Perfetto.
+    /// @par Each thread appends to its own ring buffer without locking and keeps only its latest events.
+    /// While disabled, a zone costs a single relaxed atomic load.
+    class Tracer
+    {
+    public:
+        static bool isEnabled()
+        {
+            return sEnabled.load(std::memory_order_relaxed);
+        }
+
+        static void setEnabled(bool enabled);
+
+        /// Name the calling thread in the trace.
+        /// @param name Must outlive the tracer, e.g. a string literal.
+        static void setThreadName(const char* name);
+
+        /// @return Nanoseconds since the start of the process.
+        static std::int64_t now();
+
+        /// @param name Must outlive the tracer, e.g. a string literal.
+        static void record(const char* name, std::int64_t begin, std::int64_t end);
+
+        /// Write the recorded events of all threads as a JSON object. Threads may keep recording meanwhile, events
+        /// overwritten while writing are left out.
+        static void write(std::ostream& stream);
+
+    private:
+        static std::atomic<bool> sEnabled;
+    };
+
+    /// Records the lifetime of the object as a time range of the calling thread.
+    class TraceZone
+    {
+    public:
+        /// @param name Must outlive the tracer, e.g. a string literal.
+        explicit TraceZone(const char* name)
+            : mName(Tracer::isEnabled() ? name : nullptr)
+            , mBegin(mName == nullptr ? 0 : Tracer::now())
+        {
+        }
+
+        TraceZone(const TraceZone&) = delete;
+        TraceZone& operator=(const TraceZone&) = delete;
+
+        ~TraceZone()
+        {
+            if (mName != nullptr)
+                Tracer::record(mName, mBegin, Tracer::now());
+        }
+
+    private:
+        const char* const mName;
+        const std::int64_t mBegin;
+    };
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include "settings.hpp"
 
 #include <components/debug/debuglog.hpp>
+#include <components/debug/trace.hpp>
 
 #include <osg/Stats>
 
@@ -49,7 +50,10 @@ namespace DetourNavigator
         , mOffMeshConnectionsManager(offMeshConnectionsManager)
         , mShouldStop()
         , mNavMeshTilesCache(settings.mMaxNavMeshTilesCacheSize)
+        , mStaticHeightfieldCache(settings.mMaxStaticHeightfieldCacheSize)
     {
+        if (!mSettings.get().mNavMeshDiskCachePath.empty())
+            mNavMeshDiskCache = std::make_unique<NavMeshDiskCache>(mSettings.get().mNavMeshDiskCachePath, settings);
         for (std::size_t i = 0; i < mSettings.get().mAsyncNavMeshUpdaterThreads; ++i)
             mThreads.emplace_back([&] { process(); });
     }
@@ -129,6 +133,7 @@ namespace DetourNavigator
     void AsyncNavMeshUpdater::process() throw()
     {
         Log(Debug::Debug) << "Start process navigator jobs by thread=" << std::this_thread::get_id();
+        Debug::Tracer::setThreadName("AsyncNavMeshUpdater");
         while (!mShouldStop)
         {
             try
@@ -153,6 +158,8 @@ namespace DetourNavigator
 
     bool AsyncNavMeshUpdater::processJob(const Job& job)
     {
+        Debug::TraceZone zone("NavMeshJob");
+
         Log(Debug::Debug) << "Process job for agent=(" << std::fixed << std::setprecision(2) << job.mAgentHalfExtents << ")"
             " by thread=" << std::this_thread::get_id();
 
@@ -170,7 +177,8 @@ namespace DetourNavigator
         const auto offMeshConnections = mOffMeshConnectionsManager.get().get(job.mChangedTile);
 
         const auto status = updateNavMesh(job.mAgentHalfExtents, recastMesh.get(), job.mChangedTile, playerTile,
-            offMeshConnections, mSettings, navMeshCacheItem, mNavMeshTilesCache);
+            offMeshConnections, mSettings, navMeshCacheItem, mNavMeshTilesCache, mNavMeshDiskCache.get(),
+            mStaticHeightfieldCache);
 
         const auto finish = std::chrono::steady_clock::now();
 
@@ -0,0 +1,200 @@
+#include "asyncpathfinder.hpp"
+#include "findsmoothpath.hpp"
+#include "settings.hpp"
+#include "settingsutils.hpp"
+
+#include <components/debug/debuglog.hpp>
+#include <components/debug/trace.hpp>
+
+#include <osg/Stats>
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+    // number of last searches to report duration of
+    const std::size_t maxReportedDurations = 100;
+}
+
+namespace DetourNavigator
+{
+    PathRequest::PathRequest(const osg::Vec3f& agentHalfExtents, const float stepSize, const osg::Vec3f& start,
+            const osg::Vec3f& end, const Flags includeFlags, const AreaCosts& areaCosts)
+        : mAgentHalfExtents(agentHalfExtents)
+        , mStepSize(stepSize)
+        , mStart(start)
+        , mEnd(end)
+        , mIncludeFlags(includeFlags)
+        , mAreaCosts(areaCosts)
+        , mStatus(Status::Success)
+        , mDone(false)
+    {
+    }
+
+    void PathRequest::setResult(Status status, std::deque<osg::Vec3f>&& path)
+    {
+        mStatus = status;
+        mPath = std::move(path);
+        mDone = true;
+    }
+
+    AsyncPathFinder::AsyncPathFinder(const Settings& settings)
+        : mSettings(settings)
+        , mShouldStop()
+        , mProcessingJobs(0)
+    {
+        for (std::size_t i = 0; i < mSettings.get().mAsyncPathFinderThreads; ++i)
+            mThreads.emplace_back([&] { process(); });
+    }
+
+    AsyncPathFinder::~AsyncPathFinder()
+    {
+        mShouldStop = true;
+        std::unique_lock<std::mutex> lock(mMutex);
+        mJobs.clear();
+        mHasJob.notify_all();
+        lock.unlock();
+        for (auto& thread : mThreads)
+            thread.join();
+    }
+
+    void AsyncPathFinder::post(const SharedNavMeshCacheItem& navMeshCacheItem,
+        const std::shared_ptr<PathRequest>& request)
+    {
+        if (!navMeshCacheItem)
+        {
+            request->setResult(Status::NavMeshNotFound, {});
+            return;
+        }
+
+        if (mThreads.empty())
+        {
+            processJob(Job {navMeshCacheItem, request});
+            return;
+        }
+
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mJobs.push_back(Job {navMeshCacheItem, request});
+        mHasJob.notify_one();
+    }
+
+    void AsyncPathFinder::wait()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [&] { return mJobs.empty() && mProcessingJobs == 0; });
+    }
+
+    void AsyncPathFinder::reportStats(unsigned int frameNumber, osg::Stats& stats) const
+    {
+        std::size_t jobs = 0;
+        std::chrono::steady_clock::duration total {0};
+        std::chrono::steady_clock::duration max {0};
+        std::size_t durations = 0;
+
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            jobs = mJobs.size() + mProcessingJobs;
+            for (const auto& duration : mDurations)
+            {
+                total += duration;
+                max = std::max(max, duration);
+            }
+            durations = mDurations.size();
+        }
+
+        using Milliseconds = std::chrono::duration<double, std::milli>;
+
+        stats.setAttribute(frameNumber, "NavMesh PathJobs", jobs);
+        if (durations > 0)
+        {
+            stats.setAttribute(frameNumber, "NavMesh PathTime", Milliseconds(total).count() / durations);
+            stats.setAttribute(frameNumber, "NavMesh PathTimeMax", Milliseconds(max).count());
+        }
+    }
+
+    void AsyncPathFinder::process() throw()
+    {
+        Log(Debug::Debug) << "Start process path requests by thread=" << std::this_thread::get_id();
+        Debug::Tracer::setThreadName("AsyncPathFinder");
+        while (!mShouldStop)
+        {
+            try
+            {
+                Job job;
+                {
+                    std::unique_lock<std::mutex> lock(mMutex);
+                    mHasJob.wait(lock, [&] { return mShouldStop || !mJobs.empty(); });
+                    if (mShouldStop)
+                        break;
+                    job = std::move(mJobs.front());
+                    mJobs.pop_front();
+                    ++mProcessingJobs;
+                }
+                // wait would block forever if the job isn't accounted as done
+                try
+                {
+                    processJob(job);
+                }
+                catch (const std::exception& e)
+                {
+                    Log(Debug::Error) << "AsyncPathFinder::process exception: " << e.what();
+                }
+                {
+                    const std::lock_guard<std::mutex> lock(mMutex);
+                    --mProcessingJobs;
+                }
+                mDone.notify_all();
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Error) << "AsyncPathFinder::process exception: " << e.what();
+            }
+        }
+        Log(Debug::Debug) << "Stop path requests processing by thread=" << std::this_thread::get_id();
+    }
+
+    void AsyncPathFinder::processJob(const Job& job)
+    {
+        PathRequest& request = *job.mRequest;
+
+        // the requester is gone, nobody would read the path
+        if (job.mRequest.use_count() == 1)
+        {
+            request.setResult(Status::Success, {});
+            return;
+        }
+
+        Debug::TraceZone zone("PathJob");
+
+        const auto start = std::chrono::steady_clock::now();
+
+        const auto& settings = mSettings.get();
+        std::deque<osg::Vec3f> path;
+        auto out = std::back_inserter(path);
+        Status status = Status::NavMeshNotFound;
+        try
+        {
+            status = findSmoothPath(job.mNavMeshCacheItem->lockConst()->getImpl(),
+                toNavMeshCoordinates(settings, request.getAgentHalfExtents()),
+                toNavMeshCoordinates(settings, request.getStepSize()), toNavMeshCoordinates(settings, request.getStart()),
+                toNavMeshCoordinates(settings, request.getEnd()), request.getIncludeFlags(), request.getAreaCosts(),
+                settings, out);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to find path: " << e.what();
+            path.clear();
+            status = Status::FindPathOverPolygonsFailed;
+        }
+
+        const auto duration = std::chrono::steady_clock::now() - start;
+
+        request.setResult(status, std::move(path));
+
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mDurations.push_back(duration);
+        if (mDurations.size() > maxReportedDurations)
+            mDurations.pop_front();
+    }
+}
@@ -0,0 +1,114 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_ASYNCPATHFINDER_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_ASYNCPATHFINDER_H
+
+#include "areatype.hpp"
+#include "flags.hpp"
+#include "navmeshcacheitem.hpp"
+#include "status.hpp"
+
+#include <osg/Vec3f>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace DetourNavigator
+{
+    struct Settings;
+
+    /**
+     * @brief PathRequest is a path search posted to AsyncPathFinder. Status and path may be read only after isDone
+     * returns true, they don't change after that.
+     */
+    class PathRequest
+    {
+    public:
+        PathRequest(const osg::Vec3f& agentHalfExtents, const float stepSize, const osg::Vec3f& start,
+            const osg::Vec3f& end, const Flags includeFlags, const AreaCosts& areaCosts);
+
+        const osg::Vec3f& getAgentHalfExtents() const { return mAgentHalfExtents; }
+
+        float getStepSize() const { return mStepSize; }
+
+        const osg::Vec3f& getStart() const { return mStart; }
+
+        const osg::Vec3f& getEnd() const { return mEnd; }
+
+        Flags getIncludeFlags() const { return mIncludeFlags; }
+
+        const AreaCosts& getAreaCosts() const { return mAreaCosts; }
+
+        bool isDone() const { return mDone; }
+
+        Status getStatus() const { return mStatus; }
+
+        const std::deque<osg::Vec3f>& getPath() const { return mPath; }
+
+        void setResult(Status status, std::deque<osg::Vec3f>&& path);
+
+    private:
+        osg::Vec3f mAgentHalfExtents;
+        float mStepSize;
+        osg::Vec3f mStart;
+        osg::Vec3f mEnd;
+        Flags mIncludeFlags;
+        AreaCosts mAreaCosts;
+        Status mStatus;
+        std::deque<osg::Vec3f> mPath;
+        std::atomic_bool mDone;
+    };
+
+    /**
+     * @brief AsyncPathFinder searches paths over navmesh in separate threads. Requests are processed in the order they
+     * are posted. A request nobody else holds anymore is dropped without search. Without threads requests are
+     * processed by post.
+     * @note A search holds a shared lock of the navmesh. Other searches and queries, including the ones on the main
+     * thread, run at the same time. Only navmesh tile updates wait for it to finish.
+     */
+    class AsyncPathFinder
+    {
+    public:
+        AsyncPathFinder(const Settings& settings);
+        ~AsyncPathFinder();
+
+        void post(const SharedNavMeshCacheItem& navMeshCacheItem, const std::shared_ptr<PathRequest>& request);
+
+        void wait();
+
+        void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
+
+    private:
+        struct Job
+        {
+            SharedNavMeshCacheItem mNavMeshCacheItem;
+            std::shared_ptr<PathRequest> mRequest;
+        };
+
+        std::reference_wrapper<const Settings> mSettings;
+        std::atomic_bool mShouldStop;
+        mutable std::mutex mMutex;
+        std::condition_variable mHasJob;
+        std::condition_variable mDone;
+        std::deque<Job> mJobs;
+        std::size_t mProcessingJobs;
+        std::deque<std::chrono::steady_clock::duration> mDurations;
+        std::vector<std::thread> mThreads;
+
+        void process() throw();
+
+        void processJob(const Job& job);
+    };
+}
+
+#endif
@@ -0,0 +1,184 @@
+#include "crowd.hpp"
+#include "settingsutils.hpp"
+
+#include <DetourCommon.h>
+#include <DetourCrowd.h>
+
+#include <algorithm>
+
+namespace
+{
+    const int maxCrowdAgents = 128;
+}
+
+namespace DetourNavigator
+{
+    Crowd::Crowd(const Settings& settings, const osg::Vec3f& agentHalfExtents)
+        : mSettings(settings)
+        , mAgentHalfExtents(agentHalfExtents)
+        , mCrowd(dtAllocCrowd(), &dtFreeCrowd)
+        , mNavMesh(nullptr)
+    {
+    }
+
+    void Crowd::setAgent(const ObjectId id, const osg::Vec3f& position, const osg::Vec3f& target, const float maxSpeed,
+        const Flags includeFlags)
+    {
+        Agent& agent = mAgents[id];
+        agent.mUsed = true;
+        agent.mPosition = position;
+        agent.mTarget = target;
+        agent.mMaxSpeed = maxSpeed;
+        agent.mIncludeFlags = includeFlags;
+    }
+
+    void Crowd::update(const SharedNavMeshCacheItem& navMeshCacheItem, const float duration)
+    {
+        for (auto it = mAgents.begin(); it != mAgents.end();)
+        {
+            if (it->second.mUsed)
+            {
+                it->second.mUsed = false;
+                ++it;
+                continue;
+            }
+            if (it->second.mIndex != -1)
+                mCrowd->removeAgent(it->second.mIndex);
+            it = mAgents.erase(it);
+        }
+
+        if (!navMeshCacheItem)
+        {
+            mNavMesh = nullptr;
+            for (auto& agent : mAgents)
+            {
+                agent.second.mIndex = -1;
+                agent.second.mVelocity = boost::none;
+            }
+            return;
+        }
+
+        const auto locked = navMeshCacheItem->lockConst();
+        const auto& navMesh = locked->getImpl();
+
+        if (&navMesh != mNavMesh && !initCrowd(navMesh))
+            return;
+
+        for (auto& agent : mAgents)
+            updateAgent(agent.second);
+
+        mCrowd->update(duration, nullptr);
+
+        for (auto& agent : mAgents)
+        {
+            if (agent.second.mIndex == -1)
+                continue;
+            const dtCrowdAgent& crowdAgent = *mCrowd->getAgent(agent.second.mIndex);
+            // an agent without a path to its target stands still, the caller follows its own path then
+            if (crowdAgent.state == DT_CROWDAGENT_STATE_WALKING && crowdAgent.targetState == DT_CROWDAGENT_TARGET_VALID)
+                agent.second.mVelocity = fromNavMeshCoordinates(mSettings,
+                    osg::Vec3f(crowdAgent.nvel[0], crowdAgent.nvel[1], crowdAgent.nvel[2]));
+            else
+                agent.second.mVelocity = boost::none;
+        }
+    }
+
+    boost::optional<osg::Vec3f> Crowd::getVelocity(const ObjectId id) const
+    {
+        const auto agent = mAgents.find(id);
+        if (agent == mAgents.end())
+            return boost::none;
+        return agent->second.mVelocity;
+    }
+
+    bool Crowd::initCrowd(const dtNavMesh& navMesh)
+    {
+        mNavMesh = nullptr;
+        for (auto& agent : mAgents)
+        {
+            agent.second.mIndex = -1;
+            agent.second.mVelocity = boost::none;
+        }
+
+        const float radius = toNavMeshCoordinates(mSettings, std::max(mAgentHalfExtents.x(), mAgentHalfExtents.y()));
+        // crowd reads navmesh only by its navmesh query
+        if (!mCrowd->init(maxCrowdAgents, radius, const_cast<dtNavMesh*>(&navMesh)))
+            return false;
+
+        // filter type of an agent is its include flags
+        for (int i = 0; i < DT_CROWD_MAX_QUERY_FILTER_TYPE; ++i)
+            mCrowd->getEditableFilter(i)->setIncludeFlags(static_cast<Flags>(i));
+
+        mNavMesh = &navMesh;
+        return true;
+    }
+
+    void Crowd::updateAgent(Agent& agent)
+    {
+        const auto params = makeAgentParams(agent);
+        const auto position = toNavMeshCoordinates(mSettings, agent.mPosition);
+
+        if (agent.mIndex != -1)
+        {
+            dtCrowdAgent& crowdAgent = *mCrowd->getEditableAgent(agent.mIndex);
+            // the agent is moved by the caller, start over if it is too far from where the crowd moved it
+            if (dtVdist2DSqr(crowdAgent.npos, position.ptr()) > params.radius * params.radius)
+            {
+                mCrowd->removeAgent(agent.mIndex);
+                agent.mIndex = -1;
+            }
+            else
+            {
+                dtVcopy(crowdAgent.npos, position.ptr());
+                mCrowd->updateAgentParameters(agent.mIndex, &params);
+            }
+        }
+
+        if (agent.mIndex == -1)
+        {
+            agent.mRequestedTarget = boost::none;
+            agent.mVelocity = boost::none;
+            agent.mIndex = mCrowd->addAgent(position.ptr(), &params);
+            if (agent.mIndex == -1)
+                return;
+        }
+
+        const auto target = toNavMeshCoordinates(mSettings, agent.mTarget);
+        if (agent.mRequestedTarget && (*agent.mRequestedTarget - target).length2() < params.radius * params.radius)
+            return;
+
+        dtPolyRef targetRef = 0;
+        osg::Vec3f targetPosition;
+        const auto status = mCrowd->getNavMeshQuery()->findNearestPoly(target.ptr(),
+            toNavMeshCoordinates(mSettings, mAgentHalfExtents).ptr(), mCrowd->getFilter(params.queryFilterType),
+            &targetRef, targetPosition.ptr());
+        if (dtStatusFailed(status) || targetRef == 0)
+        {
+            mCrowd->resetMoveTarget(agent.mIndex);
+            agent.mRequestedTarget = boost::none;
+            return;
+        }
+
+        if (mCrowd->requestMoveTarget(agent.mIndex, targetRef, targetPosition.ptr()))
+            agent.mRequestedTarget = target;
+    }
+
+    dtCrowdAgentParams Crowd::makeAgentParams(const Agent& agent) const
+    {
+        dtCrowdAgentParams params;
+        params.radius = toNavMeshCoordinates(mSettings, std::max(mAgentHalfExtents.x(), mAgentHalfExtents.y()));
+        params.height = toNavMeshCoordinates(mSettings, 2 * mAgentHalfExtents.z());
+        params.maxSpeed = toNavMeshCoordinates(mSettings, agent.mMaxSpeed);
+        // actors change their velocity almost at once
+        params.maxAcceleration = params.maxSpeed * 10;
+        params.collisionQueryRange = params.radius * 12;
+        params.pathOptimizationRange = params.radius * 30;
+        params.separationWeight = 2;
+        params.updateFlags = DT_CROWD_ANTICIPATE_TURNS | DT_CROWD_OBSTACLE_AVOIDANCE | DT_CROWD_SEPARATION
+            | DT_CROWD_OPTIMIZE_VIS | DT_CROWD_OPTIMIZE_TOPO;
+        params.obstacleAvoidanceType = 0;
+        params.queryFilterType = static_cast<unsigned char>(agent.mIncludeFlags % DT_CROWD_MAX_QUERY_FILTER_TYPE);
+        params.userData = nullptr;
+        return params;
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_CROWD_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_CROWD_H
+
+#include "flags.hpp"
+#include "navmeshcacheitem.hpp"
+#include "objectid.hpp"
+#include "settings.hpp"
+
+#include <osg/Vec3f>
+
+#include <boost/optional.hpp>
+
+#include <memory>
+#include <unordered_map>
+
+class dtCrowd;
+struct dtCrowdAgentParams;
+
+namespace DetourNavigator
+{
+    /**
+     * @brief Crowd steers agents with the same half extents over their navmesh to their targets avoiding each other
+     * and optimizing their corridors in one update for all agents. Agents are moved by the caller, crowd only suggests
+     * velocities. Each agent has to be set before every update, agents not set since the last update are removed.
+     */
+    class Crowd
+    {
+    public:
+        Crowd(const Settings& settings, const osg::Vec3f& agentHalfExtents);
+
+        /**
+         * @brief setAgent adds agent or updates it for the next update.
+         * @param id identifies the agent.
+         * @param position is the current position of the agent.
+         * @param target is the point to move to, usually the end of a path. The agent slows down close to it,
+         * so an intermediate point of a path would slow it down at every corner.
+         * @param maxSpeed limits suggested velocity.
+         * @param includeFlags setup allowed surfaces for agent to walk.
+         */
+        void setAgent(const ObjectId id, const osg::Vec3f& position, const osg::Vec3f& target, const float maxSpeed,
+            const Flags includeFlags);
+
+        void update(const SharedNavMeshCacheItem& navMeshCacheItem, const float duration);
+
+        /**
+         * @brief getVelocity returns velocity suggested by the last update.
+         * @return empty optional if the agent is not steered, e.g. it isn't on navmesh or its target isn't reachable.
+         */
+        boost::optional<osg::Vec3f> getVelocity(const ObjectId id) const;
+
+        std::size_t getAgentsCount() const
+        {
+            return mAgents.size();
+        }
+
+    private:
+        struct Agent
+        {
+            int mIndex = -1;
+            bool mUsed = false;
+            osg::Vec3f mPosition;
+            osg::Vec3f mTarget;
+            float mMaxSpeed = 0;
+            Flags mIncludeFlags = Flag_none;
+            boost::optional<osg::Vec3f> mRequestedTarget;
+            boost::optional<osg::Vec3f> mVelocity;
+        };
+
+        Settings mSettings;
+        osg::Vec3f mAgentHalfExtents;
+        std::unique_ptr<dtCrowd, void (*)(dtCrowd*)> mCrowd;
+        const dtNavMesh* mNavMesh;
+        std::unordered_map<ObjectId, Agent> mAgents;
+
+        bool initCrowd(const dtNavMesh& navMesh);
+
+        void updateAgent(Agent& agent);
+
+        dtCrowdAgentParams makeAgentParams(const Agent& agent) const;
+    };
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_HASH_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_HASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace DetourNavigator
+{
+    /// 128-bit non cryptographic content hash. Equal values are necessary but not sufficient for equal content.
+    struct Hash
+    {
+        std::uint64_t mFirst = 0;
+        std::uint64_t mSecond = 0;
+    };
+
+    inline bool operator ==(const Hash& lhs, const Hash& rhs)
+    {
+        return lhs.mFirst == rhs.mFirst && lhs.mSecond == rhs.mSecond;
+    }
+
+    inline bool operator !=(const Hash& lhs, const Hash& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    inline bool operator <(const Hash& lhs, const Hash& rhs)
+    {
+        return std::tie(lhs.mFirst, lhs.mSecond) < std::tie(rhs.mFirst, rhs.mSecond);
+    }
+
+    /// Computes Hash incrementally. Each value is mixed as separate word so structures with padding have to be
+    /// added field by field.
+    class Hasher
+    {
+    public:
+        template <class T>
+        void add(T value)
+        {
+            static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                "Only arithmetic and enum types are supported");
+            static_assert(sizeof(T) <= sizeof(std::uint64_t), "Type is too big");
+            std::uint64_t word = 0;
+            std::memcpy(&word, &value, sizeof(T));
+            addWord(word);
+        }
+
+        void add(const Hash& value)
+        {
+            addWord(value.mFirst);
+            addWord(value.mSecond);
+        }
+
+        template <class T>
+        void addArray(const std::vector<T>& values)
+        {
+            add(static_cast<std::uint64_t>(values.size()));
+            for (const auto& value : values)
+                add(value);
+        }
+
+        Hash getValue() const
+        {
+            const auto first = mix(mFirst ^ mCount);
+            const auto second = mix(mSecond + first);
+            return Hash {mix(first + second), second};
+        }
+
+    private:
+        std::uint64_t mFirst = 0x243f6a8885a308d3ull;
+        std::uint64_t mSecond = 0x13198a2e03707344ull;
+        std::uint64_t mCount = 0;
+
+        static std::uint64_t rotateLeft(std::uint64_t value, int shift)
+        {
+            return (value << shift) | (value >> (64 - shift));
+        }
+
+        static std::uint64_t mix(std::uint64_t value)
+        {
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdull;
+            value ^= value >> 33;
+            value *= 0xc4ceb9fe1a85ec53ull;
+            value ^= value >> 33;
+            return value;
+        }
+
+        void addWord(std::uint64_t word)
+        {
+            mFirst = rotateLeft(mFirst ^ (word * 0x87c37b91114253d5ull), 31) * 0x4cf5ad432745937full;
+            mSecond = rotateLeft(mSecond + word, 27) * 0x9e3779b97f4a7c15ull + 0x52dce729ull;
+            ++mCount;
+        }
+    };
+}
+
+#endif
@@ -9,6 +9,8 @@
 #include "sharednavmesh.hpp"
 #include "flags.hpp"
 #include "navmeshtilescache.hpp"
+#include "navmeshdiskcache.hpp"
+#include "staticheightfieldcache.hpp"
 
 #include <components/misc/convert.hpp>
 
@@ -175,10 +177,9 @@ namespace
             throw NavigatorException("Failed to create heightfield for navmesh");
     }
 
-    bool rasterizeSolidObjectsTriangles(rcContext& context, const RecastMesh& recastMesh, const rcConfig& config,
-        rcHeightfield& solid)
+    bool rasterizeSolidObjectsTriangles(rcContext& context, const RecastMesh& recastMesh,
+        const ChunkyTriMesh& chunkyMesh, const rcConfig& config, rcHeightfield& solid)
     {
-        const auto& chunkyMesh = recastMesh.getChunkyTriMesh();
         std::vector<unsigned char> areas(chunkyMesh.getMaxTrisPerChunk(), AreaType_null);
         const osg::Vec2f tileBoundsMin(config.bmin[0], config.bmin[2]);
         const osg::Vec2f tileBoundsMax(config.bmax[0], config.bmax[2]);
@@ -294,10 +295,89 @@ namespace
         }
     }
 
-    bool rasterizeTriangles(rcContext& context, const osg::Vec3f& agentHalfExtents, const RecastMesh& recastMesh,
-        const rcConfig& config, const Settings& settings, rcHeightfield& solid)
+    bool isCompatible(const StaticHeightfield& heightfield, const RecastMesh& recastMesh, const rcConfig& config)
+    {
+        return heightfield.mStaticHash == recastMesh.getStaticHash()
+            && heightfield.mMin == osg::Vec3f(config.bmin[0], config.bmin[1], config.bmin[2])
+            && heightfield.mMax == osg::Vec3f(config.bmax[0], config.bmax[1], config.bmax[2])
+            && heightfield.mWidth == config.width
+            && heightfield.mHeight == config.height;
+    }
+
+    std::shared_ptr<const StaticHeightfield> makeStaticHeightfield(rcContext& context, const RecastMesh& recastMesh,
+        const rcConfig& config)
+    {
+        rcHeightfield solid;
+        createHeightfield(context, solid, config.width, config.height, config.bmin, config.bmax, config.cs, config.ch);
+
+        auto result = std::make_shared<StaticHeightfield>();
+        result->mStaticHash = recastMesh.getStaticHash();
+        result->mMin = osg::Vec3f(config.bmin[0], config.bmin[1], config.bmin[2]);
+        result->mMax = osg::Vec3f(config.bmax[0], config.bmax[1], config.bmax[2]);
+        result->mWidth = config.width;
+        result->mHeight = config.height;
+        result->mHasTriangles = rasterizeSolidObjectsTriangles(context, recastMesh,
+            recastMesh.getStaticChunkyTriMesh(), config, solid);
+
+        for (int y = 0; y < solid.height; ++y)
+            for (int x = 0; x < solid.width; ++x)
+                for (const rcSpan* span = solid.spans[x + y * solid.width]; span != nullptr; span = span->next)
+                    result->mSpans.push_back(HeightfieldSpan {
+                        static_cast<std::uint16_t>(x),
+                        static_cast<std::uint16_t>(y),
+                        static_cast<std::uint16_t>(span->smin),
+                        static_cast<std::uint16_t>(span->smax),
+                        static_cast<unsigned char>(span->area),
+                    });
+
+        return result;
+    }
+
+    void addStaticHeightfieldSpans(rcContext& context, const StaticHeightfield& heightfield, const rcConfig& config,
+        rcHeightfield& solid)
+    {
+        for (const auto& span : heightfield.mSpans)
+        {
+            const auto spanAdded = rcAddSpan(&context, solid, span.mX, span.mY, span.mMin, span.mMax, span.mArea,
+                config.walkableClimb);
+
+            if (!spanAdded)
+                throw NavigatorException("Failed to add static heightfield span for navmesh");
+        }
+    }
+
+    /// Reuses rasterized static triangles and rasterizes only dynamic ones like Detour tile cache does with obstacles.
+    bool rasterizeStaticAndDynamicTriangles(rcContext& context, const osg::Vec3f& agentHalfExtents,
+        const TilePosition& tile, const RecastMesh& recastMesh, const rcConfig& config,
+        StaticHeightfieldCache& staticHeightfieldCache, rcHeightfield& solid)
+    {
+        auto staticHeightfield = staticHeightfieldCache.get(agentHalfExtents, tile);
+
+        if (!staticHeightfield || !isCompatible(*staticHeightfield, recastMesh, config))
+        {
+            staticHeightfield = makeStaticHeightfield(context, recastMesh, config);
+            staticHeightfieldCache.set(agentHalfExtents, tile, staticHeightfield);
+        }
+
+        addStaticHeightfieldSpans(context, *staticHeightfield, config, solid);
+
+        const bool dynamicRasterized = rasterizeSolidObjectsTriangles(context, recastMesh,
+            recastMesh.getDynamicChunkyTriMesh(), config, solid);
+
+        return staticHeightfield->mHasTriangles || dynamicRasterized;
+    }
+
+    bool rasterizeTriangles(rcContext& context, const osg::Vec3f& agentHalfExtents, const TilePosition& tile,
+        const RecastMesh& recastMesh, const rcConfig& config, const Settings& settings,
+        StaticHeightfieldCache* staticHeightfieldCache, rcHeightfield& solid)
     {
-        if (!rasterizeSolidObjectsTriangles(context, recastMesh, config, solid))
+        if (staticHeightfieldCache != nullptr && recastMesh.hasStaticAndDynamicTriangles())
+        {
+            if (!rasterizeStaticAndDynamicTriangles(context, agentHalfExtents, tile, recastMesh, config,
+                    *staticHeightfieldCache, solid))
+                return false;
+        }
+        else if (!rasterizeSolidObjectsTriangles(context, recastMesh, recastMesh.getChunkyTriMesh(), config, solid))
             return false;
 
         rasterizeWaterTriangles(context, agentHalfExtents, recastMesh, settings, config, solid);
@@ -399,9 +479,10 @@ namespace
         return true;
     }
 
-    NavMeshData makeNavMeshTileData(const osg::Vec3f& agentHalfExtents, const RecastMesh& recastMesh,
+    NavMeshData buildNavMeshTileData(const osg::Vec3f& agentHalfExtents, const RecastMesh& recastMesh,
         const std::vector<OffMeshConnection>& offMeshConnections, const TilePosition& tile,
-        const osg::Vec3f& boundsMin, const osg::Vec3f& boundsMax, const Settings& settings)
+        const osg::Vec3f& boundsMin, const osg::Vec3f& boundsMax, const Settings& settings,
+        StaticHeightfieldCache* staticHeightfieldCache)
     {
         rcContext context;
         const auto config = makeConfig(agentHalfExtents, boundsMin, boundsMax, settings);
@@ -409,7 +490,8 @@ namespace
         rcHeightfield solid;
         createHeightfield(context, solid, config.width, config.height, config.bmin, config.bmax, config.cs, config.ch);
 
-        if (!rasterizeTriangles(context, agentHalfExtents, recastMesh, config, settings, solid))
+        if (!rasterizeTriangles(context, agentHalfExtents, tile, recastMesh, config, settings, staticHeightfieldCache,
+                solid))
             return NavMeshData();
 
         rcFilterLowHangingWalkableObstacles(&context, config.walkableClimb, solid);
@@ -472,7 +554,20 @@ namespace
         return NavMeshData(navMeshData, navMeshDataSize);
     }
 
+    Bounds getRecastMeshBounds(const RecastMesh& recastMesh, const Settings& settings,
+        const osg::Vec3f& agentHalfExtents)
+    {
+        auto result = recastMesh.getBounds();
+
+        for (const auto& water : recastMesh.getWater())
+        {
+            const auto waterBounds = getWaterBounds(water, settings, agentHalfExtents);
+            result.mMin.y() = std::min(result.mMin.y(), waterBounds.mMin.y());
+            result.mMax.y() = std::max(result.mMax.y(), waterBounds.mMax.y());
+        }
 
+        return result;
+    }
 
     template <class T>
     unsigned long getMinValuableBitsNumber(const T value)
@@ -514,10 +609,28 @@ namespace DetourNavigator
         return navMesh;
     }
 
+    NavMeshData makeNavMeshTileData(const osg::Vec3f& agentHalfExtents, const RecastMesh& recastMesh,
+        const std::vector<OffMeshConnection>& offMeshConnections, const TilePosition& tile, const Settings& settings,
+        StaticHeightfieldCache* staticHeightfieldCache)
+    {
+        const auto recastMeshBounds = getRecastMeshBounds(recastMesh, settings, agentHalfExtents);
+
+        if (isEmpty(recastMeshBounds))
+            return NavMeshData();
+
+        const auto tileBounds = makeTileBounds(settings, tile);
+        const osg::Vec3f tileBorderMin(tileBounds.mMin.x(), recastMeshBounds.mMin.y() - 1, tileBounds.mMin.y());
+        const osg::Vec3f tileBorderMax(tileBounds.mMax.x(), recastMeshBounds.mMax.y() + 1, tileBounds.mMax.y());
+
+        return buildNavMeshTileData(agentHalfExtents, recastMesh, offMeshConnections, tile,
+            tileBorderMin, tileBorderMax, settings, staticHeightfieldCache);
+    }
+
     UpdateNavMeshStatus updateNavMesh(const osg::Vec3f& agentHalfExtents, const RecastMesh* recastMesh,
         const TilePosition& changedTile, const TilePosition& playerTile,
         const std::vector<OffMeshConnection>& offMeshConnections, const Settings& settings,
-        const SharedNavMeshCacheItem& navMeshCacheItem, NavMeshTilesCache& navMeshTilesCache)
+        const SharedNavMeshCacheItem& navMeshCacheItem, NavMeshTilesCache& navMeshTilesCache,
+        const NavMeshDiskCache* navMeshDiskCache, StaticHeightfieldCache& staticHeightfieldCache)
     {
         Log(Debug::Debug) << std::fixed << std::setprecision(2) <<
             "Update NavMesh with multiple tiles:" <<
@@ -537,16 +650,7 @@ namespace DetourNavigator
             return navMeshCacheItem->lock()->removeTile(changedTile);
         }
 
-        auto recastMeshBounds = recastMesh->getBounds();
-
-        for (const auto& water : recastMesh->getWater())
-        {
-            const auto waterBounds = getWaterBounds(water, settings, agentHalfExtents);
-            recastMeshBounds.mMin.y() = std::min(recastMeshBounds.mMin.y(), waterBounds.mMin.y());
-            recastMeshBounds.mMax.y() = std::max(recastMeshBounds.mMax.y(), waterBounds.mMax.y());
-        }
-
-        if (isEmpty(recastMeshBounds))
+        if (isEmpty(getRecastMeshBounds(*recastMesh, settings, agentHalfExtents)))
         {
             Log(Debug::Debug) << "Ignore add tile: recastMesh is empty";
             return navMeshCacheItem->lock()->removeTile(changedTile);
@@ -562,12 +666,12 @@ namespace DetourNavigator
 
         if (!cachedNavMeshData)
         {
-            const auto tileBounds = makeTileBounds(settings, changedTile);
-            const osg::Vec3f tileBorderMin(tileBounds.mMin.x(), recastMeshBounds.mMin.y() - 1, tileBounds.mMin.y());
-            const osg::Vec3f tileBorderMax(tileBounds.mMax.x(), recastMeshBounds.mMax.y() + 1, tileBounds.mMax.y());
+            auto navMeshData = navMeshDiskCache == nullptr ? NavMeshData()
+                : navMeshDiskCache->get(agentHalfExtents, changedTile, *recastMesh, offMeshConnections);
 
-            auto navMeshData = makeNavMeshTileData(agentHalfExtents, *recastMesh, offMeshConnections, changedTile,
-                tileBorderMin, tileBorderMax, settings);
+            if (!navMeshData.mValue)
+                navMeshData = makeNavMeshTileData(agentHalfExtents, *recastMesh, offMeshConnections, changedTile,
+                    settings, staticHeightfieldCache.getMaxSize() > 0 ? &staticHeightfieldCache : nullptr);
 
             if (!navMeshData.mValue)
             {
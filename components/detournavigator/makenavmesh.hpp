@@ -18,6 +18,8 @@ class dtNavMesh;
 namespace DetourNavigator
 {
     class RecastMesh;
+    class NavMeshDiskCache;
+    class StaticHeightfieldCache;
     struct Settings;
 
     inline float getLength(const osg::Vec2i& value)
@@ -38,10 +40,17 @@ namespace DetourNavigator
 
     NavMeshPtr makeEmptyNavMesh(const Settings& settings);
 
+    /// Builds navmesh tile data from given recast mesh, returns empty NavMeshData if there is nothing to walk on.
+    /// Static part of heightfield is reused from staticHeightfieldCache when recast mesh has dynamic triangles.
+    NavMeshData makeNavMeshTileData(const osg::Vec3f& agentHalfExtents, const RecastMesh& recastMesh,
+        const std::vector<OffMeshConnection>& offMeshConnections, const TilePosition& tile, const Settings& settings,
+        StaticHeightfieldCache* staticHeightfieldCache);
+
     UpdateNavMeshStatus updateNavMesh(const osg::Vec3f& agentHalfExtents, const RecastMesh* recastMesh,
         const TilePosition& changedTile, const TilePosition& playerTile,
         const std::vector<OffMeshConnection>& offMeshConnections, const Settings& settings,
-        const SharedNavMeshCacheItem& navMeshCacheItem, NavMeshTilesCache& navMeshTilesCache);
+        const SharedNavMeshCacheItem& navMeshCacheItem, NavMeshTilesCache& navMeshTilesCache,
+        const NavMeshDiskCache* navMeshDiskCache, StaticHeightfieldCache& staticHeightfieldCache);
 }
 
 #endif
@@ -1,6 +1,7 @@
 ﻿#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVIGATOR_H
 #define OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVIGATOR_H
 
+#include "asyncpathfinder.hpp"
 #include "findsmoothpath.hpp"
 #include "flags.hpp"
 #include "settings.hpp"
@@ -161,7 +162,8 @@ namespace DetourNavigator
         virtual void setUpdatesEnabled(bool enabled) = 0;
 
         /**
-         * @brief wait locks thread until all tiles are updated from last update call.
+         * @brief wait locks thread until all tiles are updated from last update call and all path requests are
+         * processed.
          */
         virtual void wait() = 0;
 
@@ -196,6 +198,15 @@ namespace DetourNavigator
                 toNavMeshCoordinates(settings, end), includeFlags, areaCosts, settings, out);
         }
 
+        /**
+         * @brief findPathAsync starts to find path in a separate thread, see findPath for parameters.
+         * @return request to be checked for completion on a later frame. It has status NavMeshNotFound if there is no
+         * navmesh for the agent. The search is dropped when the request is released before it is started.
+         */
+        virtual std::shared_ptr<const PathRequest> findPathAsync(const osg::Vec3f& agentHalfExtents,
+            const float stepSize, const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags,
+            const AreaCosts& areaCosts) = 0;
+
         /**
          * @brief getNavMesh returns navmesh for specific agent half extents
          * @return navmesh
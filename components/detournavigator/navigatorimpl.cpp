@@ -12,6 +12,7 @@ namespace DetourNavigator
     NavigatorImpl::NavigatorImpl(const Settings& settings)
         : mSettings(settings)
         , mNavMeshManager(mSettings)
+        , mAsyncPathFinder(mSettings)
         , mUpdatesEnabled(true)
     {
     }
@@ -154,6 +155,17 @@ namespace DetourNavigator
     void NavigatorImpl::wait()
     {
         mNavMeshManager.wait();
+        mAsyncPathFinder.wait();
+    }
+
+    std::shared_ptr<const PathRequest> NavigatorImpl::findPathAsync(const osg::Vec3f& agentHalfExtents,
+        const float stepSize, const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags,
+        const AreaCosts& areaCosts)
+    {
+        const auto request = std::make_shared<PathRequest>(agentHalfExtents, stepSize, start, end, includeFlags,
+            areaCosts);
+        mAsyncPathFinder.post(getNavMesh(agentHalfExtents), request);
+        return request;
     }
 
     SharedNavMeshCacheItem NavigatorImpl::getNavMesh(const osg::Vec3f& agentHalfExtents) const
@@ -174,6 +186,7 @@ namespace DetourNavigator
     void NavigatorImpl::reportStats(unsigned int frameNumber, osg::Stats& stats) const
     {
         mNavMeshManager.reportStats(frameNumber, stats);
+        mAsyncPathFinder.reportStats(frameNumber, stats);
     }
 
     RecastMeshTiles NavigatorImpl::getRecastMeshTiles()
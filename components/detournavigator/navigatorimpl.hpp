@@ -50,6 +50,10 @@ namespace DetourNavigator
 
         void wait() override;
 
+        std::shared_ptr<const PathRequest> findPathAsync(const osg::Vec3f& agentHalfExtents, const float stepSize,
+            const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags,
+            const AreaCosts& areaCosts) override;
+
         SharedNavMeshCacheItem getNavMesh(const osg::Vec3f& agentHalfExtents) const override;
 
         std::map<osg::Vec3f, SharedNavMeshCacheItem> getNavMeshes() const override;
@@ -63,6 +67,7 @@ namespace DetourNavigator
     private:
         Settings mSettings;
         NavMeshManager mNavMeshManager;
+        AsyncPathFinder mAsyncPathFinder;
         bool mUpdatesEnabled;
         std::map<osg::Vec3f, std::size_t> mAgents;
         std::unordered_map<ObjectId, ObjectId> mAvoidIds;
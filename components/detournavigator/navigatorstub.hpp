@@ -70,6 +70,16 @@ namespace DetourNavigator
 
         void wait() override {}
 
+        std::shared_ptr<const PathRequest> findPathAsync(const osg::Vec3f& agentHalfExtents, const float stepSize,
+            const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags,
+            const AreaCosts& areaCosts) override
+        {
+            const auto request = std::make_shared<PathRequest>(agentHalfExtents, stepSize, start, end, includeFlags,
+                areaCosts);
+            request->setResult(Status::NavMeshNotFound, {});
+            return request;
+        }
+
         SharedNavMeshCacheItem getNavMesh(const osg::Vec3f& /*agentHalfExtents*/) const override
         {
             return mEmptyNavMeshCacheItem;
@@ -191,7 +191,8 @@ namespace DetourNavigator
         }
     };
 
-    using GuardedNavMeshCacheItem = Misc::ScopeGuarded<NavMeshCacheItem>;
+    // path searches only read the navmesh, so searches on different threads don't wait for each other
+    using GuardedNavMeshCacheItem = Misc::SharedGuarded<NavMeshCacheItem>;
     using SharedNavMeshCacheItem = std::shared_ptr<GuardedNavMeshCacheItem>;
 }
 
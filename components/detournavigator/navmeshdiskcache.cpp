@@ -0,0 +1,273 @@
+#include "navmeshdiskcache.hpp"
+#include "exceptions.hpp"
+#include "recastmesh.hpp"
+#include "settings.hpp"
+
+#include <components/debug/debuglog.hpp>
+#include <components/misc/hash.hpp>
+
+#include <DetourAlloc.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+#include <type_traits>
+
+namespace
+{
+    using namespace DetourNavigator;
+
+    constexpr std::array<char, 8> navMeshTileFileMagic {{'O', 'M', 'W', 'N', 'A', 'V', 'T', '\0'}};
+    constexpr std::uint32_t navMeshTileFileVersion = 2;
+
+    struct Triangle
+    {
+        std::array<osg::Vec3f, 3> mVertices;
+        AreaType mAreaType;
+    };
+
+    bool operator<(const Triangle& lhs, const Triangle& rhs)
+    {
+        return std::tie(lhs.mVertices, lhs.mAreaType) < std::tie(rhs.mVertices, rhs.mAreaType);
+    }
+
+    class Writer
+    {
+    public:
+        template <class T>
+        void write(const T& value)
+        {
+            static_assert(std::is_arithmetic<T>::value, "Only arithmetic types are supported");
+            const auto begin = reinterpret_cast<const char*>(&value);
+            mBuffer.insert(mBuffer.end(), begin, begin + sizeof(T));
+        }
+
+        void write(AreaType value)
+        {
+            write(static_cast<unsigned char>(value));
+        }
+
+        void write(const osg::Vec3f& value)
+        {
+            write(value.x());
+            write(value.y());
+            write(value.z());
+        }
+
+        void write(const btTransform& value)
+        {
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < 3; ++j)
+                    write(static_cast<float>(value.getBasis()[i][j]));
+            write(static_cast<float>(value.getOrigin().x()));
+            write(static_cast<float>(value.getOrigin().y()));
+            write(static_cast<float>(value.getOrigin().z()));
+        }
+
+        std::string& getBuffer()
+        {
+            return mBuffer;
+        }
+
+    private:
+        std::string mBuffer;
+    };
+
+    std::uint64_t getSettingsHash(const Settings& settings)
+    {
+        Writer writer;
+        writer.write(settings.mCellHeight);
+        writer.write(settings.mCellSize);
+        writer.write(settings.mDetailSampleDist);
+        writer.write(settings.mDetailSampleMaxError);
+        writer.write(settings.mMaxClimb);
+        writer.write(settings.mMaxSimplificationError);
+        writer.write(settings.mMaxSlope);
+        writer.write(settings.mRecastScaleFactor);
+        writer.write(settings.mSwimHeightScale);
+        writer.write(settings.mBorderSize);
+        writer.write(settings.mMaxEdgeLen);
+        writer.write(settings.mMaxPolys);
+        writer.write(settings.mMaxVertsPerPoly);
+        writer.write(settings.mRegionMergeSize);
+        writer.write(settings.mRegionMinSize);
+        writer.write(settings.mTileSize);
+        writer.write(static_cast<std::uint64_t>(settings.mTrianglesPerChunk));
+        return Misc::getFnv1aHash(writer.getBuffer().data(), writer.getBuffer().size());
+    }
+
+    /// Triangles by their vertices starting from the least one to keep the winding, sorted. Game adds objects to
+    /// the recast mesh while cells are loaded and navmeshtool adds whole worldspace at once, so the same geometry
+    /// comes with different order of triangles and vertices.
+    std::vector<Triangle> makeCanonicalTriangles(const RecastMesh& recastMesh)
+    {
+        const auto& indices = recastMesh.getIndices();
+        const auto& vertices = recastMesh.getVertices();
+        std::vector<Triangle> result;
+        result.reserve(recastMesh.getTrianglesCount());
+        for (std::size_t i = 0; i < recastMesh.getTrianglesCount(); ++i)
+        {
+            Triangle triangle;
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                const auto vertex = static_cast<std::size_t>(indices[i * 3 + j]) * 3;
+                triangle.mVertices[j] = osg::Vec3f(vertices[vertex], vertices[vertex + 1], vertices[vertex + 2]);
+            }
+            const auto least = std::min_element(triangle.mVertices.begin(), triangle.mVertices.end());
+            std::rotate(triangle.mVertices.begin(), least, triangle.mVertices.end());
+            triangle.mAreaType = recastMesh.getAreaTypes()[i];
+            result.push_back(triangle);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::string makeNavMeshDiskKey(const RecastMesh& recastMesh,
+        const std::vector<OffMeshConnection>& offMeshConnections)
+    {
+        Writer writer;
+
+        const auto triangles = makeCanonicalTriangles(recastMesh);
+        writer.write(static_cast<std::uint64_t>(triangles.size()));
+        for (const auto& triangle : triangles)
+        {
+            for (const auto& vertex : triangle.mVertices)
+                writer.write(vertex);
+            writer.write(triangle.mAreaType);
+        }
+
+        std::vector<std::string> water;
+        water.reserve(recastMesh.getWater().size());
+        for (const auto& v : recastMesh.getWater())
+        {
+            Writer waterWriter;
+            waterWriter.write(v.mCellSize);
+            waterWriter.write(v.mTransform);
+            water.push_back(std::move(waterWriter.getBuffer()));
+        }
+        std::sort(water.begin(), water.end());
+        writer.write(static_cast<std::uint64_t>(water.size()));
+        for (const auto& v : water)
+            writer.getBuffer().append(v);
+
+        auto connections = offMeshConnections;
+        std::sort(connections.begin(), connections.end());
+        writer.write(static_cast<std::uint64_t>(connections.size()));
+        for (const auto& connection : connections)
+        {
+            writer.write(connection.mStart);
+            writer.write(connection.mEnd);
+            writer.write(connection.mAreaType);
+        }
+
+        return std::move(writer.getBuffer());
+    }
+
+    std::string makeHeader(std::uint64_t settingsHash, const osg::Vec3f& agentHalfExtents,
+        const TilePosition& changedTile, const std::string& key)
+    {
+        Writer writer;
+        writer.getBuffer().append(navMeshTileFileMagic.data(), navMeshTileFileMagic.size());
+        writer.write(navMeshTileFileVersion);
+        writer.write(settingsHash);
+        writer.write(agentHalfExtents);
+        writer.write(changedTile.x());
+        writer.write(changedTile.y());
+        writer.write(static_cast<std::uint64_t>(key.size()));
+        writer.getBuffer().append(key);
+        return std::move(writer.getBuffer());
+    }
+}
+
+namespace DetourNavigator
+{
+    NavMeshDiskCache::NavMeshDiskCache(const std::string& path, const Settings& settings)
+        : mPath(path)
+        , mSettingsHash(getSettingsHash(settings))
+    {
+    }
+
+    NavMeshData NavMeshDiskCache::get(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+        const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections) const
+    {
+        const auto key = makeNavMeshDiskKey(recastMesh, offMeshConnections);
+        const auto filePath = getFilePath(agentHalfExtents, changedTile, key);
+
+        boost::filesystem::ifstream file(filePath, std::ios::binary);
+        if (!file.is_open())
+            return NavMeshData();
+
+        const auto expectedHeader = makeHeader(mSettingsHash, agentHalfExtents, changedTile, key);
+        std::string header(expectedHeader.size(), '\0');
+        std::uint32_t size = 0;
+        if (!file.read(&header[0], static_cast<std::streamsize>(header.size()))
+                || header != expectedHeader
+                || !file.read(reinterpret_cast<char*>(&size), sizeof(size))
+                || size == 0)
+            return NavMeshData();
+
+        NavMeshData result(static_cast<unsigned char*>(dtAlloc(size, DT_ALLOC_PERM)), static_cast<int>(size));
+        if (!result.mValue)
+            return NavMeshData();
+
+        if (!file.read(reinterpret_cast<char*>(result.mValue.get()), size))
+        {
+            Log(Debug::Warning) << "Truncated nav mesh tile file: " << filePath.string();
+            return NavMeshData();
+        }
+
+        return result;
+    }
+
+    void NavMeshDiskCache::set(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+        const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections,
+        const NavMeshData& value) const
+    {
+        const auto key = makeNavMeshDiskKey(recastMesh, offMeshConnections);
+        const auto filePath = getFilePath(agentHalfExtents, changedTile, key);
+
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(filePath.parent_path(), ec);
+
+        auto tmpPath = filePath;
+        tmpPath += ".tmp";
+
+        {
+            boost::filesystem::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                throw NavigatorException("Open file failed: " + tmpPath.string());
+            file.exceptions(std::ios::failbit | std::ios::badbit);
+            const auto header = makeHeader(mSettingsHash, agentHalfExtents, changedTile, key);
+            const auto size = static_cast<std::uint32_t>(value.mSize);
+            file.write(header.data(), static_cast<std::streamsize>(header.size()));
+            file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            file.write(reinterpret_cast<const char*>(value.mValue.get()), value.mSize);
+        }
+
+        boost::filesystem::rename(tmpPath, filePath);
+    }
+
+    boost::filesystem::path NavMeshDiskCache::getFilePath(const osg::Vec3f& agentHalfExtents,
+        const TilePosition& changedTile, const std::string& key) const
+    {
+        Writer writer;
+        writer.write(mSettingsHash);
+        writer.write(agentHalfExtents);
+        writer.write(changedTile.x());
+        writer.write(changedTile.y());
+        auto hash = Misc::getFnv1aHash(writer.getBuffer().data(), writer.getBuffer().size());
+        hash = Misc::getFnv1aHash(key.data(), key.size(), hash);
+
+        std::ostringstream name;
+        name << std::hex << std::setfill('0') << std::setw(16) << hash;
+        const auto fileName = name.str();
+
+        return mPath / fileName.substr(0, 2) / (fileName + ".navmeshtile");
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVMESHDISKCACHE_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVMESHDISKCACHE_H
+
+#include "navmeshdata.hpp"
+#include "offmeshconnection.hpp"
+#include "tileposition.hpp"
+
+#include <osg/Vec3f>
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DetourNavigator
+{
+    class RecastMesh;
+    struct Settings;
+
+    /// Persistent storage for nav mesh tiles. Tile is identified by agent half extents, tile position, recast mesh
+    /// geometry, off mesh connections and navigator settings affecting nav mesh generation. Any mismatch is a miss.
+    /// Geometry is compared regardless of the order in which its triangles, water and connections were added in.
+    class NavMeshDiskCache
+    {
+    public:
+        NavMeshDiskCache(const std::string& path, const Settings& settings);
+
+        NavMeshData get(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+            const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections) const;
+
+        void set(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+            const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections,
+            const NavMeshData& value) const;
+
+    private:
+        boost::filesystem::path mPath;
+        std::uint64_t mSettingsHash;
+
+        boost::filesystem::path getFilePath(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+            const std::string& key) const;
+    };
+}
+
+#endif
@@ -47,6 +47,22 @@ namespace DetourNavigator
             );
             return result;
         }
+
+        Hash makeNavMeshKeyHash(const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections)
+        {
+            Hasher hasher;
+            hasher.add(recastMesh.getHash());
+            hasher.add(static_cast<std::uint64_t>(offMeshConnections.size()));
+            for (const auto& v : offMeshConnections)
+            {
+                for (int i = 0; i < 3; ++i)
+                    hasher.add(v.mStart[i]);
+                for (int i = 0; i < 3; ++i)
+                    hasher.add(v.mEnd[i]);
+                hasher.add(v.mAreaType);
+            }
+            return hasher.getValue();
+        }
     }
 
     NavMeshTilesCache::NavMeshTilesCache(const std::size_t maxNavMeshDataSize)
@@ -55,6 +71,8 @@ namespace DetourNavigator
     NavMeshTilesCache::Value NavMeshTilesCache::get(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
         const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections)
     {
+        const RecastMeshKeyView key(makeNavMeshKeyHash(recastMesh, offMeshConnections), recastMesh, offMeshConnections);
+
         const std::lock_guard<std::mutex> lock(mMutex);
 
         const auto agentValues = mValues.find(agentHalfExtents);
@@ -65,7 +83,7 @@ namespace DetourNavigator
         if (tileValues == agentValues->second.end())
             return Value();
 
-        const auto tile = tileValues->second.mMap.find(RecastMeshKeyView(recastMesh, offMeshConnections));
+        const auto tile = tileValues->second.mMap.find(key);
         if (tile == tileValues->second.mMap.end())
             return Value();
 
@@ -79,6 +97,9 @@ namespace DetourNavigator
         NavMeshData&& value)
     {
         const auto navMeshSize = static_cast<std::size_t>(value.mSize);
+        const auto navMeshKeyHash = makeNavMeshKeyHash(recastMesh, offMeshConnections);
+        auto navMeshKey = makeNavMeshKey(recastMesh, offMeshConnections);
+        const auto itemSize = navMeshSize + 2 * navMeshKey.size();
 
         const std::lock_guard<std::mutex> lock(mMutex);
 
@@ -88,17 +109,16 @@ namespace DetourNavigator
         if (navMeshSize > mFreeNavMeshDataSize + (mMaxNavMeshDataSize - mUsedNavMeshDataSize))
             return Value();
 
-        auto navMeshKey = makeNavMeshKey(recastMesh, offMeshConnections);
-        const auto itemSize = navMeshSize + 2 * navMeshKey.size();
-
         if (itemSize > mFreeNavMeshDataSize + (mMaxNavMeshDataSize - mUsedNavMeshDataSize))
             return Value();
 
         while (!mFreeItems.empty() && mUsedNavMeshDataSize + itemSize > mMaxNavMeshDataSize)
             removeLeastRecentlyUsed();
 
-        const auto iterator = mFreeItems.emplace(mFreeItems.end(), agentHalfExtents, changedTile, std::move(navMeshKey));
-        const auto emplaced = mValues[agentHalfExtents][changedTile].mMap.emplace(iterator->mNavMeshKey, iterator);
+        const auto iterator = mFreeItems.emplace(mFreeItems.end(), agentHalfExtents, changedTile,
+            navMeshKeyHash, std::move(navMeshKey));
+        const auto emplaced = mValues[agentHalfExtents][changedTile].mMap.emplace(
+            KeyView(iterator->mNavMeshKeyHash, iterator->mNavMeshKey), iterator);
 
         if (!emplaced.second)
         {
@@ -145,7 +165,7 @@ namespace DetourNavigator
         if (tileValues == agentValues->second.end())
             return;
 
-        const auto value = tileValues->second.mMap.find(item.mNavMeshKey);
+        const auto value = tileValues->second.mMap.find(KeyView(item.mNavMeshKeyHash, item.mNavMeshKey));
         if (value == tileValues->second.mMap.end())
             return;
 
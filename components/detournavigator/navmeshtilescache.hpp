@@ -1,6 +1,7 @@
 #ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVMESHTILESCACHE_H
 #define OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVMESHTILESCACHE_H
 
+#include "hash.hpp"
 #include "offmeshconnection.hpp"
 #include "navmeshdata.hpp"
 #include "recastmesh.hpp"
@@ -33,13 +34,16 @@ namespace DetourNavigator
             std::atomic<std::int64_t> mUseCount;
             osg::Vec3f mAgentHalfExtents;
             TilePosition mChangedTile;
+            Hash mNavMeshKeyHash;
             std::string mNavMeshKey;
             NavMeshData mNavMeshData;
 
-            Item(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile, std::string navMeshKey)
+            Item(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile, const Hash& navMeshKeyHash,
+                    std::string navMeshKey)
                 : mUseCount(0)
                 , mAgentHalfExtents(agentHalfExtents)
                 , mChangedTile(changedTile)
+                , mNavMeshKeyHash(navMeshKeyHash)
                 , mNavMeshKey(std::move(navMeshKey))
             {}
         };
@@ -113,6 +117,7 @@ namespace DetourNavigator
         void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
 
     private:
+        /// Orders keys by hash first so full comparison of serialized recast mesh is required only on hash match.
         class KeyView
         {
         public:
@@ -120,8 +125,13 @@ namespace DetourNavigator
 
             virtual ~KeyView() = default;
 
-            KeyView(const std::string& value)
-                : mValue(&value) {}
+            KeyView(const Hash& hash, const std::string& value)
+                : mHash(hash), mValue(&value) {}
+
+            const Hash& getHash() const
+            {
+                return mHash;
+            }
 
             const std::string& getValue() const
             {
@@ -138,6 +148,8 @@ namespace DetourNavigator
             virtual bool isLess(const KeyView& other) const
             {
                 assert(mValue);
+                if (mHash != other.getHash())
+                    return mHash < other.getHash();
                 return other.compare(*mValue) > 0;
             }
 
@@ -146,20 +158,28 @@ namespace DetourNavigator
                 return lhs.isLess(rhs);
             }
 
+        protected:
+            explicit KeyView(const Hash& hash)
+                : mHash(hash) {}
+
         private:
+            Hash mHash;
             const std::string* mValue = nullptr;
         };
 
         class RecastMeshKeyView : public KeyView
         {
         public:
-            RecastMeshKeyView(const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections)
-                : mRecastMesh(recastMesh), mOffMeshConnections(offMeshConnections) {}
+            RecastMeshKeyView(const Hash& hash, const RecastMesh& recastMesh,
+                    const std::vector<OffMeshConnection>& offMeshConnections)
+                : KeyView(hash), mRecastMesh(recastMesh), mOffMeshConnections(offMeshConnections) {}
 
             int compare(const std::string& other) const override;
 
             bool isLess(const KeyView& other) const override
             {
+                if (getHash() != other.getHash())
+                    return getHash() < other.getHash();
                 return compare(other.getValue()) < 0;
             }
 
@@ -3,10 +3,73 @@
 
 #include <Recast.h>
 
+#include <algorithm>
+#include <limits>
+
 namespace DetourNavigator
 {
+    namespace
+    {
+        Hash makeRecastMeshHash(const std::vector<int>& indices, const std::vector<float>& vertices,
+            const std::vector<AreaType>& areaTypes, const std::vector<RecastMesh::Water>& water)
+        {
+            Hasher hasher;
+            hasher.addArray(indices);
+            hasher.addArray(vertices);
+            hasher.addArray(areaTypes);
+            hasher.add(static_cast<std::uint64_t>(water.size()));
+            for (const auto& v : water)
+            {
+                hasher.add(v.mCellSize);
+                for (int i = 0; i < 3; ++i)
+                    for (int j = 0; j < 3; ++j)
+                        hasher.add(v.mTransform.getBasis()[i][j]);
+                for (int i = 0; i < 3; ++i)
+                    hasher.add(v.mTransform.getOrigin()[i]);
+            }
+            return hasher.getValue();
+        }
+
+        Hash makeStaticTrianglesHash(const std::vector<int>& indices, const std::vector<float>& vertices,
+            const std::vector<AreaType>& areaTypes, std::size_t staticTrianglesCount)
+        {
+            Hasher hasher;
+            hasher.add(static_cast<std::uint64_t>(staticTrianglesCount));
+            for (std::size_t i = 0; i < staticTrianglesCount; ++i)
+            {
+                for (std::size_t j = 0; j < 3; ++j)
+                {
+                    const auto vertex = static_cast<std::size_t>(indices[i * 3 + j]) * 3;
+                    for (std::size_t k = 0; k < 3; ++k)
+                        hasher.add(vertices[vertex + k]);
+                }
+                hasher.add(areaTypes[i]);
+            }
+            return hasher.getValue();
+        }
+
+        std::unique_ptr<ChunkyTriMesh> makeChunkyTriMesh(const std::vector<int>& indices,
+            const std::vector<float>& vertices, const std::vector<AreaType>& areaTypes, std::size_t trianglesBegin,
+            std::size_t trianglesEnd, std::size_t trianglesPerChunk)
+        {
+            const std::vector<int> partIndices(indices.begin() + static_cast<std::ptrdiff_t>(trianglesBegin * 3),
+                indices.begin() + static_cast<std::ptrdiff_t>(trianglesEnd * 3));
+            const std::vector<AreaType> partAreaTypes(areaTypes.begin() + static_cast<std::ptrdiff_t>(trianglesBegin),
+                areaTypes.begin() + static_cast<std::ptrdiff_t>(trianglesEnd));
+            return std::make_unique<ChunkyTriMesh>(vertices, partIndices, partAreaTypes, trianglesPerChunk);
+        }
+    }
+
     RecastMesh::RecastMesh(std::size_t generation, std::size_t revision, std::vector<int> indices, std::vector<float> vertices,
             std::vector<AreaType> areaTypes, std::vector<Water> water, const std::size_t trianglesPerChunk)
+        : RecastMesh(generation, revision, std::move(indices), std::move(vertices), std::move(areaTypes),
+            std::move(water), trianglesPerChunk, std::numeric_limits<std::size_t>::max())
+    {
+    }
+
+    RecastMesh::RecastMesh(std::size_t generation, std::size_t revision, std::vector<int> indices, std::vector<float> vertices,
+            std::vector<AreaType> areaTypes, std::vector<Water> water, const std::size_t trianglesPerChunk,
+            std::size_t staticTrianglesCount)
         : mGeneration(generation)
         , mRevision(revision)
         , mIndices(std::move(indices))
@@ -14,10 +77,20 @@ namespace DetourNavigator
         , mAreaTypes(std::move(areaTypes))
         , mWater(std::move(water))
         , mChunkyTriMesh(mVertices, mIndices, mAreaTypes, trianglesPerChunk)
+        , mStaticTrianglesCount(std::min(staticTrianglesCount, mAreaTypes.size()))
+        , mHash(makeRecastMeshHash(mIndices, mVertices, mAreaTypes, mWater))
     {
         if (getTrianglesCount() != mAreaTypes.size())
             throw InvalidArgument("Number of flags doesn't match number of triangles: triangles="
                 + std::to_string(getTrianglesCount()) + ", areaTypes=" + std::to_string(mAreaTypes.size()));
+        if (hasStaticAndDynamicTriangles())
+        {
+            mStaticChunkyTriMesh = makeChunkyTriMesh(mIndices, mVertices, mAreaTypes, 0, mStaticTrianglesCount,
+                trianglesPerChunk);
+            mDynamicChunkyTriMesh = makeChunkyTriMesh(mIndices, mVertices, mAreaTypes, mStaticTrianglesCount,
+                getTrianglesCount(), trianglesPerChunk);
+            mStaticHash = makeStaticTrianglesHash(mIndices, mVertices, mAreaTypes, mStaticTrianglesCount);
+        }
         if (getVerticesCount())
             rcCalcBounds(mVertices.data(), static_cast<int>(getVerticesCount()), mBounds.mMin.ptr(), mBounds.mMax.ptr());
     }
@@ -4,6 +4,7 @@
 #include "areatype.hpp"
 #include "chunkytrimesh.hpp"
 #include "bounds.hpp"
+#include "hash.hpp"
 
 #include <memory>
 #include <string>
@@ -27,6 +28,11 @@ namespace DetourNavigator
         RecastMesh(std::size_t generation, std::size_t revision, std::vector<int> indices, std::vector<float> vertices,
             std::vector<AreaType> areaTypes, std::vector<Water> water, const std::size_t trianglesPerChunk);
 
+        /// First staticTrianglesCount triangles belong to static objects, the rest to dynamic ones.
+        RecastMesh(std::size_t generation, std::size_t revision, std::vector<int> indices, std::vector<float> vertices,
+            std::vector<AreaType> areaTypes, std::vector<Water> water, const std::size_t trianglesPerChunk,
+            std::size_t staticTrianglesCount);
+
         std::size_t getGeneration() const
         {
             return mGeneration;
@@ -72,11 +78,45 @@ namespace DetourNavigator
             return mChunkyTriMesh;
         }
 
+        std::size_t getStaticTrianglesCount() const
+        {
+            return mStaticTrianglesCount;
+        }
+
+        bool hasStaticAndDynamicTriangles() const
+        {
+            return mStaticTrianglesCount > 0 && mStaticTrianglesCount < getTrianglesCount();
+        }
+
+        /// Available only when hasStaticAndDynamicTriangles() is true.
+        const ChunkyTriMesh& getStaticChunkyTriMesh() const
+        {
+            return *mStaticChunkyTriMesh;
+        }
+
+        /// Available only when hasStaticAndDynamicTriangles() is true.
+        const ChunkyTriMesh& getDynamicChunkyTriMesh() const
+        {
+            return *mDynamicChunkyTriMesh;
+        }
+
         const Bounds& getBounds() const
         {
             return mBounds;
         }
 
+        /// Hash of indices, vertices, area types and water. Meshes with equal content have equal hashes.
+        const Hash& getHash() const
+        {
+            return mHash;
+        }
+
+        /// Hash of static triangles vertices and area types. Does not depend on vertices order.
+        const Hash& getStaticHash() const
+        {
+            return mStaticHash;
+        }
+
     private:
         std::size_t mGeneration;
         std::size_t mRevision;
@@ -85,7 +125,12 @@ namespace DetourNavigator
         std::vector<AreaType> mAreaTypes;
         std::vector<Water> mWater;
         ChunkyTriMesh mChunkyTriMesh;
+        std::size_t mStaticTrianglesCount;
+        std::unique_ptr<ChunkyTriMesh> mStaticChunkyTriMesh;
+        std::unique_ptr<ChunkyTriMesh> mDynamicChunkyTriMesh;
         Bounds mBounds;
+        Hash mHash;
+        Hash mStaticHash;
     };
 }
 
@@ -17,6 +17,7 @@
 #include <LinearMath/btAabbUtil2.h>
 
 #include <algorithm>
+#include <limits>
 #include <tuple>
 
 namespace DetourNavigator
@@ -64,6 +65,7 @@ namespace DetourNavigator
     RecastMeshBuilder::RecastMeshBuilder(const Settings& settings, const TileBounds& bounds)
         : mSettings(settings)
         , mBounds(bounds)
+        , mStaticTrianglesCount(std::numeric_limits<std::size_t>::max())
     {
         mBounds.mMin /= mSettings.get().mRecastScaleFactor;
         mBounds.mMax /= mSettings.get().mRecastScaleFactor;
@@ -151,11 +153,16 @@ namespace DetourNavigator
         mWater.push_back(RecastMesh::Water {cellSize, transform});
     }
 
+    void RecastMeshBuilder::startDynamicObjects()
+    {
+        mStaticTrianglesCount = mAreaTypes.size();
+    }
+
     std::shared_ptr<RecastMesh> RecastMeshBuilder::create(std::size_t generation, std::size_t revision)
     {
         optimizeRecastMesh(mIndices, mVertices);
         return std::make_shared<RecastMesh>(generation, revision, mIndices, mVertices, mAreaTypes,
-            mWater, mSettings.get().mTrianglesPerChunk);
+            mWater, mSettings.get().mTrianglesPerChunk, mStaticTrianglesCount);
     }
 
     void RecastMeshBuilder::reset()
@@ -164,6 +171,7 @@ namespace DetourNavigator
         mVertices.clear();
         mAreaTypes.clear();
         mWater.clear();
+        mStaticTrianglesCount = std::numeric_limits<std::size_t>::max();
     }
 
     void RecastMeshBuilder::addObject(const btConcaveShape& shape, const btTransform& transform,
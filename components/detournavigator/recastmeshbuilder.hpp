@@ -34,6 +34,9 @@ namespace DetourNavigator
 
         void addWater(const int mCellSize, const btTransform& transform);
 
+        /// Triangles of objects added after this call are rasterized separately from the static ones.
+        void startDynamicObjects();
+
         std::shared_ptr<RecastMesh> create(std::size_t generation, std::size_t revision);
 
         void reset();
@@ -45,6 +48,7 @@ namespace DetourNavigator
         std::vector<float> mVertices;
         std::vector<AreaType> mAreaTypes;
         std::vector<RecastMesh::Water> mWater;
+        std::size_t mStaticTrianglesCount;
 
         void addObject(const btConcaveShape& shape, const btTransform& transform, btTriangleCallback&& callback);
 
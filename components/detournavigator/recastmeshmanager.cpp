@@ -90,7 +90,12 @@ namespace DetourNavigator
         for (const auto& v : mWaterOrder)
             mMeshBuilder.addWater(v.mCellSize, v.mTransform);
         for (const auto& v : mObjectsOrder)
-            mMeshBuilder.addObject(v.getShape(), v.getTransform(), v.getAreaType());
+            if (!v.isDynamic())
+                mMeshBuilder.addObject(v.getShape(), v.getTransform(), v.getAreaType());
+        mMeshBuilder.startDynamicObjects();
+        for (const auto& v : mObjectsOrder)
+            if (v.isDynamic())
+                mMeshBuilder.addObject(v.getShape(), v.getTransform(), v.getAreaType());
         mLastBuildRevision = mRevision;
     }
 }
@@ -39,6 +39,8 @@ namespace DetourNavigator
         if (mShape.get().isCompound())
             result = updateCompoundObject(static_cast<const btCompoundShape&>(mShape.get()), mAreaType, mChildren)
                     || result;
+        if (result)
+            mDynamic = true;
         return result;
     }
 
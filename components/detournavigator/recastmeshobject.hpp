@@ -35,12 +35,19 @@ namespace DetourNavigator
                 return mAreaType;
             }
 
+            /// Object is dynamic once it has been changed by update.
+            bool isDynamic() const
+            {
+                return mDynamic;
+            }
+
         private:
             std::reference_wrapper<const btCollisionShape> mShape;
             btTransform mTransform;
             AreaType mAreaType;
             btVector3 mLocalScaling;
             std::vector<RecastMeshObject> mChildren;
+            bool mDynamic = false;
 
             static bool updateCompoundObject(const btCompoundShape& shape, const AreaType areaType,
                 std::vector<RecastMeshObject>& children);
@@ -0,0 +1,62 @@
+#include "staticheightfieldcache.hpp"
+
+namespace DetourNavigator
+{
+    StaticHeightfieldCache::StaticHeightfieldCache(const std::size_t maxSize)
+        : mMaxSize(maxSize), mSize(0) {}
+
+    std::shared_ptr<const StaticHeightfield> StaticHeightfieldCache::get(const osg::Vec3f& agentHalfExtents,
+        const TilePosition& tile)
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        const auto it = mIndex.find(Key(agentHalfExtents, tile));
+        if (it == mIndex.end())
+            return nullptr;
+
+        mItems.splice(mItems.begin(), mItems, it->second);
+
+        return it->second->mValue;
+    }
+
+    void StaticHeightfieldCache::set(const osg::Vec3f& agentHalfExtents, const TilePosition& tile,
+        std::shared_ptr<const StaticHeightfield> value)
+    {
+        const auto size = getSize(*value);
+        const Key key(agentHalfExtents, tile);
+
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        const auto it = mIndex.find(key);
+        if (it != mIndex.end())
+        {
+            mSize -= getSize(*it->second->mValue);
+            mItems.erase(it->second);
+            mIndex.erase(it);
+        }
+
+        if (size > mMaxSize)
+            return;
+
+        while (!mItems.empty() && mSize + size > mMaxSize)
+            removeLeastRecentlyUsed();
+
+        mItems.push_front(Item {key, std::move(value)});
+        mIndex.emplace(key, mItems.begin());
+        mSize += size;
+    }
+
+    std::size_t StaticHeightfieldCache::getSize() const
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        return mSize;
+    }
+
+    void StaticHeightfieldCache::removeLeastRecentlyUsed()
+    {
+        const auto& item = mItems.back();
+        mSize -= getSize(*item.mValue);
+        mIndex.erase(item.mKey);
+        mItems.pop_back();
+    }
+}
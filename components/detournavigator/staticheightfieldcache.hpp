@@ -0,0 +1,84 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_STATICHEIGHTFIELDCACHE_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_STATICHEIGHTFIELDCACHE_H
+
+#include "hash.hpp"
+#include "tileposition.hpp"
+
+#include <osg/Vec3f>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace DetourNavigator
+{
+    struct HeightfieldSpan
+    {
+        std::uint16_t mX;
+        std::uint16_t mY;
+        std::uint16_t mMin;
+        std::uint16_t mMax;
+        unsigned char mArea;
+    };
+
+    /// Spans of heightfield rasterized from static triangles of recast mesh. Valid only for heightfield with the
+    /// same bounds and static triangles with the same hash.
+    struct StaticHeightfield
+    {
+        Hash mStaticHash;
+        osg::Vec3f mMin;
+        osg::Vec3f mMax;
+        int mWidth;
+        int mHeight;
+        bool mHasTriangles;
+        std::vector<HeightfieldSpan> mSpans;
+    };
+
+    /// Keeps last rasterized static heightfield for each agent and tile to rebuild tiles with moving objects without
+    /// rasterization of whole recast mesh.
+    class StaticHeightfieldCache
+    {
+    public:
+        StaticHeightfieldCache(const std::size_t maxSize);
+
+        std::shared_ptr<const StaticHeightfield> get(const osg::Vec3f& agentHalfExtents, const TilePosition& tile);
+
+        void set(const osg::Vec3f& agentHalfExtents, const TilePosition& tile,
+            std::shared_ptr<const StaticHeightfield> value);
+
+        std::size_t getSize() const;
+
+        std::size_t getMaxSize() const
+        {
+            return mMaxSize;
+        }
+
+    private:
+        using Key = std::pair<osg::Vec3f, TilePosition>;
+
+        struct Item
+        {
+            Key mKey;
+            std::shared_ptr<const StaticHeightfield> mValue;
+        };
+
+        mutable std::mutex mMutex;
+        std::size_t mMaxSize;
+        std::size_t mSize;
+        std::list<Item> mItems;
+        std::map<Key, std::list<Item>::iterator> mIndex;
+
+        void removeLeastRecentlyUsed();
+
+        static std::size_t getSize(const StaticHeightfield& value)
+        {
+            return sizeof(value) + value.mSpans.size() * sizeof(HeightfieldSpan);
+        }
+    };
+}
+
+#endif
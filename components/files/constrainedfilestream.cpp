@@ -53,6 +53,23 @@ namespace Files
             return traits_type::to_int_type(*gptr());
         }
 
+        virtual std::streamsize xsgetn(char_type* s, std::streamsize count)
+        {
+            // Take what is already buffered and read the rest directly into destination to avoid extra copies
+            std::streamsize result = std::min<std::streamsize>(count, egptr() - gptr());
+            if (result > 0)
+            {
+                std::copy(gptr(), gptr() + result, s);
+                gbump(static_cast<int>(result));
+            }
+            if (result < count)
+            {
+                const size_t toRead = std::min(static_cast<size_t>(count - result), (mOrigin+mSize)-(mFile.tell()));
+                result += static_cast<std::streamsize>(mFile.read(s + result, toRead));
+            }
+            return result;
+        }
+
         virtual pos_type seekoff(off_type offset, std::ios_base::seekdir whence, std::ios_base::openmode mode)
         {
             if((mode&std::ios_base::out) || !(mode&std::ios_base::in))
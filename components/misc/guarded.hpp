@@ -4,14 +4,15 @@
 #include <mutex>
 #include <memory>
 #include <condition_variable>
+#include <shared_mutex>
 
 namespace Misc
 {
-    template <class T>
+    template <class T, class Lock = std::unique_lock<std::mutex>>
     class Locked
     {
         public:
-            Locked(std::mutex& mutex, T& value)
+            Locked(typename Lock::mutex_type& mutex, T& value)
                 : mLock(mutex), mValue(value)
             {}
 
@@ -31,7 +32,7 @@ namespace Misc
             }
 
         private:
-            std::unique_lock<std::mutex> mLock;
+            Lock mLock;
             std::reference_wrapper<T> mValue;
     };
 
@@ -91,6 +92,35 @@ namespace Misc
             std::mutex mMutex;
             T mValue;
     };
+
+    /// Like ScopeGuarded but lockConst doesn't exclude other lockConst, only lock does.
+    template <class T>
+    class SharedGuarded
+    {
+        public:
+            template <class ... Args>
+            SharedGuarded(Args&& ... args)
+                : mMutex()
+                , mValue(std::forward<Args>(args) ...)
+            {}
+
+            SharedGuarded(const SharedGuarded&) = delete;
+            SharedGuarded& operator=(const SharedGuarded&) = delete;
+
+            Locked<T, std::unique_lock<std::shared_timed_mutex>> lock()
+            {
+                return Locked<T, std::unique_lock<std::shared_timed_mutex>>(mMutex, mValue);
+            }
+
+            Locked<const T, std::shared_lock<std::shared_timed_mutex>> lockConst()
+            {
+                return Locked<const T, std::shared_lock<std::shared_timed_mutex>>(mMutex, mValue);
+            }
+
+        private:
+            std::shared_timed_mutex mMutex;
+            T mValue;
+    };
 }
 
 #endif
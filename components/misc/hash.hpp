@@ -0,0 +1,24 @@
+#ifndef OPENMW_COMPONENTS_MISC_HASH_H
+#define OPENMW_COMPONENTS_MISC_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Misc
+{
+    constexpr std::uint64_t fnv1aHashSeed = 14695981039346656037ull;
+
+    /// 64-bit FNV-1a hash, pass the previous result as hash to continue hashing over several buffers.
+    /// @note Stable across platforms and runs, so it can be used to name and validate files.
+    inline std::uint64_t getFnv1aHash(const char* data, std::size_t size, std::uint64_t hash = fnv1aHashSeed)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef OPENMW_COMPONENTS_MISC_SPATIALGRID_H
+#define OPENMW_COMPONENTS_MISC_SPATIALGRID_H
+
+#include <osg/Vec3f>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace Misc
+{
+    /// \class SpatialGrid
+    /// Uniform grid over the horizontal plane to find the keys near a position without visiting all of them.
+    /// Positions are stored as given by update, moving a key requires another call.
+    template <typename Key, typename Compare = std::less<Key>>
+    class SpatialGrid
+    {
+    public:
+        explicit SpatialGrid(float cellSize);
+
+        float getCellSize() const { return mCellSize; }
+
+        std::size_t size() const { return mEntries.size(); }
+
+        /// Inserts the key or moves it to the new position.
+        void update(const Key& key, const osg::Vec3f& position);
+
+        void remove(const Key& key);
+
+        void clear();
+
+        /// Appends the keys stored within the distance of the position to out, ordered by Compare.
+        void getInRange(const osg::Vec3f& position, float radius, std::vector<Key>& out) const;
+
+    private:
+        using CellIndex = std::pair<int, int>;
+
+        struct Entry
+        {
+            CellIndex mCell;
+            osg::Vec3f mPosition;
+        };
+
+        float mCellSize;
+        std::map<Key, Entry, Compare> mEntries;
+        std::map<CellIndex, std::vector<Key>> mCells;
+
+        int getCellCoordinate(float value) const
+        {
+            return static_cast<int>(std::floor(value / mCellSize));
+        }
+
+        void removeFromCell(const CellIndex& cell, const Key& key);
+    };
+
+
+    template <typename Key, typename Compare>
+    SpatialGrid<Key, Compare>::SpatialGrid(float cellSize)
+        : mCellSize(cellSize)
+    {
+    }
+
+    template <typename Key, typename Compare>
+    void SpatialGrid<Key, Compare>::update(const Key& key, const osg::Vec3f& position)
+    {
+        const CellIndex cell(getCellCoordinate(position.x()), getCellCoordinate(position.y()));
+        const auto found = mEntries.find(key);
+        if (found == mEntries.end())
+        {
+            mEntries.emplace(key, Entry {cell, position});
+            mCells[cell].push_back(key);
+            return;
+        }
+        found->second.mPosition = position;
+        if (found->second.mCell == cell)
+            return;
+        removeFromCell(found->second.mCell, key);
+        found->second.mCell = cell;
+        mCells[cell].push_back(key);
+    }
+
+    template <typename Key, typename Compare>
+    void SpatialGrid<Key, Compare>::remove(const Key& key)
+    {
+        const auto found = mEntries.find(key);
+        if (found == mEntries.end())
+            return;
+        removeFromCell(found->second.mCell, key);
+        mEntries.erase(found);
+    }
+
+    template <typename Key, typename Compare>
+    void SpatialGrid<Key, Compare>::clear()
+    {
+        mEntries.clear();
+        mCells.clear();
+    }
+
+    template <typename Key, typename Compare>
+    void SpatialGrid<Key, Compare>::getInRange(const osg::Vec3f& position, float radius, std::vector<Key>& out) const
+    {
+        const std::size_t begin = out.size();
+        const int minX = getCellCoordinate(position.x() - radius);
+        const int maxX = getCellCoordinate(position.x() + radius);
+        const int minY = getCellCoordinate(position.y() - radius);
+        const int maxY = getCellCoordinate(position.y() + radius);
+        const float radiusSqr = radius * radius;
+
+        // visit the occupied cells instead once the range covers more cells than there are
+        if (static_cast<std::size_t>(maxX - minX + 1) * static_cast<std::size_t>(maxY - minY + 1) > mCells.size())
+        {
+            for (const auto& entry : mEntries)
+                if ((entry.second.mPosition - position).length2() <= radiusSqr)
+                    out.push_back(entry.first);
+            return;
+        }
+
+        for (int x = minX; x <= maxX; ++x)
+        {
+            for (int y = minY; y <= maxY; ++y)
+            {
+                const auto cell = mCells.find(CellIndex(x, y));
+                if (cell == mCells.end())
+                    continue;
+                for (const Key& key : cell->second)
+                    if ((mEntries.find(key)->second.mPosition - position).length2() <= radiusSqr)
+                        out.push_back(key);
+            }
+        }
+
+        std::sort(out.begin() + begin, out.end(), Compare());
+    }
+
+    template <typename Key, typename Compare>
+    void SpatialGrid<Key, Compare>::removeFromCell(const CellIndex& cell, const Key& key)
+    {
+        const auto found = mCells.find(cell);
+        if (found == mCells.end())
+            return;
+        std::vector<Key>& keys = found->second;
+        const auto it = std::find_if(keys.begin(), keys.end(),
+            [&] (const Key& value) { return !Compare()(value, key) && !Compare()(key, value); });
+        if (it != keys.end())
+        {
+            *it = std::move(keys.back());
+            keys.pop_back();
+        }
+        if (keys.empty())
+            mCells.erase(found);
+    }
+}
+
+#endif
@@ -0,0 +1,46 @@
+#include "thread.hpp"
+
+#include <components/debug/debuglog.hpp>
+
+#include <cstring>
+
+#ifdef __linux__
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace Misc
+{
+    void setCurrentThreadIdlePriority()
+    {
+        sched_param param;
+        param.sched_priority = 0;
+        if (const int error = pthread_setschedparam(pthread_self(), SCHED_IDLE, &param))
+            Log(Debug::Warning) << "Failed to set idle priority to thread: " << std::strerror(error);
+    }
+}
+
+#elif defined(_WIN32)
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace Misc
+{
+    void setCurrentThreadIdlePriority()
+    {
+        if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST))
+            Log(Debug::Warning) << "Failed to set idle priority to thread: " << GetLastError();
+    }
+}
+
+#else
+
+namespace Misc
+{
+    void setCurrentThreadIdlePriority()
+    {
+    }
+}
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef OPENMW_COMPONENTS_MISC_THREAD_H
+#define OPENMW_COMPONENTS_MISC_THREAD_H
+
+namespace Misc
+{
+    /// Lower the scheduling priority of the calling thread so that it only runs when no other work is pending.
+    /// Does nothing on platforms without support for per thread priorities.
+    void setCurrentThreadIdlePriority();
+}
+
+#endif
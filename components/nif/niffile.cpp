@@ -14,19 +14,11 @@ NIFFile::NIFFile(Files::IStreamPtr stream, const std::string &name)
     parse(stream);
 }
 
-NIFFile::~NIFFile()
-{
-    for (std::vector<Record*>::iterator it = records.begin() ; it != records.end(); ++it)
-    {
-        delete *it;
-    }
-}
-
-template <typename NodeType> static Record* construct() { return new NodeType; }
+template <typename NodeType> static Record* construct(RecordArena &arena) { return arena.create<NodeType>(); }
 
 struct RecordFactoryEntry {
 
-    typedef Record* (*create_t) ();
+    typedef Record* (*create_t) (RecordArena &);
 
     create_t        mCreate;
     RecordType      mType;
@@ -34,7 +26,7 @@ struct RecordFactoryEntry {
 };
 
 ///Helper function for adding records to the factory map
-static std::pair<std::string,RecordFactoryEntry> makeEntry(std::string recName, Record* (*create_t) (), RecordType type)
+static std::pair<std::string,RecordFactoryEntry> makeEntry(std::string recName, Record* (*create_t) (RecordArena &), RecordType type)
 {
     RecordFactoryEntry anEntry = {create_t,type};
     return std::make_pair(recName, anEntry);
@@ -151,6 +143,7 @@ void NIFFile::parse(Files::IStreamPtr stream)
     // Number of records
     size_t recNum = nif.getInt();
     records.resize(recNum);
+    arena.reserve(recNum);
 
     for(size_t i = 0;i < recNum;i++)
     {
@@ -168,7 +161,7 @@ void NIFFile::parse(Files::IStreamPtr stream)
 
         if (entry != factories.end())
         {
-            r = entry->second.mCreate ();
+            r = entry->second.mCreate (arena);
             r->recType = entry->second.mType;
         }
         else
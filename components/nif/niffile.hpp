@@ -10,6 +10,7 @@
 #include <components/files/constrainedfilestream.hpp>
 
 #include "record.hpp"
+#include "recordarena.hpp"
 
 namespace Nif
 {
@@ -51,6 +52,9 @@ class NIFFile final : public File
     /// File name, used for error messages and opening the file
     std::string filename;
 
+    /// Storage of all records
+    RecordArena arena;
+
     /// Record list
     std::vector<Record*> records;
 
@@ -104,7 +108,6 @@ public:
 
     /// Open a NIF stream. The name is used for error messages.
     NIFFile(Files::IStreamPtr stream, const std::string &name);
-    ~NIFFile();
 
     /// Get a given record
     Record *getRecord(size_t index) const override
@@ -2,12 +2,63 @@
 //For error reporting
 #include "niffile.hpp"
 
+#include <sstream>
+
 namespace Nif
 {
+    std::vector<char> readStreamContent(std::istream& stream)
+    {
+        std::vector<char> result;
+
+        const auto begin = stream.tellg();
+        if (begin != std::istream::pos_type(-1) && stream.seekg(0, std::ios_base::end))
+        {
+            const auto end = stream.tellg();
+            stream.seekg(begin);
+            if (end != std::istream::pos_type(-1) && end >= begin)
+            {
+                result.resize(static_cast<std::size_t>(end - begin));
+                stream.read(result.data(), static_cast<std::streamsize>(result.size()));
+                result.resize(static_cast<std::size_t>(stream.gcount()));
+                return result;
+            }
+        }
+
+        stream.clear();
+        const std::size_t chunkSize = 64 * 1024;
+        std::size_t size = 0;
+        do
+        {
+            result.resize(size + chunkSize);
+            stream.read(result.data() + size, static_cast<std::streamsize>(chunkSize));
+            size += static_cast<std::size_t>(stream.gcount());
+        } while (stream);
+        result.resize(size);
+
+        return result;
+    }
+
+    NIFStream::NIFStream(NIFFile * file, Files::IStreamPtr inp)
+        : mBuffer(readStreamContent(*inp))
+        , mPosition(mBuffer.data())
+        , mEnd(mBuffer.data() + mBuffer.size())
+        , file(file)
+    {
+    }
+
+    void NIFStream::failEndOfFile(size_t size) const
+    {
+        std::ostringstream message;
+        message << "Unexpected end of file: read of " << size << " bytes at offset "
+                << (mPosition - mBuffer.data()) << " exceeds file size " << mBuffer.size();
+        file->fail(message.str());
+        throw std::logic_error("NIFFile::fail has returned");
+    }
+
     osg::Quat NIFStream::getQuaternion()
     {
         float f[4];
-        readLittleEndianBufferOfType<4, float,uint32_t>(inp, (float*)&f);
+        readLittleEndianBufferOfType<4, float,uint32_t>(read(4 * sizeof(float)), (float*)&f);
         osg::Quat quat;
         quat.w() = f[0];
         quat.x() = f[1];
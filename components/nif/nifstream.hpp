@@ -3,13 +3,18 @@
 #ifndef OPENMW_COMPONENTS_NIF_NIFSTREAM_HPP
 #define OPENMW_COMPONENTS_NIF_NIFSTREAM_HPP
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <istream>
 #include <stdint.h>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include <components/files/constrainedfilestream.hpp>
 
+#include <osg/Vec2f>
 #include <osg/Vec3f>
 #include <osg/Vec4f>
 #include <osg/Quat>
@@ -21,16 +26,15 @@ namespace Nif
 
 class NIFFile;
 
-/* 
+/*
     readLittleEndianBufferOfType: This template should only be used with non POD data types
 */
-template <uint32_t numInstances, typename T, typename IntegerT> inline void readLittleEndianBufferOfType(Files::IStreamPtr &pIStream, T* dest)
+template <uint32_t numInstances, typename T, typename IntegerT> inline void readLittleEndianBufferOfType(const char* src, T* dest)
 {
 #if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    std::memcpy(dest, src, numInstances * sizeof(T));
 #else
-    uint8_t* destByteBuffer = (uint8_t*)dest;
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    const uint8_t* srcByteBuffer = (const uint8_t*)src;
     /*
         Due to the loop iterations being known at compile time,
         this nested loop will most likely be unrolled
@@ -44,7 +48,7 @@ template <uint32_t numInstances, typename T, typename IntegerT> inline void read
     {
         u = { 0 };
         for (uint32_t byte = 0; byte < sizeof(T); byte++)
-            u.i |= (((IntegerT)destByteBuffer[i * sizeof(T) + byte]) << (byte * 8));
+            u.i |= (((IntegerT)srcByteBuffer[i * sizeof(T) + byte]) << (byte * 8));
         dest[i] = u.t;
     }
 #endif
@@ -53,101 +57,139 @@ template <uint32_t numInstances, typename T, typename IntegerT> inline void read
 /*
     readLittleEndianDynamicBufferOfType: This template should only be used with non POD data types
 */
-template <typename T, typename IntegerT> inline void readLittleEndianDynamicBufferOfType(Files::IStreamPtr &pIStream, T* dest, uint32_t numInstances)
+template <typename T, typename IntegerT> inline void readLittleEndianDynamicBufferOfType(const char* src, T* dest, size_t numInstances)
 {
 #if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    std::memcpy(dest, src, numInstances * sizeof(T));
 #else
-    uint8_t* destByteBuffer = (uint8_t*)dest;
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    const uint8_t* srcByteBuffer = (const uint8_t*)src;
     union {
         IntegerT i;
         T t;
     } u;
-    for (uint32_t i = 0; i < numInstances; i++)
+    for (size_t i = 0; i < numInstances; i++)
     {
         u.i = 0;
         for (uint32_t byte = 0; byte < sizeof(T); byte++)
-            u.i |= ((IntegerT)destByteBuffer[i * sizeof(T) + byte]) << (byte * 8);
+            u.i |= ((IntegerT)srcByteBuffer[i * sizeof(T) + byte]) << (byte * 8);
         dest[i] = u.t;
     }
 #endif
 }
-template<typename type, typename IntegerT> type inline readLittleEndianType(Files::IStreamPtr &pIStream)
-{
-    type val;
-    readLittleEndianBufferOfType<1,type,IntegerT>(pIStream, (type*)&val);
-    return val;
-}
+
+/// Reads whole stream into memory with as few read calls as possible.
+std::vector<char> readStreamContent(std::istream& stream);
 
 class NIFStream
 {
-    /// Input stream
-    Files::IStreamPtr inp;
+    /// Whole file content, all reads are bounds-checked moves of the position inside it
+    std::vector<char> mBuffer;
+    const char* mPosition;
+    const char* mEnd;
+
+    /// Returns pointer to the next size bytes and moves position past them
+    const char* read(size_t size)
+    {
+        if (size > static_cast<size_t>(mEnd - mPosition))
+            failEndOfFile(size);
+        const char* result = mPosition;
+        mPosition += size;
+        return result;
+    }
+
+    /// Same as read but for arrays, checks for overflow of the total size
+    template <typename T>
+    const char* readArray(size_t numInstances)
+    {
+        if (numInstances > static_cast<size_t>(mEnd - mPosition) / sizeof(T))
+            failEndOfFile(numInstances * sizeof(T));
+        return read(numInstances * sizeof(T));
+    }
+
+    template <typename type, typename IntegerT>
+    type readLittleEndianType()
+    {
+        type val;
+        readLittleEndianBufferOfType<1, type, IntegerT>(read(sizeof(type)), &val);
+        return val;
+    }
+
+    template <typename type, typename IntegerT>
+    void readLittleEndianVector(std::vector<type> &vec, size_t size)
+    {
+        const char* data = readArray<type>(size);
+        vec.resize(size);
+        readLittleEndianDynamicBufferOfType<type, IntegerT>(data, vec.data(), size);
+    }
+
+    [[noreturn]] void failEndOfFile(size_t size) const;
 
 public:
 
     NIFFile * const file;
 
-    NIFStream (NIFFile * file, Files::IStreamPtr inp): inp (inp), file (file) {}
+    NIFStream (NIFFile * file, Files::IStreamPtr inp);
+
+    NIFStream(const NIFStream&) = delete;
+    NIFStream& operator=(const NIFStream&) = delete;
 
-    void skip(size_t size) { inp->ignore(size); }
+    void skip(size_t size) { read(size); }
 
     char getChar()
     {
-        return readLittleEndianType<char,char>(inp);
+        return readLittleEndianType<char,char>();
     }
 
     short getShort()
     {
-        return readLittleEndianType<short,short>(inp);
+        return readLittleEndianType<short,short>();
     }
 
     unsigned short getUShort()
     {
-        return readLittleEndianType<unsigned short,unsigned short>(inp);
+        return readLittleEndianType<unsigned short,unsigned short>();
     }
 
     int getInt()
     {
-        return readLittleEndianType<int,int>(inp);
+        return readLittleEndianType<int,int>();
     }
 
     unsigned int getUInt()
     {
-        return readLittleEndianType<unsigned int,unsigned int>(inp);
+        return readLittleEndianType<unsigned int,unsigned int>();
     }
 
     float getFloat()
     {
-        return readLittleEndianType<float,uint32_t>(inp);
+        return readLittleEndianType<float,uint32_t>();
     }
 
     osg::Vec2f getVector2()
     {
         osg::Vec2f vec;
-        readLittleEndianBufferOfType<2,float,uint32_t>(inp, (float*)&vec._v[0]);
+        readLittleEndianBufferOfType<2,float,uint32_t>(read(2 * sizeof(float)), (float*)&vec._v[0]);
         return vec;
     }
 
     osg::Vec3f getVector3()
     {
         osg::Vec3f vec;
-        readLittleEndianBufferOfType<3, float,uint32_t>(inp, (float*)&vec._v[0]);
+        readLittleEndianBufferOfType<3, float,uint32_t>(read(3 * sizeof(float)), (float*)&vec._v[0]);
         return vec;
     }
 
     osg::Vec4f getVector4()
     {
         osg::Vec4f vec;
-        readLittleEndianBufferOfType<4, float,uint32_t>(inp, (float*)&vec._v[0]);
+        readLittleEndianBufferOfType<4, float,uint32_t>(read(4 * sizeof(float)), (float*)&vec._v[0]);
         return vec;
     }
 
     Matrix3 getMatrix3()
     {
         Matrix3 mat;
-        readLittleEndianBufferOfType<9, float,uint32_t>(inp, (float*)&mat.mValues);
+        readLittleEndianBufferOfType<9, float,uint32_t>(read(9 * sizeof(float)), (float*)&mat.mValues);
         return mat;
     }
 
@@ -169,92 +211,87 @@ public:
         return (major << 24) + (minor << 16) + (patch << 8) + rev;
     }
 
-    ///Read in a string of the given length
+    ///Read in a string of the given length, the string ends at the first null character
     std::string getSizedString(size_t length)
     {
-        std::vector<char> str(length + 1, 0);
-
-        inp->read(str.data(), length);
-
-        return str.data();
+        const char* data = read(length);
+        return std::string(data, std::find(data, data + length, '\0'));
     }
     ///Read in a string of the length specified in the file
     std::string getSizedString()
     {
-        size_t size = readLittleEndianType<uint32_t,uint32_t>(inp);
+        size_t size = readLittleEndianType<uint32_t,uint32_t>();
         return getSizedString(size);
     }
 
     ///Specific to Bethesda headers, uses a byte for length
     std::string getExportString()
     {
-        size_t size = static_cast<size_t>(readLittleEndianType<uint8_t,uint8_t>(inp));
+        size_t size = static_cast<size_t>(readLittleEndianType<uint8_t,uint8_t>());
         return getSizedString(size);
     }
 
     ///This is special since the version string doesn't start with a number, and ends with "\n"
     std::string getVersionString()
     {
-        std::string result;
-        std::getline(*inp, result);
+        const char* end = std::find(mPosition, mEnd, '\n');
+        std::string result(mPosition, end);
+        mPosition = end == mEnd ? end : end + 1;
         return result;
     }
 
     void getChars(std::vector<char> &vec, size_t size)
     {
-        vec.resize(size);
-        readLittleEndianDynamicBufferOfType<char,char>(inp, vec.data(), size);
+        readLittleEndianVector<char,char>(vec, size);
     }
 
     void getUChars(std::vector<unsigned char> &vec, size_t size)
     {
-        vec.resize(size);
-        readLittleEndianDynamicBufferOfType<unsigned char,unsigned char>(inp, vec.data(), size);
+        readLittleEndianVector<unsigned char,unsigned char>(vec, size);
     }
 
     void getUShorts(std::vector<unsigned short> &vec, size_t size)
     {
-        vec.resize(size);
-        readLittleEndianDynamicBufferOfType<unsigned short,unsigned short>(inp, vec.data(), size);
+        readLittleEndianVector<unsigned short,unsigned short>(vec, size);
     }
 
     void getFloats(std::vector<float> &vec, size_t size)
     {
-        vec.resize(size);
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp, vec.data(), size);
+        readLittleEndianVector<float,uint32_t>(vec, size);
     }
 
     void getInts(std::vector<int> &vec, size_t size)
     {
-        vec.resize(size);
-        readLittleEndianDynamicBufferOfType<int,int>(inp, vec.data(), size);
+        readLittleEndianVector<int,int>(vec, size);
     }
 
     void getUInts(std::vector<unsigned int> &vec, size_t size)
     {
-        vec.resize(size);
-        readLittleEndianDynamicBufferOfType<unsigned int,unsigned int>(inp, vec.data(), size);
+        readLittleEndianVector<unsigned int,unsigned int>(vec, size);
     }
 
     void getVector2s(std::vector<osg::Vec2f> &vec, size_t size)
     {
+        const char* data = readArray<osg::Vec2f>(size);
         vec.resize(size);
         /* The packed storage of each Vec2f is 2 floats exactly */
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp,(float*)vec.data(), size*2);
+        readLittleEndianDynamicBufferOfType<float,uint32_t>(data, (float*)vec.data(), size*2);
     }
 
     void getVector3s(std::vector<osg::Vec3f> &vec, size_t size)
     {
+        const char* data = readArray<osg::Vec3f>(size);
         vec.resize(size);
         /* The packed storage of each Vec3f is 3 floats exactly */
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp, (float*)vec.data(), size*3);
+        readLittleEndianDynamicBufferOfType<float,uint32_t>(data, (float*)vec.data(), size*3);
     }
 
     void getVector4s(std::vector<osg::Vec4f> &vec, size_t size)
     {
+        const char* data = readArray<osg::Vec4f>(size);
         vec.resize(size);
         /* The packed storage of each Vec4f is 4 floats exactly */
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp, (float*)vec.data(), size*4);
+        readLittleEndianDynamicBufferOfType<float,uint32_t>(data, (float*)vec.data(), size*4);
     }
 
     void getQuaternions(std::vector<osg::Quat> &quat, size_t size)
@@ -0,0 +1,70 @@
+#ifndef OPENMW_COMPONENTS_NIF_RECORDARENA_HPP
+#define OPENMW_COMPONENTS_NIF_RECORDARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "record.hpp"
+
+namespace Nif
+{
+
+/// Places records of a single file into large memory blocks instead of allocating each one separately.
+/// Records are destroyed together with the arena in reverse order of creation.
+class RecordArena
+{
+    static constexpr std::size_t sBlockSize = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> mBlocks;
+    char* mCurrent = nullptr;
+    std::size_t mAvailable = 0;
+    std::vector<Record*> mRecords;
+
+    void* allocate(std::size_t size, std::size_t alignment)
+    {
+        void* result = mCurrent;
+        if (result == nullptr || std::align(alignment, size, result, mAvailable) == nullptr)
+        {
+            const std::size_t blockSize = size + alignment > sBlockSize ? size + alignment : sBlockSize;
+            mBlocks.emplace_back(new char[blockSize]);
+            result = mBlocks.back().get();
+            mAvailable = blockSize;
+            std::align(alignment, size, result, mAvailable);
+        }
+        mCurrent = static_cast<char*>(result) + size;
+        mAvailable -= size;
+        return result;
+    }
+
+public:
+    RecordArena() = default;
+
+    RecordArena(const RecordArena&) = delete;
+    RecordArena& operator=(const RecordArena&) = delete;
+
+    ~RecordArena()
+    {
+        for (auto it = mRecords.rbegin(); it != mRecords.rend(); ++it)
+            (*it)->~Record();
+    }
+
+    void reserve(std::size_t records)
+    {
+        mRecords.reserve(records);
+    }
+
+    template <class T>
+    T* create()
+    {
+        mRecords.reserve(mRecords.size() + 1);
+        T* result = new (allocate(sizeof(T), alignof(T))) T;
+        mRecords.push_back(result);
+        return result;
+    }
+};
+
+}
+
+#endif
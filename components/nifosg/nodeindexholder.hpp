@@ -24,6 +24,8 @@ namespace NifOsg
 
         int getIndex() const { return mIndex; }
 
+        void setIndex(int index) { mIndex = index; }
+
     private:
 
         // NIF record index
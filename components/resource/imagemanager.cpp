@@ -1,6 +1,8 @@
 #include "imagemanager.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <osgDB/Registry>
 
 #include <components/debug/debuglog.hpp>
@@ -39,6 +41,30 @@ namespace
         return warningImage;
     }
 
+    /// Moves the given mipmap level of the image to the top, dropping the larger ones.
+    osg::ref_ptr<osg::Image> makeReducedImage(const osg::Image& image, unsigned int mipLevel)
+    {
+        const unsigned int offset = image.getMipmapOffset(mipLevel);
+        const unsigned int size = image.getTotalSizeInBytesIncludingMipmaps() - offset;
+
+        unsigned char* data = new unsigned char[size];
+        std::memcpy(data, image.data() + offset, size);
+
+        osg::ref_ptr<osg::Image> result = new osg::Image;
+        result->setFileName(image.getFileName());
+        result->setImage(std::max(image.s() >> mipLevel, 1), std::max(image.t() >> mipLevel, 1), image.r(),
+                         image.getInternalTextureFormat(), image.getPixelFormat(), image.getDataType(),
+                         data, osg::Image::USE_NEW_DELETE, image.getPacking());
+        result->setOrigin(image.getOrigin());
+
+        osg::Image::MipmapDataType mipmaps;
+        for (unsigned int i = mipLevel + 1; i < image.getNumMipmapLevels(); ++i)
+            mipmaps.push_back(image.getMipmapOffset(i) - offset);
+        result->setMipmapLevels(mipmaps);
+
+        return result;
+    }
+
 }
 
 namespace Resource
@@ -89,105 +115,151 @@ namespace Resource
         osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
         if (obj)
             return osg::ref_ptr<osg::Image>(static_cast<osg::Image*>(obj.get()));
+
+        osg::ref_ptr<osg::Image> image = loadImage(normalized, filename);
+        if (!image)
+        {
+            mCache->addEntryToObjectCache(normalized, mWarningImage);
+            return mWarningImage;
+        }
+
+        mCache->addEntryToObjectCache(normalized, image, 0.0, image->getTotalSizeInBytesIncludingMipmaps());
+        return image;
+    }
+
+    osg::ref_ptr<osg::Image> ImageManager::getImage(const std::string &filename, unsigned int mipLevels)
+    {
+        if (mipLevels == 0)
+            return getImage(filename);
+
+        std::string normalized = filename;
+        mVFS->normalizeFilename(normalized);
+
+        // reduced images are cached next to the full ones, '|' can't be a part of a file name
+        const std::string key = normalized + '|' + std::to_string(mipLevels);
+
+        osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(key);
+        if (obj)
+            return osg::ref_ptr<osg::Image>(static_cast<osg::Image*>(obj.get()));
+
+        // reduce an already cached full image, otherwise read the file and keep only the smaller mipmaps of it
+        osg::ref_ptr<osg::Image> image;
+        obj = mCache->getRefFromObjectCache(normalized);
+        if (obj)
+            image = static_cast<osg::Image*>(obj.get());
         else
+            image = loadImage(normalized, filename);
+
+        if (!image)
         {
-            Files::IStreamPtr stream;
-            try
-            {
-                stream = mVFS->get(normalized.c_str());
-            }
-            catch (std::exception& e)
-            {
-                Log(Debug::Error) << "Failed to open image: " << e.what();
-                mCache->addEntryToObjectCache(normalized, mWarningImage);
-                return mWarningImage;
-            }
+            mCache->addEntryToObjectCache(key, mWarningImage);
+            return mWarningImage;
+        }
 
-            size_t extPos = normalized.find_last_of('.');
-            std::string ext;
-            if (extPos != std::string::npos && extPos+1 < normalized.size())
-                ext = normalized.substr(extPos+1);
-            osgDB::ReaderWriter* reader = osgDB::Registry::instance()->getReaderWriterForExtension(ext);
-            if (!reader)
-            {
-                Log(Debug::Error) << "Error loading " << filename << ": no readerwriter for '" << ext << "' found";
-                mCache->addEntryToObjectCache(normalized, mWarningImage);
-                return mWarningImage;
-            }
+        // images without precomputed mipmaps are kept as they are, don't count the memory of a cached one twice
+        std::size_t cost = obj ? 0 : image->getTotalSizeInBytesIncludingMipmaps();
+        if (image != mWarningImage && image->r() == 1 && image->isDataContiguous() && image->getNumMipmapLevels() > 1)
+        {
+            image = makeReducedImage(*image, std::min(mipLevels, image->getNumMipmapLevels() - 1));
+            cost = image->getTotalSizeInBytesIncludingMipmaps();
+        }
 
-            bool killAlpha = false;
-            if (reader->supportedExtensions().count("tga"))
-            {
-                // Morrowind ignores the alpha channel of 16bpp TGA files even when the header says not to
-                unsigned char header[18];
-                stream->read((char*)header, 18);
-                if (stream->gcount() != 18)
-                {
-                    Log(Debug::Error) << "Error loading " << filename << ": couldn't read TGA header";
-                    mCache->addEntryToObjectCache(normalized, mWarningImage);
-                    return mWarningImage;
-                }
-                int type = header[2];
-                int depth;
-                if (type == 1 || type == 9)
-                    depth = header[7];
-                else
-                    depth = header[16];
-                int alphaBPP = header[17] & 0x0F;
-                killAlpha = depth == 16 && alphaBPP == 1;
-                stream->seekg(0);
-            }
+        mCache->addEntryToObjectCache(key, image, 0.0, cost);
+        return image;
+    }
+
+    osg::ref_ptr<osg::Image> ImageManager::loadImage(const std::string& normalized, const std::string& filename) const
+    {
+        Files::IStreamPtr stream;
+        try
+        {
+            stream = mVFS->get(normalized.c_str());
+        }
+        catch (std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to open image: " << e.what();
+            return nullptr;
+        }
 
-            osgDB::ReaderWriter::ReadResult result = reader->readImage(*stream, mOptions);
-            if (!result.success())
+        size_t extPos = normalized.find_last_of('.');
+        std::string ext;
+        if (extPos != std::string::npos && extPos+1 < normalized.size())
+            ext = normalized.substr(extPos+1);
+        osgDB::ReaderWriter* reader = osgDB::Registry::instance()->getReaderWriterForExtension(ext);
+        if (!reader)
+        {
+            Log(Debug::Error) << "Error loading " << filename << ": no readerwriter for '" << ext << "' found";
+            return nullptr;
+        }
+
+        bool killAlpha = false;
+        if (reader->supportedExtensions().count("tga"))
+        {
+            // Morrowind ignores the alpha channel of 16bpp TGA files even when the header says not to
+            unsigned char header[18];
+            stream->read((char*)header, 18);
+            if (stream->gcount() != 18)
             {
-                Log(Debug::Error) << "Error loading " << filename << ": " << result.message() << " code " << result.status();
-                mCache->addEntryToObjectCache(normalized, mWarningImage);
-                return mWarningImage;
+                Log(Debug::Error) << "Error loading " << filename << ": couldn't read TGA header";
+                return nullptr;
             }
+            int type = header[2];
+            int depth;
+            if (type == 1 || type == 9)
+                depth = header[7];
+            else
+                depth = header[16];
+            int alphaBPP = header[17] & 0x0F;
+            killAlpha = depth == 16 && alphaBPP == 1;
+            stream->seekg(0);
+        }
+
+        osgDB::ReaderWriter::ReadResult result = reader->readImage(*stream, mOptions);
+        if (!result.success())
+        {
+            Log(Debug::Error) << "Error loading " << filename << ": " << result.message() << " code " << result.status();
+            return nullptr;
+        }
 
-            osg::ref_ptr<osg::Image> image = result.getImage();
+        osg::ref_ptr<osg::Image> image = result.getImage();
 
-            image->setFileName(normalized);
-            if (!checkSupported(image, filename))
+        image->setFileName(normalized);
+        if (!checkSupported(image, filename))
+        {
+            static bool uncompress = (getenv("OPENMW_DECOMPRESS_TEXTURES") != 0);
+            if (!uncompress)
             {
-                static bool uncompress = (getenv("OPENMW_DECOMPRESS_TEXTURES") != 0);
-                if (!uncompress)
-                {
-                    Log(Debug::Error) << "Error loading " << filename << ": no S3TC texture compression support installed";
-                    mCache->addEntryToObjectCache(normalized, mWarningImage);
-                    return mWarningImage;
-                }
-                else
-                {
-                    // decompress texture in software if not supported by GPU
-                    // requires update to getColor() to be released with OSG 3.6
-                    osg::ref_ptr<osg::Image> newImage = new osg::Image;
-                    newImage->setFileName(image->getFileName());
-                    newImage->allocateImage(image->s(), image->t(), image->r(), image->isImageTranslucent() ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE);
-                    for (int s=0; s<image->s(); ++s)
-                        for (int t=0; t<image->t(); ++t)
-                            for (int r=0; r<image->r(); ++r)
-                                newImage->setColor(image->getColor(s,t,r), s,t,r);
-                    image = newImage;
-                }
+                Log(Debug::Error) << "Error loading " << filename << ": no S3TC texture compression support installed";
+                return nullptr;
             }
-            else if (killAlpha)
+            else
             {
+                // decompress texture in software if not supported by GPU
+                // requires update to getColor() to be released with OSG 3.6
                 osg::ref_ptr<osg::Image> newImage = new osg::Image;
                 newImage->setFileName(image->getFileName());
-                newImage->allocateImage(image->s(), image->t(), image->r(), GL_RGB, GL_UNSIGNED_BYTE);
-                // OSG just won't write the alpha as there's nowhere to put it.
-                for (int s = 0; s < image->s(); ++s)
-                    for (int t = 0; t < image->t(); ++t)
-                        for (int r = 0; r < image->r(); ++r)
-                            newImage->setColor(image->getColor(s, t, r), s, t, r);
+                newImage->allocateImage(image->s(), image->t(), image->r(), image->isImageTranslucent() ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE);
+                for (int s=0; s<image->s(); ++s)
+                    for (int t=0; t<image->t(); ++t)
+                        for (int r=0; r<image->r(); ++r)
+                            newImage->setColor(image->getColor(s,t,r), s,t,r);
                 image = newImage;
             }
-
-            mCache->addEntryToObjectCache(normalized, image);
-            return image;
         }
+        else if (killAlpha)
+        {
+            osg::ref_ptr<osg::Image> newImage = new osg::Image;
+            newImage->setFileName(image->getFileName());
+            newImage->allocateImage(image->s(), image->t(), image->r(), GL_RGB, GL_UNSIGNED_BYTE);
+            // OSG just won't write the alpha as there's nowhere to put it.
+            for (int s = 0; s < image->s(); ++s)
+                for (int t = 0; t < image->t(); ++t)
+                    for (int r = 0; r < image->r(); ++r)
+                        newImage->setColor(image->getColor(s, t, r), s, t, r);
+            image = newImage;
+        }
+
+        return image;
     }
 
     osg::Image *ImageManager::getWarningImage()
@@ -195,9 +267,14 @@ namespace Resource
         return mWarningImage;
     }
 
+    std::size_t ImageManager::getMemoryUsage() const
+    {
+        return mCache->getTotalCost();
+    }
+
     void ImageManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
-        stats->setAttribute(frameNumber, "Image", mCache->getCacheSize());
+        reportCacheStats(frameNumber, stats, "Image");
     }
 
 }
@@ -1,6 +1,7 @@
 #ifndef OPENMW_COMPONENTS_RESOURCE_IMAGEMANAGER_H
 #define OPENMW_COMPONENTS_RESOURCE_IMAGEMANAGER_H
 
+#include <cstddef>
 #include <string>
 #include <map>
 
@@ -30,11 +31,22 @@ namespace Resource
         /// Returns the dummy image if the given image is not found.
         osg::ref_ptr<osg::Image> getImage(const std::string& filename);
 
+        /// Create or retrieve an Image without its \a mipLevels largest mipmap levels, e.g. for distant objects.
+        /// Returns the full Image if it has no precomputed mipmaps. The smallest mipmap level is always kept.
+        /// @note The full Image is not added to the cache when it has to be read to create the reduced one.
+        osg::ref_ptr<osg::Image> getImage(const std::string& filename, unsigned int mipLevels);
+
         osg::Image* getWarningImage();
 
-        void reportStats(unsigned int frameNumber, osg::Stats* stats) const;
+        /// Size in bytes of all cached images.
+        std::size_t getMemoryUsage() const;
+
+        void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
 
     private:
+        /// @return nullptr if the image can't be loaded, the reason is logged.
+        osg::ref_ptr<osg::Image> loadImage(const std::string& normalized, const std::string& filename) const;
+
         osg::ref_ptr<osg::Image> mWarningImage;
         osg::ref_ptr<osgDB::Options> mOptions;
 
@@ -3,6 +3,10 @@
 // - removeExpiredObjectsInCache no longer keeps a lock while the unref happens.
 // - template allows customized KeyType.
 // - objects with uninitialized time stamp are not removed.
+// - entries are spread over independently locked shards.
+// - entries may have a cost in bytes, unreferenced ones are removed in least recently used order when the total cost
+//   of all caches sharing a budget is above its limit.
+// - hits, misses and evictions are counted.
 
 /* -*-c++-*- OpenSceneGraph - Copyright (C) 1998-2006 Robert Osfield
  *
@@ -23,10 +27,20 @@
 #include <osg/Referenced>
 #include <osg/ref_ptr>
 #include <osg/Node>
+#include <osg/Vec2f>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <map>
 #include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace osg
 {
@@ -37,13 +51,193 @@ namespace osg
 
 namespace Resource {
 
+namespace ObjectCacheKey
+{
+    inline void combineHash(std::size_t& seed, std::size_t value)
+    {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    template <class T>
+    std::size_t getHash(const T& value);
+
+    inline std::size_t getHash(const osg::Vec2f& value);
+
+    template <class First, class Second>
+    std::size_t getHash(const std::pair<First, Second>& value);
+
+    template <class ... Types>
+    std::size_t getHash(const std::tuple<Types ...>& value);
+
+    template <class T>
+    std::size_t getHash(const T& value)
+    {
+        return std::hash<T>()(value);
+    }
+
+    inline std::size_t getHash(const osg::Vec2f& value)
+    {
+        std::size_t result = getHash(value.x());
+        combineHash(result, getHash(value.y()));
+        return result;
+    }
+
+    template <class First, class Second>
+    std::size_t getHash(const std::pair<First, Second>& value)
+    {
+        std::size_t result = getHash(value.first);
+        combineHash(result, getHash(value.second));
+        return result;
+    }
+
+    template <class Tuple, std::size_t ... indices>
+    std::size_t getTupleHash(const Tuple& value, std::index_sequence<indices ...>)
+    {
+        std::size_t result = 0;
+        (void) std::initializer_list<int> {(combineHash(result, getHash(std::get<indices>(value))), 0) ...};
+        return result;
+    }
+
+    template <class ... Types>
+    std::size_t getHash(const std::tuple<Types ...>& value)
+    {
+        return getTupleHash(value, std::index_sequence_for<Types ...>());
+    }
+}
+
+/** Object cache as seen by a CacheBudget, independent of the key type.*/
+class BudgetedObjectCache : public osg::Referenced
+{
+    public:
+
+        BudgetedObjectCache() : osg::Referenced(true) {}
+
+        /** Append usage order and cost of each object without external references that has a cost.*/
+        virtual void collectUnreferencedCosts(std::vector<std::pair<std::uint64_t, std::size_t> >& costs) const = 0;
+
+        /** Remove objects without external references that have a cost and were last used at or before lastUsed.*/
+        virtual void removeUnreferencedUsedBefore(std::uint64_t lastUsed) = 0;
+
+    protected:
+
+        virtual ~BudgetedObjectCache() {}
+};
+
+/** Memory limit shared by object caches. Objects are ordered by their last use across all caches, so the least
+  * recently used ones are removed first whichever cache they are in.*/
+class CacheBudget : public osg::Referenced
+{
+    public:
+
+        CacheBudget()
+            : osg::Referenced(true)
+            , _maxCost(0)
+            , _totalCost(0)
+            , _lastUsed(0) {}
+
+        /** Set the total cost above which unreferenced objects are removed, 0 means no limit. */
+        void setMaxCost(std::size_t maxCost) { _maxCost = maxCost; }
+
+        std::size_t getMaxCost() const { return _maxCost; }
+
+        /** Get the sum of costs of all objects in all caches using this budget. */
+        std::size_t getTotalCost() const { return _totalCost; }
+
+        void addCost(std::size_t cost) { _totalCost += cost; }
+
+        void subtractCost(std::size_t cost) { _totalCost -= cost; }
+
+        /** Get the next value of the usage order shared by the caches.*/
+        std::uint64_t use() { return ++_lastUsed; }
+
+        void addCache(BudgetedObjectCache* cache)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _caches.push_back(cache);
+        }
+
+        void removeCache(BudgetedObjectCache* cache)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _caches.erase(std::remove(_caches.begin(), _caches.end(), cache), _caches.end());
+        }
+
+        /** Remove objects without external references from all caches in least recently used order until the total
+          * cost is within the limit. Objects still referenced elsewhere are never removed because this wouldn't release
+          * any memory.*/
+        void removeLeastRecentlyUsedObjects()
+        {
+            const std::size_t maxCost = _maxCost;
+            if (maxCost == 0 || _totalCost <= maxCost)
+                return;
+
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            std::vector<std::pair<std::uint64_t, std::size_t> > costs;
+            for (const BudgetedObjectCache* cache : _caches)
+                cache->collectUnreferencedCosts(costs);
+
+            std::sort(costs.begin(), costs.end());
+
+            // the most recently used object to remove, all used before it are removed too
+            std::size_t totalCost = _totalCost;
+            std::uint64_t lastUsed = 0;
+            for (const auto& cost : costs)
+            {
+                if (totalCost <= maxCost)
+                    break;
+                totalCost -= std::min(totalCost, cost.second);
+                lastUsed = cost.first;
+            }
+
+            if (lastUsed == 0)
+                return;
+
+            for (BudgetedObjectCache* cache : _caches)
+                cache->removeUnreferencedUsedBefore(lastUsed);
+        }
+
+    protected:
+
+        virtual ~CacheBudget() {}
+
+        std::atomic<std::size_t>                _maxCost;
+        std::atomic<std::size_t>                _totalCost;
+        std::atomic<std::uint64_t>              _lastUsed;
+        std::mutex                              _mutex;
+        std::vector<BudgetedObjectCache*>       _caches;
+};
+
 template <typename KeyType>
-class GenericObjectCache : public osg::Referenced
+class GenericObjectCache : public BudgetedObjectCache
 {
     public:
 
         GenericObjectCache()
-            : osg::Referenced(true) {}
+            : _budget(new CacheBudget)
+            , _totalCost(0)
+            , _hits(0)
+            , _misses(0)
+            , _evictions(0)
+        {
+            _budget->addCache(this);
+        }
+
+        /** Share the memory limit with other caches using the same budget, nullptr gives the cache a budget of its
+          * own. Not safe to call while the cache is used from other threads.*/
+        void setBudget(CacheBudget* budget)
+        {
+            osg::ref_ptr<CacheBudget> newBudget = budget != nullptr ? budget : new CacheBudget;
+            if (newBudget == _budget)
+                return;
+            _budget->removeCache(this);
+            _budget->subtractCost(_totalCost);
+            _budget = newBudget;
+            _budget->addCache(this);
+            _budget->addCost(_totalCost);
+        }
+
+        CacheBudget* getBudget() const { return _budget.get(); }
 
         /** For each object in the cache which has an reference count greater than 1
           * (and therefore referenced by elsewhere in the application) set the time stamp
@@ -53,14 +247,17 @@ class GenericObjectCache : public osg::Referenced
           * The time used should be taken from the FrameStamp::getReferenceTime().*/
         void updateTimeStampOfObjectsInCacheWithExternalReferences(double referenceTime)
         {
-            // look for objects with external references and update their time stamp.
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            for(typename ObjectCacheMap::iterator itr=_objectCache.begin(); itr!=_objectCache.end(); ++itr)
+            for (Shard& shard : _shards)
             {
-                // If ref count is greater than 1, the object has an external reference.
-                // If the timestamp is yet to be initialized, it needs to be updated too.
-                if (itr->second.first->referenceCount()>1 || itr->second.second == 0.0)
-                    itr->second.second = referenceTime;
+                // look for objects with external references and update their time stamp.
+                std::lock_guard<std::mutex> lock(shard._mutex);
+                for(typename ObjectCacheMap::iterator itr=shard._objectCache.begin(); itr!=shard._objectCache.end(); ++itr)
+                {
+                    // If ref count is greater than 1, the object has an external reference.
+                    // If the timestamp is yet to be initialized, it needs to be updated too.
+                    if (itr->second._object->referenceCount()>1 || itr->second._timeStamp == 0.0)
+                        itr->second._timeStamp = referenceTime;
+                }
             }
         }
 
@@ -71,16 +268,18 @@ class GenericObjectCache : public osg::Referenced
         void removeExpiredObjectsInCache(double expiryTime)
         {
             std::vector<osg::ref_ptr<osg::Object> > objectsToRemove;
+            for (Shard& shard : _shards)
             {
-                std::lock_guard<std::mutex> lock(_objectCacheMutex);
+                std::lock_guard<std::mutex> lock(shard._mutex);
                 // Remove expired entries from object cache
-                typename ObjectCacheMap::iterator oitr = _objectCache.begin();
-                while(oitr != _objectCache.end())
+                typename ObjectCacheMap::iterator oitr = shard._objectCache.begin();
+                while(oitr != shard._objectCache.end())
                 {
-                    if (oitr->second.second<=expiryTime)
+                    if (oitr->second._timeStamp<=expiryTime)
                     {
-                        objectsToRemove.push_back(oitr->second.first);
-                        _objectCache.erase(oitr++);
+                        objectsToRemove.push_back(std::move(oitr->second._object));
+                        subtractCost(oitr->second._cost);
+                        shard._objectCache.erase(oitr++);
                     }
                     else
                         ++oitr;
@@ -90,46 +289,119 @@ class GenericObjectCache : public osg::Referenced
             objectsToRemove.clear();
         }
 
+        /** Remove objects without external references in least recently used order until the total cost
+          * of all caches sharing the budget is within its limit, see CacheBudget::removeLeastRecentlyUsedObjects.
+          * This would typically be called once per frame after removeExpiredObjectsInCache.*/
+        void removeLeastRecentlyUsedObjectsInCache()
+        {
+            _budget->removeLeastRecentlyUsedObjects();
+        }
+
+        void collectUnreferencedCosts(std::vector<std::pair<std::uint64_t, std::size_t> >& costs) const override
+        {
+            for (const Shard& shard : _shards)
+            {
+                std::lock_guard<std::mutex> lock(shard._mutex);
+                for (const auto& entry : shard._objectCache)
+                    if (entry.second._cost > 0 && entry.second._object->referenceCount() == 1)
+                        costs.emplace_back(entry.second._lastUsed, entry.second._cost);
+            }
+        }
+
+        void removeUnreferencedUsedBefore(std::uint64_t lastUsed) override
+        {
+            std::vector<osg::ref_ptr<osg::Object> > objectsToRemove;
+            for (Shard& shard : _shards)
+            {
+                std::lock_guard<std::mutex> lock(shard._mutex);
+                typename ObjectCacheMap::iterator itr = shard._objectCache.begin();
+                while (itr != shard._objectCache.end())
+                {
+                    // the object may have been used since the costs were collected
+                    if (itr->second._cost > 0 && itr->second._lastUsed <= lastUsed
+                            && itr->second._object->referenceCount() == 1)
+                    {
+                        objectsToRemove.push_back(std::move(itr->second._object));
+                        subtractCost(itr->second._cost);
+                        shard._objectCache.erase(itr++);
+                        ++_evictions;
+                    }
+                    else
+                        ++itr;
+                }
+            }
+            // note, actual unref happens outside of the lock
+            objectsToRemove.clear();
+        }
+
         /** Remove all objects in the cache regardless of having external references or expiry times.*/
         void clear()
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            _objectCache.clear();
+            for (Shard& shard : _shards)
+            {
+                std::lock_guard<std::mutex> lock(shard._mutex);
+                for (const auto& entry : shard._objectCache)
+                    subtractCost(entry.second._cost);
+                shard._objectCache.clear();
+            }
         }
 
-        /** Add a key,object,timestamp triple to the Registry::ObjectCache.*/
-        void addEntryToObjectCache(const KeyType& key, osg::Object* object, double timestamp = 0.0)
+        /** Add a key,object,timestamp triple to the Registry::ObjectCache.
+          * The cost is the memory in bytes owned by the object and counts towards the limit set by setMaxCost.*/
+        void addEntryToObjectCache(const KeyType& key, osg::Object* object, double timestamp = 0.0, std::size_t cost = 0)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            _objectCache[key]=ObjectTimeStampPair(object,timestamp);
+            osg::ref_ptr<osg::Object> replaced;
+            Shard& shard = getShard(key);
+            std::lock_guard<std::mutex> lock(shard._mutex);
+            ObjectCacheEntry& entry = shard._objectCache[key];
+            replaced = std::move(entry._object);
+            subtractCost(entry._cost);
+            entry._object = object;
+            entry._timeStamp = timestamp;
+            entry._cost = cost;
+            entry._lastUsed = _budget->use();
+            addCost(cost);
         }
 
         /** Remove Object from cache.*/
         void removeFromObjectCache(const KeyType& key)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            typename ObjectCacheMap::iterator itr = _objectCache.find(key);
-            if (itr!=_objectCache.end()) _objectCache.erase(itr);
+            Shard& shard = getShard(key);
+            std::lock_guard<std::mutex> lock(shard._mutex);
+            typename ObjectCacheMap::iterator itr = shard._objectCache.find(key);
+            if (itr!=shard._objectCache.end())
+            {
+                subtractCost(itr->second._cost);
+                shard._objectCache.erase(itr);
+            }
         }
 
         /** Get an ref_ptr<Object> from the object cache*/
         osg::ref_ptr<osg::Object> getRefFromObjectCache(const KeyType& key)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            typename ObjectCacheMap::iterator itr = _objectCache.find(key);
-            if (itr!=_objectCache.end())
-                return itr->second.first;
-            else return 0;
+            Shard& shard = getShard(key);
+            std::lock_guard<std::mutex> lock(shard._mutex);
+            typename ObjectCacheMap::iterator itr = shard._objectCache.find(key);
+            if (itr!=shard._objectCache.end())
+            {
+                itr->second._lastUsed = _budget->use();
+                ++_hits;
+                return itr->second._object;
+            }
+            ++_misses;
+            return 0;
         }
 
         /** Check if an object is in the cache, and if it is, update its usage time stamp. */
         bool checkInObjectCache(const KeyType& key, double timeStamp)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            typename ObjectCacheMap::iterator itr = _objectCache.find(key);
-            if (itr!=_objectCache.end())
+            Shard& shard = getShard(key);
+            std::lock_guard<std::mutex> lock(shard._mutex);
+            typename ObjectCacheMap::iterator itr = shard._objectCache.find(key);
+            if (itr!=shard._objectCache.end())
             {
-                itr->second.second = timeStamp;
+                itr->second._timeStamp = timeStamp;
+                itr->second._lastUsed = _budget->use();
                 return true;
             }
             else return false;
@@ -138,26 +410,32 @@ class GenericObjectCache : public osg::Referenced
         /** call releaseGLObjects on all objects attached to the object cache.*/
         void releaseGLObjects(osg::State* state)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            for(typename ObjectCacheMap::iterator itr = _objectCache.begin(); itr != _objectCache.end(); ++itr)
+            for (Shard& shard : _shards)
             {
-                osg::Object* object = itr->second.first.get();
-                object->releaseGLObjects(state);
+                std::lock_guard<std::mutex> lock(shard._mutex);
+                for(typename ObjectCacheMap::iterator itr = shard._objectCache.begin(); itr != shard._objectCache.end(); ++itr)
+                {
+                    osg::Object* object = itr->second._object.get();
+                    object->releaseGLObjects(state);
+                }
             }
         }
 
         /** call node->accept(nv); for all nodes in the objectCache. */
         void accept(osg::NodeVisitor& nv)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            for(typename ObjectCacheMap::iterator itr = _objectCache.begin(); itr != _objectCache.end(); ++itr)
+            for (Shard& shard : _shards)
             {
-                osg::Object* object = itr->second.first.get();
-                if (object)
+                std::lock_guard<std::mutex> lock(shard._mutex);
+                for(typename ObjectCacheMap::iterator itr = shard._objectCache.begin(); itr != shard._objectCache.end(); ++itr)
                 {
-                    osg::Node* node = dynamic_cast<osg::Node*>(object);
-                    if (node)
-                        node->accept(nv);
+                    osg::Object* object = itr->second._object.get();
+                    if (object)
+                    {
+                        osg::Node* node = dynamic_cast<osg::Node*>(object);
+                        if (node)
+                            node->accept(nv);
+                    }
                 }
             }
         }
@@ -166,28 +444,94 @@ class GenericObjectCache : public osg::Referenced
         template <class Functor>
         void call(Functor& f)
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            for (typename ObjectCacheMap::iterator it = _objectCache.begin(); it != _objectCache.end(); ++it)
-                f(it->first, it->second.first.get());
+            for (Shard& shard : _shards)
+            {
+                std::lock_guard<std::mutex> lock(shard._mutex);
+                for (typename ObjectCacheMap::iterator it = shard._objectCache.begin(); it != shard._objectCache.end(); ++it)
+                    f(it->first, it->second._object.get());
+            }
         }
 
         /** Get the number of objects in the cache. */
         unsigned int getCacheSize() const
         {
-            std::lock_guard<std::mutex> lock(_objectCacheMutex);
-            return _objectCache.size();
+            std::size_t result = 0;
+            for (const Shard& shard : _shards)
+            {
+                std::lock_guard<std::mutex> lock(shard._mutex);
+                result += shard._objectCache.size();
+            }
+            return static_cast<unsigned int>(result);
         }
 
+        /** Set the total cost of all caches sharing the budget above which unreferenced objects are removed,
+          * 0 means no limit. */
+        void setMaxCost(std::size_t maxCost) { _budget->setMaxCost(maxCost); }
+
+        std::size_t getMaxCost() const { return _budget->getMaxCost(); }
+
+        /** Get the sum of costs of all objects in the cache. */
+        std::size_t getTotalCost() const { return _totalCost; }
+
+        /** Get the number of getRefFromObjectCache calls that found an object. */
+        std::size_t getHits() const { return _hits; }
+
+        /** Get the number of getRefFromObjectCache calls that didn't find an object. */
+        std::size_t getMisses() const { return _misses; }
+
+        /** Get the number of objects removed by removeLeastRecentlyUsedObjectsInCache. */
+        std::size_t getEvictions() const { return _evictions; }
+
     protected:
 
-        virtual ~GenericObjectCache() {}
+        virtual ~GenericObjectCache()
+        {
+            _budget->removeCache(this);
+            _budget->subtractCost(_totalCost);
+        }
+
+        struct ObjectCacheEntry
+        {
+            osg::ref_ptr<osg::Object> _object;
+            double _timeStamp = 0.0;
+            std::size_t _cost = 0;
+            std::uint64_t _lastUsed = 0;
+        };
+
+        typedef std::map<KeyType, ObjectCacheEntry >             ObjectCacheMap;
+
+        struct Shard
+        {
+            ObjectCacheMap                      _objectCache;
+            mutable std::mutex                  _mutex;
+        };
+
+        // a power of two to select a shard by the lower bits of the key hash
+        static constexpr std::size_t            NumShards = 16;
 
-        typedef std::pair<osg::ref_ptr<osg::Object>, double >           ObjectTimeStampPair;
-        typedef std::map<KeyType, ObjectTimeStampPair >             ObjectCacheMap;
+        std::array<Shard, NumShards>            _shards;
+        osg::ref_ptr<CacheBudget>               _budget;
+        std::atomic<std::size_t>                _totalCost;
+        std::atomic<std::size_t>                _hits;
+        std::atomic<std::size_t>                _misses;
+        std::atomic<std::size_t>                _evictions;
 
-        ObjectCacheMap                          _objectCache;
-        mutable std::mutex                      _objectCacheMutex;
+        void addCost(std::size_t cost)
+        {
+            _totalCost += cost;
+            _budget->addCost(cost);
+        }
 
+        void subtractCost(std::size_t cost)
+        {
+            _totalCost -= cost;
+            _budget->subtractCost(cost);
+        }
+
+        Shard& getShard(const KeyType& key)
+        {
+            return _shards[ObjectCacheKey::getHash(key) % NumShards];
+        }
 };
 
 class ObjectCache : public GenericObjectCache<std::string>
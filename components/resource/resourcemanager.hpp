@@ -1,7 +1,11 @@
 #ifndef OPENMW_COMPONENTS_RESOURCE_MANAGER_H
 #define OPENMW_COMPONENTS_RESOURCE_MANAGER_H
 
+#include <cstddef>
+#include <string>
+
 #include <osg/ref_ptr>
+#include <osg/Stats>
 
 #include "objectcache.hpp"
 
@@ -12,7 +16,6 @@ namespace VFS
 
 namespace osg
 {
-    class Stats;
     class State;
 }
 
@@ -26,6 +29,7 @@ namespace Resource
         virtual void updateCache(double referenceTime) {}
         virtual void clearCache() {}
         virtual void setExpiryDelay(double expiryDelay) {}
+        virtual void setCacheBudget(CacheBudget* budget) {}
         virtual void reportStats(unsigned int frameNumber, osg::Stats* stats) const {}
         virtual void releaseGLObjects(osg::State* state) {}
     };
@@ -47,11 +51,13 @@ namespace Resource
 
         virtual ~GenericResourceManager() {}
 
-        /// Clear cache entries that have not been referenced for longer than expiryDelay.
+        /// Clear cache entries that have not been referenced for longer than expiryDelay, then clear least recently
+        /// used entries without references while the cache uses more memory than allowed.
         virtual void updateCache(double referenceTime)
         {
             mCache->updateTimeStampOfObjectsInCacheWithExternalReferences(referenceTime);
             mCache->removeExpiredObjectsInCache(referenceTime - mExpiryDelay);
+            mCache->removeLeastRecentlyUsedObjectsInCache();
         }
 
         /// Clear all cache entries.
@@ -60,6 +66,10 @@ namespace Resource
         /// How long to keep objects in cache after no longer being referenced.
         void setExpiryDelay (double expiryDelay) { mExpiryDelay = expiryDelay; }
 
+        /// Share the memory limit of the cache with other managers using the same budget. Only objects added with a
+        /// cost count towards the limit.
+        void setCacheBudget(CacheBudget* budget) { mCache->setBudget(budget); }
+
         const VFS::Manager* getVFS() const { return mVFS; }
 
         virtual void reportStats(unsigned int frameNumber, osg::Stats* stats) const {}
@@ -67,6 +77,15 @@ namespace Resource
         virtual void releaseGLObjects(osg::State* state) { mCache->releaseGLObjects(state); }
 
     protected:
+        void reportCacheStats(unsigned int frameNumber, osg::Stats* stats, const std::string& name) const
+        {
+            stats->setAttribute(frameNumber, name, mCache->getCacheSize());
+            stats->setAttribute(frameNumber, name + " Memory", mCache->getTotalCost());
+            stats->setAttribute(frameNumber, name + " Hit", mCache->getHits());
+            stats->setAttribute(frameNumber, name + " Miss", mCache->getMisses());
+            stats->setAttribute(frameNumber, name + " Evicted", mCache->getEvictions());
+        }
+
         const VFS::Manager* mVFS;
         osg::ref_ptr<CacheType> mCache;
         double mExpiryDelay;
@@ -6,12 +6,14 @@
 #include "imagemanager.hpp"
 #include "niffilemanager.hpp"
 #include "keyframemanager.hpp"
+#include "objectcache.hpp"
 
 namespace Resource
 {
 
     ResourceSystem::ResourceSystem(const VFS::Manager *vfs)
         : mVFS(vfs)
+        , mCacheBudget(new CacheBudget)
     {
         mNifFileManager.reset(new NifFileManager(vfs));
         mKeyframeManager.reset(new KeyframeManager(vfs));
@@ -62,6 +64,11 @@ namespace Resource
         mNifFileManager->setExpiryDelay(0.0);
     }
 
+    void ResourceSystem::setMaxCacheMemory(std::size_t maxMemory)
+    {
+        mCacheBudget->setMaxCost(maxMemory);
+    }
+
     void ResourceSystem::updateCache(double referenceTime)
     {
         for (std::vector<BaseResourceManager*>::iterator it = mResourceManagers.begin(); it != mResourceManagers.end(); ++it)
@@ -77,13 +84,17 @@ namespace Resource
     void ResourceSystem::addResourceManager(BaseResourceManager *resourceMgr)
     {
         mResourceManagers.push_back(resourceMgr);
+        resourceMgr->setCacheBudget(mCacheBudget.get());
     }
 
     void ResourceSystem::removeResourceManager(BaseResourceManager *resourceMgr)
     {
         std::vector<BaseResourceManager*>::iterator found = std::find(mResourceManagers.begin(), mResourceManagers.end(), resourceMgr);
         if (found != mResourceManagers.end())
+        {
+            resourceMgr->setCacheBudget(nullptr);
             mResourceManagers.erase(found);
+        }
     }
 
     const VFS::Manager* ResourceSystem::getVFS() const
@@ -1,9 +1,12 @@
 #ifndef OPENMW_COMPONENTS_RESOURCE_RESOURCESYSTEM_H
 #define OPENMW_COMPONENTS_RESOURCE_RESOURCESYSTEM_H
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
+#include <osg/ref_ptr>
+
 namespace VFS
 {
     class Manager;
@@ -23,6 +26,7 @@ namespace Resource
     class NifFileManager;
     class KeyframeManager;
     class BaseResourceManager;
+    class CacheBudget;
 
     /// @brief Wrapper class that constructs and provides access to the most commonly used resource subsystems.
     /// @par Resource subsystems can be used with multiple OpenGL contexts, just like the OSG equivalents, but
@@ -46,7 +50,7 @@ namespace Resource
         /// @note May be called from any thread if you do not add or remove resource managers at that point.
         void clearCache();
 
-        /// Add this ResourceManager to be handled by the ResourceSystem.
+        /// Add this ResourceManager to be handled by the ResourceSystem, its cache shares the memory budget with the others.
         /// @note Does not transfer ownership.
         void addResourceManager(BaseResourceManager* resourceMgr);
         /// @note Do nothing if resourceMgr does not exist.
@@ -56,6 +60,10 @@ namespace Resource
         /// How long to keep objects in cache after no longer being referenced.
         void setExpiryDelay(double expiryDelay);
 
+        /// How much memory in bytes all resource caches together may use before objects no longer referenced are
+        /// removed in least recently used order across the caches, regardless of the expiry delay. 0 means no limit.
+        void setMaxCacheMemory(std::size_t maxMemory);
+
         /// @note May be called from any thread.
         const VFS::Manager* getVFS() const;
 
@@ -74,6 +82,8 @@ namespace Resource
         // Here users can register their own resourcemanager as well
         std::vector<BaseResourceManager*> mResourceManagers;
 
+        osg::ref_ptr<CacheBudget> mCacheBudget;
+
         const VFS::Manager* mVFS;
 
         ResourceSystem(const ResourceSystem&);
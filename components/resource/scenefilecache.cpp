@@ -0,0 +1,298 @@
+#include "scenefilecache.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include <osg/Drawable>
+#include <osg/Image>
+#include <osg/Node>
+#include <osg/NodeVisitor>
+#include <osg/StateSet>
+#include <osg/Texture>
+#include <osg/UserDataContainer>
+
+#include <osgDB/Registry>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <components/debug/debuglog.hpp>
+#include <components/misc/hash.hpp>
+#include <components/sceneutil/serialize.hpp>
+#include <components/vfs/manager.hpp>
+
+namespace
+{
+
+    constexpr std::array<char, 8> sceneFileMagic {{'O', 'M', 'W', 'S', 'C', 'E', 'N', '\0'}};
+    constexpr std::uint32_t sceneFileVersion = 2;
+    constexpr std::uint64_t maxAbsentFileNameSize = 4096;
+
+    bool isLibrary(const osg::Object& object, const char* libraryName)
+    {
+        return std::strcmp(object.libraryName(), libraryName) == 0;
+    }
+
+    bool isClass(const osg::Object& object, const char* libraryName, const char* className)
+    {
+        return isLibrary(object, libraryName) && std::strcmp(object.className(), className) == 0;
+    }
+
+    /// Checks whether the scene consists only of objects that are restored completely from OSG binary format.
+    class CanStoreVisitor : public osg::NodeVisitor
+    {
+    public:
+        CanStoreVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mResult(true)
+        {
+        }
+
+        virtual void apply(osg::Node& node)
+        {
+            if (!mResult)
+                return;
+
+            if (!(isLibrary(node, "osg") || isClass(node, "NifOsg", "MatrixTransform"))
+                    || node.getUpdateCallback() || node.getEventCallback() || node.getCullCallback()
+                    || node.getComputeBoundingSphereCallback()
+                    || !canStore(node.getUserDataContainer())
+                    || !canStore(node.getStateSet()))
+            {
+                mResult = false;
+                return;
+            }
+
+            traverse(node);
+        }
+
+        virtual void apply(osg::Drawable& drawable)
+        {
+            if (!isClass(drawable, "osg", "Geometry") || drawable.getDrawCallback()
+                    || drawable.getComputeBoundingBoxCallback())
+            {
+                mResult = false;
+                return;
+            }
+
+            apply(static_cast<osg::Node&>(drawable));
+        }
+
+        bool getResult() const
+        {
+            return mResult;
+        }
+
+    private:
+        bool mResult;
+
+        static bool canStore(const osg::UserDataContainer* container)
+        {
+            if (!container)
+                return true;
+
+            if (!isLibrary(*container, "osg") || container->getUserData())
+                return false;
+
+            for (unsigned int i = 0; i < container->getNumUserObjects(); ++i)
+            {
+                const osg::Object* object = container->getUserObject(i);
+                if (!isLibrary(*object, "osg") && !isClass(*object, "NifOsg", "NodeIndexHolder"))
+                    return false;
+            }
+
+            return true;
+        }
+
+        static bool canStore(const osg::StateAttribute* attribute)
+        {
+            if (!isLibrary(*attribute, "osg") || isClass(*attribute, "osg", "Program")
+                    || attribute->getUpdateCallback() || attribute->getEventCallback())
+                return false;
+
+            // images are stored as file names and read back through the image manager
+            if (const osg::Texture* texture = attribute->asTexture())
+                for (unsigned int i = 0; i < texture->getNumImages(); ++i)
+                    if (!texture->getImage(i) || texture->getImage(i)->getFileName().empty())
+                        return false;
+
+            return true;
+        }
+
+        static bool canStore(const osg::StateSet* stateset)
+        {
+            if (!stateset)
+                return true;
+
+            if (stateset->getUpdateCallback() || stateset->getEventCallback())
+                return false;
+
+            for (const auto& attribute : stateset->getAttributeList())
+                if (!canStore(attribute.second.first.get()))
+                    return false;
+
+            for (const auto& unitAttributes : stateset->getTextureAttributeList())
+                for (const auto& attribute : unitAttributes)
+                    if (!canStore(attribute.second.first.get()))
+                        return false;
+
+            for (const auto& uniform : stateset->getUniformList())
+                if (uniform.second.first->getUpdateCallback() || uniform.second.first->getEventCallback())
+                    return false;
+
+            return true;
+        }
+    };
+
+    void writeString(std::string& buffer, const std::string& value)
+    {
+        const auto size = static_cast<std::uint64_t>(value.size());
+        buffer.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        buffer.append(value);
+    }
+
+    bool readString(std::istream& stream, std::string& value)
+    {
+        std::uint64_t size = 0;
+        if (!stream.read(reinterpret_cast<char*>(&size), sizeof(size)) || size > maxAbsentFileNameSize)
+            return false;
+        value.resize(static_cast<std::size_t>(size));
+        return size == 0 || stream.read(&value[0], static_cast<std::streamsize>(size));
+    }
+
+    std::string makeHeader(const std::string& normalizedFilename, const std::string& sourceStamp, const std::string& settings)
+    {
+        std::string result(sceneFileMagic.data(), sceneFileMagic.size());
+        result.append(reinterpret_cast<const char*>(&sceneFileVersion), sizeof(sceneFileVersion));
+        writeString(result, normalizedFilename);
+        writeString(result, settings);
+        writeString(result, sourceStamp);
+        return result;
+    }
+
+}
+
+namespace Resource
+{
+
+    SceneFileCache::SceneFileCache(const std::string& path, const VFS::Manager* vfs)
+        : mPath(path)
+        , mVFS(vfs)
+        , mReaderWriter(osgDB::Registry::instance()->getReaderWriterForExtension("osgb"))
+    {
+        if (!mReaderWriter)
+            Log(Debug::Warning) << "No readerwriter for 'osgb' found, mesh cache is disabled";
+
+        SceneUtil::registerSceneSerializers();
+    }
+
+    osg::ref_ptr<osg::Node> SceneFileCache::get(const std::string& normalizedFilename, const std::string& sourceStamp,
+                                                const std::string& settings, const osgDB::Options* options) const
+    {
+        if (!isAvailable())
+            return nullptr;
+
+        const auto filePath = getFilePath(normalizedFilename, settings);
+
+        boost::filesystem::ifstream file(filePath, std::ios::binary);
+        if (!file.is_open())
+            return nullptr;
+
+        const auto expectedHeader = makeHeader(normalizedFilename, sourceStamp, settings);
+        std::string header(expectedHeader.size(), '\0');
+        if (!file.read(&header[0], static_cast<std::streamsize>(header.size())) || header != expectedHeader)
+            return nullptr;
+
+        std::uint64_t absentFilesCount = 0;
+        if (!file.read(reinterpret_cast<char*>(&absentFilesCount), sizeof(absentFilesCount)))
+            return nullptr;
+
+        std::string absentFile;
+        for (std::uint64_t i = 0; i < absentFilesCount; ++i)
+            if (!readString(file, absentFile) || mVFS->exists(absentFile))
+                return nullptr;
+
+        osgDB::ReaderWriter::ReadResult result = mReaderWriter->readNode(file, options);
+        if (!result.success())
+        {
+            Log(Debug::Warning) << "Failed to read cached mesh " << filePath.string() << ": " << result.message();
+            return nullptr;
+        }
+
+        return result.getNode();
+    }
+
+    void SceneFileCache::set(const std::string& normalizedFilename, const std::string& sourceStamp,
+                             const std::string& settings, const std::vector<std::string>& absentFiles, osg::Node& node) const
+    {
+        if (!isAvailable())
+            return;
+
+        CanStoreVisitor visitor;
+        node.accept(visitor);
+        if (!visitor.getResult())
+            return;
+
+        const auto filePath = getFilePath(normalizedFilename, settings);
+        auto tmpPath = filePath;
+        tmpPath += ".tmp";
+
+        try
+        {
+            boost::filesystem::create_directories(filePath.parent_path());
+
+            {
+                boost::filesystem::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+                if (!file.is_open())
+                    throw std::runtime_error("Open file failed: " + tmpPath.string());
+                file.exceptions(std::ios::failbit | std::ios::badbit);
+
+                auto header = makeHeader(normalizedFilename, sourceStamp, settings);
+                const auto absentFilesCount = static_cast<std::uint64_t>(absentFiles.size());
+                header.append(reinterpret_cast<const char*>(&absentFilesCount), sizeof(absentFilesCount));
+                for (const auto& absentFile : absentFiles)
+                    writeString(header, absentFile);
+                file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+                osg::ref_ptr<osgDB::Options> options (new osgDB::Options);
+                options->setPluginStringData("fileType", "Binary");
+                options->setPluginStringData("WriteImageHint", "UseExternal");
+
+                osgDB::ReaderWriter::WriteResult result = mReaderWriter->writeNode(node, file, options);
+                if (!result.success())
+                    throw std::runtime_error(result.message());
+            }
+
+            boost::filesystem::rename(tmpPath, filePath);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to write cached mesh " << filePath.string() << ": " << e.what();
+            boost::system::error_code ec;
+            boost::filesystem::remove(tmpPath, ec);
+        }
+    }
+
+    bool SceneFileCache::isAvailable() const
+    {
+        // scenes are incomplete after the debug serializers are registered to export the scene graph
+        return mReaderWriter != nullptr && !SceneUtil::areSerializersRegistered();
+    }
+
+    boost::filesystem::path SceneFileCache::getFilePath(const std::string& normalizedFilename, const std::string& settings) const
+    {
+        const std::string key = normalizedFilename + '\0' + settings;
+        const auto hash = Misc::getFnv1aHash(key.data(), key.size());
+
+        std::ostringstream name;
+        name << std::hex << std::setfill('0') << std::setw(16) << hash;
+        const auto fileName = name.str();
+
+        return mPath / fileName.substr(0, 2) / (fileName + ".osgbcache");
+    }
+
+}
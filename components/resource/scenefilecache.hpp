@@ -0,0 +1,64 @@
+#ifndef OPENMW_COMPONENTS_RESOURCE_SCENEFILECACHE_H
+#define OPENMW_COMPONENTS_RESOURCE_SCENEFILECACHE_H
+
+#include <string>
+#include <vector>
+
+#include <osg/ref_ptr>
+
+#include <boost/filesystem/path.hpp>
+
+namespace osg
+{
+    class Node;
+}
+
+namespace osgDB
+{
+    class Options;
+    class ReaderWriter;
+}
+
+namespace VFS
+{
+    class Manager;
+}
+
+namespace Resource
+{
+
+    /// @brief Persistent storage for converted and optimized scene templates in OSG binary format.
+    /// @par A cached scene is identified by the source file name, its VFS stamp (size and modification time) and the
+    /// settings affecting conversion. Any mismatch is a miss, as is the appearance of a file that was looked up and not
+    /// found during conversion (e.g. an auto-used normal map). Only scenes made of types that can be restored completely are stored,
+    /// i.e. static scenes without controllers, particles, skinning or shaders.
+    /// @note Thread safe.
+    class SceneFileCache
+    {
+    public:
+        SceneFileCache(const std::string& path, const VFS::Manager* vfs);
+
+        /// @param sourceStamp See VFS::Manager::getStamp.
+        /// @param options Used to read images referenced by the scene.
+        /// @return nullptr if there is no valid cached scene for the given source.
+        osg::ref_ptr<osg::Node> get(const std::string& normalizedFilename, const std::string& sourceStamp,
+                                    const std::string& settings, const osgDB::Options* options) const;
+
+        /// Store the scene unless it contains objects that can't be restored from the file.
+        /// @param absentFiles Files that the conversion looked up and didn't find.
+        void set(const std::string& normalizedFilename, const std::string& sourceStamp, const std::string& settings,
+                 const std::vector<std::string>& absentFiles, osg::Node& node) const;
+
+    private:
+        boost::filesystem::path mPath;
+        const VFS::Manager* mVFS;
+        osgDB::ReaderWriter* mReaderWriter;
+
+        bool isAvailable() const;
+
+        boost::filesystem::path getFilePath(const std::string& normalizedFilename, const std::string& settings) const;
+    };
+
+}
+
+#endif
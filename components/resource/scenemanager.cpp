@@ -1,9 +1,14 @@
 #include "scenemanager.hpp"
 
 #include <cstdlib>
+#include <exception>
+#include <set>
+#include <sstream>
 
+#include <osg/Geometry>
 #include <osg/Node>
 #include <osg/UserDataContainer>
+#include <osg/Version>
 
 #include <osgParticle/ParticleSystem>
 
@@ -25,6 +30,7 @@
 #include <components/sceneutil/util.hpp>
 #include <components/sceneutil/controller.hpp>
 #include <components/sceneutil/optimizer.hpp>
+#include <components/sceneutil/workqueue.hpp>
 
 #include <components/shader/shadervisitor.hpp>
 #include <components/shader/shadermanager.hpp>
@@ -33,6 +39,7 @@
 #include "niffilemanager.hpp"
 #include "objectcache.hpp"
 #include "multiobjectcache.hpp"
+#include "scenefilecache.hpp"
 
 namespace
 {
@@ -106,6 +113,48 @@ namespace
     private:
         unsigned int mMask;
     };
+
+    /// Sums up the size of vertex data and indices, the main part of a template's own memory.
+    class GeometryMemoryVisitor : public osg::NodeVisitor
+    {
+    public:
+        GeometryMemoryVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mMemoryUsage(0)
+        {
+        }
+
+        void apply(osg::Drawable& drw)
+        {
+            osg::Geometry* geometry = drw.asGeometry();
+            if (!geometry)
+                return;
+
+            add(geometry->getVertexArray());
+            add(geometry->getNormalArray());
+            add(geometry->getColorArray());
+            for (const auto& array : geometry->getTexCoordArrayList())
+                add(array.get());
+            for (const auto& array : geometry->getVertexAttribArrayList())
+                add(array.get());
+            for (const auto& primitiveSet : geometry->getPrimitiveSetList())
+                add(primitiveSet.get());
+        }
+
+        std::size_t getMemoryUsage() const
+        {
+            return mMemoryUsage;
+        }
+
+    private:
+        std::size_t mMemoryUsage;
+
+        void add(const osg::BufferData* data)
+        {
+            if (data)
+                mMemoryUsage += data->getTotalDataSize();
+        }
+    };
 }
 
 namespace Resource
@@ -211,6 +260,38 @@ namespace Resource
         int mMaxAnisotropy;
     };
 
+    /// Collect file names of the images that the ShaderVisitor treats as diffuse maps.
+    class CollectDiffuseMapsVisitor : public osg::NodeVisitor
+    {
+    public:
+        CollectDiffuseMapsVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+        {
+        }
+
+        virtual void apply(osg::Node& node)
+        {
+            if (const osg::StateSet* stateset = node.getStateSet())
+                applyStateSet(*stateset);
+
+            traverse(node);
+        }
+
+        void applyStateSet(const osg::StateSet& stateset)
+        {
+            const osg::StateSet::TextureAttributeList& texAttributes = stateset.getTextureAttributeList();
+            for (unsigned int unit = 0; unit < texAttributes.size(); ++unit)
+            {
+                const osg::StateAttribute* attr = stateset.getTextureAttribute(unit, osg::StateAttribute::TEXTURE);
+                const osg::Texture* texture = attr ? attr->asTexture() : nullptr;
+                if (texture && texture->getImage(0) && (texture->getName() == "diffuseMap" || unit == 0))
+                    mFileNames.insert(texture->getImage(0)->getFileName());
+            }
+        }
+
+        std::set<std::string> mFileNames;
+    };
+
 
 
     SceneManager::SceneManager(const VFS::Manager *vfs, Resource::ImageManager* imageManager, Resource::NifFileManager* nifFileManager)
@@ -467,6 +548,87 @@ namespace Resource
         return options;
     }
 
+    /// Loads a scene template exactly once for all threads requesting it, either in a worker thread or in the first
+    /// thread waiting for it.
+    class SceneManager::PendingTemplate : public SceneUtil::WorkItem
+    {
+    public:
+        PendingTemplate(SceneManager& sceneManager, const std::string& normalized, bool compile)
+            : mSceneManager(sceneManager)
+            , mNormalized(normalized)
+            , mCompile(compile)
+            , mStarted(false)
+            , mFuture(mPromise.get_future())
+        {
+        }
+
+        /// Set the result for a template that is already in cache.
+        void setLoaded(osg::ref_ptr<const osg::Node> loaded)
+        {
+            mStarted = true;
+            mPromise.set_value(std::move(loaded));
+        }
+
+        const std::shared_future<osg::ref_ptr<const osg::Node>>& getFuture() const
+        {
+            return mFuture;
+        }
+
+        /// Compile the template for a request asking for it after the load was started without.
+        void requestCompile()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mCompile)
+                return;
+            mCompile = true;
+            // otherwise run compiles it once loaded
+            if (mLoaded)
+                mSceneManager.compileTemplate(*mLoaded);
+        }
+
+        virtual void doWork()
+        {
+            run();
+        }
+
+        /// Load the template unless another thread has already started it.
+        void run()
+        {
+            if (mStarted.exchange(true))
+                return;
+
+            try
+            {
+                osg::ref_ptr<osg::Node> loaded = mSceneManager.loadTemplate(mNormalized);
+                bool compile = false;
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mLoaded = loaded;
+                    compile = mCompile;
+                }
+                if (compile)
+                    mSceneManager.compileTemplate(*loaded);
+                mPromise.set_value(std::move(loaded));
+            }
+            catch (...)
+            {
+                mPromise.set_exception(std::current_exception());
+            }
+
+            mSceneManager.removePendingTemplate(mNormalized);
+        }
+
+    private:
+        SceneManager& mSceneManager;
+        const std::string mNormalized;
+        std::mutex mMutex;
+        bool mCompile;
+        osg::ref_ptr<osg::Node> mLoaded;
+        std::atomic<bool> mStarted;
+        std::promise<osg::ref_ptr<const osg::Node>> mPromise;
+        std::shared_future<osg::ref_ptr<const osg::Node>> mFuture;
+    };
+
     osg::ref_ptr<const osg::Node> SceneManager::getTemplate(const std::string &name, bool compile)
     {
         std::string normalized = name;
@@ -475,35 +637,193 @@ namespace Resource
         osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
         if (obj)
             return osg::ref_ptr<const osg::Node>(static_cast<osg::Node*>(obj.get()));
-        else
+
+        bool added = false;
+        osg::ref_ptr<PendingTemplate> pending = getPendingTemplate(normalized, compile, added);
+        // does nothing if the template is already being loaded by a worker thread, then just wait for it
+        pending->run();
+        return pending->getFuture().get();
+    }
+
+    std::shared_future<osg::ref_ptr<const osg::Node>> SceneManager::getTemplateAsync(const std::string &name, bool compile)
+    {
+        std::string normalized = name;
+        mVFS->normalizeFilename(normalized);
+
+        osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
+        if (obj)
         {
-            osg::ref_ptr<osg::Node> loaded;
-            try
+            std::promise<osg::ref_ptr<const osg::Node>> promise;
+            promise.set_value(osg::ref_ptr<const osg::Node>(static_cast<osg::Node*>(obj.get())));
+            return promise.get_future().share();
+        }
+
+        bool added = false;
+        osg::ref_ptr<PendingTemplate> pending = getPendingTemplate(normalized, compile, added);
+        if (added)
+        {
+            if (mWorkQueue)
+                mWorkQueue->addWorkItem(pending, true);
+            else
+                pending->run();
+        }
+        return pending->getFuture();
+    }
+
+    void SceneManager::setWorkQueue(SceneUtil::WorkQueue* workQueue)
+    {
+        mWorkQueue = workQueue;
+    }
+
+    void SceneManager::setSceneFileCachePath(const std::string& path)
+    {
+        if (path.empty())
+        {
+            mSceneFileCache.reset();
+            mSceneFileCacheOptions = nullptr;
+            return;
+        }
+
+        mSceneFileCache.reset(new SceneFileCache(path, mVFS));
+        mSceneFileCacheOptions = new osgDB::Options;
+        mSceneFileCacheOptions->setReadFileCallback(new ImageReadCallback(mImageManager));
+    }
+
+    std::string SceneManager::getSceneFileCacheSettings() const
+    {
+        std::ostringstream stream;
+        stream << osgGetVersion()
+               << ' ' << getOptimizationOptions()
+               << ' ' << mForceShaders
+               << ' ' << mClampLighting
+               << ' ' << mAutoUseNormalMaps << ' ' << mNormalMapPattern << ' ' << mNormalHeightMapPattern
+               << ' ' << mAutoUseSpecularMaps << ' ' << mSpecularMapPattern
+               << ' ' << mMinFilter << ' ' << mMagFilter << ' ' << mMaxAnisotropy
+               << ' ' << mUnRefImageDataAfterApply
+               << ' ' << NifOsg::Loader::getShowMarkers()
+               << ' ' << NifOsg::Loader::getHiddenNodeMask()
+               << ' ' << NifOsg::Loader::getIntersectionDisabledNodeMask();
+        return stream.str();
+    }
+
+    std::vector<std::string> SceneManager::getAbsentAutoUseMaps(osg::Node& node) const
+    {
+        std::vector<std::string> result;
+        if (!mAutoUseNormalMaps && !mAutoUseSpecularMaps)
+            return result;
+
+        CollectDiffuseMapsVisitor visitor;
+        node.accept(visitor);
+
+        const auto addIfAbsent = [&] (const std::string& diffuseMap, const std::string& pattern)
+        {
+            std::string fileName = diffuseMap;
+            Misc::StringUtils::replaceLast(fileName, ".", pattern + ".");
+            if (!mVFS->exists(fileName))
+                result.push_back(fileName);
+        };
+
+        for (const std::string& diffuseMap : visitor.mFileNames)
+        {
+            if (mAutoUseNormalMaps)
             {
-                Files::IStreamPtr file = mVFS->get(normalized);
+                addIfAbsent(diffuseMap, mNormalHeightMapPattern);
+                addIfAbsent(diffuseMap, mNormalMapPattern);
+            }
+            if (mAutoUseSpecularMaps)
+                addIfAbsent(diffuseMap, mSpecularMapPattern);
+        }
 
-                loaded = load(file, normalized, mImageManager, mNifFileManager);
+        return result;
+    }
+
+    osg::ref_ptr<SceneManager::PendingTemplate> SceneManager::getPendingTemplate(const std::string& normalized, bool compile, bool& added)
+    {
+        std::lock_guard<std::mutex> lock(mPendingTemplatesMutex);
+
+        const auto it = mPendingTemplates.find(normalized);
+        if (it != mPendingTemplates.end())
+        {
+            if (compile)
+                it->second->requestCompile();
+            return it->second;
+        }
+
+        osg::ref_ptr<PendingTemplate> pending (new PendingTemplate(*this, normalized, compile));
+
+        // the template may have been loaded and removed from pending ones after the caller has checked the cache
+        osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
+        if (obj)
+        {
+            pending->setLoaded(osg::ref_ptr<const osg::Node>(static_cast<osg::Node*>(obj.get())));
+            return pending;
+        }
+
+        mPendingTemplates.emplace(normalized, pending);
+        added = true;
+        return pending;
+    }
+
+    void SceneManager::removePendingTemplate(const std::string& normalized)
+    {
+        std::lock_guard<std::mutex> lock(mPendingTemplatesMutex);
+        mPendingTemplates.erase(normalized);
+    }
+
+    osg::ref_ptr<osg::Node> SceneManager::loadTemplate(const std::string& name)
+    {
+        std::string normalized = name;
+        osg::ref_ptr<osg::Node> loaded;
+        bool fromFileCache = false;
+        std::string sourceStamp;
+        std::string fileCacheSettings;
+        try
+        {
+            if (mSceneFileCache && getFileExtension(normalized) == "nif")
+            {
+                sourceStamp = mVFS->getStamp(normalized);
+                fileCacheSettings = getSceneFileCacheSettings();
+                loaded = mSceneFileCache->get(normalized, sourceStamp, fileCacheSettings, mSceneFileCacheOptions);
+                fromFileCache = loaded != nullptr;
             }
-            catch (std::exception& e)
+
+            // the source file is only read when the scene file cache misses
+            if (!loaded)
             {
-                static const char * const sMeshTypes[] = { "nif", "osg", "osgt", "osgb", "osgx", "osg2" };
+                Files::IStreamPtr file = mVFS->get(normalized);
+                loaded = load(file, normalized, mImageManager, mNifFileManager);
+            }
+        }
+        catch (std::exception& e)
+        {
+            fileCacheSettings.clear();
 
-                for (unsigned int i=0; i<sizeof(sMeshTypes)/sizeof(sMeshTypes[0]); ++i)
+            static const char * const sMeshTypes[] = { "nif", "osg", "osgt", "osgb", "osgx", "osg2" };
+
+            for (unsigned int i=0; i<sizeof(sMeshTypes)/sizeof(sMeshTypes[0]); ++i)
+            {
+                normalized = "meshes/marker_error." + std::string(sMeshTypes[i]);
+                if (mVFS->exists(normalized))
                 {
-                    normalized = "meshes/marker_error." + std::string(sMeshTypes[i]);
-                    if (mVFS->exists(normalized))
-                    {
-                        Log(Debug::Error) << "Failed to load '" << name << "': " << e.what() << ", using marker_error." << sMeshTypes[i] << " instead";
-                        Files::IStreamPtr file = mVFS->get(normalized);
-                        loaded = load(file, normalized, mImageManager, mNifFileManager);
-                        break;
-                    }
+                    Log(Debug::Error) << "Failed to load '" << name << "': " << e.what() << ", using marker_error." << sMeshTypes[i] << " instead";
+                    Files::IStreamPtr file = mVFS->get(normalized);
+                    loaded = load(file, normalized, mImageManager, mNifFileManager);
+                    break;
                 }
-
-                if (!loaded)
-                    throw;
             }
 
+            if (!loaded)
+                throw;
+        }
+
+        if (fromFileCache)
+        {
+            // cached scenes are stored after optimization, only their state has to be shared with other scenes
+            std::lock_guard<std::mutex> lock(mSharedStateMutex);
+            mSharedStateManager->share(loaded.get());
+        }
+        else
+        {
             // set filtering settings
             SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
             loaded->accept(setFilterSettingsVisitor);
@@ -530,14 +850,23 @@ namespace Resource
                 optimizer.optimize(loaded, options);
             }
 
-            if (compile && mIncrementalCompileOperation)
-                mIncrementalCompileOperation->add(loaded);
-            else
-                loaded->getBound();
-
-            mCache->addEntryToObjectCache(normalized, loaded);
-            return loaded;
+            if (!fileCacheSettings.empty())
+                mSceneFileCache->set(normalized, sourceStamp, fileCacheSettings, getAbsentAutoUseMaps(*loaded), *loaded);
         }
+
+        loaded->getBound();
+
+        GeometryMemoryVisitor memoryVisitor;
+        loaded->accept(memoryVisitor);
+
+        mCache->addEntryToObjectCache(normalized, loaded, 0.0, memoryVisitor.getMemoryUsage());
+        return loaded;
+    }
+
+    void SceneManager::compileTemplate(osg::Node& node)
+    {
+        if (mIncrementalCompileOperation)
+            mIncrementalCompileOperation->add(&node);
     }
 
     osg::ref_ptr<osg::Node> SceneManager::cacheInstance(const std::string &name)
@@ -757,7 +1086,7 @@ namespace Resource
             stats->setAttribute(frameNumber, "StateSet", mSharedStateManager->getNumSharedStateSets());
         }
 
-        stats->setAttribute(frameNumber, "Node", mCache->getCacheSize());
+        reportCacheStats(frameNumber, stats, "Node");
         stats->setAttribute(frameNumber, "Node Instance", mInstanceCache->getCacheSize());
     }
 
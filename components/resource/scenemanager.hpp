@@ -5,6 +5,8 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <future>
+#include <vector>
 
 #include <osg/ref_ptr>
 #include <osg/Node>
@@ -26,9 +28,15 @@ namespace osgUtil
 
 namespace osgDB
 {
+    class Options;
     class SharedStateManager;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace Shader
 {
     class ShaderManager;
@@ -39,6 +47,7 @@ namespace Resource
 {
 
     class MultiObjectCache;
+    class SceneFileCache;
 
     /// @brief Handles loading and caching of scenes, e.g. .nif files or .osg files
     /// @note Some methods of the scene manager can be used from any thread, see the methods documentation for more details.
@@ -82,8 +91,26 @@ namespace Resource
         /// @note If the given filename does not exist or fails to load, an error marker mesh will be used instead.
         ///  If even the error marker mesh can not be found, an exception is thrown.
         /// @note Thread safe.
+        /// @note Waits for the template if it is already being loaded by another thread.
         osg::ref_ptr<const osg::Node> getTemplate(const std::string& name, bool compile=true);
 
+        /// Start loading the given scene template in a worker thread of the work queue and return its future result.
+        /// Concurrent requests for the same template, including from getTemplate, share a single load. The template is
+        /// compiled if any of them asks for it.
+        /// @note Loads the template in the calling thread when no work queue is set.
+        /// @note Thread safe.
+        std::shared_future<osg::ref_ptr<const osg::Node>> getTemplateAsync(const std::string& name, bool compile=true);
+
+        /// Set the work queue used by getTemplateAsync. The scene manager holds a reference to it, so the queue is
+        /// only destroyed once it's reset here as well. Templates loaded by the queue refer to the scene manager, reset it
+        /// and destroy the queue before the scene manager.
+        void setWorkQueue(SceneUtil::WorkQueue* workQueue);
+
+        /// Store converted NIF scenes in the given directory and load them from there on later runs instead of
+        /// converting again. An empty path disables the cache.
+        /// @note Not thread safe, has to be called before loading any scenes.
+        void setSceneFileCachePath(const std::string& path);
+
         /// Create an instance of the given scene template and cache it for later use, so that future calls to getInstance() can simply
         /// return this cached object instead of creating a new one.
         /// @note The returned ref_ptr may be kept around by the caller to ensure that the object stays in cache for as long as needed.
@@ -146,8 +173,24 @@ namespace Resource
 
     private:
 
+        class PendingTemplate;
+
         Shader::ShaderVisitor* createShaderVisitor();
 
+        osg::ref_ptr<PendingTemplate> getPendingTemplate(const std::string& normalized, bool compile, bool& added);
+
+        void removePendingTemplate(const std::string& normalized);
+
+        osg::ref_ptr<osg::Node> loadTemplate(const std::string& name);
+
+        void compileTemplate(osg::Node& node);
+
+        /// Settings affecting converted scenes, a cached scene is used only if they are the same.
+        std::string getSceneFileCacheSettings() const;
+
+        /// Files the shader visitor looked up for the scene and didn't find, a cached scene is invalid if any appears.
+        std::vector<std::string> getAbsentAutoUseMaps(osg::Node& node) const;
+
         std::unique_ptr<Shader::ShaderManager> mShaderManager;
         bool mForceShaders;
         bool mClampLighting;
@@ -172,6 +215,12 @@ namespace Resource
 
         osg::ref_ptr<osgUtil::IncrementalCompileOperation> mIncrementalCompileOperation;
 
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+        std::unique_ptr<SceneFileCache> mSceneFileCache;
+        osg::ref_ptr<osgDB::Options> mSceneFileCacheOptions;
+        std::map<std::string, osg::ref_ptr<PendingTemplate>> mPendingTemplates;
+        std::mutex mPendingTemplatesMutex;
+
         unsigned int mParticleSystemMask;
 
         SceneManager(const SceneManager&);
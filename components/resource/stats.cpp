@@ -281,6 +281,8 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
             "FrameNumber",
             "",
             "Compiling",
+            "Upload Budget",
+            "Upload Time",
             "WorkQueue",
             "WorkThread",
             "",
@@ -288,9 +290,17 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
             "StateSet",
             "Node",
             "Node Instance",
+            "Node Memory",
+            "Node Hit",
+            "Node Miss",
+            "Node Evicted",
             "Shape",
             "Shape Instance",
             "Image",
+            "Image Memory",
+            "Image Hit",
+            "Image Miss",
+            "Image Evicted",
             "Nif",
             "Keyframe",
             "",
@@ -302,17 +312,31 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
             "",
             "UnrefQueue",
             "",
+            "Occlusion Tested",
+            "Occlusion Culled",
+            "Occluder Triangles",
+            "Occluder Culled",
+            "Occluder Time",
+            "",
             "NavMesh UpdateJobs",
             "NavMesh CacheSize",
             "NavMesh UsedTiles",
             "NavMesh CachedTiles",
+            "NavMesh PathJobs",
+            "NavMesh PathTime",
+            "NavMesh PathTimeMax",
             "",
             "Mechanics Actors",
             "Mechanics Objects",
+            "AI Decisions",
+            "AI Deferred",
+            "AI Crowd Agents",
             "",
             "Physics Actors",
             "Physics Objects",
             "Physics HeightFields",
+            "Physics LOS Rays",
+            "Physics LOS Cached",
         });
 
         static const auto longest = std::max_element(statNames.begin(), statNames.end(),
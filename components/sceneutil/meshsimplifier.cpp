@@ -0,0 +1,538 @@
+#include "meshsimplifier.hpp"
+
+#include <osg/TriangleIndexFunctor>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <utility>
+
+namespace
+{
+
+    /// Sum of squared distances to a set of planes.
+    struct Quadric
+    {
+        std::array<double, 10> mValues {};
+
+        void addPlane(const osg::Vec3d& normal, double distance)
+        {
+            const double a = normal.x();
+            const double b = normal.y();
+            const double c = normal.z();
+            const double d = distance;
+            const std::array<double, 10> values {{a*a, a*b, a*c, a*d, b*b, b*c, b*d, c*c, c*d, d*d}};
+            for (std::size_t i = 0; i < mValues.size(); ++i)
+                mValues[i] += values[i];
+        }
+
+        Quadric& operator+=(const Quadric& other)
+        {
+            for (std::size_t i = 0; i < mValues.size(); ++i)
+                mValues[i] += other.mValues[i];
+            return *this;
+        }
+
+        double getError(const osg::Vec3d& v) const
+        {
+            const double x = v.x();
+            const double y = v.y();
+            const double z = v.z();
+            const auto& q = mValues;
+            const double result = q[0]*x*x + 2*q[1]*x*y + 2*q[2]*x*z + 2*q[3]*x
+                                + q[4]*y*y + 2*q[5]*y*z + 2*q[6]*y
+                                + q[7]*z*z + 2*q[8]*z
+                                + q[9];
+            return std::max(result, 0.0);
+        }
+    };
+
+    struct Collapse
+    {
+        double mCost;
+        unsigned int mFrom;
+        unsigned int mTo;
+        unsigned int mFromVersion;
+        unsigned int mToVersion;
+
+        bool operator>(const Collapse& other) const
+        {
+            return mCost > other.mCost;
+        }
+    };
+
+    class Simplifier
+    {
+    public:
+        Simplifier(const std::vector<osg::Vec3f>& vertices, const std::vector<unsigned int>& indices)
+            : mVertices(vertices)
+            , mQuadrics(vertices.size())
+            , mVertexTriangles(vertices.size())
+            , mVersions(vertices.size(), 0)
+            , mRemoved(vertices.size(), false)
+            , mLocked(vertices.size(), false)
+            , mNumTriangles(0)
+        {
+            for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                const std::array<unsigned int, 3> triangle {{indices[i], indices[i + 1], indices[i + 2]}};
+                if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[2] == triangle[0])
+                    continue;
+                for (unsigned int vertex : triangle)
+                    mVertexTriangles[vertex].push_back(static_cast<unsigned int>(mTriangles.size()));
+                mTriangles.push_back(triangle);
+                mAlive.push_back(true);
+                ++mNumTriangles;
+            }
+
+            lockSeams();
+            initQuadrics();
+        }
+
+        double simplify(std::size_t targetTriangles, double maxError)
+        {
+            for (unsigned int vertex = 0; vertex < mVertices.size(); ++vertex)
+                for (unsigned int neighbour : getNeighbours(vertex))
+                    if (vertex < neighbour)
+                        pushCollapse(vertex, neighbour);
+
+            const double maxCost = maxError * maxError;
+            double result = 0;
+
+            while (mNumTriangles > targetTriangles && !mQueue.empty())
+            {
+                const Collapse collapse = mQueue.top();
+                mQueue.pop();
+
+                if (mRemoved[collapse.mFrom] || mRemoved[collapse.mTo]
+                        || mVersions[collapse.mFrom] != collapse.mFromVersion || mVersions[collapse.mTo] != collapse.mToVersion)
+                    continue;
+
+                if (collapse.mCost > maxCost)
+                    break;
+
+                if (!canCollapse(collapse.mFrom, collapse.mTo))
+                    continue;
+
+                apply(collapse.mFrom, collapse.mTo);
+                result = std::max(result, collapse.mCost);
+
+                for (unsigned int neighbour : getNeighbours(collapse.mTo))
+                    pushCollapse(collapse.mTo, neighbour);
+            }
+
+            return std::sqrt(result);
+        }
+
+        std::vector<unsigned int> getIndices() const
+        {
+            std::vector<unsigned int> result;
+            result.reserve(mNumTriangles * 3);
+            for (std::size_t i = 0; i < mTriangles.size(); ++i)
+                if (mAlive[i])
+                    result.insert(result.end(), mTriangles[i].begin(), mTriangles[i].end());
+            return result;
+        }
+
+    private:
+        const std::vector<osg::Vec3f>& mVertices;
+        std::vector<std::array<unsigned int, 3>> mTriangles;
+        std::vector<bool> mAlive;
+        std::vector<Quadric> mQuadrics;
+        std::vector<std::vector<unsigned int>> mVertexTriangles;
+        std::vector<unsigned int> mVersions;
+        std::vector<bool> mRemoved;
+        std::vector<bool> mLocked;
+        std::size_t mNumTriangles;
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> mQueue;
+
+        void lockSeams()
+        {
+            // vertices are split where texture coordinates or normals are discontinuous, removing one of them opens a crack
+            std::map<osg::Vec3f, unsigned int> positions;
+            for (unsigned int vertex = 0; vertex < mVertices.size(); ++vertex)
+            {
+                if (mVertexTriangles[vertex].empty())
+                    continue;
+                const auto inserted = positions.emplace(mVertices[vertex], vertex);
+                if (!inserted.second)
+                {
+                    mLocked[vertex] = true;
+                    mLocked[inserted.first->second] = true;
+                }
+            }
+        }
+
+        void initQuadrics()
+        {
+            std::map<std::pair<unsigned int, unsigned int>, unsigned int> edges;
+            for (const auto& triangle : mTriangles)
+                for (std::size_t i = 0; i < 3; ++i)
+                    ++edges[std::minmax(triangle[i], triangle[(i + 1) % 3])];
+
+            for (const auto& triangle : mTriangles)
+            {
+                const osg::Vec3d v0 = mVertices[triangle[0]];
+                osg::Vec3d normal = (osg::Vec3d(mVertices[triangle[1]]) - v0) ^ (osg::Vec3d(mVertices[triangle[2]]) - v0);
+                if (normal.normalize() == 0)
+                    continue;
+
+                Quadric quadric;
+                quadric.addPlane(normal, -(normal * v0));
+                for (unsigned int vertex : triangle)
+                    mQuadrics[vertex] += quadric;
+
+                // an open border is kept in place by a plane through the edge perpendicular to the triangle
+                for (std::size_t i = 0; i < 3; ++i)
+                {
+                    const unsigned int from = triangle[i];
+                    const unsigned int to = triangle[(i + 1) % 3];
+                    if (edges[std::minmax(from, to)] != 1)
+                        continue;
+                    osg::Vec3d border = (osg::Vec3d(mVertices[to]) - osg::Vec3d(mVertices[from])) ^ normal;
+                    if (border.normalize() == 0)
+                        continue;
+                    Quadric borderQuadric;
+                    borderQuadric.addPlane(border, -(border * osg::Vec3d(mVertices[from])));
+                    mQuadrics[from] += borderQuadric;
+                    mQuadrics[to] += borderQuadric;
+                }
+            }
+        }
+
+        std::vector<unsigned int> getNeighbours(unsigned int vertex) const
+        {
+            std::vector<unsigned int> result;
+            for (unsigned int triangle : mVertexTriangles[vertex])
+                for (unsigned int other : mTriangles[triangle])
+                    if (other != vertex)
+                        result.push_back(other);
+            std::sort(result.begin(), result.end());
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+            return result;
+        }
+
+        void pushCollapse(unsigned int first, unsigned int second)
+        {
+            Quadric quadric = mQuadrics[first];
+            quadric += mQuadrics[second];
+
+            Collapse collapse {std::numeric_limits<double>::max(), first, second, mVersions[first], mVersions[second]};
+            if (!mLocked[first])
+                collapse.mCost = quadric.getError(mVertices[second]);
+            if (!mLocked[second])
+            {
+                const double cost = quadric.getError(mVertices[first]);
+                if (cost < collapse.mCost)
+                {
+                    collapse.mCost = cost;
+                    std::swap(collapse.mFrom, collapse.mTo);
+                    std::swap(collapse.mFromVersion, collapse.mToVersion);
+                }
+            }
+
+            if (collapse.mCost != std::numeric_limits<double>::max())
+                mQueue.push(collapse);
+        }
+
+        bool canCollapse(unsigned int from, unsigned int to) const
+        {
+            // the vertices may only share the neighbours of the triangles on their edge, otherwise the mesh folds
+            const std::vector<unsigned int> fromNeighbours = getNeighbours(from);
+            const std::vector<unsigned int> toNeighbours = getNeighbours(to);
+            std::vector<unsigned int> shared;
+            std::set_intersection(fromNeighbours.begin(), fromNeighbours.end(), toNeighbours.begin(), toNeighbours.end(),
+                                  std::back_inserter(shared));
+            std::size_t edgeTriangles = 0;
+            for (unsigned int triangle : mVertexTriangles[from])
+                if (std::find(mTriangles[triangle].begin(), mTriangles[triangle].end(), to) != mTriangles[triangle].end())
+                    ++edgeTriangles;
+            if (shared.size() > edgeTriangles)
+                return false;
+
+            // remaining triangles must neither flip nor degenerate
+            for (unsigned int triangle : mVertexTriangles[from])
+            {
+                const auto& vertices = mTriangles[triangle];
+                if (std::find(vertices.begin(), vertices.end(), to) != vertices.end())
+                    continue;
+                std::array<osg::Vec3f, 3> positions;
+                for (std::size_t i = 0; i < 3; ++i)
+                    positions[i] = mVertices[vertices[i]];
+                const osg::Vec3f before = (positions[1] - positions[0]) ^ (positions[2] - positions[0]);
+                for (std::size_t i = 0; i < 3; ++i)
+                    if (vertices[i] == from)
+                        positions[i] = mVertices[to];
+                const osg::Vec3f after = (positions[1] - positions[0]) ^ (positions[2] - positions[0]);
+                if (after.length2() == 0 || before * after <= 0)
+                    return false;
+            }
+
+            return true;
+        }
+
+        void apply(unsigned int from, unsigned int to)
+        {
+            for (unsigned int triangle : mVertexTriangles[from])
+            {
+                auto& vertices = mTriangles[triangle];
+                if (std::find(vertices.begin(), vertices.end(), to) == vertices.end())
+                {
+                    std::replace(vertices.begin(), vertices.end(), from, to);
+                    mVertexTriangles[to].push_back(triangle);
+                    continue;
+                }
+                mAlive[triangle] = false;
+                --mNumTriangles;
+                for (unsigned int vertex : vertices)
+                {
+                    if (vertex == from)
+                        continue;
+                    auto& triangles = mVertexTriangles[vertex];
+                    triangles.erase(std::remove(triangles.begin(), triangles.end(), triangle), triangles.end());
+                }
+            }
+
+            mQuadrics[to] += mQuadrics[from];
+            mVertexTriangles[from].clear();
+            mRemoved[from] = true;
+            ++mVersions[to];
+        }
+    };
+
+    struct CollectTriangles
+    {
+        std::vector<unsigned int> mIndices;
+
+        void operator()(unsigned int first, unsigned int second, unsigned int third)
+        {
+            mIndices.push_back(first);
+            mIndices.push_back(second);
+            mIndices.push_back(third);
+        }
+    };
+
+    class RemapArrayVisitor : public osg::ConstArrayVisitor
+    {
+    public:
+        RemapArrayVisitor(const std::vector<unsigned int>& vertices)
+            : mVertices(vertices)
+        {
+        }
+
+        /// @return nullptr if the array type is not supported.
+        osg::ref_ptr<osg::Array> remap(const osg::Array& array)
+        {
+            mResult = nullptr;
+            array.accept(*this);
+            return mResult;
+        }
+
+        template <class T>
+        void remapArray(const T& array)
+        {
+            osg::ref_ptr<T> result = static_cast<T*>(array.cloneType());
+            result->reserve(mVertices.size());
+            for (unsigned int vertex : mVertices)
+                result->push_back(array[vertex]);
+            result->setBinding(array.getBinding());
+            result->setNormalize(array.getNormalize());
+            mResult = result;
+        }
+
+        virtual void apply(const osg::ByteArray& array) { remapArray(array); }
+        virtual void apply(const osg::ShortArray& array) { remapArray(array); }
+        virtual void apply(const osg::IntArray& array) { remapArray(array); }
+        virtual void apply(const osg::UByteArray& array) { remapArray(array); }
+        virtual void apply(const osg::UShortArray& array) { remapArray(array); }
+        virtual void apply(const osg::UIntArray& array) { remapArray(array); }
+
+        virtual void apply(const osg::Vec4ubArray& array) { remapArray(array); }
+        virtual void apply(const osg::Vec3ubArray& array) { remapArray(array); }
+        virtual void apply(const osg::Vec2ubArray& array) { remapArray(array); }
+
+        virtual void apply(const osg::Vec4usArray& array) { remapArray(array); }
+        virtual void apply(const osg::Vec3usArray& array) { remapArray(array); }
+        virtual void apply(const osg::Vec2usArray& array) { remapArray(array); }
+
+        virtual void apply(const osg::FloatArray& array) { remapArray(array); }
+        virtual void apply(const osg::Vec2Array& array) { remapArray(array); }
+        virtual void apply(const osg::Vec3Array& array) { remapArray(array); }
+        virtual void apply(const osg::Vec4Array& array) { remapArray(array); }
+
+        virtual void apply(const osg::DoubleArray& array) { remapArray(array); }
+        virtual void apply(const osg::Vec2dArray& array) { remapArray(array); }
+        virtual void apply(const osg::Vec3dArray& array) { remapArray(array); }
+        virtual void apply(const osg::Vec4dArray& array) { remapArray(array); }
+
+        virtual void apply(const osg::Vec2bArray& array) { remapArray(array); }
+        virtual void apply(const osg::Vec3bArray& array) { remapArray(array); }
+        virtual void apply(const osg::Vec4bArray& array) { remapArray(array); }
+
+        virtual void apply(const osg::Vec2sArray& array) { remapArray(array); }
+        virtual void apply(const osg::Vec3sArray& array) { remapArray(array); }
+        virtual void apply(const osg::Vec4sArray& array) { remapArray(array); }
+
+    private:
+        const std::vector<unsigned int>& mVertices;
+        osg::ref_ptr<osg::Array> mResult;
+    };
+
+    bool isPerVertex(const osg::Array* array)
+    {
+        return array != nullptr && array->getBinding() == osg::Array::BIND_PER_VERTEX;
+    }
+
+    bool canSimplify(const osg::Geometry& geometry)
+    {
+        if (!dynamic_cast<const osg::Vec3Array*>(geometry.getVertexArray()))
+            return false;
+
+        const unsigned int numVertices = geometry.getVertexArray()->getNumElements();
+        osg::Geometry::ArrayList arrays;
+        geometry.getArrayList(arrays);
+        for (const osg::Array* array : arrays)
+        {
+            const osg::Array::Binding binding = array->getBinding();
+            if (binding == osg::Array::BIND_PER_PRIMITIVE_SET || (binding == osg::Array::BIND_PER_VERTEX && array->getNumElements() < numVertices))
+                return false;
+        }
+
+        for (unsigned int i = 0; i < geometry.getNumPrimitiveSets(); ++i)
+        {
+            switch (geometry.getPrimitiveSet(i)->getMode())
+            {
+                case osg::PrimitiveSet::TRIANGLES:
+                case osg::PrimitiveSet::TRIANGLE_STRIP:
+                case osg::PrimitiveSet::TRIANGLE_FAN:
+                case osg::PrimitiveSet::QUADS:
+                case osg::PrimitiveSet::QUAD_STRIP:
+                case osg::PrimitiveSet::POLYGON:
+                    break;
+                default:
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    osg::ref_ptr<osg::Geometry> makeGeometry(const osg::Geometry& geometry, const std::vector<unsigned int>& indices)
+    {
+        std::vector<unsigned int> vertices;
+        std::vector<unsigned int> newIndices(geometry.getVertexArray()->getNumElements(), std::numeric_limits<unsigned int>::max());
+        for (unsigned int index : indices)
+        {
+            if (newIndices[index] != std::numeric_limits<unsigned int>::max())
+                continue;
+            newIndices[index] = static_cast<unsigned int>(vertices.size());
+            vertices.push_back(index);
+        }
+
+        RemapArrayVisitor visitor(vertices);
+        bool failed = false;
+        const auto remap = [&] (const osg::Array* array) -> osg::ref_ptr<osg::Array>
+        {
+            osg::ref_ptr<osg::Array> result = visitor.remap(*array);
+            if (!result)
+                failed = true;
+            return result;
+        };
+
+        osg::ref_ptr<osg::Geometry> result = new osg::Geometry(geometry, osg::CopyOp::SHALLOW_COPY);
+        result->removePrimitiveSet(0, result->getNumPrimitiveSets());
+
+        result->setVertexArray(remap(geometry.getVertexArray()));
+        if (isPerVertex(geometry.getNormalArray()))
+            result->setNormalArray(remap(geometry.getNormalArray()));
+        if (isPerVertex(geometry.getColorArray()))
+            result->setColorArray(remap(geometry.getColorArray()));
+        if (isPerVertex(geometry.getSecondaryColorArray()))
+            result->setSecondaryColorArray(remap(geometry.getSecondaryColorArray()));
+        if (isPerVertex(geometry.getFogCoordArray()))
+            result->setFogCoordArray(remap(geometry.getFogCoordArray()));
+        for (unsigned int i = 0; i < geometry.getNumTexCoordArrays(); ++i)
+            if (isPerVertex(geometry.getTexCoordArray(i)))
+                result->setTexCoordArray(i, remap(geometry.getTexCoordArray(i)));
+        for (unsigned int i = 0; i < geometry.getNumVertexAttribArrays(); ++i)
+            if (isPerVertex(geometry.getVertexAttribArray(i)))
+                result->setVertexAttribArray(i, remap(geometry.getVertexAttribArray(i)));
+
+        if (failed)
+            return nullptr;
+
+        if (vertices.size() <= std::numeric_limits<unsigned short>::max() + 1u)
+        {
+            osg::ref_ptr<osg::DrawElementsUShort> primitives = new osg::DrawElementsUShort(osg::PrimitiveSet::TRIANGLES);
+            primitives->reserve(indices.size());
+            for (unsigned int index : indices)
+                primitives->push_back(static_cast<unsigned short>(newIndices[index]));
+            result->addPrimitiveSet(primitives);
+        }
+        else
+        {
+            osg::ref_ptr<osg::DrawElementsUInt> primitives = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES);
+            primitives->reserve(indices.size());
+            for (unsigned int index : indices)
+                primitives->push_back(newIndices[index]);
+            result->addPrimitiveSet(primitives);
+        }
+
+        return result;
+    }
+
+}
+
+namespace SceneUtil
+{
+
+    float simplifyTriangles(const std::vector<osg::Vec3f>& vertices, std::vector<unsigned int>& indices,
+                            std::size_t targetTriangles, float maxError)
+    {
+        Simplifier simplifier(vertices, indices);
+        const double result = simplifier.simplify(targetTriangles, maxError);
+        indices = simplifier.getIndices();
+        return static_cast<float>(result);
+    }
+
+    std::vector<SimplifiedGeometry> simplifyGeometry(const osg::Geometry& geometry, unsigned int levels, float ratio,
+                                                     std::size_t minTriangles)
+    {
+        if (!canSimplify(geometry))
+            return {};
+
+        osg::TriangleIndexFunctor<CollectTriangles> functor;
+        geometry.accept(functor);
+        std::vector<unsigned int> indices = std::move(functor.mIndices);
+        if (indices.size() / 3 < minTriangles)
+            return {};
+
+        const osg::Vec3Array& vertexArray = static_cast<const osg::Vec3Array&>(*geometry.getVertexArray());
+        const std::vector<osg::Vec3f> vertices(vertexArray.begin(), vertexArray.end());
+
+        std::vector<SimplifiedGeometry> result;
+        float error = 0;
+        for (unsigned int level = 0; level < levels; ++level)
+        {
+            const std::size_t numTriangles = indices.size() / 3;
+            error += simplifyTriangles(vertices, indices, static_cast<std::size_t>(numTriangles * ratio),
+                                       std::numeric_limits<float>::max());
+
+            // stop once the mesh can't be reduced significantly without breaking its topology
+            if (indices.empty() || indices.size() / 3 > numTriangles * 0.9)
+                break;
+
+            osg::ref_ptr<osg::Geometry> simplified = makeGeometry(geometry, indices);
+            if (!simplified)
+                return {};
+            result.push_back(SimplifiedGeometry {simplified, error});
+        }
+
+        return result;
+    }
+
+}
@@ -0,0 +1,43 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_MESHSIMPLIFIER_H
+#define OPENMW_COMPONENTS_SCENEUTIL_MESHSIMPLIFIER_H
+
+#include <osg/Geometry>
+#include <osg/Vec3f>
+#include <osg/ref_ptr>
+
+#include <cstddef>
+#include <vector>
+
+namespace SceneUtil
+{
+
+    /// @brief Reduces the number of triangles of a mesh by quadric error edge collapse.
+    /// @par Edges are collapsed into one of their vertices, so the remaining triangles index a subset of the original
+    /// vertices and keep their attributes. Vertices sharing a position with another vertex, i.e. lying on a seam of
+    /// texture coordinates or normals, are never removed, and the error of moving an open border is accounted for,
+    /// so the outline of the mesh is preserved.
+    /// @param indices Triangle list, replaced by the simplified one.
+    /// @param targetTriangles Stop collapsing edges once there are no more triangles than this.
+    /// @param maxError Approximate error threshold, stop collapsing edges once the quadric error, which estimates the
+    /// distance the surface would move, is larger.
+    /// @return The largest quadric error of the collapsed edges, an approximation of the distance the surface moved.
+    float simplifyTriangles(const std::vector<osg::Vec3f>& vertices, std::vector<unsigned int>& indices,
+                            std::size_t targetTriangles, float maxError);
+
+    struct SimplifiedGeometry
+    {
+        osg::ref_ptr<osg::Geometry> mGeometry;
+        /// Sum of the errors of the levels up to this one, approximate like each of them.
+        float mError;
+    };
+
+    /// @brief Build successively simplified copies of the geometry with vertex arrays reduced to the used vertices.
+    /// @param ratio Maximum number of triangles of each level relative to the previous one.
+    /// @return Levels in order of increasing error. Empty if the geometry has less than minTriangles triangles or
+    /// can't be simplified without losing data, e.g. because it contains points or lines.
+    std::vector<SimplifiedGeometry> simplifyGeometry(const osg::Geometry& geometry, unsigned int levels, float ratio,
+                                                     std::size_t minTriangles);
+
+}
+
+#endif
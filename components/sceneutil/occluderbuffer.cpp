@@ -0,0 +1,200 @@
+#include "occluderbuffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace
+{
+
+    /// Signed distance to the near plane in clip space, negative behind it.
+    float getNearDistance(const osg::Vec4f& clip)
+    {
+        return clip.z() + clip.w();
+    }
+
+    float getEdge(const osg::Vec3f& a, const osg::Vec3f& b, float x, float y)
+    {
+        return (b.x() - a.x()) * (y - a.y()) - (b.y() - a.y()) * (x - a.x());
+    }
+
+}
+
+namespace SceneUtil
+{
+
+    OccluderBuffer::OccluderBuffer(unsigned int width, unsigned int height)
+        : mWidth(width)
+        , mHeight(height)
+        , mDepth(static_cast<std::size_t>(width) * height, 1.f)
+        , mNumTriangles(0)
+    {
+    }
+
+    void OccluderBuffer::reset(const osg::Matrixf& viewProjection)
+    {
+        mViewProjection = viewProjection;
+        std::fill(mDepth.begin(), mDepth.end(), 1.f);
+        mNumTriangles = 0;
+    }
+
+    void OccluderBuffer::addTriangles(const std::vector<osg::Vec3f>& vertices, const std::vector<unsigned int>& indices)
+    {
+        std::vector<osg::Vec4f> clip;
+        clip.reserve(vertices.size());
+        for (const osg::Vec3f& vertex : vertices)
+            clip.push_back(osg::Vec4f(vertex, 1.f) * mViewProjection);
+
+        for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+            drawTriangle(clip[indices[i]], clip[indices[i + 1]], clip[indices[i + 2]]);
+    }
+
+    bool OccluderBuffer::isVisible(const osg::BoundingBox& box, const osg::Matrixf& localToClip) const
+    {
+        if (!box.valid())
+            return true;
+
+        float minX = static_cast<float>(mWidth);
+        float maxX = 0;
+        float minY = static_cast<float>(mHeight);
+        float maxY = 0;
+        float minDepth = 1;
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            const osg::Vec4f clip = osg::Vec4f(box.corner(i), 1.f) * localToClip;
+            // the box reaches in front of the near plane, there is nothing to hide it
+            if (getNearDistance(clip) <= 0)
+                return true;
+            const osg::Vec3f screen = toScreen(clip);
+            minX = std::min(minX, screen.x());
+            maxX = std::max(maxX, screen.x());
+            minY = std::min(minY, screen.y());
+            maxY = std::max(maxY, screen.y());
+            minDepth = std::min(minDepth, screen.z());
+        }
+
+        // outside of the view, leave it to frustum culling
+        if (maxX < 0 || maxY < 0 || minX >= mWidth || minY >= mHeight)
+            return true;
+
+        const unsigned int startX = static_cast<unsigned int>(std::max(minX, 0.f));
+        const unsigned int endX = static_cast<unsigned int>(std::min(maxX, mWidth - 1.f));
+        const unsigned int startY = static_cast<unsigned int>(std::max(minY, 0.f));
+        const unsigned int endY = static_cast<unsigned int>(std::min(maxY, mHeight - 1.f));
+        for (unsigned int y = startY; y <= endY; ++y)
+        {
+            const float* row = &mDepth[y * mWidth];
+            for (unsigned int x = startX; x <= endX; ++x)
+                if (minDepth <= row[x])
+                    return true;
+        }
+
+        return false;
+    }
+
+    void OccluderBuffer::drawTriangle(const osg::Vec4f& a, const osg::Vec4f& b, const osg::Vec4f& c)
+    {
+        const std::array<osg::Vec4f, 3> triangle {{a, b, c}};
+        std::array<osg::Vec4f, 4> polygon;
+        std::size_t size = 0;
+
+        // clip against the near plane, a triangle becomes a quad at most
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            const osg::Vec4f& current = triangle[i];
+            const osg::Vec4f& next = triangle[(i + 1) % 3];
+            const float currentDistance = getNearDistance(current);
+            const float nextDistance = getNearDistance(next);
+            if (currentDistance >= 0)
+                polygon[size++] = current;
+            if ((currentDistance >= 0) != (nextDistance >= 0))
+            {
+                const float t = currentDistance / (currentDistance - nextDistance);
+                polygon[size++] = current + (next - current) * t;
+            }
+        }
+
+        if (size < 3)
+            return;
+
+        std::array<osg::Vec3f, 4> screen;
+        for (std::size_t i = 0; i < size; ++i)
+            screen[i] = toScreen(polygon[i]);
+
+        ++mNumTriangles;
+        rasterize(screen[0], screen[1], screen[2]);
+        if (size == 4)
+            rasterize(screen[0], screen[2], screen[3]);
+    }
+
+    void OccluderBuffer::rasterize(const osg::Vec3f& a, const osg::Vec3f& b, const osg::Vec3f& c)
+    {
+        const float area = getEdge(a, b, c.x(), c.y());
+        if (std::abs(area) < 1e-6f)
+            return;
+
+        // pixel centers are at half integer coordinates
+        const float minX = std::max(std::min({a.x(), b.x(), c.x()}) - 0.5f, 0.f);
+        const float maxX = std::min(std::max({a.x(), b.x(), c.x()}) - 0.5f, mWidth - 1.f);
+        const float minY = std::max(std::min({a.y(), b.y(), c.y()}) - 0.5f, 0.f);
+        const float maxY = std::min(std::max({a.y(), b.y(), c.y()}) - 0.5f, mHeight - 1.f);
+        if (minX > maxX || minY > maxY)
+            return;
+        const unsigned int startX = static_cast<unsigned int>(std::ceil(minX));
+        const unsigned int endX = static_cast<unsigned int>(std::floor(maxX));
+        const unsigned int startY = static_cast<unsigned int>(std::ceil(minY));
+        const unsigned int endY = static_cast<unsigned int>(std::floor(maxY));
+
+        // depth is linear in screen space, use its largest value within each pixel to keep occluders conservative
+        const float invArea = 1.f / area;
+        const float depthX = ((b.y() - c.y()) * a.z() + (c.y() - a.y()) * b.z() + (a.y() - b.y()) * c.z()) * invArea;
+        const float depthY = ((c.x() - b.x()) * a.z() + (a.x() - c.x()) * b.z() + (b.x() - a.x()) * c.z()) * invArea;
+        const float maxDepth = std::max({a.z(), b.z(), c.z()});
+        const float depthMargin = 0.5f * (std::abs(depthX) + std::abs(depthY));
+
+        // edge functions are positive inside for either winding
+        const float sign = area > 0 ? 1.f : -1.f;
+        const std::array<const osg::Vec3f*, 3> vertices {{&a, &b, &c}};
+        std::array<float, 3> edgeX;
+        std::array<float, 3> edgeY;
+        std::array<float, 3> edgeRow;
+        const float startCenterX = startX + 0.5f;
+        const float startCenterY = startY + 0.5f;
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            const osg::Vec3f& from = *vertices[(i + 1) % 3];
+            const osg::Vec3f& to = *vertices[(i + 2) % 3];
+            edgeX[i] = -(to.y() - from.y()) * sign;
+            edgeY[i] = (to.x() - from.x()) * sign;
+            edgeRow[i] = getEdge(from, to, startCenterX, startCenterY) * sign;
+        }
+        float depthRow = a.z() + depthX * (startCenterX - a.x()) + depthY * (startCenterY - a.y());
+
+        for (unsigned int y = startY; y <= endY; ++y)
+        {
+            float* row = &mDepth[y * mWidth];
+            for (unsigned int x = startX; x <= endX; ++x)
+            {
+                const float offset = static_cast<float>(x - startX);
+                const float e0 = edgeRow[0] + edgeX[0] * offset;
+                const float e1 = edgeRow[1] + edgeX[1] * offset;
+                const float e2 = edgeRow[2] + edgeX[2] * offset;
+                const float depth = std::min(depthRow + depthX * offset + depthMargin, maxDepth);
+                if (e0 >= 0 && e1 >= 0 && e2 >= 0)
+                    row[x] = std::min(row[x], depth);
+            }
+            for (std::size_t i = 0; i < 3; ++i)
+                edgeRow[i] += edgeY[i];
+            depthRow += depthY;
+        }
+    }
+
+    osg::Vec3f OccluderBuffer::toScreen(const osg::Vec4f& clip) const
+    {
+        const float invW = 1.f / clip.w();
+        return osg::Vec3f((clip.x() * invW * 0.5f + 0.5f) * mWidth,
+                          (clip.y() * invW * 0.5f + 0.5f) * mHeight,
+                          clip.z() * invW);
+    }
+
+}
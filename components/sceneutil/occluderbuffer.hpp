@@ -0,0 +1,65 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_OCCLUDERBUFFER_H
+#define OPENMW_COMPONENTS_SCENEUTIL_OCCLUDERBUFFER_H
+
+#include <osg/BoundingBox>
+#include <osg/Matrixf>
+#include <osg/Vec3f>
+#include <osg/Vec4f>
+
+#include <vector>
+
+namespace SceneUtil
+{
+
+    /// @brief Low resolution depth buffer of large occluders rasterized on the CPU.
+    /// @par Occluders are drawn with the farthest depth they may have within each pixel whose center they cover,
+    /// and boxes are tested with their nearest depth against every pixel they overlap, so a box is only reported as
+    /// hidden if it is behind occluders everywhere. Pixels partially covered along the silhouette of an occluder
+    /// may still hide a box peeking over it by less than a pixel.
+    class OccluderBuffer
+    {
+    public:
+        OccluderBuffer(unsigned int width, unsigned int height);
+
+        /// Clear the buffer to draw occluders for a new view.
+        void reset(const osg::Matrixf& viewProjection);
+
+        /// Draw a triangle list given in world space. Triangles are clipped against the near plane.
+        void addTriangles(const std::vector<osg::Vec3f>& vertices, const std::vector<unsigned int>& indices);
+
+        /// @param localToClip Transformation of the box into clip space, e.g. model view and projection matrix.
+        /// @return false if the box is completely hidden behind occluders.
+        bool isVisible(const osg::BoundingBox& box, const osg::Matrixf& localToClip) const;
+
+        /// @param box Bounds in world space.
+        bool isVisible(const osg::BoundingBox& box) const
+        {
+            return isVisible(box, mViewProjection);
+        }
+
+        unsigned int getWidth() const { return mWidth; }
+
+        unsigned int getHeight() const { return mHeight; }
+
+        /// @return Normalized device depth of the pixel, 1 where no occluder was drawn.
+        float getDepth(unsigned int x, unsigned int y) const { return mDepth[y * mWidth + x]; }
+
+        std::size_t getNumTriangles() const { return mNumTriangles; }
+
+    private:
+        unsigned int mWidth;
+        unsigned int mHeight;
+        osg::Matrixf mViewProjection;
+        std::vector<float> mDepth;
+        std::size_t mNumTriangles;
+
+        void drawTriangle(const osg::Vec4f& a, const osg::Vec4f& b, const osg::Vec4f& c);
+
+        void rasterize(const osg::Vec3f& a, const osg::Vec3f& b, const osg::Vec3f& c);
+
+        osg::Vec3f toScreen(const osg::Vec4f& clip) const;
+    };
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+#include "occluderculling.hpp"
+
+#include <osg/Camera>
+#include <osg/Stats>
+#include <osg/Timer>
+#include <osg/Transform>
+
+#include <osgUtil/CullVisitor>
+
+namespace SceneUtil
+{
+
+    OccluderCulling::OccluderCulling(unsigned int width, unsigned int height)
+        : mWidth(width)
+        , mHeight(height)
+        , mSource(nullptr)
+        , mCulled(0)
+        , mTriangles(0)
+        , mFillTime(0)
+    {
+    }
+
+    void OccluderCulling::setSource(OccluderSource* source)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSource = source;
+        for (auto& view : mViews)
+            view.second->mValid = false;
+    }
+
+    void OccluderCulling::addCamera(const osg::Camera* camera)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto& view = mViews[camera];
+        if (!view)
+            view.reset(new View(mWidth, mHeight));
+    }
+
+    OccluderCulling::View* OccluderCulling::getView(const osg::Camera* camera)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mSource == nullptr)
+            return nullptr;
+        const auto it = mViews.find(camera);
+        if (it == mViews.end())
+            return nullptr;
+        return it->second.get();
+    }
+
+    bool OccluderCulling::isVisible(osgUtil::CullVisitor& cv, const osg::BoundingBox& box)
+    {
+        const osg::Camera* camera = cv.getCurrentCamera();
+        View* view = getView(camera);
+        if (view == nullptr)
+            return true;
+
+        std::lock_guard<std::mutex> lock(view->mMutex);
+        const unsigned int frameNumber = cv.getTraversalNumber();
+        if (!view->mValid || view->mFrameNumber != frameNumber)
+        {
+            const osg::Timer_t start = osg::Timer::instance()->tick();
+            view->mBuffer.reset(camera->getViewMatrix() * *cv.getProjectionMatrix());
+            mSource->addOccluders(camera->getInverseViewMatrix().getTrans(), view->mBuffer);
+            view->mFrameNumber = frameNumber;
+            view->mValid = true;
+            mTriangles += static_cast<unsigned int>(view->mBuffer.getNumTriangles());
+            mFillTime += static_cast<unsigned int>(osg::Timer::instance()->delta_u(start, osg::Timer::instance()->tick()));
+        }
+
+        if (view->mBuffer.isVisible(box, *cv.getModelViewMatrix() * *cv.getProjectionMatrix()))
+            return true;
+
+        ++mCulled;
+        return false;
+    }
+
+    void OccluderCulling::reportStats(unsigned int frameNumber, osg::Stats* stats)
+    {
+        stats->setAttribute(frameNumber, "Occluder Triangles", mTriangles.exchange(0));
+        stats->setAttribute(frameNumber, "Occluder Culled", mCulled.exchange(0));
+        stats->setAttribute(frameNumber, "Occluder Time", mFillTime.exchange(0));
+    }
+
+    void OccluderCullCallback::operator()(osg::Node* node, osg::NodeVisitor* nv)
+    {
+        osgUtil::CullVisitor* cv = static_cast<osgUtil::CullVisitor*>(nv);
+
+        // the bound of a transform is in the parent space, while the current model view already includes the transform
+        osg::BoundingSphere sphere;
+        if (osg::Transform* transform = node->asTransform())
+        {
+            for (unsigned int i = 0; i < transform->getNumChildren(); ++i)
+                sphere.expandBy(transform->getChild(i)->getBound());
+        }
+        else
+            sphere = node->getBound();
+
+        if (mCulling && sphere.valid())
+        {
+            osg::BoundingBox box;
+            box.expandBy(sphere);
+            if (!mCulling->isVisible(*cv, box))
+                return;
+        }
+
+        traverse(node, nv);
+    }
+
+}
@@ -0,0 +1,108 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_OCCLUDERCULLING_H
+#define OPENMW_COMPONENTS_SCENEUTIL_OCCLUDERCULLING_H
+
+#include <osg/NodeCallback>
+#include <osg/Vec3f>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "occluderbuffer.hpp"
+
+namespace osg
+{
+    class Camera;
+    class Stats;
+}
+
+namespace osgUtil
+{
+    class CullVisitor;
+}
+
+namespace SceneUtil
+{
+
+    /// Provides occluder geometry for a view, e.g. coarse terrain.
+    class OccluderSource
+    {
+    public:
+        virtual ~OccluderSource() = default;
+
+        /// Draw occluders seen from the eye point into the buffer.
+        /// @note Called from cull threads.
+        virtual void addOccluders(const osg::Vec3f& eyePoint, OccluderBuffer& buffer) = 0;
+    };
+
+    /// @brief Keeps an occluder buffer per camera, filled from the source once per frame when the first node is tested
+    /// in the cull traversal of that camera.
+    /// @note Thread safe.
+    class OccluderCulling : public osg::Referenced
+    {
+    public:
+        OccluderCulling(unsigned int width, unsigned int height);
+
+        void setSource(OccluderSource* source);
+
+        /// Only traversals of the given cameras are tested, everything else is considered visible.
+        void addCamera(const osg::Camera* camera);
+
+        /// @param box Bounds in the local coordinates of the current model view matrix of the visitor.
+        bool isVisible(osgUtil::CullVisitor& cv, const osg::BoundingBox& box);
+
+        /// Report and reset the counts accumulated by the cull traversals since the last call.
+        void reportStats(unsigned int frameNumber, osg::Stats* stats);
+
+    private:
+        struct View
+        {
+            std::mutex mMutex;
+            unsigned int mFrameNumber = 0;
+            bool mValid = false;
+            OccluderBuffer mBuffer;
+
+            View(unsigned int width, unsigned int height) : mBuffer(width, height) {}
+        };
+
+        unsigned int mWidth;
+        unsigned int mHeight;
+        std::mutex mMutex;
+        OccluderSource* mSource;
+        std::map<const osg::Camera*, std::unique_ptr<View>> mViews;
+        std::atomic<unsigned int> mCulled;
+        std::atomic<unsigned int> mTriangles;
+        std::atomic<unsigned int> mFillTime;
+
+        View* getView(const osg::Camera* camera);
+    };
+
+    /// Skips the subgraph in the cull traversal while its bounds are hidden behind occluders.
+    class OccluderCullCallback : public osg::NodeCallback
+    {
+    public:
+        OccluderCullCallback() = default;
+
+        OccluderCullCallback(OccluderCulling* culling)
+            : mCulling(culling)
+        {
+        }
+
+        OccluderCullCallback(const OccluderCullCallback& copy, const osg::CopyOp& copyop)
+            : osg::Object(copy, copyop), osg::NodeCallback(copy, copyop)
+            , mCulling(copy.mCulling)
+        {
+        }
+
+        META_Object(SceneUtil, OccluderCullCallback)
+
+        void operator()(osg::Node* node, osg::NodeVisitor* nv) override;
+
+    private:
+        osg::ref_ptr<OccluderCulling> mCulling;
+    };
+
+}
+
+#endif
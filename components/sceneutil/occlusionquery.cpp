@@ -0,0 +1,57 @@
+#include "occlusionquery.hpp"
+
+#include <osg/Stats>
+
+namespace SceneUtil
+{
+
+    OcclusionQueryNode::OcclusionQueryNode(OcclusionCulling* culling)
+        : mCulling(culling)
+    {
+    }
+
+    OcclusionQueryNode::OcclusionQueryNode(const OcclusionQueryNode& copy, const osg::CopyOp& copyop)
+        : osg::OcclusionQueryNode(copy, copyop)
+        , mCulling(copy.mCulling)
+    {
+    }
+
+    bool OcclusionQueryNode::getPassed(const osg::Camera* camera, osg::NodeVisitor& nv)
+    {
+        const bool passed = osg::OcclusionQueryNode::getPassed(camera, nv);
+        if (mCulling)
+            mCulling->onTested(passed);
+        return passed;
+    }
+
+    OcclusionCulling::OcclusionCulling(unsigned int queryFrameCount, unsigned int visibilityThreshold)
+        : mQueryFrameCount(queryFrameCount)
+        , mVisibilityThreshold(visibilityThreshold)
+        , mTested(0)
+        , mCulled(0)
+    {
+    }
+
+    osg::ref_ptr<OcclusionQueryNode> OcclusionCulling::createQueryNode(unsigned int nodeMask)
+    {
+        osg::ref_ptr<OcclusionQueryNode> node = new OcclusionQueryNode(this);
+        node->setQueryFrameCount(mQueryFrameCount);
+        node->setVisibilityThreshold(mVisibilityThreshold);
+        node->setNodeMask(nodeMask);
+        return node;
+    }
+
+    void OcclusionCulling::onTested(bool passed)
+    {
+        ++mTested;
+        if (!passed)
+            ++mCulled;
+    }
+
+    void OcclusionCulling::reportStats(unsigned int frameNumber, osg::Stats* stats)
+    {
+        stats->setAttribute(frameNumber, "Occlusion Tested", mTested.exchange(0));
+        stats->setAttribute(frameNumber, "Occlusion Culled", mCulled.exchange(0));
+    }
+
+}
@@ -0,0 +1,62 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_OCCLUSIONQUERY_H
+#define OPENMW_COMPONENTS_SCENEUTIL_OCCLUSIONQUERY_H
+
+#include <osg/OcclusionQueryNode>
+
+#include <atomic>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace SceneUtil
+{
+
+    class OcclusionCulling;
+
+    /// @brief Skips its children in the cull traversal while a hardware occlusion query over their bounding box finds
+    /// no visible samples.
+    /// @par Queries are issued every few frames per camera and only finished results are used, so the draw thread
+    /// never waits for them. Children are drawn while the camera is inside the bounding box or no result is available.
+    class OcclusionQueryNode : public osg::OcclusionQueryNode
+    {
+    public:
+        OcclusionQueryNode(OcclusionCulling* culling = nullptr);
+
+        OcclusionQueryNode(const OcclusionQueryNode& copy, const osg::CopyOp& copyop = osg::CopyOp::SHALLOW_COPY);
+
+        META_Node(SceneUtil, OcclusionQueryNode)
+
+        bool getPassed(const osg::Camera* camera, osg::NodeVisitor& nv) override;
+
+    private:
+        osg::ref_ptr<OcclusionCulling> mCulling;
+    };
+
+    /// Creates occlusion query nodes with the same settings and counts how many of them are culled.
+    class OcclusionCulling : public osg::Referenced
+    {
+    public:
+        /// @param queryFrameCount Number of frames between queries of the same node.
+        /// @param visibilityThreshold Minimum number of samples passing the depth test for a node to be drawn.
+        OcclusionCulling(unsigned int queryFrameCount, unsigned int visibilityThreshold);
+
+        /// @param nodeMask Should match the mask of the children, so the query is only issued by cameras drawing them.
+        osg::ref_ptr<OcclusionQueryNode> createQueryNode(unsigned int nodeMask);
+
+        void onTested(bool passed);
+
+        /// Report and reset the counts accumulated by the cull traversals since the last call.
+        void reportStats(unsigned int frameNumber, osg::Stats* stats);
+
+    private:
+        unsigned int mQueryFrameCount;
+        unsigned int mVisibilityThreshold;
+        std::atomic<unsigned int> mTested;
+        std::atomic<unsigned int> mCulled;
+    };
+
+}
+
+#endif
@@ -1,9 +1,13 @@
 #include "serialize.hpp"
 
+#include <atomic>
+#include <mutex>
+
 #include <osgDB/ObjectWrapper>
 #include <osgDB/Registry>
 
 #include <components/nifosg/matrixtransform.hpp>
+#include <components/nifosg/nodeindexholder.hpp>
 
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/skeleton.hpp>
@@ -76,12 +80,66 @@ public:
     }
 };
 
+static bool checkRotationScale(const NifOsg::MatrixTransform&)
+{
+    return true;
+}
+
+static bool readRotationScale(osgDB::InputStream& is, NifOsg::MatrixTransform& node)
+{
+    for (int i=0; i<3; ++i)
+        for (int j=0; j<3; ++j)
+            is >> node.mRotationScale.mValues[i][j];
+    return true;
+}
+
+static bool writeRotationScale(osgDB::OutputStream& os, const NifOsg::MatrixTransform& node)
+{
+    for (int i=0; i<3; ++i)
+        for (int j=0; j<3; ++j)
+            os << node.mRotationScale.mValues[i][j];
+    os << std::endl;
+    return true;
+}
+
+static bool checkScale(const NifOsg::MatrixTransform&)
+{
+    return true;
+}
+
+static bool readScale(osgDB::InputStream& is, NifOsg::MatrixTransform& node)
+{
+    is >> node.mScale;
+    return true;
+}
+
+static bool writeScale(osgDB::OutputStream& os, const NifOsg::MatrixTransform& node)
+{
+    os << node.mScale << std::endl;
+    return true;
+}
+
 class MatrixTransformSerializer : public osgDB::ObjectWrapper
 {
 public:
     MatrixTransformSerializer()
-        : osgDB::ObjectWrapper(createInstanceFunc<NifOsg::MatrixTransform>, "NifOsg::MatrixTransform", "osg::Object osg::Node osg::Transform osg::MatrixTransform NifOsg::MatrixTransform")
+        : osgDB::ObjectWrapper(createInstanceFunc<NifOsg::MatrixTransform>, "NifOsg::MatrixTransform", "osg::Object osg::Node osg::Group osg::Transform osg::MatrixTransform NifOsg::MatrixTransform")
     {
+        addSerializer( new osgDB::UserSerializer<NifOsg::MatrixTransform>(
+            "rotationScale", &checkRotationScale, &readRotationScale, &writeRotationScale), osgDB::BaseSerializer::RW_USER );
+        addSerializer( new osgDB::UserSerializer<NifOsg::MatrixTransform>(
+            "scale", &checkScale, &readScale, &writeScale), osgDB::BaseSerializer::RW_USER );
+    }
+};
+
+class NodeIndexHolderSerializer : public osgDB::ObjectWrapper
+{
+public:
+    NodeIndexHolderSerializer()
+        : osgDB::ObjectWrapper(createInstanceFunc<NifOsg::NodeIndexHolder>, "NifOsg::NodeIndexHolder", "osg::Object NifOsg::NodeIndexHolder")
+    {
+        addSerializer( new osgDB::PropByValSerializer< NifOsg::NodeIndexHolder, int >(
+            "index", 0, &NifOsg::NodeIndexHolder::getIndex, &NifOsg::NodeIndexHolder::setIndex), osgDB::BaseSerializer::RW_INT );
     }
 };
 
@@ -99,11 +157,15 @@ public:
     }
 };
 
+static std::atomic<bool> sSerializersRegistered {false};
+
 void registerSerializers()
 {
     static bool done = false;
     if (!done)
     {
+        sSerializersRegistered = true;
+
         osgDB::ObjectWrapperManager* mgr = osgDB::Registry::instance()->getObjectWrapperManager();
         mgr->addWrapper(new PositionAttitudeTransformSerializer);
         mgr->addWrapper(new SkeletonSerializer);
@@ -161,4 +223,19 @@ void registerSerializers()
     }
 }
 
+bool areSerializersRegistered()
+{
+    return sSerializersRegistered;
+}
+
+void registerSceneSerializers()
+{
+    static std::once_flag once;
+    std::call_once(once, [] {
+        osgDB::ObjectWrapperManager* mgr = osgDB::Registry::instance()->getObjectWrapperManager();
+        mgr->addWrapper(new MatrixTransformSerializer);
+        mgr->addWrapper(new NodeIndexHolderSerializer);
+    });
+}
+
 }
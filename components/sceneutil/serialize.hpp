@@ -7,6 +7,13 @@ namespace SceneUtil
     /// Register osg node serializers for certain SceneUtil classes if not already done so
     void registerSerializers();
 
+    /// Whether registerSerializers was called. Geometry data is not serialized after that, so complete scenes can be
+    /// neither written nor read anymore.
+    bool areSerializersRegistered();
+
+    /// Register osg node serializers for NifOsg classes needed to write and read back complete static scenes
+    void registerSceneSerializers();
+
 }
 
 #endif
@@ -1,39 +1,98 @@
 #include "unrefqueue.hpp"
 
-//#include <osg/Timer>
-
-//#include <components/debug/debuglog.hpp>
+#include <components/misc/thread.hpp>
 
 namespace SceneUtil
 {
-    void UnrefWorkItem::doWork()
+    UnrefQueue::UnrefQueue(double frameBudget)
+        : mFrameBudget(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(frameBudget)))
+        , mPushed(nullptr)
+        , mNumItems(0)
+        , mStop(false)
+        , mFrame(0)
+        , mThread([this] { run(); })
     {
-        mObjects.clear();
     }
 
-    UnrefQueue::UnrefQueue()
+    UnrefQueue::~UnrefQueue()
     {
-        mWorkItem = new UnrefWorkItem;
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mHasWork.notify_one();
+        mThread.join();
+
+        mReleasing.insert(mReleasing.end(), mBatches.begin(), mBatches.end());
+        if (Item* pushed = mPushed.exchange(nullptr))
+            mReleasing.push_back(pushed);
+        release(std::chrono::steady_clock::duration::zero());
     }
 
     void UnrefQueue::push(const osg::Referenced *obj)
     {
-        mWorkItem->mObjects.push_back(obj);
+        Item* item = new Item {obj, mPushed.load(std::memory_order_relaxed)};
+        while (!mPushed.compare_exchange_weak(item->mNext, item, std::memory_order_release, std::memory_order_relaxed))
+            ;
+        ++mNumItems;
     }
 
-    void UnrefQueue::flush(SceneUtil::WorkQueue *workQueue)
+    void UnrefQueue::flush()
     {
-        if (mWorkItem->mObjects.empty())
-            return;
+        Item* pushed = mPushed.exchange(nullptr, std::memory_order_acquire);
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            if (pushed != nullptr)
+                mBatches.push_back(pushed);
+            ++mFrame;
+        }
+        mHasWork.notify_one();
+    }
 
-        workQueue->addWorkItem(mWorkItem, true);
+    unsigned int UnrefQueue::getNumItems() const
+    {
+        return mNumItems;
+    }
+
+    void UnrefQueue::run()
+    {
+        Misc::setCurrentThreadIdlePriority();
 
-        mWorkItem = new UnrefWorkItem;
+        std::size_t frame = 0;
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true)
+        {
+            mHasWork.wait(lock, [&] { return mStop || (frame != mFrame && !(mBatches.empty() && mReleasing.empty())); });
+            if (mStop)
+                return;
+            frame = mFrame;
+            mReleasing.insert(mReleasing.end(), mBatches.begin(), mBatches.end());
+            mBatches.clear();
+            lock.unlock();
+            release(mFrameBudget);
+            lock.lock();
+        }
     }
 
-    unsigned int UnrefQueue::getNumItems() const
+    void UnrefQueue::release(std::chrono::steady_clock::duration budget)
     {
-        return mWorkItem->mObjects.size();
+        const auto start = std::chrono::steady_clock::now();
+        std::size_t released = 0;
+        while (!mReleasing.empty())
+        {
+            Item* const item = mReleasing.front();
+            if (item->mNext == nullptr)
+                mReleasing.pop_front();
+            else
+                mReleasing.front() = item->mNext;
+            delete item;
+            --mNumItems;
+            // reading the clock after every object would take a noticeable part of the budget
+            if (budget != std::chrono::steady_clock::duration::zero() && ++released % 64 == 0
+                    && std::chrono::steady_clock::now() - start >= budget)
+                return;
+        }
     }
 
 }
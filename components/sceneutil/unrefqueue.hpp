@@ -1,42 +1,65 @@
 #ifndef OPENMW_COMPONENTS_UNREFQUEUE_H
 #define OPENMW_COMPONENTS_UNREFQUEUE_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <osg/ref_ptr>
 #include <osg/Referenced>
 
-#include <components/sceneutil/workqueue.hpp>
-
 namespace SceneUtil
 {
-    class WorkQueue;
-    
-    class UnrefWorkItem : public SceneUtil::WorkItem
-    {
-    public:
-        std::deque<osg::ref_ptr<const osg::Referenced> > mObjects;
-        virtual void doWork();
-    };
-
-    /// @brief Handles unreferencing of objects through the WorkQueue. Typical use scenario
-    /// would be the main thread pushing objects that are no longer needed, and the background thread deleting them.
+    /// @brief Handles unreferencing of objects in a dedicated low priority thread. Typical use scenario
+    /// would be the main thread pushing objects that are no longer needed, and the background thread deleting them
+    /// without holding up the WorkQueue used for preloading.
+    /// @par Objects are pushed without locking and handed over to the thread in batches by flush(), which is meant to
+    /// be called once per frame. For each flush the thread spends at most the given time on deleting objects and
+    /// continues with the rest after the next flush.
     class UnrefQueue : public osg::Referenced
     {
     public:
-        UnrefQueue();
+        /// @param frameBudget Time in seconds to spend on unreferencing objects per flush, 0 means no limit.
+        explicit UnrefQueue(double frameBudget = 0);
 
-        /// Adds an object to the list of objects to be unreferenced. Call from the main thread.
+        /// Unreferences the remaining objects in the calling thread.
+        ~UnrefQueue();
+
+        /// Adds an object to the list of objects to be unreferenced. May be called from any thread.
         void push(const osg::Referenced* obj);
 
-        /// Adds a WorkItem to the given WorkQueue that will clear the list of objects in a worker thread, thus unreferencing them.
+        /// Hands over the objects pushed so far to the background thread and starts its time budget for another frame.
         /// Call from the main thread.
-        void flush(SceneUtil::WorkQueue* workQueue);
+        void flush();
 
+        /// Number of objects pushed but not unreferenced yet.
         unsigned int getNumItems() const;
 
     private:
-        osg::ref_ptr<UnrefWorkItem> mWorkItem;
+        struct Item
+        {
+            osg::ref_ptr<const osg::Referenced> mObject;
+            Item* mNext;
+        };
+
+        const std::chrono::steady_clock::duration mFrameBudget;
+        std::atomic<Item*> mPushed;
+        std::atomic<unsigned int> mNumItems;
+        std::mutex mMutex;
+        std::condition_variable mHasWork;
+        bool mStop;
+        std::size_t mFrame;
+        std::vector<Item*> mBatches;
+        std::deque<Item*> mReleasing;
+        std::thread mThread;
+
+        void run();
+
+        void release(std::chrono::steady_clock::duration budget);
     };
 
 }
@@ -0,0 +1,125 @@
+#include "uploadscheduler.hpp"
+
+#include <osg/Stats>
+
+#include <algorithm>
+
+namespace SceneUtil
+{
+
+    UploadScheduler::UploadScheduler()
+        : mMinimumTimeAvailable(0.0035)
+        , mFirstFrame(true)
+        , mTimeAvailable(0)
+        , mCompileTimeSpent(0)
+    {
+        // the time available is computed in update() from the duration of the whole last frame
+        setConservativeTimeRatio(0);
+        setMinimumTimeAvailableForGLCompileAndDeletePerFrame(mMinimumTimeAvailable);
+    }
+
+    void UploadScheduler::setMinimumTimeAvailable(double time)
+    {
+        mMinimumTimeAvailable = time;
+    }
+
+    void UploadScheduler::addQueue(UploadQueue* queue)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQueues.push_back(queue);
+    }
+
+    void UploadScheduler::removeQueue(UploadQueue* queue)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQueues.erase(std::remove(mQueues.begin(), mQueues.end(), queue), mQueues.end());
+    }
+
+    void UploadScheduler::update(const osg::Vec3f& viewPoint)
+    {
+        const double frameTime = mFirstFrame ? 0.0 : std::min(mTimer.time_s(), 0.2);
+        mTimer.setStartTick();
+        mFirstFrame = false;
+
+        const double targetFrameTime = 1.0 / getTargetFrameRate();
+        const double conservativeTimeRatio = 0.75;
+        mTimeAvailable = std::max((targetFrameTime - frameTime) * conservativeTimeRatio, mMinimumTimeAvailable);
+
+        std::size_t numCompileSets = 0;
+        {
+            std::lock_guard<OpenThreads::Mutex> lock(*getToCompiledMutex());
+            numCompileSets = getToCompile().size();
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mViewPoint = viewPoint;
+
+        std::vector<std::size_t> pending;
+        pending.reserve(mQueues.size());
+        std::size_t totalPending = numCompileSets;
+        std::size_t numBusy = numCompileSets > 0 ? 1 : 0;
+        for (const UploadQueue* queue : mQueues)
+        {
+            pending.push_back(queue->getNumPendingUploads());
+            totalPending += pending.back();
+            numBusy += pending.back() > 0 ? 1 : 0;
+        }
+
+        const auto getShare = [&] (std::size_t value)
+        {
+            if (value == 0)
+                return 0.0;
+            return mTimeAvailable * 0.5 * (1.0 / numBusy + static_cast<double>(value) / totalPending);
+        };
+
+        // objects added to the IncrementalCompileOperation later in this frame can use the whole time
+        setMinimumTimeAvailableForGLCompileAndDeletePerFrame(totalPending == 0 ? mTimeAvailable : getShare(numCompileSets));
+
+        for (std::size_t i = 0; i < mQueues.size(); ++i)
+            mQueues[i]->scheduleUploads(getShare(pending[i]), viewPoint);
+    }
+
+    void UploadScheduler::reportStats(unsigned int frameNumber, osg::Stats* stats) const
+    {
+        double timeSpent = mCompileTimeSpent;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (const UploadQueue* queue : mQueues)
+                timeSpent += queue->getUploadTimeSpent();
+        }
+
+        // in microseconds because stats are shown as integers
+        stats->setAttribute(frameNumber, "Upload Budget", mTimeAvailable * 1e6);
+        stats->setAttribute(frameNumber, "Upload Time", timeSpent * 1e6);
+    }
+
+    void UploadScheduler::operator()(osg::GraphicsContext* context)
+    {
+        const osg::Timer_t start = osg::Timer::instance()->tick();
+
+        osg::Vec3f viewPoint;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            viewPoint = mViewPoint;
+        }
+
+        {
+            std::lock_guard<OpenThreads::Mutex> lock(*getToCompiledMutex());
+            // sets without a position belong to objects that are about to be shown and keep their order in front
+            getToCompile().sort([&] (const osg::ref_ptr<CompileSet>& lhs, const osg::ref_ptr<CompileSet>& rhs)
+            {
+                const auto lhsPositioned = dynamic_cast<const PositionedCompileSet*>(lhs.get());
+                const auto rhsPositioned = dynamic_cast<const PositionedCompileSet*>(rhs.get());
+                if (lhsPositioned == nullptr || rhsPositioned == nullptr)
+                    return lhsPositioned == nullptr && rhsPositioned != nullptr;
+                return (lhsPositioned->getPosition() - viewPoint).length2()
+                        < (rhsPositioned->getPosition() - viewPoint).length2();
+            });
+        }
+
+        osgUtil::IncrementalCompileOperation::operator()(context);
+
+        mCompileTimeSpent = osg::Timer::instance()->delta_s(start, osg::Timer::instance()->tick());
+    }
+
+}
@@ -0,0 +1,90 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_UPLOADSCHEDULER_H
+#define OPENMW_COMPONENTS_SCENEUTIL_UPLOADSCHEDULER_H
+
+#include <osgUtil/IncrementalCompileOperation>
+
+#include <osg/Timer>
+#include <osg/Vec3f>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace SceneUtil
+{
+
+    /// CompileSet for a subgraph with a known position in world space, sets closer to the view point are compiled first.
+    class PositionedCompileSet : public osgUtil::IncrementalCompileOperation::CompileSet
+    {
+    public:
+        PositionedCompileSet(osg::Node* subgraphToCompile, const osg::Vec3f& position)
+            : osgUtil::IncrementalCompileOperation::CompileSet(subgraphToCompile)
+            , mPosition(position)
+        {
+        }
+
+        const osg::Vec3f& getPosition() const { return mPosition; }
+
+    private:
+        osg::Vec3f mPosition;
+    };
+
+    /// Work uploaded to the GPU in the draw thread besides the IncrementalCompileOperation, e.g. rendering to textures.
+    class UploadQueue
+    {
+    public:
+        virtual ~UploadQueue() = default;
+
+        virtual std::size_t getNumPendingUploads() const = 0;
+
+        /// Set the time in seconds available in the next frame, work closer to the view point should be done first.
+        virtual void scheduleUploads(double timeAvailable, const osg::Vec3f& viewPoint) = 0;
+
+        /// Time in seconds spent on uploads in the last frame.
+        virtual double getUploadTimeSpent() const = 0;
+    };
+
+    /// @brief IncrementalCompileOperation that shares one time budget per frame for uploading textures and vertex
+    /// buffers with other UploadQueues, so that together they don't take more time than the frame rate allows.
+    /// @par The budget is the time left from the last frame until the target frame time or at least the minimum time.
+    /// One half of it is split evenly between queues with pending work and the other half by the amount of pending work.
+    class UploadScheduler : public osgUtil::IncrementalCompileOperation
+    {
+    public:
+        UploadScheduler();
+
+        /// Minimum time in seconds to spend on uploads per frame, even if the frame rate is below the target.
+        void setMinimumTimeAvailable(double time);
+
+        /// @note Does not transfer ownership.
+        void addQueue(UploadQueue* queue);
+
+        void removeQueue(UploadQueue* queue);
+
+        /// Divide the budget of the next frame. Call once per frame from the update traversal.
+        void update(const osg::Vec3f& viewPoint);
+
+        void reportStats(unsigned int frameNumber, osg::Stats* stats) const;
+
+        void operator()(osg::GraphicsContext* context) override;
+
+    private:
+        double mMinimumTimeAvailable;
+        osg::Timer mTimer;
+        bool mFirstFrame;
+        double mTimeAvailable;
+        std::atomic<double> mCompileTimeSpent;
+        std::vector<UploadQueue*> mQueues;
+        mutable std::mutex mMutex;
+        osg::Vec3f mViewPoint;
+    };
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "workqueue.hpp"
 
 #include <components/debug/debuglog.hpp>
+#include <components/debug/trace.hpp>
 
 #include <numeric>
 
@@ -112,13 +113,17 @@ WorkThread::~WorkThread()
 
 void WorkThread::run()
 {
+    Debug::Tracer::setThreadName("WorkQueue");
     while (true)
     {
         osg::ref_ptr<WorkItem> item = mWorkQueue->removeWorkItem();
         if (!item)
             return;
         mActive = true;
-        item->doWork();
+        {
+            Debug::TraceZone zone("WorkItem");
+            item->doWork();
+        }
         item->signalDone();
         mActive = false;
     }
@@ -12,6 +12,7 @@
 #include <components/resource/scenemanager.hpp>
 
 #include <components/sceneutil/lightmanager.hpp>
+#include <components/sceneutil/uploadscheduler.hpp>
 
 #include "terraindrawable.hpp"
 #include "material.hpp"
@@ -56,7 +57,7 @@ osg::ref_ptr<osg::Node> ChunkManager::getChunk(float size, const osg::Vec2f &cen
 
 void ChunkManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
 {
-    stats->setAttribute(frameNumber, "Terrain Chunk", mCache->getCacheSize());
+    reportCacheStats(frameNumber, stats, "Terrain Chunk");
 }
 
 void ChunkManager::clearCache()
@@ -208,6 +209,7 @@ osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Ve
     {
         osg::ref_ptr<CompositeMap> compositeMap = new CompositeMap;
         compositeMap->mTexture = createCompositeMapRTT();
+        compositeMap->mCenter = osg::Vec3f(chunkCenter.x(), chunkCenter.y(), 0) * mStorage->getCellWorldSize();
 
         createCompositeMapGeometry(chunkSize, chunkCenter, osg::Vec4f(0,0,1,1), *compositeMap);
 
@@ -231,7 +233,8 @@ osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Ve
 
     if (compile && mSceneManager->getIncrementalCompileOperation())
     {
-        mSceneManager->getIncrementalCompileOperation()->add(geometry);
+        const osg::Vec3f center = osg::Vec3f(chunkCenter.x(), chunkCenter.y(), 0) * mStorage->getCellWorldSize();
+        mSceneManager->getIncrementalCompileOperation()->add(new SceneUtil::PositionedCompileSet(geometry, center));
     }
     geometry->setNodeMask(mNodeMask);
 
@@ -5,7 +5,6 @@
 #include <osg/RenderInfo>
 
 #include <components/sceneutil/unrefqueue.hpp>
-#include <components/sceneutil/workqueue.hpp>
 
 #include <algorithm>
 
@@ -15,14 +14,15 @@ namespace Terrain
 CompositeMapRenderer::CompositeMapRenderer()
     : mTargetFrameRate(120)
     , mMinimumTimeAvailable(0.0025)
+    , mScheduled(false)
+    , mScheduledTime(0)
+    , mTimeSpent(0)
 {
     setSupportsDisplayList(false);
     setCullingActive(false);
 
     mFBO = new osg::FrameBufferObject;
 
-    mUnrefQueue = new SceneUtil::UnrefQueue;
-
     getOrCreateStateSet()->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
 }
 
@@ -30,9 +30,9 @@ CompositeMapRenderer::~CompositeMapRenderer()
 {
 }
 
-void CompositeMapRenderer::setWorkQueue(SceneUtil::WorkQueue* workQueue)
+void CompositeMapRenderer::setUnrefQueue(SceneUtil::UnrefQueue* unrefQueue)
 {
-    mWorkQueue = workQueue;
+    mUnrefQueue = unrefQueue;
 }
 
 void CompositeMapRenderer::drawImplementation(osg::RenderInfo &renderInfo) const
@@ -45,14 +45,18 @@ void CompositeMapRenderer::drawImplementation(osg::RenderInfo &renderInfo) const
     double availableTime = std::max((targetFrameTime - dt)*conservativeTimeRatio,
                                     mMinimumTimeAvailable);
 
-    if (mWorkQueue)
-        mUnrefQueue->flush(mWorkQueue.get());
-
     std::lock_guard<std::mutex> lock(mMutex);
 
+    mTimeSpent = 0;
+
     if (mImmediateCompileSet.empty() && mCompileSet.empty())
         return;
 
+    osg::Timer timer;
+
+    if (mScheduled)
+        availableTime = mScheduledTime;
+
     while (!mImmediateCompileSet.empty())
     {
         osg::ref_ptr<CompositeMap> node = *mImmediateCompileSet.begin();
@@ -67,8 +71,15 @@ void CompositeMapRenderer::drawImplementation(osg::RenderInfo &renderInfo) const
 
     while (!mCompileSet.empty() && timeLeft > 0)
     {
-        osg::ref_ptr<CompositeMap> node = *mCompileSet.begin();
-        mCompileSet.erase(node);
+        CompileSet::iterator next = mCompileSet.begin();
+        if (mScheduled)
+            next = std::min_element(mCompileSet.begin(), mCompileSet.end(),
+                [&] (const osg::ref_ptr<CompositeMap>& lhs, const osg::ref_ptr<CompositeMap>& rhs)
+                {
+                    return (lhs->mCenter - mViewPoint).length2() < (rhs->mCenter - mViewPoint).length2();
+                });
+        osg::ref_ptr<CompositeMap> node = *next;
+        mCompileSet.erase(next);
 
         mMutex.unlock();
         compile(*node, renderInfo, &timeLeft);
@@ -82,6 +93,7 @@ void CompositeMapRenderer::drawImplementation(osg::RenderInfo &renderInfo) const
         }
     }
     mTimer.setStartTick();
+    mTimeSpent = timer.time_s();
 }
 
 void CompositeMapRenderer::compile(CompositeMap &compositeMap, osg::RenderInfo &renderInfo, double* timeLeft) const
@@ -139,10 +151,8 @@ void CompositeMapRenderer::compile(CompositeMap &compositeMap, osg::RenderInfo &
 
         ++compositeMap.mCompiled;
 
-        if (mWorkQueue)
-        {
+        if (mUnrefQueue)
             mUnrefQueue->push(compositeMap.mDrawables[i]);
-        }
         compositeMap.mDrawables[i] = nullptr;
 
         if (timeLeft)
@@ -201,6 +211,25 @@ unsigned int CompositeMapRenderer::getCompileSetSize() const
     return mCompileSet.size();
 }
 
+std::size_t CompositeMapRenderer::getNumPendingUploads() const
+{
+    return getCompileSetSize();
+}
+
+void CompositeMapRenderer::scheduleUploads(double timeAvailable, const osg::Vec3f& viewPoint)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mScheduled = true;
+    mScheduledTime = timeAvailable;
+    mViewPoint = viewPoint;
+}
+
+double CompositeMapRenderer::getUploadTimeSpent() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mTimeSpent;
+}
+
 CompositeMap::CompositeMap()
     : mCompiled(0)
 {
@@ -2,6 +2,9 @@
 #define OPENMW_COMPONENTS_TERRAIN_COMPOSITEMAPRENDERER_H
 
 #include <osg/Drawable>
+#include <osg/Vec3f>
+
+#include <components/sceneutil/uploadscheduler.hpp>
 
 #include <set>
 #include <mutex>
@@ -16,7 +19,6 @@ namespace osg
 namespace SceneUtil
 {
     class UnrefQueue;
-    class WorkQueue;
 }
 
 namespace Terrain
@@ -30,12 +32,15 @@ namespace Terrain
         std::vector<osg::ref_ptr<osg::Drawable> > mDrawables;
         osg::ref_ptr<osg::Texture2D> mTexture;
         unsigned int mCompiled;
+        osg::Vec3f mCenter;
     };
 
     /**
      * @brief The CompositeMapRenderer is responsible for updating composite map textures in a blocking or non-blocking way.
+     * @par When used as an UploadQueue of a SceneUtil::UploadScheduler, the time for non-immediate composite maps is
+     * given by the scheduler and the closest maps are rendered first.
      */
-    class CompositeMapRenderer : public osg::Drawable
+    class CompositeMapRenderer : public osg::Drawable, public SceneUtil::UploadQueue
     {
     public:
         CompositeMapRenderer();
@@ -45,8 +50,8 @@ namespace Terrain
 
         void compile(CompositeMap& compositeMap, osg::RenderInfo& renderInfo, double* timeLeft) const;
 
-        /// Set a WorkQueue to delete compiled composite map layers in the background thread
-        void setWorkQueue(SceneUtil::WorkQueue* workQueue);
+        /// Set an UnrefQueue to delete compiled composite map layers in the background thread
+        void setUnrefQueue(SceneUtil::UnrefQueue* unrefQueue);
 
         /// Set the available time in seconds for compiling (non-immediate) composite maps each frame
         void setMinimumTimeAvailableForCompile(double time);
@@ -62,13 +67,23 @@ namespace Terrain
 
         unsigned int getCompileSetSize() const;
 
+        std::size_t getNumPendingUploads() const override;
+
+        void scheduleUploads(double timeAvailable, const osg::Vec3f& viewPoint) override;
+
+        double getUploadTimeSpent() const override;
+
     private:
         float mTargetFrameRate;
         double mMinimumTimeAvailable;
         mutable osg::Timer mTimer;
 
+        bool mScheduled;
+        double mScheduledTime;
+        osg::Vec3f mViewPoint;
+        mutable double mTimeSpent;
+
         osg::ref_ptr<SceneUtil::UnrefQueue> mUnrefQueue;
-        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
 
         typedef std::set<osg::ref_ptr<CompositeMap> > CompileSet;
 
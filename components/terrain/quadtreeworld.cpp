@@ -250,6 +250,7 @@ QuadTreeWorld::QuadTreeWorld(osg::Group *parent, osg::Group *compileRoot, Resour
     , mLodFactor(lodFactor)
     , mVertexLodMod(vertexLodMod)
     , mViewDistance(std::numeric_limits<float>::max())
+    , mOccluderDistance(0.f)
 {
     mChunkManager->setCompositeMapSize(compMapResolution);
     mChunkManager->setCompositeMapLevel(compMapLevel);
@@ -451,6 +452,103 @@ void QuadTreeWorld::accept(osg::NodeVisitor &nv)
     }
 }
 
+struct QuadTreeWorld::OccluderBoxes
+{
+    osg::Vec3f mEyePoint;
+    std::vector<osg::Vec3f> mVertices;
+    std::vector<unsigned int> mIndices;
+
+    void addQuad(const osg::Vec3f& a, const osg::Vec3f& b, const osg::Vec3f& c, const osg::Vec3f& d)
+    {
+        const unsigned int first = static_cast<unsigned int>(mVertices.size());
+        mVertices.insert(mVertices.end(), {a, b, c, d});
+        mIndices.insert(mIndices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+    }
+
+    // The terrain is a height field, so a box from its lowest height downwards is always inside of it.
+    // Only the faces towards the eye point are needed.
+    void addBox(float xMin, float yMin, float xMax, float yMax, float top, float bottom)
+    {
+        const osg::Vec3f corners[4] = {
+            osg::Vec3f(xMin, yMin, top),
+            osg::Vec3f(xMax, yMin, top),
+            osg::Vec3f(xMax, yMax, top),
+            osg::Vec3f(xMin, yMax, top),
+        };
+        const osg::Vec3f down(0, 0, bottom - top);
+
+        if (mEyePoint.z() > top)
+            addQuad(corners[0], corners[1], corners[2], corners[3]);
+        if (mEyePoint.y() < yMin)
+            addQuad(corners[0], corners[1], corners[1] + down, corners[0] + down);
+        if (mEyePoint.x() > xMax)
+            addQuad(corners[1], corners[2], corners[2] + down, corners[1] + down);
+        if (mEyePoint.y() > yMax)
+            addQuad(corners[2], corners[3], corners[3] + down, corners[2] + down);
+        if (mEyePoint.x() < xMin)
+            addQuad(corners[3], corners[0], corners[0] + down, corners[3] + down);
+    }
+};
+
+void QuadTreeWorld::addOccluders(const osg::Vec3f& eyePoint, SceneUtil::OccluderBuffer& buffer)
+{
+    {
+        std::lock_guard<std::mutex> lock(mQuadTreeMutex);
+        if (!mQuadTreeBuilt)
+            return;
+    }
+    if (!mRootNode->getNodeMask())
+        return;
+
+    OccluderBoxes boxes;
+    boxes.mEyePoint = eyePoint;
+    addOccluders(mRootNode, boxes);
+    buffer.addTriangles(boxes.mVertices, boxes.mIndices);
+}
+
+void QuadTreeWorld::addOccluders(QuadTreeNode* node, OccluderBoxes& boxes)
+{
+    // the heights of nodes are not known, only the horizontal bounds
+    if (!node->hasValidBounds() || node->distance(osg::Vec3f(boxes.mEyePoint.x(), boxes.mEyePoint.y(), 0)) > mOccluderDistance)
+        return;
+
+    const float size = node->getSize();
+    const float cellWorldSize = mStorage->getCellWorldSize();
+    // refine nodes closer than their size, but keep the boxes at least a quarter of a cell large
+    if (node->getNumChildren() > 0
+            && (size > 1 || (size > 0.25f && node->distance(boxes.mEyePoint) < size * cellWorldSize)))
+    {
+        for (unsigned int i = 0; i < node->getNumChildren(); ++i)
+            addOccluders(node->getChild(i), boxes);
+        return;
+    }
+    if (size > 1)
+        return;
+
+    const float minHeight = getOccluderHeight(node);
+    const osg::BoundingBox& bounds = node->getBoundingBox();
+    const bool containsEye = boxes.mEyePoint.x() >= bounds.xMin() && boxes.mEyePoint.x() <= bounds.xMax()
+            && boxes.mEyePoint.y() >= bounds.yMin() && boxes.mEyePoint.y() <= bounds.yMax();
+    // the eye point is below the terrain, e.g. while clipping through it
+    if (containsEye && boxes.mEyePoint.z() < minHeight)
+        return;
+
+    boxes.addBox(bounds.xMin(), bounds.yMin(), bounds.xMax(), bounds.yMax(), minHeight, minHeight - size * cellWorldSize);
+}
+
+float QuadTreeWorld::getOccluderHeight(const QuadTreeNode* node)
+{
+    std::lock_guard<std::mutex> lock(mOccluderHeightsMutex);
+    const auto it = mOccluderHeights.find(node);
+    if (it != mOccluderHeights.end())
+        return it->second;
+    float minHeight = 0;
+    float maxHeight = 0;
+    mStorage->getMinMaxHeights(node->getSize(), node->getCenter(), minHeight, maxHeight);
+    mOccluderHeights.emplace(node, minHeight);
+    return minHeight;
+}
+
 void QuadTreeWorld::ensureQuadTreeBuilt()
 {
     std::lock_guard<std::mutex> lock(mQuadTreeMutex);
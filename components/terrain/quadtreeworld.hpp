@@ -4,6 +4,9 @@
 #include "world.hpp"
 #include "terraingrid.hpp"
 
+#include <components/sceneutil/occluderculling.hpp>
+
+#include <map>
 #include <mutex>
 
 namespace osg
@@ -13,11 +16,12 @@ namespace osg
 
 namespace Terrain
 {
+    class QuadTreeNode;
     class RootNode;
     class ViewDataMap;
 
     /// @brief Terrain implementation that loads cells into a Quad Tree, with geometry LOD and texture LOD.
-    class QuadTreeWorld : public TerrainGrid // note: derived from TerrainGrid is only to render default cells (see loadCell)
+    class QuadTreeWorld : public TerrainGrid, public SceneUtil::OccluderSource // note: derived from TerrainGrid is only to render default cells (see loadCell)
     {
     public:
         QuadTreeWorld(osg::Group* parent, osg::Group* compileRoot, Resource::ResourceSystem* resourceSystem, Storage* storage, int nodeMask, int preCompileMask, int borderMask, int compMapResolution, float comMapLevel, float lodFactor, int vertexLodMod, float maxCompGeometrySize);
@@ -43,6 +47,13 @@ namespace Terrain
 
         void reportStats(unsigned int frameNumber, osg::Stats* stats) override;
 
+        /// Draw the terrain within the occluder distance as boxes below the lowest height of cells and their quarters,
+        /// with more detail near the eye point.
+        /// @note Heights are loaded once per node, the first time it is needed.
+        void addOccluders(const osg::Vec3f& eyePoint, SceneUtil::OccluderBuffer& buffer) override;
+
+        void setOccluderDistance(float distance) { mOccluderDistance = distance; }
+
         class ChunkManager
         {
         public:
@@ -53,8 +64,14 @@ namespace Terrain
         void addChunkManager(ChunkManager*);
 
     private:
+        struct OccluderBoxes;
+
         void ensureQuadTreeBuilt();
 
+        void addOccluders(QuadTreeNode* node, OccluderBoxes& boxes);
+
+        float getOccluderHeight(const QuadTreeNode* node);
+
         osg::ref_ptr<RootNode> mRootNode;
 
         osg::ref_ptr<ViewDataMap> mViewDataMap;
@@ -66,6 +83,9 @@ namespace Terrain
         float mLodFactor;
         int mVertexLodMod;
         float mViewDistance;
+        float mOccluderDistance;
+        std::mutex mOccluderHeightsMutex;
+        std::map<const QuadTreeNode*, float> mOccluderHeights;
     };
 
 }
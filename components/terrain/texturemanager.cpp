@@ -56,7 +56,7 @@ osg::ref_ptr<osg::Texture2D> TextureManager::getTexture(const std::string &name)
 
 void TextureManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
 {
-    stats->setAttribute(frameNumber, "Terrain Texture", mCache->getCacheSize());
+    reportCacheStats(frameNumber, stats, "Terrain Texture");
 }
 
 
@@ -4,6 +4,7 @@
 #include <osg/Camera>
 
 #include <components/resource/resourcesystem.hpp>
+#include <components/sceneutil/uploadscheduler.hpp>
 
 #include "storage.hpp"
 #include "texturemanager.hpp"
@@ -51,6 +52,9 @@ World::World(osg::Group* parent, osg::Group* compileRoot, Resource::ResourceSyst
 
 World::~World()
 {
+    if (mUploadScheduler)
+        mUploadScheduler->removeQueue(mCompositeMapRenderer.get());
+
     mResourceSystem->removeResourceManager(mChunkManager.get());
     mResourceSystem->removeResourceManager(mTextureManager.get());
 
@@ -62,9 +66,18 @@ World::~World()
     delete mStorage;
 }
 
-void World::setWorkQueue(SceneUtil::WorkQueue* workQueue)
+void World::setUnrefQueue(SceneUtil::UnrefQueue* unrefQueue)
+{
+    mCompositeMapRenderer->setUnrefQueue(unrefQueue);
+}
+
+void World::setUploadScheduler(SceneUtil::UploadScheduler* uploadScheduler)
 {
-    mCompositeMapRenderer->setWorkQueue(workQueue);
+    if (mUploadScheduler)
+        mUploadScheduler->removeQueue(mCompositeMapRenderer.get());
+    mUploadScheduler = uploadScheduler;
+    if (mUploadScheduler)
+        mUploadScheduler->addQueue(mCompositeMapRenderer.get());
 }
 
 void World::setBordersVisible(bool visible)
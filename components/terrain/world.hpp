@@ -29,7 +29,8 @@ namespace Resource
 
 namespace SceneUtil
 {
-    class WorkQueue;
+    class UnrefQueue;
+    class UploadScheduler;
 }
 
 namespace Terrain
@@ -108,8 +109,11 @@ namespace Terrain
         World(osg::Group* parent, osg::Group* compileRoot, Resource::ResourceSystem* resourceSystem, Storage* storage, int nodeMask, int preCompileMask, int borderMask);
         virtual ~World();
 
-        /// Set a WorkQueue to delete objects in the background thread.
-        void setWorkQueue(SceneUtil::WorkQueue* workQueue);
+        /// Set an UnrefQueue to delete objects in the background thread.
+        void setUnrefQueue(SceneUtil::UnrefQueue* unrefQueue);
+
+        /// Let the UploadScheduler divide the time for rendering composite maps with other GPU uploads.
+        void setUploadScheduler(SceneUtil::UploadScheduler* uploadScheduler);
 
         /// See CompositeMapRenderer::setTargetFrameRate
         void setTargetFrameRate(float rate);
@@ -173,6 +177,7 @@ namespace Terrain
 
         osg::ref_ptr<osg::Group> mCompositeMapCamera;
         osg::ref_ptr<CompositeMapRenderer> mCompositeMapRenderer;
+        osg::ref_ptr<SceneUtil::UploadScheduler> mUploadScheduler;
 
         Resource::ResourceSystem* mResourceSystem;
 
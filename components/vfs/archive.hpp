@@ -2,6 +2,7 @@
 #define OPENMW_COMPONENTS_RESOURCE_ARCHIVE_H
 
 #include <map>
+#include <string>
 
 #include <components/files/constrainedfilestream.hpp>
 
@@ -14,6 +15,10 @@ namespace VFS
         virtual ~File() {}
 
         virtual Files::IStreamPtr open() = 0;
+
+        /// Get a string that changes whenever the file content is changed, without reading the file.
+        /// @note Made of metadata like size and modification time, so it is cheap but may change without the content.
+        virtual std::string getStamp() const = 0;
     };
 
     class Archive
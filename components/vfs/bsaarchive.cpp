@@ -2,6 +2,8 @@
 #include <components/bsa/compressedbsafile.hpp>
 #include <memory>
 
+#include <boost/filesystem/operations.hpp>
+
 namespace VFS
 {
 
@@ -53,4 +55,12 @@ Files::IStreamPtr BsaArchiveFile::open()
     return mFile->getFile(mInfo);
 }
 
+std::string BsaArchiveFile::getStamp() const
+{
+    boost::system::error_code ec;
+    const auto time = boost::filesystem::last_write_time(mFile->getFilename(), ec);
+    return mFile->getFilename() + '\0' + std::to_string(time)
+        + '\0' + std::to_string(mInfo->offset) + '\0' + std::to_string(mInfo->fileSize);
+}
+
 }
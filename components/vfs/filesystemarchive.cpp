@@ -65,4 +65,12 @@ namespace VFS
         return Files::openConstrainedFileStream(mPath.c_str());
     }
 
+    std::string FileSystemArchiveFile::getStamp() const
+    {
+        boost::system::error_code ec;
+        const auto size = boost::filesystem::file_size(mPath, ec);
+        const auto time = boost::filesystem::last_write_time(mPath, ec);
+        return mPath + '\0' + std::to_string(size) + '\0' + std::to_string(time);
+    }
+
 }
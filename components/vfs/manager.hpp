@@ -58,6 +58,11 @@ namespace VFS
         /// @note May be called from any thread once the index has been built.
         Files::IStreamPtr getNormalized(const std::string& normalizedName) const;
 
+        /// Get a stamp of the file that changes whenever its content does, see File::getStamp (name is already normalized).
+        /// @note Throws an exception if the file can not be found.
+        /// @note May be called from any thread once the index has been built.
+        std::string getStamp(const std::string& normalizedName) const;
+
     private:
         bool mStrict;
 